@@ -0,0 +1,68 @@
+#version 430 core
+// Copyright 2020 Bastian Kuolt
+
+// one invocation per mesh, see GPUCulling
+layout(local_size_x = 64) in;
+
+struct Bounds {
+    vec4 center;
+    vec4 extent;  // half the size
+};
+
+struct Draw {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+    uint group;
+};
+
+struct Command {  // DrawElementsIndirectCommand
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer BoundsBuffer { Bounds bounds[]; };
+layout(std430, binding = 1) readonly buffer DrawBuffer { Draw draws[]; };
+layout(std430, binding = 2) readonly buffer GroupBuffer { uint groupOffsets[]; };  // first command of a group
+layout(std430, binding = 3) writeonly buffer CommandBuffer { Command commands[]; };
+layout(std430, binding = 4) buffer CountBuffer { uint counts[]; };  // commands per group
+
+uniform vec4 planes[6];  // in model space
+uniform uint drawCount;
+uniform bool isCompact;  // otherwise culled commands are kept with zero instances
+
+bool isVisible(Bounds box) {
+    for (int i = 0; i < 6; ++i) {
+        // the box is outside if even its corner nearest to the plane is behind it
+        const float distance = dot(planes[i].xyz, box.center.xyz) + planes[i].w;
+        if (distance < -dot(abs(planes[i].xyz), box.extent.xyz)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void main() {
+    const uint i = gl_GlobalInvocationID.x;
+    if (i >= drawCount) {
+        return;
+    }
+
+    const Draw draw = draws[i];
+    const bool visible = isVisible(bounds[i]);
+    Command command = Command(draw.count, visible ? 1u : 0u, draw.firstIndex, draw.baseVertex, 0u);
+
+    if (isCompact) {
+        if (visible) {
+            const uint slot = atomicAdd(counts[draw.group], 1u);
+            commands[groupOffsets[draw.group] + slot] = command;
+        }
+    } else {
+        commands[i] = command;
+    }
+}
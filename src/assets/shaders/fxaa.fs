@@ -0,0 +1,129 @@
+#version 330 core
+// Copyright 2020 Bastian Kuolt
+
+// Fast approximate anti-aliasing (after FXAA 3.11 by Timothy Lottes)
+
+uniform sampler2D frame;
+uniform vec2 texelSize;
+
+in vec2 texCoord;
+out vec4 fragColor;
+
+const float EdgeThreshold = 0.125;     // minimum local contrast of an edge
+const float EdgeThresholdMin = 0.0312; // ignores dark areas
+const float SubpixelQuality = 0.75;
+const int Steps = 10;
+const float StepSizes[Steps] = float[](1.0, 1.0, 1.0, 1.0, 1.5, 2.0, 2.0, 2.0, 4.0, 8.0);
+
+float luma(vec3 color) {
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+float lumaAt(vec2 uv) {
+    return luma(texture(frame, uv).rgb);
+}
+
+void main() {
+    vec4 center = texture(frame, texCoord);
+    float lumaCenter = luma(center.rgb);
+    float lumaDown = luma(textureOffset(frame, texCoord, ivec2(0, -1)).rgb);
+    float lumaUp = luma(textureOffset(frame, texCoord, ivec2(0, 1)).rgb);
+    float lumaLeft = luma(textureOffset(frame, texCoord, ivec2(-1, 0)).rgb);
+    float lumaRight = luma(textureOffset(frame, texCoord, ivec2(1, 0)).rgb);
+
+    float lumaMin = min(lumaCenter, min(min(lumaDown, lumaUp), min(lumaLeft, lumaRight)));
+    float lumaMax = max(lumaCenter, max(max(lumaDown, lumaUp), max(lumaLeft, lumaRight)));
+    float range = lumaMax - lumaMin;
+    if (range < max(EdgeThresholdMin, lumaMax * EdgeThreshold)) {
+        fragColor = center;  // no edge
+        return;
+    }
+
+    float lumaDownLeft = luma(textureOffset(frame, texCoord, ivec2(-1, -1)).rgb);
+    float lumaUpRight = luma(textureOffset(frame, texCoord, ivec2(1, 1)).rgb);
+    float lumaUpLeft = luma(textureOffset(frame, texCoord, ivec2(-1, 1)).rgb);
+    float lumaDownRight = luma(textureOffset(frame, texCoord, ivec2(1, -1)).rgb);
+
+    // the orientation of the edge
+    float lumaDownUp = lumaDown + lumaUp;
+    float lumaLeftRight = lumaLeft + lumaRight;
+    float lumaLeftCorners = lumaDownLeft + lumaUpLeft;
+    float lumaDownCorners = lumaDownLeft + lumaDownRight;
+    float lumaRightCorners = lumaDownRight + lumaUpRight;
+    float lumaUpCorners = lumaUpRight + lumaUpLeft;
+    float edgeHorizontal = abs(-2.0 * lumaLeft + lumaLeftCorners) + abs(-2.0 * lumaCenter + lumaDownUp) * 2.0 +
+                           abs(-2.0 * lumaRight + lumaRightCorners);
+    float edgeVertical = abs(-2.0 * lumaUp + lumaUpCorners) + abs(-2.0 * lumaCenter + lumaLeftRight) * 2.0 +
+                         abs(-2.0 * lumaDown + lumaDownCorners);
+    bool isHorizontal = edgeHorizontal >= edgeVertical;
+
+    // the side of the pixel the edge lies on
+    float luma1 = isHorizontal ? lumaDown : lumaLeft;
+    float luma2 = isHorizontal ? lumaUp : lumaRight;
+    float gradient1 = luma1 - lumaCenter;
+    float gradient2 = luma2 - lumaCenter;
+    bool is1Steepest = abs(gradient1) >= abs(gradient2);
+    float gradientScaled = 0.25 * max(abs(gradient1), abs(gradient2));
+
+    float stepLength = isHorizontal ? texelSize.y : texelSize.x;
+    float lumaLocalAverage;
+    if (is1Steepest) {
+        stepLength = -stepLength;
+        lumaLocalAverage = 0.5 * (luma1 + lumaCenter);
+    } else {
+        lumaLocalAverage = 0.5 * (luma2 + lumaCenter);
+    }
+
+    vec2 edgeCoord = texCoord;
+    if (isHorizontal) {
+        edgeCoord.y += stepLength * 0.5;
+    } else {
+        edgeCoord.x += stepLength * 0.5;
+    }
+
+    // walks along the edge in both directions until its end
+    vec2 offset = isHorizontal ? vec2(texelSize.x, 0.0) : vec2(0.0, texelSize.y);
+    vec2 uv1 = edgeCoord - offset * StepSizes[0];
+    vec2 uv2 = edgeCoord + offset * StepSizes[0];
+    float lumaEnd1 = lumaAt(uv1) - lumaLocalAverage;
+    float lumaEnd2 = lumaAt(uv2) - lumaLocalAverage;
+    bool reached1 = abs(lumaEnd1) >= gradientScaled;
+    bool reached2 = abs(lumaEnd2) >= gradientScaled;
+    for (int i = 1; i < Steps && !(reached1 && reached2); ++i) {
+        if (!reached1) {
+            uv1 -= offset * StepSizes[i];
+            lumaEnd1 = lumaAt(uv1) - lumaLocalAverage;
+            reached1 = abs(lumaEnd1) >= gradientScaled;
+        }
+        if (!reached2) {
+            uv2 += offset * StepSizes[i];
+            lumaEnd2 = lumaAt(uv2) - lumaLocalAverage;
+            reached2 = abs(lumaEnd2) >= gradientScaled;
+        }
+    }
+
+    float distance1 = isHorizontal ? texCoord.x - uv1.x : texCoord.y - uv1.y;
+    float distance2 = isHorizontal ? uv2.x - texCoord.x : uv2.y - texCoord.y;
+    bool isDirection1 = distance1 < distance2;
+    float distanceFinal = min(distance1, distance2);
+    float edgeThickness = distance1 + distance2;
+
+    // only pixels on the darker or brighter side of the edge end are blended
+    bool isLumaCenterSmaller = lumaCenter < lumaLocalAverage;
+    bool correctVariation = ((isDirection1 ? lumaEnd1 : lumaEnd2) < 0.0) != isLumaCenterSmaller;
+    float pixelOffset = correctVariation ? 0.5 - distanceFinal / edgeThickness : 0.0;
+
+    // sub-pixel aliasing of thin features
+    float lumaAverage = (2.0 * (lumaDownUp + lumaLeftRight) + lumaLeftCorners + lumaRightCorners) / 12.0;
+    float subPixelOffset1 = clamp(abs(lumaAverage - lumaCenter) / range, 0.0, 1.0);
+    float subPixelOffset2 = (-2.0 * subPixelOffset1 + 3.0) * subPixelOffset1 * subPixelOffset1;
+    float subPixelOffset = subPixelOffset2 * subPixelOffset2 * SubpixelQuality;
+
+    vec2 finalCoord = texCoord;
+    if (isHorizontal) {
+        finalCoord.y += max(pixelOffset, subPixelOffset) * stepLength;
+    } else {
+        finalCoord.x += max(pixelOffset, subPixelOffset) * stepLength;
+    }
+    fragColor = vec4(texture(frame, finalCoord).rgb, center.a);
+}
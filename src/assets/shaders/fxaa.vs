@@ -0,0 +1,11 @@
+#version 330 core
+// Copyright 2020 Bastian Kuolt
+
+out vec2 texCoord;
+
+void main() {
+    // a single triangle that covers the whole viewport
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    texCoord = position;
+    gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
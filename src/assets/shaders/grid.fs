@@ -0,0 +1,50 @@
+#version 330 core
+// Copyright 2020 Bastian Kuolt
+
+uniform mat4 PV;
+uniform vec3 eye;
+uniform vec3 origin;  // of the grid, which lies in the plane y = origin.y
+uniform float cellSize;
+uniform float fadeDistance;
+uniform vec3 color;
+
+in vec3 nearPoint;
+in vec3 farPoint;
+out vec4 fragColor;
+
+const float Subdivisions = 10.0;  // cells per cell of the next coarser level
+const float MinCellPixels = 8.0;  // coarser levels are used for smaller cells
+
+// the coverage of the pixel by the lines of a grid with cells of the given size
+float getCoverage(vec2 position, vec2 derivative, float size) {
+    vec2 distance = abs(fract(position / size - 0.5) - 0.5) * size / derivative;  // [pixels] to the line
+    return 1.0 - min(min(distance.x, distance.y), 1.0);
+}
+
+void main() {
+    float t = (origin.y - nearPoint.y) / (farPoint.y - nearPoint.y);
+    vec3 position = nearPoint + t * (farPoint - nearPoint);
+    vec2 uv = position.xz - origin.xz;
+    vec2 derivative = max(fwidth(uv), vec2(1e-6));  // before any discard
+
+    vec4 clip = PV * vec4(position, 1.0);
+    if (t <= 0.0 || clip.w <= 0.0 || abs(clip.z) > clip.w) {
+        discard;  // the ray does not hit the plane within the frustum
+    }
+
+    // level of detail of the grid, blended between two levels
+    float lod = max(0.0, log(length(derivative) * MinCellPixels / cellSize) / log(Subdivisions) + 1.0);
+    float size = cellSize * pow(Subdivisions, floor(lod));
+    float blend = fract(lod);
+    float coverage = max(getCoverage(uv, derivative, size) * (1.0 - blend),
+                         getCoverage(uv, derivative, size * Subdivisions));
+
+    float fade = 1.0 - smoothstep(0.5 * fadeDistance, fadeDistance, distance(eye, position));
+    float alpha = coverage * fade;
+    if (alpha <= 0.0) {
+        discard;
+    }
+
+    fragColor = vec4(color, alpha);
+    gl_FragDepth = (clip.z / clip.w) * 0.5 + 0.5;
+}
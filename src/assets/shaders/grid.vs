@@ -0,0 +1,20 @@
+#version 330 core
+// Copyright 2020 Bastian Kuolt
+
+uniform mat4 inversePV;
+
+out vec3 nearPoint;  // world space points of the pixel on the near
+out vec3 farPoint;   // and far plane
+
+vec3 unproject(vec2 position, float depth) {
+    vec4 point = inversePV * vec4(position, depth, 1.0);
+    return point.xyz / point.w;
+}
+
+void main() {
+    // a single triangle that covers the whole viewport
+    vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2) * 2.0 - 1.0;
+    nearPoint = unproject(position, -1.0);
+    farPoint = unproject(position, 1.0);
+    gl_Position = vec4(position, 0.0, 1.0);
+}
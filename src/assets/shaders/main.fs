@@ -1,46 +1,140 @@
-#version 330 core
+#version 430 core
 // Copyright 2020 Bastian Kuolt
-#extension GL_ARB_explicit_uniform_location : require
-#extension GL_ARB_separate_shader_objects : require
-
-uniform mat4 MVP;
 
 uniform struct Light {
-    vec3 direction;
+    vec3 direction;  // view space
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
 } light;
 
-uniform struct Material {
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
+struct Material {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
     float shininess;
-
     bool isTextured;
-    sampler2D texture;
-} material;
+};
+
+// per draw call, written into the upload ring (see DrawConstants in model.cpp)
+layout(std140, binding = 0) uniform DrawConstants {
+    mat4 MVP;
+    mat4 MV;
+    Material material;
+    bool isInstanced;  // the model matrix is an attribute
+};
+
+uniform sampler2D diffuseMap;
+
+/* ------------------------ Clustered Lights ------------------------ */
+// see ClusteredLighting in lighting.hpp
+
+const uvec3 ClusterCount = uvec3(16, 9, 24);
+
+uniform struct Clusters {
+    vec2 tileSize;  // [pixels]
+    float scale;    // depth slice = log(depth) * scale + bias
+    float bias;
+} clusters;
+
+struct PointLight {  // a spot light unless cosOuter is -1
+    vec3 position;   // view space
+    float radius;
+    vec3 color;
+    float cosInner;
+    vec3 direction;  // view space
+    float cosOuter;
+};
+
+layout(std430, binding = 0) readonly buffer LightBuffer {
+    PointLight lights[];
+};
+
+layout(std430, binding = 1) readonly buffer ClusterBuffer {
+    uvec2 clusterLights[];  // offset and count into lightIndices
+};
 
-in vec3 position;
-in vec3 normal;
-in vec2 texcoords;
+layout(std430, binding = 2) readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
 
-in vec3 pixelNormal;
-in vec2 pixelTexCoord;
+/* ------------------------------------------------------------------ */
 
+in VertexData {
+    vec3 position;  // view space
+    vec3 normal;    // view space
+    vec2 texCoord;
+} pixel;
 
-float calculateLightIntensity() {
-    return max(dot(light.direction, normalize(pixelNormal)), 0.0);
+out vec4 fragColor;
+
+#ifdef WIREFRAME
+// see main.gs
+
+uniform struct Wireframe {
+    vec3 color;
+    float width;  // [pixels]
+    bool isFilled;
+} wireframe;
+
+noperspective in vec3 edgeDistance;
+
+float getEdgeCoverage() {
+    float distance = min(edgeDistance.x, min(edgeDistance.y, edgeDistance.z));
+    return 1.0 - smoothstep(0.5 * wireframe.width - 0.5, 0.5 * wireframe.width + 0.5, distance);
+}
+#endif  // WIREFRAME
+
+
+uint getCluster() {
+    uvec2 tile = min(uvec2(gl_FragCoord.xy / clusters.tileSize), ClusterCount.xy - 1);
+    float depth = max(-pixel.position.z, 1e-4);
+    uint slice = uint(clamp(log(depth) * clusters.scale + clusters.bias, 0.0, float(ClusterCount.z - 1)));
+    return (slice * ClusterCount.y + tile.y) * ClusterCount.x + tile.x;
 }
 
-vec4 getLightColor() {
+vec3 getPointLightColor(PointLight pointLight, vec3 normal) {
+    vec3 toLight = pointLight.position - pixel.position;
+    float distance = length(toLight);
+    vec3 direction = toLight / max(distance, 1e-4);
+
+    // smooth window, so the light ends exactly at its radius
+    float falloff = clamp(1.0 - pow(distance / pointLight.radius, 4.0), 0.0, 1.0);
+    float attenuation = falloff * falloff / (distance * distance + 1.0);
+    if (pointLight.cosOuter > -1.0) {
+        attenuation *= smoothstep(pointLight.cosOuter, pointLight.cosInner, dot(-direction, pointLight.direction));
+    }
+    return pointLight.color * max(dot(normal, direction), 0.0) * attenuation;
+}
+
+vec3 getLightColor() {
+    vec3 normal = normalize(pixel.normal);
     vec3 color = light.ambient;
-    color += light.diffuse * calculateLightIntensity() * 0.8;
-    return vec4(color, 0.0);
+    color += light.diffuse * max(dot(light.direction, normal), 0.0) * 0.8;
+
+    uvec2 cluster = clusterLights[getCluster()];
+    for (uint i = 0; i < cluster.y; ++i) {
+        color += getPointLightColor(lights[lightIndices[cluster.x + i]], normal);
+    }
+    return color;
 }
 
 void main() {
-    gl_FragColor = getLightColor() *
-        ((material.isTextured) ? texture2D(material.texture, pixelTexCoord) : vec4(1.0, 1.0, 1.0, 1.0));
+#ifdef WIREFRAME
+    float edge = getEdgeCoverage();
+    if (!wireframe.isFilled) {
+        if (edge <= 0.0) {
+            discard;
+        }
+        fragColor = vec4(wireframe.color, edge);  // blended
+        return;
+    }
+#endif  // WIREFRAME
+
+    vec4 diffuse = material.isTextured ? texture(diffuseMap, pixel.texCoord) : vec4(1.0);
+    fragColor = vec4(getLightColor(), 0.0) * diffuse;
+
+#ifdef WIREFRAME
+    fragColor.rgb = mix(fragColor.rgb, wireframe.color, edge);
+#endif  // WIREFRAME
 }
@@ -0,0 +1,56 @@
+#version 450 core
+// Copyright 2020 Bastian Kuolt
+
+// Single-pass wireframe: passes triangles through and adds the screen space distances of each
+// vertex to the opposite edges, which the fragment shader turns into anti-aliased lines.
+
+layout(triangles) in;
+layout(triangle_strip, max_vertices = 3) out;
+
+uniform vec2 viewportSize;  // [pixels]
+
+in gl_PerVertex { vec4 gl_Position; } gl_in[];
+out gl_PerVertex { vec4 gl_Position; };
+
+in VertexData {
+    vec3 position;
+    vec3 normal;
+    vec2 texCoord;
+} vertices[];
+
+out VertexData {
+    vec3 position;
+    vec3 normal;
+    vec2 texCoord;
+} vertex;
+noperspective out vec3 edgeDistance;  // [pixels]
+
+void main() {
+    vec2 points[3];
+    bool clipped = false;
+    for (int i = 0; i < 3; ++i) {
+        clipped = clipped || gl_in[i].gl_Position.w <= 0.0;
+        points[i] = 0.5 * viewportSize * gl_in[i].gl_Position.xy / gl_in[i].gl_Position.w;
+    }
+
+    // the height of each vertex above its opposite edge is twice the area divided by the edge length
+    vec2 edge0 = points[2] - points[1];
+    vec2 edge1 = points[2] - points[0];
+    vec2 edge2 = points[1] - points[0];
+    float area = abs(edge1.x * edge2.y - edge1.y * edge2.x);
+    vec3 heights = area / max(vec3(length(edge0), length(edge1), length(edge2)), vec3(1e-6));
+    if (clipped) {
+        heights = vec3(1e6);  // crosses the camera plane, the projected edges are meaningless
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        gl_Position = gl_in[i].gl_Position;
+        vertex.position = vertices[i].position;
+        vertex.normal = vertices[i].normal;
+        vertex.texCoord = vertices[i].texCoord;
+        edgeDistance = vec3(0.0);
+        edgeDistance[i] = heights[i];
+        EmitVertex();
+    }
+    EndPrimitive();
+}
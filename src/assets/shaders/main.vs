@@ -1,25 +1,41 @@
 #version 450 core
 // Copyright 2020 Bastian Kuolt
-uniform mat4 MVP;
 
-uniform struct Light {
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-} light;
+struct Material {
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    float shininess;
+    bool isTextured;
+};
 
-in vec3 position;
-in vec3 normal;
-in vec2 texcoords;
+// per draw call, written into the upload ring (see DrawConstants in model.cpp)
+layout(std140, binding = 0) uniform DrawConstants {
+    mat4 MVP;
+    mat4 MV;
+    Material material;
+    bool isInstanced;  // the model matrix is an attribute
+};
 
-out vec3 pixelNormal;
-out vec2 pixelTexCoord;
+// explicit locations keep the vertex arrays valid for the wireframe variant of the program
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec2 texcoords;
+layout(location = 3) in vec4 tangent;  // xyz and the sign of the bitangent (MikkTSpace), for normal maps
+layout(location = 4) in mat4 instance;  // takes locations 4 to 7, a rotation and translation
+
+out VertexData {
+    vec3 position;  // view space
+    vec3 normal;    // view space
+    vec2 texCoord;
+} vertex;
 out gl_PerVertex { vec4 gl_Position; };
 
 
 void main() {
-    gl_Position = MVP * vec4(position, 1.0);
-    pixelNormal = normalize(mat3(MVP) * normal);
-    pixelTexCoord = texcoords;
+    mat4 M = isInstanced ? instance : mat4(1.0);
+    gl_Position = MVP * (M * vec4(position, 1.0));
+    vertex.position = vec3(MV * (M * vec4(position, 1.0)));
+    vertex.normal = normalize(mat3(MV) * (mat3(M) * normal));
+    vertex.texCoord = texcoords;
 }
@@ -0,0 +1,14 @@
+#version 330 core
+// Copyright 2020 Bastian Kuolt
+
+in vec4 pointColor;
+out vec4 fragColor;
+
+
+void main() {
+    vec2 offset = gl_PointCoord * 2.0 - 1.0;
+    if (dot(offset, offset) > 1.0) {
+        discard;  // round points
+    }
+    fragColor = pointColor;
+}
@@ -0,0 +1,26 @@
+#version 330 core
+// Copyright 2020 Bastian Kuolt
+
+uniform mat4 MVP;
+uniform mat4 MV;
+uniform float spacing;     // between the points of the node in model space
+uniform float pixelScale;  // pixels per unit at distance 1
+uniform float maxPointSize;
+uniform bool isColored;
+uniform vec3 solidColor;
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec4 color;
+
+out vec4 pointColor;
+
+
+void main() {
+    vec4 viewPosition = MV * vec4(position, 1.0);
+    gl_Position = MVP * vec4(position, 1.0);
+
+    // points grow as they come closer, so that they cover the gaps to their neighbours
+    float size = spacing * length(MV[0].xyz) * pixelScale / max(-viewPosition.z, 1e-4);
+    gl_PointSize = clamp(size, 1.0, maxPointSize);
+    pointColor = isColored ? color : vec4(solidColor, 1.0);
+}
@@ -0,0 +1,44 @@
+#version 330 core
+// Copyright 2020 Bastian Kuolt
+
+// Upscaling of a frame rendered at a reduced resolution with contrast adaptive sharpening
+// (after FidelityFX CAS by AMD)
+
+uniform sampler2D frame;
+uniform sampler2D depth;
+uniform vec2 texelSize;
+uniform vec2 scale;       // of the rendered part of the textures
+uniform float sharpness;  // [0, 1]
+
+in vec2 texCoord;
+out vec4 fragColor;
+
+const float MaxWeight = 0.2;  // of the negative lobe, keeps the filter normalizable
+
+// keeps bilinear filtering from blending in texels outside of the rendered part
+vec2 clampToFrame(vec2 uv) {
+    return clamp(uv, 0.5 * texelSize, scale - 0.5 * texelSize);
+}
+
+vec3 colorAt(vec2 uv) {
+    return texture(frame, clampToFrame(uv)).rgb;
+}
+
+void main() {
+    vec2 uv = texCoord * scale;
+    vec3 center = colorAt(uv);
+    vec3 up = colorAt(uv + vec2(0.0, texelSize.y));
+    vec3 down = colorAt(uv - vec2(0.0, texelSize.y));
+    vec3 left = colorAt(uv - vec2(texelSize.x, 0.0));
+    vec3 right = colorAt(uv + vec2(texelSize.x, 0.0));
+
+    // sharpens less where the neighbourhood is already contrasty, which avoids ringing
+    vec3 minimum = min(center, min(min(up, down), min(left, right)));
+    vec3 maximum = max(center, max(max(up, down), max(left, right)));
+    vec3 amount = sqrt(clamp(min(minimum, 1.0 - maximum) / max(maximum, vec3(1e-4)), 0.0, 1.0));
+    vec3 weight = -amount * MaxWeight * sharpness;
+
+    vec3 color = (center + (up + down + left + right) * weight) / (1.0 + 4.0 * weight);
+    fragColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+    gl_FragDepth = texture(depth, clampToFrame(uv)).r;
+}
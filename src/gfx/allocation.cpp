@@ -0,0 +1,210 @@
+#include <malloc.h>  // malloc_usable_size()
+#include <unistd.h>  // sysconf()
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>  // std::malloc(), std::free()
+#include <fstream>
+#include <limits>
+#include <new>
+#include <string>
+
+#include "allocation.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+std::atomic<bool> enabled { false };
+
+/**
+ * @brief The allocations of all threads, constant initialized so operator new can use them anytime.
+ * @note Workers of parallel_for() allocate on behalf of the stage that started them, so the
+ *       counters are shared instead of per thread.
+ */
+struct Counters {
+    std::atomic<std::size_t> count;
+    std::atomic<std::int64_t> bytes;  // may become negative if memory allocated before tracking is freed
+    std::atomic<std::int64_t> peak;
+};
+
+Counters counters { { 0 }, { 0 }, { 0 } };
+
+inline void raise_peak(std::int64_t bytes) noexcept {
+    std::int64_t peak { counters.peak.load(std::memory_order_relaxed) };
+    while (bytes > peak && !counters.peak.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+    }
+}
+
+inline void count_allocation(void *pointer) noexcept {
+    if (pointer != nullptr && enabled.load(std::memory_order_relaxed)) {
+        const auto size { static_cast<std::int64_t>(malloc_usable_size(pointer)) };
+        counters.count.fetch_add(1, std::memory_order_relaxed);
+        raise_peak(counters.bytes.fetch_add(size, std::memory_order_relaxed) + size);
+    }
+}
+
+inline void count_deallocation(void *pointer) noexcept {
+    if (pointer != nullptr && enabled.load(std::memory_order_relaxed)) {
+        counters.bytes.fetch_sub(static_cast<std::int64_t>(malloc_usable_size(pointer)), std::memory_order_relaxed);
+    }
+}
+
+void* allocate(std::size_t size) {
+    for (;;) {
+        if (void *pointer { std::malloc(size > 0 ? size : 1) }) {
+            count_allocation(pointer);
+            return pointer;
+        }
+        const std::new_handler handler { std::get_new_handler() };
+        if (handler == nullptr) {
+            throw std::bad_alloc {};
+        }
+        handler();
+    }
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment) {
+    const auto align { std::max(static_cast<std::size_t>(alignment), sizeof(void*)) };
+    for (;;) {
+        void *pointer { nullptr };
+        if (posix_memalign(&pointer, align, size > 0 ? size : 1) == 0) {
+            count_allocation(pointer);
+            return pointer;
+        }
+        const std::new_handler handler { std::get_new_handler() };
+        if (handler == nullptr) {
+            throw std::bad_alloc {};
+        }
+        handler();
+    }
+}
+
+void deallocate(void *pointer) noexcept {
+    count_deallocation(pointer);
+    std::free(pointer);
+}
+
+}  // anonymous namespace
+
+std::size_t GetResidentMemory() noexcept {
+    std::ifstream statm { "/proc/self/statm" };
+    std::size_t size { 0 }, resident { 0 };  // [pages]
+    if (!(statm >> size >> resident)) {
+        return 0;
+    }
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+std::size_t GetPeakResidentMemory() noexcept {
+    std::ifstream status { "/proc/self/status" };
+    std::string key;
+    while (status >> key) {
+        if (key == "VmHWM:") {
+            std::size_t kib { 0 };
+            status >> kib;
+            return kib * 1024;
+        }
+        status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    return 0;
+}
+
+void EnableAllocationTracking(bool value) noexcept {
+    enabled = value;
+}
+
+bool IsAllocationTrackingEnabled() noexcept {
+    return enabled;
+}
+
+AllocationScope::AllocationScope() noexcept
+    : _count { counters.count }, _bytes { counters.bytes }, _outerPeak { counters.peak } {
+    counters.peak = _bytes;
+}
+
+AllocationScope::~AllocationScope() noexcept {
+    raise_peak(_outerPeak);
+}
+
+AllocationStatistics AllocationScope::getStatistics() const noexcept {
+    return { counters.count - _count, static_cast<std::size_t>(std::max<std::int64_t>(counters.peak - _bytes, 0)) };
+}
+
+void AllocationScope::restart() noexcept {
+    _outerPeak = std::max<std::int64_t>(_outerPeak, counters.peak);
+    _count = counters.count;
+    _bytes = counters.bytes;
+    counters.peak = _bytes;
+}
+
+}  // namespace bgl
+
+/*********************************************************
+ *             Replaced Global Allocation Functions      *
+ *********************************************************/
+
+void* operator new(std::size_t size) {
+    return bgl::allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return bgl::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return bgl::allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return bgl::allocate(size);
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return bgl::allocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return bgl::allocate(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept {
+    bgl::deallocate(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    bgl::deallocate(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    bgl::deallocate(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    bgl::deallocate(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    bgl::deallocate(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+    bgl::deallocate(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    bgl::deallocate(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept {
+    bgl::deallocate(pointer);
+}
@@ -0,0 +1,57 @@
+/**
+ * @file allocation.hpp
+ * @brief Counting of heap allocations and resident memory, e.g. to catch regressions of the import path.
+ */
+#ifndef GFX_ALLOCATION_HPP_
+#define GFX_ALLOCATION_HPP_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+
+
+namespace bgl {
+
+/**
+ * @brief Starts counting the heap allocations of all threads.
+ * @details The library replaces the global operator new and delete, which only test a flag
+ *          while tracking is disabled.
+ */
+void EnableAllocationTracking(bool enabled = true) noexcept;
+bool IsAllocationTrackingEnabled() noexcept;
+
+/**
+ * @brief Returns the resident set size of the process in bytes, or 0 if it is unknown.
+ */
+std::size_t GetResidentMemory() noexcept;
+std::size_t GetPeakResidentMemory() noexcept;  // high-water mark of the resident set size
+
+struct AllocationStatistics {
+    std::size_t count;      // of allocations
+    std::size_t peakBytes;  // above the bytes that were allocated when measuring started
+};
+
+/**
+ * @brief Measures the allocations of all threads from its construction or restart() on.
+ * @details Includes the workers of parallel_for(), but also any other thread that allocates at
+ *          the same time, e.g. concurrent imports of other models. Scopes may be nested on one thread.
+ */
+class AllocationScope {
+ public:
+	AllocationScope() noexcept;
+	AllocationScope(const AllocationScope&) = delete;
+	AllocationScope& operator=(const AllocationScope&) = delete;
+
+	virtual ~AllocationScope() noexcept;
+
+	AllocationStatistics getStatistics() const noexcept;
+	void restart() noexcept;
+
+ private:
+	std::size_t _count;
+	std::int64_t _bytes;
+	std::int64_t _outerPeak;  // of an enclosing scope
+};
+
+}  // namespace bgl
+
+#endif  // GFX_ALLOCATION_HPP_
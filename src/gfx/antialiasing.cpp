@@ -0,0 +1,193 @@
+#include "gl.hpp"
+
+#include <QOpenGLShaderProgram>
+
+#include <algorithm>  // std::min()
+#include <stdexcept>
+#include <string>
+
+#include "antialiasing.hpp"
+#include "gfx.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+GLsizei get_samples(Antialiasing mode) noexcept {
+    switch (mode) {
+        case Antialiasing::MSAA2:
+            return 2;
+        case Antialiasing::MSAA4:
+            return 4;
+        case Antialiasing::MSAA8:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+inline bool is_multisampled(Antialiasing mode) noexcept {
+    return get_samples(mode) > 0;
+}
+
+}  // anonymous namespace
+
+const char* GetName(Antialiasing mode) noexcept {
+    switch (mode) {
+        case Antialiasing::None:
+            return "Off";
+        case Antialiasing::MSAA2:
+            return "MSAA 2x";
+        case Antialiasing::MSAA4:
+            return "MSAA 4x";
+        case Antialiasing::MSAA8:
+            return "MSAA 8x";
+        case Antialiasing::FXAA:
+            return "FXAA";
+        default:
+            return "";
+    }
+}
+
+RenderTarget::~RenderTarget() noexcept {
+    release();
+}
+
+void RenderTarget::setMode(Antialiasing mode) noexcept {
+    _mode = mode;
+}
+
+Antialiasing RenderTarget::getMode() const noexcept {
+    return _mode;
+}
+
+void RenderTarget::begin(GLuint target) {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const ivec2 size { viewport[2], viewport[3] };
+
+    if (_mode == Antialiasing::None || size.x <= 0 || size.y <= 0) {
+        destroy();
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        return;
+    }
+    if (_framebuffer == 0 || _createdMode != _mode || size != _size) {
+        destroy();
+        create(size);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+}
+
+void RenderTarget::end(GLuint target) {
+    if (_framebuffer == 0) {
+        return;  // rendered into the target
+    }
+
+    if (is_multisampled(_createdMode)) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, _framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+        glBlitFramebuffer(0, 0, _size.x, _size.y, 0, 0, _size.x, _size.y, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    } else {
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        applyFXAA();
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+}
+
+void RenderTarget::create(const ivec2 &size) {
+    glGenFramebuffers(1, &_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+
+    if (is_multisampled(_mode)) {
+        GLint max_samples { 0 };
+        glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+        const GLsizei samples { std::min(get_samples(_mode), static_cast<GLsizei>(max_samples)) };
+
+        glGenRenderbuffers(1, &_color);
+        glBindRenderbuffer(GL_RENDERBUFFER, _color);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_RGBA8, size.x, size.y);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _color);
+
+        glGenRenderbuffers(1, &_depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, _depth);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, GL_DEPTH_COMPONENT24, size.x, size.y);
+    } else {
+        // FXAA samples its neighbours with bilinear filtering
+        glGenTextures(1, &_color);
+        glBindTexture(GL_TEXTURE_2D, _color);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _color, 0);
+
+        glGenRenderbuffers(1, &_depth);
+        glBindRenderbuffer(GL_RENDERBUFFER, _depth);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size.x, size.y);
+    }
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    const GLenum status { glCheckFramebufferStatus(GL_FRAMEBUFFER) };
+    _createdMode = _mode;
+    _size = size;
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        destroy();
+        throw std::runtime_error { std::string { "could not create framebuffer for " } + GetName(_mode) };
+    }
+}
+
+void RenderTarget::release() noexcept {
+    destroy();
+    if (_vao != 0) {
+        glDeleteVertexArrays(1, &_vao);
+        _vao = 0;
+    }
+    _fxaa.reset();
+}
+
+void RenderTarget::destroy() noexcept {
+    if (_framebuffer == 0) {
+        return;
+    }
+
+    if (is_multisampled(_createdMode)) {
+        glDeleteRenderbuffers(1, &_color);
+    } else {
+        glDeleteTextures(1, &_color);
+    }
+    glDeleteRenderbuffers(1, &_depth);
+    glDeleteFramebuffers(1, &_framebuffer);
+    _framebuffer = _color = _depth = 0;
+    _size = { 0, 0 };
+}
+
+void RenderTarget::applyFXAA() {
+    if (!_fxaa) {
+        _fxaa = LoadProgram("./assets/shaders/fxaa.vs", "./assets/shaders/fxaa.fs");
+        glGenVertexArrays(1, &_vao);
+    }
+
+    const GLboolean depth_test { glIsEnabled(GL_DEPTH_TEST) };
+    glDisable(GL_DEPTH_TEST);
+
+    _fxaa->bind();
+    _fxaa->setUniformValue("frame", 0);
+    _fxaa->setUniformValue("texelSize", 1.0f / _size.x, 1.0f / _size.y);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _color);
+    glBindVertexArray(_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    _fxaa->release();
+
+    if (depth_test) {
+        glEnable(GL_DEPTH_TEST);
+    }
+}
+
+}  // namespace bgl
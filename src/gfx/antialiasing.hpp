@@ -0,0 +1,84 @@
+/**
+ * @file antialiasing.hpp
+ * @brief Multisampled and post-processed anti-aliasing of rendered frames.
+ */
+#ifndef GFX_ANTIALIASING_HPP_
+#define GFX_ANTIALIASING_HPP_
+
+#include <memory>  // std::shared_ptr
+
+#include "gl.hpp"
+
+class QOpenGLShaderProgram;
+
+
+namespace bgl {
+
+enum class Antialiasing {
+    None,
+    MSAA2,
+    MSAA4,
+    MSAA8,
+    FXAA  // a single post-processing pass over the resolved frame
+};
+
+const char* GetName(Antialiasing mode) noexcept;
+
+/**
+ * @brief An offscreen framebuffer that anti-aliases the frame rendered into it.
+ * @details With MSAA the frame is rendered into multisampled renderbuffers that are resolved by
+ *          a blit, with FXAA into a texture that is filtered by a fullscreen pass. Without
+ *          anti-aliasing the frame is rendered into the target framebuffer directly. The buffers
+ *          are (re)created whenever the mode or the size of the viewport changes. All methods
+ *          must be called with the OpenGL context being current.
+ */
+class RenderTarget {
+ public:
+	RenderTarget() = default;
+	RenderTarget(RenderTarget&&) = delete;
+	RenderTarget& operator=(RenderTarget&&) = delete;
+
+	RenderTarget(const RenderTarget&) = delete;
+	RenderTarget& operator=(const RenderTarget&) = delete;
+
+	virtual ~RenderTarget() noexcept;
+
+	void setMode(Antialiasing mode) noexcept;
+	Antialiasing getMode() const noexcept;
+
+	/**
+	 * @brief Binds the framebuffer to render a frame of the size of the current viewport into.
+	 * @param target the framebuffer to render into if anti-aliasing is disabled
+	 */
+	void begin(GLuint target);
+
+	/**
+	 * @brief Resolves the frame into the @p target framebuffer.
+	 */
+	void end(GLuint target);
+
+	/**
+	 * @brief Deletes all OpenGL objects, they are created again by the next begin().
+	 * @note Must be called before the OpenGL context is destroyed if the target outlives it.
+	 */
+	void release() noexcept;
+
+ private:
+	void create(const ivec2 &size);
+	void destroy() noexcept;
+	void applyFXAA();
+
+	Antialiasing _mode { Antialiasing::None };
+	Antialiasing _createdMode { Antialiasing::None };  // of the current buffers
+	ivec2 _size { 0, 0 };
+
+	GLuint _framebuffer { 0 };
+	GLuint _color { 0 };  // renderbuffer (MSAA) or texture (FXAA)
+	GLuint _depth { 0 };  // renderbuffer
+	GLuint _vao { 0 };    // empty, the fullscreen triangle is generated by the vertex shader
+	std::shared_ptr<QOpenGLShaderProgram> _fxaa;
+};
+
+}  // namespace bgl
+
+#endif  // GFX_ANTIALIASING_HPP_
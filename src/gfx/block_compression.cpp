@@ -0,0 +1,618 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>  // std::memcpy()
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>  // std::pair
+
+#include "block_compression.hpp"
+#include "parallel.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+using Block = std::array<std::array<float, 4>, 16>;  // 4x4 RGBA texels
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+/*********************************************************
+ *                    Endpoint Selection                 *
+ *********************************************************/
+
+/**
+ * @brief Finds the two endpoints of the principal axis of the first @p channels channels.
+ * @details The axis is approximated by a few power iterations on the covariance matrix and
+ *          the endpoints are inset slightly to reduce the quantization error of the extremes.
+ */
+template<int channels>
+void find_endpoints(const Block &block, std::array<float, 4> &e0, std::array<float, 4> &e1) {
+    std::array<float, channels> mean {};
+    for (auto &texel : block) {
+        for (auto c = 0; c < channels; ++c) {
+            mean[c] += texel[c] / 16.0f;
+        }
+    }
+
+    std::array<std::array<float, channels>, channels> covariance {};
+    for (auto &texel : block) {
+        for (auto i = 0; i < channels; ++i) {
+            for (auto j = 0; j < channels; ++j) {
+                covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+            }
+        }
+    }
+
+    std::array<float, channels> axis;
+    axis.fill(1.0f);
+    for (auto iteration = 0; iteration < 8; ++iteration) {
+        std::array<float, channels> next {};
+        float length { 0.0f };
+        for (auto i = 0; i < channels; ++i) {
+            for (auto j = 0; j < channels; ++j) {
+                next[i] += covariance[i][j] * axis[j];
+            }
+            length = std::max(length, std::abs(next[i]));
+        }
+        if (length < 1e-6f) {
+            break;  // all texels are (nearly) equal
+        }
+        for (auto i = 0; i < channels; ++i) {
+            axis[i] = next[i] / length;
+        }
+    }
+
+    float min { INFINITY };
+    float max { -INFINITY };
+    for (auto &texel : block) {
+        float projection { 0.0f };
+        for (auto c = 0; c < channels; ++c) {
+            projection += (texel[c] - mean[c]) * axis[c];
+        }
+        min = std::min(min, projection);
+        max = std::max(max, projection);
+    }
+
+    float norm { 0.0f };
+    for (auto c = 0; c < channels; ++c) {
+        norm += axis[c] * axis[c];
+    }
+    const float inset { (max - min) / 16.0f };
+    min = (min + inset) / std::max(norm, 1e-6f);
+    max = (max - inset) / std::max(norm, 1e-6f);
+
+    e0.fill(255.0f);
+    e1.fill(255.0f);
+    for (auto c = 0; c < channels; ++c) {
+        e0[c] = std::clamp(mean[c] + axis[c] * max, 0.0f, 255.0f);
+        e1[c] = std::clamp(mean[c] + axis[c] * min, 0.0f, 255.0f);
+    }
+}
+
+template<int channels, std::size_t N>
+unsigned find_nearest(const std::array<float, 4> &texel, const std::array<std::array<float, 4>, N> &palette) {
+    unsigned nearest { 0 };
+    float nearest_distance { INFINITY };
+    for (auto i = 0u; i < N; ++i) {
+        float distance { 0.0f };
+        for (auto c = 0; c < channels; ++c) {
+            const float d { texel[c] - palette[i][c] };
+            distance += d * d;
+        }
+        if (distance < nearest_distance) {
+            nearest = i;
+            nearest_distance = distance;
+        }
+    }
+    return nearest;
+}
+
+/*********************************************************
+ *                          BC1                          *
+ *********************************************************/
+
+inline std::uint16_t to_565(const std::array<float, 4> &color) noexcept {
+    const auto r { static_cast<std::uint16_t>(std::lround(color[0] * 31.0f / 255.0f)) };
+    const auto g { static_cast<std::uint16_t>(std::lround(color[1] * 63.0f / 255.0f)) };
+    const auto b { static_cast<std::uint16_t>(std::lround(color[2] * 31.0f / 255.0f)) };
+    return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+}
+
+inline std::array<float, 4> from_565(std::uint16_t color) noexcept {
+    const unsigned r { (color >> 11) & 31u };
+    const unsigned g { (color >> 5) & 63u };
+    const unsigned b { color & 31u };
+    return { static_cast<float>((r << 3) | (r >> 2)),
+             static_cast<float>((g << 2) | (g >> 4)),
+             static_cast<float>((b << 3) | (b >> 2)), 255.0f };
+}
+
+/**
+ * @brief Encodes the colors of a block in 4-color mode (as used by BC1 and BC3).
+ */
+void encode_bc1(const Block &block, std::uint8_t *output) {
+    std::array<float, 4> e0;
+    std::array<float, 4> e1;
+    find_endpoints<3>(block, e0, e1);
+
+    std::uint16_t c0 { to_565(e0) };
+    std::uint16_t c1 { to_565(e1) };
+    if (c0 < c1) {
+        std::swap(c0, c1);  // c0 > c1 selects the 4-color mode
+    }
+
+    std::uint32_t indices { 0 };
+    if (c0 != c1) {
+        const std::array<float, 4> p0 { from_565(c0) };
+        const std::array<float, 4> p1 { from_565(c1) };
+        std::array<std::array<float, 4>, 4> palette { p0, p1, p0, p1 };
+        for (auto c = 0; c < 3; ++c) {
+            palette[2][c] = (2.0f * p0[c] + p1[c]) / 3.0f;
+            palette[3][c] = (p0[c] + 2.0f * p1[c]) / 3.0f;
+        }
+        for (auto i = 0u; i < 16; ++i) {
+            indices |= find_nearest<3>(block[i], palette) << (2 * i);
+        }
+    }
+
+    output[0] = c0 & 0xFF;
+    output[1] = c0 >> 8;
+    output[2] = c1 & 0xFF;
+    output[3] = c1 >> 8;
+    std::memcpy(output + 4, &indices, sizeof(indices));  // little endian
+}
+
+/*********************************************************
+ *                          BC4                          *
+ *********************************************************/
+
+/**
+ * @brief Encodes one channel of a block (BC4, used by BC3 for alpha and twice by BC5).
+ */
+void encode_bc4(const Block &block, int channel, std::uint8_t *output) {
+    float min { 255.0f };
+    float max { 0.0f };
+    for (auto &texel : block) {
+        min = std::min(min, texel[channel]);
+        max = std::max(max, texel[channel]);
+    }
+
+    const auto a0 { static_cast<std::uint8_t>(std::lround(max)) };
+    const auto a1 { static_cast<std::uint8_t>(std::lround(min)) };
+    output[0] = a0;
+    output[1] = a1;
+
+    std::uint64_t indices { 0 };
+    if (a0 > a1) {  // 8 value mode
+        std::array<std::array<float, 4>, 8> palette {};
+        palette[0][0] = a0;
+        palette[1][0] = a1;
+        for (auto i = 1; i < 7; ++i) {
+            palette[i + 1][0] = ((7 - i) * a0 + i * a1) / 7.0f;
+        }
+        for (auto i = 0u; i < 16; ++i) {
+            const std::array<float, 4> value { block[i][channel] };
+            indices |= std::uint64_t { find_nearest<1>(value, palette) } << (3 * i);
+        }
+    }
+
+    for (auto i = 0; i < 6; ++i) {
+        output[2 + i] = static_cast<std::uint8_t>(indices >> (8 * i));
+    }
+}
+
+/*********************************************************
+ *                          BC7                          *
+ *********************************************************/
+
+class BitWriter {
+ public:
+    explicit BitWriter(std::uint8_t *output) noexcept
+        : _output { output } {
+        std::fill_n(_output, 16, 0);
+    }
+
+    void write(unsigned value, unsigned count) noexcept {
+        for (auto i = 0u; i < count; ++i, ++_position) {
+            _output[_position / 8] |= ((value >> i) & 1u) << (_position % 8);
+        }
+    }
+
+ private:
+    std::uint8_t *_output;
+    unsigned _position { 0 };
+};
+
+/**
+ * @brief Quantizes an endpoint to 7 bits per channel plus a shared p-bit.
+ */
+void quantize_bc7(const std::array<float, 4> &endpoint, std::array<unsigned, 4> &color, unsigned &p_bit) {
+    float best_error { INFINITY };
+    for (auto p = 0u; p < 2; ++p) {
+        std::array<unsigned, 4> candidate;
+        float error { 0.0f };
+        for (auto c = 0; c < 4; ++c) {
+            candidate[c] = static_cast<unsigned>(std::clamp(std::lround((endpoint[c] - p) / 2.0f), 0l, 127l));
+            const float d { endpoint[c] - ((candidate[c] << 1) | p) };
+            error += d * d;
+        }
+        if (error < best_error) {
+            best_error = error;
+            color = candidate;
+            p_bit = p;
+        }
+    }
+}
+
+/**
+ * @brief Encodes a block using BC7 mode 6 (one subset, RGBA 7.7.7.7 endpoints with p-bits and
+ *        4-bit indices).
+ */
+void encode_bc7(const Block &block, std::uint8_t *output) {
+    constexpr std::array<unsigned, 16> weights { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    std::array<float, 4> e0;
+    std::array<float, 4> e1;
+    find_endpoints<4>(block, e0, e1);
+
+    std::array<std::array<unsigned, 4>, 2> colors;
+    std::array<unsigned, 2> p_bits;
+    quantize_bc7(e0, colors[0], p_bits[0]);
+    quantize_bc7(e1, colors[1], p_bits[1]);
+
+    std::array<std::array<float, 4>, 16> palette;
+    for (auto i = 0u; i < 16; ++i) {
+        for (auto c = 0; c < 4; ++c) {
+            const unsigned a { (colors[0][c] << 1) | p_bits[0] };
+            const unsigned b { (colors[1][c] << 1) | p_bits[1] };
+            palette[i][c] = static_cast<float>(((64 - weights[i]) * a + weights[i] * b + 32) >> 6);
+        }
+    }
+
+    std::array<unsigned, 16> indices;
+    for (auto i = 0u; i < 16; ++i) {
+        indices[i] = find_nearest<4>(block[i], palette);
+    }
+
+    // the most significant index bit of the first texel is implicitly 0
+    if (indices[0] >= 8) {
+        std::swap(colors[0], colors[1]);
+        std::swap(p_bits[0], p_bits[1]);
+        for (auto &index : indices) {
+            index = 15 - index;
+        }
+    }
+
+    BitWriter writer { output };
+    writer.write(1u << 6, 7);  // mode 6
+    for (auto c = 0; c < 4; ++c) {
+        writer.write(colors[0][c], 7);
+        writer.write(colors[1][c], 7);
+    }
+    writer.write(p_bits[0], 1);
+    writer.write(p_bits[1], 1);
+    writer.write(indices[0], 3);
+    for (auto i = 1u; i < 16; ++i) {
+        writer.write(indices[i], 4);
+    }
+}
+
+/*********************************************************
+ *                        Images                         *
+ *********************************************************/
+
+Block load_block(const std::uint8_t *rgba, unsigned width, unsigned height, unsigned bx, unsigned by) {
+    Block block;
+    for (auto y = 0u; y < 4; ++y) {
+        for (auto x = 0u; x < 4; ++x) {
+            const unsigned px { std::min(bx * 4 + x, width - 1) };
+            const unsigned py { std::min(by * 4 + y, height - 1) };
+            const std::uint8_t *texel { rgba + (std::size_t { py } * width + px) * 4 };
+            for (auto c = 0; c < 4; ++c) {
+                block[y * 4 + x][c] = texel[c];
+            }
+        }
+    }
+    return block;
+}
+
+void encode_block(const Block &block, BlockFormat format, std::uint8_t *output) {
+    switch (format) {
+        case BlockFormat::BC1:
+            encode_bc1(block, output);
+            break;
+        case BlockFormat::BC3:
+            encode_bc4(block, 3, output);
+            encode_bc1(block, output + 8);
+            break;
+        case BlockFormat::BC5:
+            encode_bc4(block, 0, output);
+            encode_bc4(block, 1, output + 8);
+            break;
+        case BlockFormat::BC7:
+            encode_bc7(block, output);
+            break;
+        default:
+            break;
+    }
+}
+
+/*********************************************************
+ *                       Decoding                        *
+ *********************************************************/
+
+// Decoders following the format specifications, which only serve to check the encoders
+
+void decode_bc1(const std::uint8_t *input, bool four_colors, Block &block) {
+    const auto c0 { static_cast<std::uint16_t>(input[0] | (input[1] << 8)) };
+    const auto c1 { static_cast<std::uint16_t>(input[2] | (input[3] << 8)) };
+    const std::array<float, 4> p0 { from_565(c0) };
+    const std::array<float, 4> p1 { from_565(c1) };
+    const bool opaque { four_colors || c0 > c1 };  // otherwise the fourth color is transparent black
+    std::array<std::array<float, 4>, 4> palette { p0, p1, p0, opaque ? p1 : std::array<float, 4> {} };
+    for (auto c = 0; c < 3; ++c) {
+        if (opaque) {
+            palette[2][c] = std::round((2.0f * p0[c] + p1[c]) / 3.0f);
+            palette[3][c] = std::round((p0[c] + 2.0f * p1[c]) / 3.0f);
+        } else {
+            palette[2][c] = std::round((p0[c] + p1[c]) / 2.0f);
+        }
+    }
+
+    std::uint32_t indices;
+    std::memcpy(&indices, input + 4, sizeof(indices));  // little endian
+    for (auto i = 0u; i < 16; ++i) {
+        block[i] = palette[(indices >> (2 * i)) & 3u];
+    }
+}
+
+void decode_bc4(const std::uint8_t *input, int channel, Block &block) {
+    const auto a0 { static_cast<float>(input[0]) };
+    const auto a1 { static_cast<float>(input[1]) };
+    std::array<float, 8> palette { a0, a1 };
+    if (input[0] > input[1]) {
+        for (auto i = 2; i < 8; ++i) {
+            palette[i] = std::round(((8 - i) * a0 + (i - 1) * a1) / 7.0f);
+        }
+    } else {
+        for (auto i = 2; i < 6; ++i) {
+            palette[i] = std::round(((6 - i) * a0 + (i - 1) * a1) / 5.0f);
+        }
+        palette[6] = 0.0f;
+        palette[7] = 255.0f;
+    }
+
+    std::uint64_t indices { 0 };
+    for (auto i = 0; i < 6; ++i) {
+        indices |= std::uint64_t { input[2 + i] } << (8 * i);
+    }
+    for (auto i = 0u; i < 16; ++i) {
+        block[i][channel] = palette[(indices >> (3 * i)) & 7u];
+    }
+}
+
+class BitReader {
+ public:
+    explicit BitReader(const std::uint8_t *input) noexcept
+        : _input { input } {}
+
+    unsigned read(unsigned count) noexcept {
+        unsigned value { 0 };
+        for (auto i = 0u; i < count; ++i, ++_position) {
+            value |= ((_input[_position / 8] >> (_position % 8)) & 1u) << i;
+        }
+        return value;
+    }
+
+ private:
+    const std::uint8_t *_input;
+    unsigned _position { 0 };
+};
+
+/**
+ * @return false if the block is not encoded in mode 6, the only mode written by encode_bc7()
+ */
+bool decode_bc7(const std::uint8_t *input, Block &block) {
+    constexpr std::array<unsigned, 16> weights { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    BitReader reader { input };
+    if (reader.read(7) != 1u << 6) {
+        return false;
+    }
+    std::array<std::array<unsigned, 4>, 2> endpoints;
+    for (auto c = 0; c < 4; ++c) {
+        endpoints[0][c] = reader.read(7) << 1;
+        endpoints[1][c] = reader.read(7) << 1;
+    }
+    for (auto &endpoint : endpoints) {
+        const unsigned p_bit { reader.read(1) };
+        for (auto &value : endpoint) {
+            value |= p_bit;
+        }
+    }
+
+    for (auto i = 0u; i < 16; ++i) {
+        const unsigned weight { weights[reader.read(i == 0 ? 3 : 4)] };
+        for (auto c = 0; c < 4; ++c) {
+            block[i][c] = static_cast<float>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+        }
+    }
+    return true;
+}
+
+bool decode_block(const std::uint8_t *input, BlockFormat format, Block &block) {
+    for (auto &texel : block) {
+        texel = { 0.0f, 0.0f, 0.0f, 255.0f };
+    }
+    switch (format) {
+        case BlockFormat::BC1:
+            decode_bc1(input, false, block);
+            return true;
+        case BlockFormat::BC3:
+            decode_bc1(input + 8, true, block);
+            decode_bc4(input, 3, block);
+            return true;
+        case BlockFormat::BC5:
+            decode_bc4(input, 0, block);
+            decode_bc4(input + 8, 1, block);
+            return true;
+        case BlockFormat::BC7:
+            return decode_bc7(input, block);
+        default:
+            return false;
+    }
+}
+
+/*********************************************************
+ *                       Benchmark                       *
+ *********************************************************/
+
+constexpr std::array<std::pair<BlockFormat, const char*>, 4> Formats { {
+    { BlockFormat::BC1, "BC1" }, { BlockFormat::BC3, "BC3" }, { BlockFormat::BC5, "BC5" }, { BlockFormat::BC7, "BC7" } } };
+
+// the limits are the errors of the current encoders with a small margin, per format in the order of Formats
+struct TestImage {
+    std::string name;
+    std::array<double, Formats.size()> minPSNR;  // [dB]
+    std::array<float, Formats.size()> maxError;  // of a channel of a texel
+    std::vector<std::uint8_t> rgba;
+};
+
+struct Error {
+    double psnr;  // [dB]
+    float max;
+};
+
+/**
+ * @brief Creates a solid, a smooth, a normal map and a noise image.
+ */
+std::vector<TestImage> create_images(unsigned width, unsigned height) {
+    std::vector<TestImage> images {
+        { "solid", { 44.0, 45.0, 60.0, 52.0 }, { 3.0f, 3.0f, 1.0f, 1.0f }, {} },
+        { "gradient", { 40.0, 41.0, 60.0, 50.0 }, { 6.0f, 6.0f, 1.0f, 3.0f }, {} },
+        { "normal map", { 41.0, 42.0, 65.0, 50.0 }, { 8.0f, 8.0f, 2.0f, 5.0f }, {} },
+        { "noise", { 12.0, 13.0, 27.0, 12.0 }, { 255.0f, 255.0f, 32.0f, 255.0f }, {} } };
+    for (auto &image : images) {
+        image.rgba.reserve(std::size_t { width } * height * 4);
+    }
+
+    std::mt19937 random { 42 };
+    std::uniform_int_distribution<int> distribution { 0, 255 };
+    for (auto y = 0u; y < height; ++y) {
+        for (auto x = 0u; x < width; ++x) {
+            const float u { static_cast<float>(x) / static_cast<float>(width - 1) };
+            const float v { static_cast<float>(y) / static_cast<float>(height - 1) };
+            const float nx { 0.5f * std::sin(u * 25.0f) * std::cos(v * 13.0f) };
+            const float ny { 0.5f * std::cos(u * 17.0f) * std::sin(v * 29.0f) };
+            const float nz { std::sqrt(1.0f - nx * nx - ny * ny) };
+            const std::array<std::array<float, 4>, 3> colors { {
+                { 200.0f, 120.0f, 40.0f, 255.0f },
+                { 255.0f * u, 255.0f * v, 255.0f * (1.0f - u) * v, 255.0f * (1.0f - v) },
+                { 127.5f + 127.5f * nx, 127.5f + 127.5f * ny, 127.5f + 127.5f * nz, 255.0f } } };
+            for (auto i = 0u; i < colors.size(); ++i) {
+                for (const float value : colors[i]) {
+                    images[i].rgba.push_back(static_cast<std::uint8_t>(std::lround(value)));
+                }
+            }
+            for (auto c = 0; c < 4; ++c) {
+                images[3].rgba.push_back(static_cast<std::uint8_t>(distribution(random)));
+            }
+        }
+    }
+    return images;
+}
+
+/**
+ * @brief Decodes an image and compares the encoded channels with the original.
+ */
+Error get_error(const std::uint8_t *rgba, unsigned width, unsigned height, BlockFormat format,
+                const std::vector<std::uint8_t> &compressed) {
+    const int channels { format == BlockFormat::BC1 ? 3 : format == BlockFormat::BC5 ? 2 : 4 };
+    const unsigned blocks_x { (width + 3) / 4 };
+    double error { 0.0 };
+    float max_error { 0.0f };
+    for (auto by = 0u; by < (height + 3) / 4; ++by) {
+        for (auto bx = 0u; bx < blocks_x; ++bx) {
+            Block block;
+            if (!decode_block(&compressed[(std::size_t { by } * blocks_x + bx) * GetBlockSize(format)], format, block)) {
+                return { 0.0, 255.0f };
+            }
+            for (auto y = 0u; y < 4 && by * 4 + y < height; ++y) {
+                for (auto x = 0u; x < 4 && bx * 4 + x < width; ++x) {
+                    const std::uint8_t *texel { rgba + ((std::size_t { by } * 4 + y) * width + bx * 4 + x) * 4 };
+                    for (auto c = 0; c < channels; ++c) {
+                        const float d { block[y * 4 + x][c] - texel[c] };
+                        error += d * d;
+                        max_error = std::max(max_error, std::abs(d));
+                    }
+                }
+            }
+        }
+    }
+
+    const double mean_error { error / (static_cast<double>(width) * height * channels) };
+    return { mean_error == 0.0 ? INFINITY : 10.0 * std::log10(255.0 * 255.0 / mean_error), max_error };
+}
+
+}  // anonymous namespace
+
+std::size_t GetBlockSize(BlockFormat format) noexcept {
+    return format == BlockFormat::BC1 ? 8 : 16;
+}
+
+std::size_t GetCompressedSize(BlockFormat format, unsigned width, unsigned height) noexcept {
+    return std::size_t { (width + 3) / 4 } * ((height + 3) / 4) * GetBlockSize(format);
+}
+
+std::vector<std::uint8_t> CompressImage(const std::uint8_t *rgba, unsigned width, unsigned height,
+                                        BlockFormat format) {
+    const unsigned blocks_x { (width + 3) / 4 };
+    const unsigned blocks_y { (height + 3) / 4 };
+    const std::size_t block_size { GetBlockSize(format) };
+
+    std::vector<std::uint8_t> output(GetCompressedSize(format, width, height));
+    parallel_for(0, blocks_y, [&] (std::size_t begin, std::size_t end) {
+        for (auto by = begin; by < end; ++by) {
+            for (auto bx = 0u; bx < blocks_x; ++bx) {
+                const Block block { load_block(rgba, width, height, bx, static_cast<unsigned>(by)) };
+                encode_block(block, format, &output[(by * blocks_x + bx) * block_size]);
+            }
+        }
+    }, 16);
+    return output;
+}
+
+bool RunBlockCompressionBenchmark() {
+    constexpr unsigned Width { 1022 };
+    constexpr unsigned Height { 514 };
+
+    bool valid { true };
+    for (const TestImage &image : create_images(Width, Height)) {
+        for (auto i = 0u; i < Formats.size(); ++i) {
+            const auto [format, name] = Formats[i];
+            const Clock::time_point begin { Clock::now() };
+            const std::vector<std::uint8_t> compressed { CompressImage(image.rgba.data(), Width, Height, format) };
+            const double time { get_milliseconds(begin) };
+            const Error error { get_error(image.rgba.data(), Width, Height, format, compressed) };
+            const bool matches { error.psnr >= image.minPSNR[i] && error.max <= image.maxError[i] };
+            valid = valid && matches;
+
+            std::cout << std::fixed << std::setprecision(1)
+                      << name << " " << image.name << " " << Width << "x" << Height << ": "
+                      << error.psnr << " dB PSNR, max. error " << error.max << ", encoded in " << time << " ms ("
+                      << Width * Height / time / 1000.0 << " M texels/s) on " << get_thread_count() << " threads"
+                      << (matches ? "" : " MISMATCH") << std::endl;
+        }
+    }
+    return valid;
+}
+
+}  // namespace bgl
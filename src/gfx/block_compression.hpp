@@ -0,0 +1,48 @@
+/**
+ * @file block_compression.hpp
+ * @brief CPU encoders for GPU block compressed texture formats.
+ */
+#ifndef GFX_BLOCK_COMPRESSION_HPP_
+#define GFX_BLOCK_COMPRESSION_HPP_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <vector>
+
+
+namespace bgl {
+
+enum class BlockFormat : std::uint32_t {
+    BC1,  // RGB, 4 bits per texel
+    BC3,  // RGBA, 8 bits per texel
+    BC5,  // two channels (e.g. normal maps), 8 bits per texel
+    BC7   // RGBA in higher quality, 8 bits per texel
+};
+
+/**
+ * @brief Returns the size of one 4x4 texel block in bytes.
+ */
+std::size_t GetBlockSize(BlockFormat format) noexcept;
+
+/**
+ * @brief Returns the size of a compressed image in bytes.
+ */
+std::size_t GetCompressedSize(BlockFormat format, unsigned width, unsigned height) noexcept;
+
+/**
+ * @brief Compresses an RGBA8 image, the blocks are encoded in parallel.
+ * @note Images that are no multiple of 4x4 are padded by repeating their border texels.
+ */
+std::vector<std::uint8_t> CompressImage(const std::uint8_t *rgba, unsigned width, unsigned height,
+                                        BlockFormat format);
+
+/**
+ * @brief Compresses synthetic images into every format, decodes them again and prints the
+ *        peak signal-to-noise ratios and the encoding throughputs.
+ * @return whether all images were decoded with at least the PSNR expected of them
+ */
+bool RunBlockCompressionBenchmark();
+
+}  // namespace bgl
+
+#endif  // GFX_BLOCK_COMPRESSION_HPP_
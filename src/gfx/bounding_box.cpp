@@ -15,6 +15,10 @@ vec3 BoundingBox::getSize() const noexcept {
     return _size;
 }
 
+vec3 BoundingBox::getCenter() const noexcept {
+    return _center;
+}
+
 void BoundingBox::resize(const vec3 &size) {
     _size = size;
 }
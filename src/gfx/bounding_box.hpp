@@ -12,8 +12,8 @@ class BoundingBox {
 	BoundingBox(const vec3 &center, const vec3 &size);
 
 	vec3 getSize() const noexcept;
+	vec3 getCenter() const noexcept;
 	void resize(const vec3 &size);
-	// TODO: getCenter()
 	// TODO: setCenter()
 	// TODO: translate()
 	// TODO: collides()
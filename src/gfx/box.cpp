@@ -62,6 +62,8 @@ Box::Box() {
     uvec2 *buffer { reinterpret_cast<uvec2 *>(_meshes[0]._ibo.map(QOpenGLBuffer::WriteOnly)) };
     std::copy(box_indices.begin(), box_indices.end(), buffer);
     _meshes[0]._ibo.unmap();
+    _meshes[0]._vertexBytes = box_vertices.size() * sizeof(vec3);
+    _meshes[0]._indexBytes = box_indices.size() * 2 * sizeof(GLuint);
 
     // create vao
     _meshes[0]._vao.bind();
@@ -79,7 +81,6 @@ Box::Box(const BoundingBox &boundingBox)
 }
 
 void Box::render(const mat4 &VP) {
-    std::cout << "Box::render()" << std::endl;
     _program->bind();
     glLineWidth(3);
 
@@ -60,18 +60,27 @@ float Camera::getZoom() const noexcept {
 }
 
 mat4 Camera::matrix() const noexcept {
+    return getProjection() * getView();
+}
+
+mat4 Camera::getProjection() const noexcept {
     assert(_zoom > 0);
 
     const float ratio { calculate_aspect_ratio() };
     const float width { (ratio / 2) * _zoom };
-    const mat4 P {
-        glm::frustum(-width, width, -_zoom,  _zoom, 1.0f, 10.0f)
-    };
-    const mat4 V {
-        glm::lookAt(_position * _zoom, _center, _up)
-    };
-
-    return P * V;
+    return glm::frustum(-width, width, -_zoom,  _zoom, getNear(), getFar());
+}
+
+mat4 Camera::getView() const noexcept {
+    return glm::lookAt(_position * _zoom, _center, _up);
+}
+
+float Camera::getNear() const noexcept {
+    return 1.0f;
+}
+
+float Camera::getFar() const noexcept {
+    return 10.0f;
 }
 
 void Camera::setUp(const vec3 &up) {
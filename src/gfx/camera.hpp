@@ -31,7 +31,11 @@ class Camera {
 	float getZoom() const noexcept;
 	const vec3& getUp() const noexcept;
 
-	mat4 matrix() const noexcept;
+	mat4 matrix() const noexcept;  // projection * view
+	mat4 getProjection() const noexcept;
+	mat4 getView() const noexcept;
+	float getNear() const noexcept;
+	float getFar() const noexcept;
 
  private:
 	vec3 _position { 0.0, 0.0, 1.0 };
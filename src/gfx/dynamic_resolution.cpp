@@ -0,0 +1,229 @@
+#include "gl.hpp"
+
+#include <QOpenGLShaderProgram>
+
+#include <algorithm>  // std::clamp(), std::max()
+#include <cmath>      // std::lround(), std::sqrt()
+#include <stdexcept>
+
+#include "dynamic_resolution.hpp"
+#include "gfx.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr double Tolerance { 0.1 };  // relative deviation from the target that keeps the scale
+constexpr double Damping { 0.5 };    // part of the way to the expected scale moved per measurement
+
+inline GLsizei get_scaled(GLsizei size, float scale) noexcept {
+    return std::max(static_cast<GLsizei>(std::lround(size * scale)), GLsizei { 1 });
+}
+
+/**
+ * @brief Creates a renderbuffer with @p samples samples and attaches it to the bound framebuffer.
+ */
+GLuint create_renderbuffer(GLenum format, GLenum attachment, GLsizei samples, const ivec2 &size) noexcept {
+    GLuint renderbuffer { 0 };
+    glGenRenderbuffers(1, &renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format, size.x, size.y);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    return renderbuffer;
+}
+
+void set_texture_parameters(GLint filter) noexcept {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+}  // anonymous namespace
+
+DynamicResolution::~DynamicResolution() noexcept {
+    release();
+}
+
+void DynamicResolution::setTargetFrameTime(double time) noexcept {
+    _target = std::max(time, 0.0);
+    if (_target == 0.0) {
+        _scale = 1.0f;
+    }
+}
+
+double DynamicResolution::getTargetFrameTime() const noexcept {
+    return _target;
+}
+
+bool DynamicResolution::isEnabled() const noexcept {
+    return _target > 0.0;
+}
+
+float DynamicResolution::getScale() const noexcept {
+    return _scale;
+}
+
+void DynamicResolution::update(double frameTime) noexcept {
+    if (!isEnabled() || frameTime <= 0.0) {
+        return;
+    }
+
+    const double ratio { _target / frameTime };
+    if (ratio > 1.0 - Tolerance && ratio < 1.0 + Tolerance) {
+        return;  // close enough, avoids oscillating around the target
+    }
+    const double expected { _scale * std::sqrt(ratio) };
+    _scale = static_cast<float>(std::clamp(_scale + Damping * (expected - _scale),
+                                           static_cast<double>(MinScale), 1.0));
+}
+
+void DynamicResolution::begin() {
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &_previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, _previousViewport);
+    const ivec2 size { _previousViewport[2], _previousViewport[3] };
+
+    if (!isEnabled() || size.x <= 0 || size.y <= 0) {
+        destroy();
+        return;
+    }
+    GLint samples { 0 };  // of the previous framebuffer, e.g. the MSAA render target
+    glGetIntegerv(GL_SAMPLES, &samples);
+    if (_framebuffer == 0 || size != _size || samples != _samples) {
+        destroy();
+        create(size, samples);
+    }
+
+    _scaledSize = { get_scaled(size.x, _scale), get_scaled(size.y, _scale) };
+    glBindFramebuffer(GL_FRAMEBUFFER, _samples > 0 ? _multisampledFramebuffer : _framebuffer);
+    glViewport(0, 0, _scaledSize.x, _scaledSize.y);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void DynamicResolution::end() {
+    if (_framebuffer == 0) {
+        return;  // rendered into the previous framebuffer
+    }
+
+    if (_samples > 0) {
+        resolve();
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(_previousFramebuffer));
+    glViewport(_previousViewport[0], _previousViewport[1], _previousViewport[2], _previousViewport[3]);
+    upscale();
+}
+
+void DynamicResolution::create(const ivec2 &size, GLsizei samples) {
+    _size = size;
+    _samples = samples;
+    if (samples > 0) {
+        glGenFramebuffers(1, &_multisampledFramebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, _multisampledFramebuffer);
+        _multisampledColor = create_renderbuffer(GL_RGBA8, GL_COLOR_ATTACHMENT0, samples, size);
+        _multisampledDepth = create_renderbuffer(GL_DEPTH_COMPONENT24, GL_DEPTH_ATTACHMENT, samples, size);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(_previousFramebuffer));
+            destroy();
+            throw std::runtime_error { "could not create multisampled framebuffer for dynamic resolution" };
+        }
+    }
+
+    glGenFramebuffers(1, &_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+
+    // the upscaling filters the color bilinearly, the depth of the nearest texel is kept
+    glGenTextures(1, &_color);
+    glBindTexture(GL_TEXTURE_2D, _color);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    set_texture_parameters(GL_LINEAR);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _color, 0);
+
+    glGenTextures(1, &_depth);
+    glBindTexture(GL_TEXTURE_2D, _depth);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size.x, size.y, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+    set_texture_parameters(GL_NEAREST);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, _depth, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    const GLenum status { glCheckFramebufferStatus(GL_FRAMEBUFFER) };
+    glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(_previousFramebuffer));
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        destroy();
+        throw std::runtime_error { "could not create framebuffer for dynamic resolution" };
+    }
+}
+
+void DynamicResolution::release() noexcept {
+    destroy();
+    if (_vao != 0) {
+        glDeleteVertexArrays(1, &_vao);
+        _vao = 0;
+    }
+    _upscale.reset();
+}
+
+void DynamicResolution::destroy() noexcept {
+    if (_multisampledFramebuffer != 0) {
+        glDeleteRenderbuffers(1, &_multisampledColor);
+        glDeleteRenderbuffers(1, &_multisampledDepth);
+        glDeleteFramebuffers(1, &_multisampledFramebuffer);
+        _multisampledFramebuffer = _multisampledColor = _multisampledDepth = 0;
+    }
+    if (_framebuffer != 0) {
+        glDeleteTextures(1, &_color);
+        glDeleteTextures(1, &_depth);
+        glDeleteFramebuffers(1, &_framebuffer);
+        _framebuffer = _color = _depth = 0;
+    }
+    _size = { 0, 0 };
+    _samples = 0;
+}
+
+void DynamicResolution::resolve() {
+    // the depth of one sample is kept, as depths must not be averaged
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _multisampledFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _framebuffer);
+    glBlitFramebuffer(0, 0, _scaledSize.x, _scaledSize.y, 0, 0, _scaledSize.x, _scaledSize.y,
+                      GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+}
+
+void DynamicResolution::upscale() {
+    if (!_upscale) {
+        // the fullscreen triangle of the FXAA pass
+        _upscale = LoadProgram("./assets/shaders/fxaa.vs", "./assets/shaders/upscale.fs");
+        glGenVertexArrays(1, &_vao);
+    }
+
+    // the frame replaces the color and depth of every pixel
+    GLint depth_function { GL_LESS };
+    glGetIntegerv(GL_DEPTH_FUNC, &depth_function);
+    glDepthFunc(GL_ALWAYS);
+
+    // sharpens more the more the frame is magnified
+    const float sharpness { (1.0f - _scale) / (1.0f - MinScale) };
+    _upscale->bind();
+    _upscale->setUniformValue("frame", 0);
+    _upscale->setUniformValue("depth", 1);
+    _upscale->setUniformValue("texelSize", 1.0f / _size.x, 1.0f / _size.y);
+    _upscale->setUniformValue("scale", static_cast<float>(_scaledSize.x) / _size.x,
+                              static_cast<float>(_scaledSize.y) / _size.y);
+    _upscale->setUniformValue("sharpness", sharpness);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, _depth);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _color);
+    glBindVertexArray(_vao);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    _upscale->release();
+
+    glDepthFunc(static_cast<GLenum>(depth_function));
+}
+
+}  // namespace bgl
@@ -0,0 +1,103 @@
+/**
+ * @file dynamic_resolution.hpp
+ * @brief Rendering at a reduced resolution that adapts to a frame time target.
+ */
+#ifndef GFX_DYNAMIC_RESOLUTION_HPP_
+#define GFX_DYNAMIC_RESOLUTION_HPP_
+
+#include <memory>  // std::shared_ptr
+
+#include "gl.hpp"
+
+class QOpenGLShaderProgram;
+
+
+namespace bgl {
+
+/**
+ * @brief An offscreen framebuffer whose resolution follows the measured frame time.
+ * @details The scene is rendered into the lower left part of textures of the size of the viewport,
+ *          so that changing the scale only changes the viewport. The viewport is what the scene reads
+ *          for screen space decisions, e.g. tiles of the light binning. The frame is then upscaled into
+ *          the framebuffer that was bound before with a contrast adaptive sharpening filter, which also
+ *          writes the depth, so that the grid and other overlays can be drawn at full resolution
+ *          afterwards. If the framebuffer bound before is multisampled (MSAA), the scene is rendered
+ *          into multisampled renderbuffers with as many samples, which are resolved into the
+ *          textures by a blit before the upscaling. All methods except the controller must be called
+ *          with the OpenGL context being current.
+ */
+class DynamicResolution {
+ public:
+	static constexpr float MinScale { 0.5f };  // of the width and height
+
+	DynamicResolution() = default;
+	DynamicResolution(DynamicResolution&&) = delete;
+	DynamicResolution& operator=(DynamicResolution&&) = delete;
+
+	DynamicResolution(const DynamicResolution&) = delete;
+	DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+	virtual ~DynamicResolution() noexcept;
+
+	/**
+	 * @brief Sets the frame time [ms] to hold, 0 disables dynamic resolution.
+	 */
+	void setTargetFrameTime(double time) noexcept;
+	double getTargetFrameTime() const noexcept;
+	bool isEnabled() const noexcept;
+
+	float getScale() const noexcept;  // of the next frame
+
+	/**
+	 * @brief Adapts the scale to a measured frame time [ms].
+	 * @details The time of a frame is assumed to grow with its pixels, i.e. with the square of the scale.
+	 *          The scale moves part of the way towards the one expected to meet the target, as frame
+	 *          times are measured a few frames late, and stays within a tolerance around the target.
+	 */
+	void update(double frameTime) noexcept;
+
+	/**
+	 * @brief Binds the framebuffer and a viewport of the current scale to render the scene into.
+	 * @note Renders into the bound framebuffer directly if dynamic resolution is disabled.
+	 */
+	void begin();
+
+	/**
+	 * @brief Upscales the frame into the framebuffer and viewport that were bound by begin().
+	 */
+	void end();
+
+	/**
+	 * @brief Deletes all OpenGL objects, they are created again by the next begin().
+	 * @note Must be called before the OpenGL context is destroyed if the object outlives it.
+	 */
+	void release() noexcept;
+
+ private:
+	void create(const ivec2 &size, GLsizei samples);
+	void destroy() noexcept;
+	void resolve();
+	void upscale();
+
+	double _target { 0.0 };  // [ms], 0 if disabled
+	float _scale { 1.0f };
+	ivec2 _size { 0, 0 };  // of the textures
+	GLsizei _samples { 0 };  // of the multisampled renderbuffers, 0 without MSAA
+	ivec2 _scaledSize { 0, 0 };  // of the current frame
+
+	GLint _previousFramebuffer { 0 };
+	GLint _previousViewport[4] { 0, 0, 0, 0 };
+
+	GLuint _framebuffer { 0 };
+	GLuint _color { 0 };  // texture
+	GLuint _depth { 0 };  // texture
+	GLuint _multisampledFramebuffer { 0 };  // rendered into if _samples > 0
+	GLuint _multisampledColor { 0 };  // renderbuffer
+	GLuint _multisampledDepth { 0 };  // renderbuffer
+	GLuint _vao { 0 };    // empty, the fullscreen triangle is generated by the vertex shader
+	std::shared_ptr<QOpenGLShaderProgram> _upscale;
+};
+
+}  // namespace bgl
+
+#endif  // GFX_DYNAMIC_RESOLUTION_HPP_
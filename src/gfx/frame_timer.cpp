@@ -0,0 +1,66 @@
+#include "gl.hpp"
+
+#include <algorithm>  // std::fill()
+#include <iterator>   // std::begin(), std::end()
+
+#include "frame_timer.hpp"
+
+
+namespace bgl {
+
+FrameTimer::~FrameTimer() noexcept {
+    release();
+}
+
+void FrameTimer::begin() {
+    if (_queries[0] == 0) {
+        glGenQueries(MaxPending, _queries);
+    }
+
+    _measuring = _pending < MaxPending;
+    if (_measuring) {
+        glBeginQuery(GL_TIME_ELAPSED, _queries[(_first + _pending) % MaxPending]);
+    }
+}
+
+void FrameTimer::end() {
+    if (_measuring) {
+        glEndQuery(GL_TIME_ELAPSED);
+        ++_pending;
+        _measuring = false;
+    }
+}
+
+void FrameTimer::reset() noexcept {
+    _first = (_first + _pending) % MaxPending;
+    _pending = 0;
+}
+
+void FrameTimer::release() noexcept {
+    if (_queries[0] != 0) {
+        glDeleteQueries(MaxPending, _queries);
+        std::fill(std::begin(_queries), std::end(_queries), 0);
+    }
+    _first = _pending = 0;
+    _measuring = false;
+}
+
+std::optional<double> FrameTimer::getTime() {
+    std::optional<double> time;
+    while (_pending > 0) {
+        GLint available { GL_FALSE };
+        glGetQueryObjectiv(_queries[_first], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            break;
+        }
+
+        GLuint64 nanoseconds { 0 };
+        glGetQueryObjectui64v(_queries[_first], GL_QUERY_RESULT, &nanoseconds);
+        time = nanoseconds / 1.0e6;
+        _first = (_first + 1) % MaxPending;
+        --_pending;
+    }
+    return time;
+}
+
+}  // namespace bgl
@@ -0,0 +1,58 @@
+/**
+ * @file frame_timer.hpp
+ * @brief GPU time of rendered frames.
+ */
+#ifndef GFX_FRAME_TIMER_HPP_
+#define GFX_FRAME_TIMER_HPP_
+
+#include <optional>
+
+#include "gl.hpp"
+
+
+namespace bgl {
+
+/**
+ * @brief Measures the GPU time of frames with timer queries without stalling the pipeline.
+ * @details Query results are read once the GPU has finished the frame, usually one or two
+ *          frames later. Frames are not measured while all queries are still pending. All methods
+ *          must be called with the OpenGL context being current.
+ */
+class FrameTimer {
+ public:
+	static constexpr unsigned MaxPending { 4 };  // frames in flight
+
+	FrameTimer() = default;
+	FrameTimer(FrameTimer&&) = delete;
+	FrameTimer& operator=(FrameTimer&&) = delete;
+
+	FrameTimer(const FrameTimer&) = delete;
+	FrameTimer& operator=(const FrameTimer&) = delete;
+
+	virtual ~FrameTimer() noexcept;
+
+	void begin();
+	void end();
+	void reset() noexcept;  // discards the results of pending frames
+
+	/**
+	 * @brief Deletes the queries and discards pending frames, the queries are created again by the next begin().
+	 * @note Must be called before the OpenGL context is destroyed if the timer outlives it.
+	 */
+	void release() noexcept;
+
+	/**
+	 * @brief Returns the GPU time [ms] of a frame that finished since the last call.
+	 */
+	std::optional<double> getTime();
+
+ private:
+	GLuint _queries[MaxPending] { 0, 0, 0, 0 };
+	unsigned _first { 0 };    // oldest pending query
+	unsigned _pending { 0 };
+	bool _measuring { false };
+};
+
+}  // namespace bgl
+
+#endif  // GFX_FRAME_TIMER_HPP_
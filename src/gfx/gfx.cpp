@@ -1,7 +1,10 @@
+#include <cstdlib>  // std::getenv()
 #include <string>
 #include <sstream>
 
 #include "gfx.hpp"
+#include "gpu_culling.hpp"
+#include "program_registry.hpp"
 
 
 namespace bgl {
@@ -22,14 +25,7 @@ void set_va_attribute(GLint location, GLsizei size, GLenum type, GLsizei stride,
 }
 
 std::shared_ptr<QOpenGLShaderProgram> LoadProgram(const std::filesystem::path &vs, const std::filesystem::path &fs) {
-    const auto program { std::make_shared<QOpenGLShaderProgram>() };
-    if (!program->addShaderFromSourceFile(QOpenGLShader::Vertex, vs.string().c_str())) {
-        throw std::runtime_error { "could not add vertex shader" };
-    }
-    if (!program->addShaderFromSourceFile(QOpenGLShader::Fragment, fs.string().c_str())) {
-        throw std::runtime_error { "could not add  fragment shader" };
-    }
-    return program;
+    return ProgramRegistry::instance().get(vs, fs);
 }
 
 std::shared_ptr<QOpenGLShaderProgram> LoadProgram(const std::initializer_list<std::filesystem::path> &paths) {
@@ -49,4 +45,50 @@ std::shared_ptr<QOpenGLShaderProgram> LoadProgram(const std::initializer_list<st
     return LoadProgram(vs, fs);
 }
 
+void PrefetchPrograms() {
+    ProgramRegistry::instance().prefetch("./assets/shaders/main.vs", "./assets/shaders/main.fs");
+    ProgramRegistry::instance().prefetch("./assets/shaders/main.gs");
+    ProgramRegistry::instance().prefetch("./assets/shaders/wireframe.vs", "./assets/shaders/wireframe.fs");
+    ProgramRegistry::instance().prefetch("./assets/shaders/grid.vs", "./assets/shaders/grid.fs");
+    ProgramRegistry::instance().prefetch("./assets/shaders/cull.cs");
+    ProgramRegistry::instance().prefetch("./assets/shaders/points.vs", "./assets/shaders/points.fs");
+    ProgramRegistry::instance().prefetch("./assets/shaders/fxaa.vs", "./assets/shaders/fxaa.fs");
+    ProgramRegistry::instance().prefetch("./assets/shaders/upscale.fs");
+}
+
+std::vector<std::shared_ptr<QOpenGLShaderProgram>> PrewarmPrograms() {
+    ProgramRegistry &registry { ProgramRegistry::instance() };
+    std::vector<std::shared_ptr<QOpenGLShaderProgram>> programs {
+        registry.get("./assets/shaders/main.vs", "./assets/shaders/main.fs"),
+        registry.get("./assets/shaders/main.vs", "./assets/shaders/main.gs", "./assets/shaders/main.fs", { "WIREFRAME" }),
+        registry.get("./assets/shaders/wireframe.vs", "./assets/shaders/wireframe.fs"),
+        registry.get("./assets/shaders/grid.vs", "./assets/shaders/grid.fs"),
+        registry.get("./assets/shaders/points.vs", "./assets/shaders/points.fs"),
+        registry.get("./assets/shaders/fxaa.vs", "./assets/shaders/fxaa.fs"),
+        registry.get("./assets/shaders/fxaa.vs", "./assets/shaders/upscale.fs")
+    };
+    if (IsGPUCullingEnabled()) {  // compute shaders need OpenGL 4.3
+        programs.push_back(registry.getCompute("./assets/shaders/cull.cs"));
+    }
+    return programs;
+}
+
+std::filesystem::path GetCacheDirectory() {
+    if (const char *cache { std::getenv("XDG_CACHE_HOME") }) {
+        return std::filesystem::path { cache } / "bgl";
+    }
+    if (const char *home { std::getenv("HOME") }) {
+        return std::filesystem::path { home } / ".cache" / "bgl";
+    }
+    return {};
+}
+
+std::uint64_t Hash(const std::string &data, std::uint64_t seed) noexcept {
+    std::uint64_t value { seed };
+    for (const unsigned char c : data) {
+        value = (value ^ c) * 0x100000001b3;
+    }
+    return value;
+}
+
 }  // namespace bgl
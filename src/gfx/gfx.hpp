@@ -1,8 +1,11 @@
 #ifndef GFX_GFX_HPP_
 #define GFX_GFX_HPP_
 
+#include <cstdint>
 #include <filesystem>   // std::filesystem::path
 #include <memory>       // std::shared_ptr
+#include <string>
+#include <vector>
 
 #include "gl.hpp"
 #include "mesh.hpp"
@@ -18,6 +21,31 @@ void set_va_attribute(GLint location, GLsizei size, GLenum type, GLsizei stride,
 std::shared_ptr<QOpenGLShaderProgram> LoadProgram(const std::filesystem::path &vs, const std::filesystem::path &fs);
 std::shared_ptr<QOpenGLShaderProgram> LoadProgram(const std::initializer_list<std::filesystem::path> &shaders);
 
+/**
+ * @brief Starts reading the sources of all built-in shader programs on worker threads.
+ */
+void PrefetchPrograms();
+
+/**
+ * @brief Links all built-in shader programs, or loads their cached binaries.
+ * @details Called right after the OpenGL context is created, while models are still imported on
+ *          worker threads, so that the first frame does not wait for GLSL compilation. The
+ *          programs stay linked as long as the returned references are kept.
+ * @note Linking happens on the calling thread, as the viewer has no shared context for workers.
+ */
+std::vector<std::shared_ptr<QOpenGLShaderProgram>> PrewarmPrograms();
+
+/**
+ * @brief Returns the per-user cache directory of the viewer (e.g. ~/.cache/bgl).
+ * @note Returns an empty path if there is no such directory.
+ */
+std::filesystem::path GetCacheDirectory();
+
+/**
+ * @brief 64-bit FNV-1a hash.
+ */
+std::uint64_t Hash(const std::string &data, std::uint64_t seed = 0xcbf29ce484222325) noexcept;
+
 }  // namespace bgl
 
 #endif  // GFX_GFX_HPP_
@@ -0,0 +1,237 @@
+#include "gl.hpp"
+
+#include <QOpenGLShaderProgram>
+
+#include <algorithm>  // std::stable_sort()
+#include <cstddef>    // offsetof
+#include <cstdint>
+#include <numeric>    // std::iota()
+#include <stdexcept>
+
+#include "gpu_culling.hpp"
+#include "program_registry.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+bool Enabled { false };
+
+/**
+ * @brief A draw command and the group it is written to (std430, see cull.cs).
+ */
+struct Draw {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+    GLuint group;
+};
+
+struct MeshBounds {  // std430
+    glm::vec4 center;
+    glm::vec4 extent;  // half the size
+};
+
+constexpr GLsizeiptr CommandSize { 5 * sizeof(GLuint) };  // DrawElementsIndirectCommand
+
+GLuint create_buffer(GLenum target, GLsizeiptr size, const void *data, GLenum usage = GL_STATIC_DRAW) {
+    GLuint buffer { 0 };
+    glGenBuffers(1, &buffer);
+    glBindBuffer(target, buffer);
+    glBufferData(target, size, data, usage);
+    glBindBuffer(target, 0);
+    return buffer;
+}
+
+}  // anonymous namespace
+
+void SetGPUCulling(bool enabled) noexcept {
+    Enabled = enabled;
+}
+
+bool IsGPUCullingEnabled() noexcept {
+    return Enabled && GLEW_ARB_compute_shader && GLEW_ARB_shader_storage_buffer_object && GLEW_ARB_multi_draw_indirect;
+}
+
+GPUCulling::GPUCulling(const std::vector<Mesh> &meshes, const std::vector<Material> &materials)
+    : _drawCount { meshes.size() },
+      _compact { GLEW_ARB_indirect_parameters != GL_FALSE } {
+    // meshes with the same material are drawn by one call
+    std::vector<std::size_t> order(meshes.size());
+    std::iota(order.begin(), order.end(), 0);
+    const auto material_of = [&meshes](std::size_t i) {
+        return meshes[i]._materialIndex ? static_cast<std::int64_t>(*meshes[i]._materialIndex) : -1;
+    };
+    std::stable_sort(order.begin(), order.end(), [&material_of](std::size_t a, std::size_t b) {
+        return material_of(a) < material_of(b);
+    });
+
+    for (auto i = 0u; i < order.size(); ++i) {
+        if (i == 0 || material_of(order[i]) != material_of(order[i - 1])) {
+            const auto index { material_of(order[i]) };
+            const Material *material { index >= 0 ? &materials.at(static_cast<std::size_t>(index)) : nullptr };
+            _groups.push_back({ material, i, 0 });
+            _materials.push_back(material);
+        }
+        ++_groups.back().count;
+    }
+
+    glGenVertexArrays(1, &_vao);
+    merge(meshes, order);
+
+    _program = ProgramRegistry::instance().getCompute("./assets/shaders/cull.cs");
+}
+
+GPUCulling::~GPUCulling() noexcept {
+    glDeleteBuffers(BufferCount, _buffers);
+    glDeleteVertexArrays(1, &_vao);
+}
+
+void GPUCulling::merge(const std::vector<Mesh> &meshes, const std::vector<std::size_t> &order) {
+    GLsizeiptr vertices_size { 0 };
+    GLsizeiptr indices_size { 0 };
+    for (auto &mesh : meshes) {
+        vertices_size += static_cast<GLsizeiptr>(mesh._vertexBytes);
+        indices_size += static_cast<GLsizeiptr>(mesh._indexBytes);
+    }
+    _buffers[Vertices] = create_buffer(GL_COPY_WRITE_BUFFER, vertices_size, nullptr);
+    _buffers[Indices] = create_buffer(GL_COPY_WRITE_BUFFER, indices_size, nullptr);
+
+    std::vector<MeshBounds> bounds;
+    std::vector<Draw> draws;
+    bounds.reserve(order.size());
+    draws.reserve(order.size());
+
+    // the indices stay relative to their mesh and are offset by baseVertex instead
+    GLintptr vertex_offset { 0 };
+    GLintptr index_offset { 0 };
+    for (auto i = 0u; i < order.size(); ++i) {
+        const Mesh &mesh { meshes[order[i]] };
+        const GLsizeiptr vertex_size { static_cast<GLsizeiptr>(mesh._vertexBytes) };
+        const GLsizeiptr index_size { static_cast<GLsizeiptr>(mesh._indexBytes) };
+
+        glBindBuffer(GL_COPY_READ_BUFFER, mesh._vbo.bufferId());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _buffers[Vertices]);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, vertex_offset, vertex_size);
+        glBindBuffer(GL_COPY_READ_BUFFER, mesh._ibo.bufferId());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _buffers[Indices]);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, index_offset, index_size);
+
+        bounds.push_back({ glm::vec4 { mesh._boundingBox.getCenter(), 1.0f },
+                           glm::vec4 { mesh._boundingBox.getSize() / 2.0f, 0.0f } });
+        draws.push_back({ static_cast<GLuint>(index_size / sizeof(GLuint)), 1,
+                          static_cast<GLuint>(index_offset / sizeof(GLuint)),
+                          static_cast<GLint>(vertex_offset / sizeof(Vertex)), 0, 0 });
+        vertex_offset += vertex_size;
+        index_offset += index_size;
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    std::vector<GLuint> group_offsets;
+    for (auto g = 0u; g < _groups.size(); ++g) {
+        group_offsets.push_back(_groups[g].first);
+        for (auto i = _groups[g].first; i < _groups[g].first + _groups[g].count; ++i) {
+            draws[i].group = g;
+        }
+    }
+
+    const auto sizeof_vector = [](const auto &v) {
+        return static_cast<GLsizeiptr>(v.size() * sizeof(v[0]));
+    };
+    _buffers[Bounds] = create_buffer(GL_SHADER_STORAGE_BUFFER, sizeof_vector(bounds), bounds.data());
+    _buffers[Draws] = create_buffer(GL_SHADER_STORAGE_BUFFER, sizeof_vector(draws), draws.data());
+    _buffers[Groups] = create_buffer(GL_SHADER_STORAGE_BUFFER, sizeof_vector(group_offsets), group_offsets.data());
+    _buffers[Commands] = create_buffer(GL_SHADER_STORAGE_BUFFER, CommandSize * static_cast<GLsizeiptr>(draws.size()),
+                                       nullptr, GL_DYNAMIC_DRAW);
+    _buffers[Counts] = create_buffer(GL_SHADER_STORAGE_BUFFER, sizeof_vector(group_offsets), nullptr, GL_DYNAMIC_DRAW);
+
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, _buffers[Vertices]);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, position)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, normal)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, texcoords)));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffers[Indices]);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (glGetError() != GL_NO_ERROR) {
+        throw std::runtime_error { "could not create GPU culling buffers" };
+    }
+}
+
+void GPUCulling::cull(const mat4 &MVP) {
+    if (_drawCount == 0) {
+        return;
+    }
+
+    if (_compact) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, _buffers[Counts]);
+        glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    glm::vec4 planes[6];
+    GetFrustumPlanes(MVP, planes);
+
+    _program->bind();
+    const GLuint program { _program->programId() };
+    glUniform4fv(glGetUniformLocation(program, "planes"), 6, &planes[0].x);
+    glUniform1ui(glGetUniformLocation(program, "drawCount"), static_cast<GLuint>(_drawCount));
+    glUniform1i(glGetUniformLocation(program, "isCompact"), _compact);
+
+    const Buffer bindings[] { Bounds, Draws, Groups, Commands, Counts };
+    for (auto i = 0u; i < 5; ++i) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, _buffers[bindings[i]]);
+    }
+    glDispatchCompute(static_cast<GLuint>((_drawCount + WorkGroupSize - 1) / WorkGroupSize), 1, 1);
+    glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+    _program->release();
+}
+
+void GPUCulling::render(const SetupMaterial &setup) {
+    if (_drawCount == 0) {
+        return;
+    }
+
+    glBindVertexArray(_vao);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _buffers[Commands]);
+    if (_compact) {
+        glBindBuffer(GL_PARAMETER_BUFFER_ARB, _buffers[Counts]);
+    }
+
+    for (auto g = 0u; g < _groups.size(); ++g) {
+        const Group &group { _groups[g] };
+        setup(group.material);
+
+        const auto *commands { reinterpret_cast<const void*>(group.first * CommandSize) };
+        if (_compact) {
+            glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, GL_UNSIGNED_INT, commands,
+                                                static_cast<GLintptr>(g * sizeof(GLuint)), group.count, 0);
+        } else {
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, commands, group.count, 0);
+        }
+    }
+
+    if (_compact) {
+        glBindBuffer(GL_PARAMETER_BUFFER_ARB, 0);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+std::size_t GPUCulling::getDrawCount() const noexcept {
+    return _drawCount;
+}
+
+const std::vector<const Material*>& GPUCulling::getMaterials() const noexcept {
+    return _materials;
+}
+
+}  // namespace bgl
@@ -0,0 +1,89 @@
+/**
+ * @file gpu_culling.hpp
+ * @brief Frustum culling and indirect draw generation on the GPU.
+ */
+#ifndef GFX_GPU_CULLING_HPP_
+#define GFX_GPU_CULLING_HPP_
+
+#include <cstddef>     // std::size_t
+#include <functional>  // std::function
+#include <memory>      // std::shared_ptr
+#include <vector>
+
+#include "gl.hpp"
+#include "material.hpp"
+#include "mesh.hpp"
+
+class QOpenGLShaderProgram;
+
+
+namespace bgl {
+
+void SetGPUCulling(bool enabled) noexcept;
+bool IsGPUCullingEnabled() noexcept;  // only true if enabled and supported by the driver
+
+/**
+ * @brief Draws the meshes of a model with a constant number of OpenGL calls.
+ * @details The meshes are copied into one vertex and one index buffer and sorted by material.
+ *          Their bounds and draw commands live in shader storage buffers. Every frame a compute
+ *          shader culls the meshes against the view frustum and writes the commands of the
+ *          visible ones, compacted per material, into an indirect buffer. It is drawn with one
+ *          glMultiDrawElementsIndirectCount() per material, which reads the number of commands
+ *          from the GPU as well. Without GL_ARB_indirect_parameters, culled commands are kept
+ *          with zero instances and drawn by glMultiDrawElementsIndirect() instead.
+ * @note The meshes must use the Vertex format and 32-bit indices.
+ */
+class GPUCulling {
+ public:
+	static constexpr unsigned WorkGroupSize { 64 };  // see cull.cs
+
+	using SetupMaterial = std::function<void(const Material *material)>;  // nullptr if none
+
+	GPUCulling(const std::vector<Mesh> &meshes, const std::vector<Material> &materials);
+	GPUCulling(GPUCulling&&) = delete;
+	GPUCulling& operator=(GPUCulling&&) = delete;
+
+	GPUCulling(const GPUCulling&) = delete;
+	GPUCulling& operator=(const GPUCulling&) = delete;
+
+	virtual ~GPUCulling() noexcept;
+
+	/**
+	 * @brief Writes the draw commands of the meshes within the view frustum of @p MVP.
+	 * @note Binds the culling program, so call it before binding the program to draw with.
+	 */
+	void cull(const mat4 &MVP);
+
+	/**
+	 * @brief Draws the commands written by the last cull().
+	 * @param setup is called before the meshes of each material are drawn
+	 */
+	void render(const SetupMaterial &setup);
+
+	std::size_t getDrawCount() const noexcept;
+	const std::vector<const Material*>& getMaterials() const noexcept;  // nullptr if none
+
+ private:
+	struct Group {  // meshes with the same material
+		const Material *material;
+		GLuint first;  // command
+		GLuint count;
+	};
+
+	void merge(const std::vector<Mesh> &meshes, const std::vector<std::size_t> &order);
+
+	enum Buffer { Vertices, Indices, Bounds, Draws, Groups, Commands, Counts, BufferCount };
+
+	std::vector<Group> _groups;
+	std::vector<const Material*> _materials;  // of the groups
+	std::size_t _drawCount { 0 };
+	bool _compact { false };  // GL_ARB_indirect_parameters
+
+	GLuint _buffers[BufferCount] {};
+	GLuint _vao { 0 };
+	std::shared_ptr<QOpenGLShaderProgram> _program;  // culls
+};
+
+}  // namespace bgl
+
+#endif  // GFX_GPU_CULLING_HPP_
@@ -2,77 +2,38 @@
 #include "gfx.hpp"
 
 #include <QMatrix4x4>
+#include <QVector3D>
+
+#include <stdexcept>
 
 
 namespace bgl {
 
-enum locations { MVP = 0 , color, position };
+namespace {
 
-Grid::Grid(GLfloat size, std::size_t num_cells)
-    : _cell_size { size },
-      _num_cells { num_cells } {
+constexpr float FadeDistance { 8.0f };  // the grid is invisible beyond
 
-    _meshes = std::vector<Mesh>(1);
-    _program = LoadProgram("./assets/shaders/wireframe.vs", "./assets/shaders/wireframe.fs");
-    create_vbo();
-    create_ibo();
-    create_vao();
+/**
+ * @brief Returns the position of the camera.
+ * @details The camera is the only point that every projection maps to w = 0.
+ */
+vec3 get_eye(const mat4 &inverse_PV) {
+    const glm::vec4 eye { inverse_PV * glm::vec4 { 0.0f, 0.0f, 1.0f, 0.0f } };
+    return vec3 { eye } / eye.w;
 }
 
-void Grid::create_vbo() {
-    auto get_index = [&](unsigned x, unsigned z) { return (_num_cells * z) + x; };
-
-    const float size = _num_cells * _cell_size;
-    const vec3 T { size / 2.0f, 0.0f, size / 2.0f };
-
-    _meshes[0]._vbo.bind();
-    _meshes[0]._vbo.allocate(sizeof(vec3) * _num_cells * _num_cells);
-
-    vec3 *buffer = reinterpret_cast<vec3*>(_meshes[0]._vbo.map(QOpenGLBuffer::WriteOnly));
-    if (buffer == 0) {
-        throw std::runtime_error { "!!!" };
-    }
-
-    for (auto z = 0u; z < _num_cells; ++z) {
-        for (auto x = 0u; x < _num_cells; ++x) {
-            buffer[get_index(x, z)] = vec3 { x * _cell_size, 0.0, z * _cell_size } - T;
-        }
-    }
-    _meshes[0]._vbo.unmap();
+inline QMatrix4x4 to_qt(const mat4 &matrix) {
+    return QMatrix4x4 { glm::value_ptr(matrix) }.transposed();
 }
 
-void Grid::create_ibo() {
-    auto get_index = [&](unsigned x, unsigned z) { return (_num_cells * z) + x; };
+}  // anonymous namespace
 
-    const size_t num_triangles { 2 * _num_cells * _num_cells + 4 };
-    _meshes[0]._ibo.bind();
-    _meshes[0]._ibo.allocate(num_triangles * 3 * sizeof(GLuint) /* vertices */);
-
-    using uvec2 = glm::tvec2<GLuint>;
-    uvec2 *buffer { reinterpret_cast<uvec2*>(_meshes[0]._ibo.map(QOpenGLBuffer::WriteOnly)) };
-    if (buffer == nullptr) {
-        throw std::runtime_error { "could not create QOpenGLBuffer" };
+Grid::Grid(GLfloat size)
+    : _cell_size { size } {
+    _program = LoadProgram("./assets/shaders/grid.vs", "./assets/shaders/grid.fs");
+    if (!_vao.create()) {
+        throw std::runtime_error { "could not create VAO" };
     }
-
-    for (auto z = 0u; z < _num_cells - 1; ++z) {
-        for (auto x = 0u; x < _num_cells - 1; ++x) {
-            *buffer++ = uvec2 { get_index(0, z), get_index(_num_cells - 1, z) };  // vertical line
-            *buffer++ = uvec2 { get_index(x, 0), get_index(x, _num_cells - 1) };  // horizontal line
-        }
-
-        *buffer++ = uvec2 { get_index(_num_cells - 1, 0), get_index(_num_cells - 1, _num_cells - 1) };
-        *buffer++ = uvec2 { get_index(0, _num_cells - 1), get_index(_num_cells - 1, _num_cells - 1) };
-    }
-    _meshes[0]._ibo.unmap();
-}
-
-void Grid::create_vao() {
-    _meshes[0]._vao.bind();
-    _meshes[0]._vbo.bind();
-    _meshes[0]._ibo.bind();
-
-    _program->bind();
-    set_va_attribute(_program->attributeLocation("position"), 3, GL_FLOAT, 0, 0);
 }
 
 void Grid::translate(const vec3 &v) {
@@ -80,19 +41,32 @@ void Grid::translate(const vec3 &v) {
 }
 
 void Grid::render(const mat4 &PV) {
-    glEnable(GL_LINE_SMOOTH);
-    glDisable(GL_CULL_FACE);
-    glLineWidth(3);
-    // TODO(bkuolt): adjust OpenGL line rendering settings
+    const GLboolean cull_face { glIsEnabled(GL_CULL_FACE) };
+    glDisable(GL_CULL_FACE);  // the plane is visible from below
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    constexpr vec3 white { 1.0f, 1.0f, 1.0f };
-    QMatrix4x4 matrix(glm::value_ptr(PV * glm::translate(_translation)));
+    const mat4 inverse_PV { glm::inverse(PV) };
+    const vec3 eye { get_eye(inverse_PV) };
 
     _program->bind();
-    _program->setUniformValue(_program->attributeLocation("MVP"), matrix.transposed());
-    _program->setUniformValue(_program->attributeLocation("color"), white.x, white.y, white.z);
-    _meshes[0].render(GL_LINES);
+    _program->setUniformValue("PV", to_qt(PV));
+    _program->setUniformValue("inversePV", to_qt(inverse_PV));
+    _program->setUniformValue("eye", QVector3D(eye.x, eye.y, eye.z));
+    _program->setUniformValue("origin", QVector3D(_translation.x, _translation.y, _translation.z));
+    _program->setUniformValue("cellSize", _cell_size);
+    _program->setUniformValue("fadeDistance", FadeDistance);
+    _program->setUniformValue("color", 1.0f, 1.0f, 1.0f);
+
+    _vao.bind();
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    _vao.release();
     _program->release();
+
+    glDisable(GL_BLEND);
+    if (cull_face) {
+        glEnable(GL_CULL_FACE);
+    }
 }
 
 }  // namespace bgl
@@ -3,23 +3,28 @@
 
 #include "model.hpp"
 
+#include <QOpenGLVertexArrayObject>  // NOLINT
+
 
 namespace bgl {
 
+/**
+ * @brief An infinite ground plane grid.
+ * @details The grid has no vertex data: a fullscreen triangle is intersected with the plane and
+ *          the lines are computed per pixel. Lines are anti-aliased by their screen space
+ *          derivatives, cells are subdivided by ten as the camera gets closer and the grid fades
+ *          out with the distance, so its cost does not depend on its extent.
+ */
 class Grid final : public Model {
  public:
-    explicit Grid(GLfloat size, std::size_t num_cells);
-    void render(const mat4 &MVP) override;
+    explicit Grid(GLfloat size);
+    void render(const mat4 &PV) override;
     void translate(const vec3 &v);
 
  private:
-    void create_vbo();
-    void create_ibo();
-    void create_vao();
-
-    const GLfloat _cell_size;
-    const std::size_t _num_cells;
+    const GLfloat _cell_size;  // of the finest cells
     vec3 _translation;
+    QOpenGLVertexArrayObject _vao;  // empty, but required by the core profile
 };
 
 }  // namespace bgl
@@ -1,22 +1,38 @@
 
+
 #include <assimp/cimport.h>      // aiPropertyStore
 #include <assimp/postprocess.h>  // Post processing flags
 #include <assimp/material.h>
 #include <assimp/scene.h>
 
 #include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>  // INFINITY
+#include <iomanip>  // std::quoted
 #include <iostream>
 #include <list>
+#include <map>
+#include <memory_resource>  // std::pmr::monotonic_buffer_resource
 #include <string>
 
 #include <assimp/Importer.hpp>
 
 #include "model.hpp"
+#include "allocation.hpp"
 #include "box.hpp"
 #include "importer.hpp"  //  TODO
+#include "mesh_codec.hpp"
+#include "model_cache.hpp"
+#include "occlusion.hpp"
+#include "parallel.hpp"  // bgl::get_thread_count()
 #include "gfx.hpp"       //  TODO
+#include "instancing.hpp"
+#include "resource_manager.hpp"
+#include "startup.hpp"
+#include "tangent_space.hpp"
+#include "vertex_weld.hpp"
 
-#include <QImage>
 #include <QMatrix4x4>
 #include <QOpenGLShaderProgram>
 #include <QOpenGLTexture>
@@ -26,6 +42,8 @@ namespace bgl {
 
 namespace {
 
+using TextureMap = std::pmr::map<std::filesystem::path, TextureData>;  // by path
+
 inline bool is_textured(const aiMesh &mesh) noexcept {
     return mesh.mTextureCoords[0] != nullptr;
 }
@@ -34,64 +52,58 @@ inline bool has_material(const aiMesh &mesh) noexcept {
     return mesh.mMaterialIndex != 0;
 }
 
+/**
+ * @brief Returns whether a mesh needs tangents, i.e. its material has a normal or bump map.
+ */
+bool has_normal_map(const aiScene &scene, const aiMesh &mesh) noexcept {
+    if (!is_textured(mesh) || mesh.mMaterialIndex >= scene.mNumMaterials) {
+        return false;
+    }
+    const aiMaterial &material { *scene.mMaterials[mesh.mMaterialIndex] };
+    return material.GetTextureCount(aiTextureType_NORMALS) > 0 || material.GetTextureCount(aiTextureType_HEIGHT) > 0;
+}
+
+// vertices are joined by WeldVertices(), which is much faster than aiProcess_JoinIdenticalVertices
+constexpr unsigned int ImportFlags { aiProcess_Triangulate | aiProcess_PreTransformVertices };
+constexpr GLuint TangentLocation { 3 };  // as declared in main.vs
+constexpr GLuint InstanceLocation { 4 };  // of the first column of the model matrix in main.vs
+
 /*********************************************************
  *                     OpenGL Code                       *
  *********************************************************/
-QOpenGLBuffer create_vbo(QOpenGLBuffer &vbo, const aiMesh &mesh) {
+void create_vbo(QOpenGLBuffer &vbo, const std::vector<Vertex> &vertices) {
     vbo.bind();
-    vbo.allocate(sizeof(Vertex) * mesh.mNumVertices);
-    auto buffer { reinterpret_cast<Vertex*>(vbo.map(QOpenGLBuffer::ReadWrite)) };
-    if (buffer == nullptr) {
-        vbo.release();
-        throw std::runtime_error{"could not map VBO"};
-    }
-
-    for (auto i = 0u; i < mesh.mNumVertices; ++i) {
-        buffer[i].normal = vec3{mesh.mNormals[i].x, mesh.mNormals[i].y, mesh.mNormals[i].z};
-        buffer[i].position = vec3{mesh.mVertices[i].x, mesh.mVertices[i].y, mesh.mVertices[i].z};
-    }
-
-    if (is_textured(mesh)) {
-        if (mesh.mNumUVComponents[0] != 2) {
-            vbo.unmap();
-            vbo.release();
-            throw std::runtime_error{"only one texture channel supported"};
-        }
-        for (unsigned int i = 0; i < mesh.mNumVertices; ++i) {
-            buffer[i].texcoords = vec2{mesh.mTextureCoords[0][i].x, 1.0 - mesh.mTextureCoords[0][i].y};
-        }
-    }
-
-    if (!vbo.unmap()) {
-        vbo.release();
-        throw std::runtime_error{"could not unmap VBO"};
-    }
+    vbo.allocate(vertices.data(), static_cast<int>(vertices.size() * sizeof(Vertex)));
     vbo.release();
-    return vbo;
 }
 
-void create_ibo(QOpenGLBuffer &ibo, const aiMesh &mesh) {
-    ibo.bind();
-    ibo.allocate(sizeof(GLuint) * mesh.mNumFaces * 3);
-    GLuint *buffer {reinterpret_cast<GLuint*>(ibo.map(QOpenGLBuffer::WriteOnly))};
-    if (buffer == nullptr) {
-        throw std::runtime_error{"could not map IBO"};
+void create_tangents(QOpenGLBuffer &tangents, const std::vector<glm::vec4> &data) {
+    if (!tangents.create()) {
+        throw std::runtime_error { "could not create tangent buffer" };
     }
+    tangents.bind();
+    tangents.allocate(data.data(), static_cast<int>(data.size() * sizeof(glm::vec4)));
+    tangents.release();
+}
 
-    for (auto i = 0u; i < mesh.mNumFaces; ++i) {
-        assert(mesh.mFaces[i].mNumIndices == 3);
-        std::copy_n(mesh.mFaces[i].mIndices, 3, buffer);
-        buffer += 3;
+void create_instances(QOpenGLBuffer &instances, const std::vector<mat4> &matrices) {
+    if (!instances.create()) {
+        throw std::runtime_error { "could not create instance buffer" };
     }
+    instances.bind();
+    instances.allocate(matrices.data(), static_cast<int>(matrices.size() * sizeof(mat4)));
+    instances.release();
+}
 
-    if (!ibo.unmap()) {
-        throw std::runtime_error{"could not unmap IBO"};
-    }
+void create_ibo(QOpenGLBuffer &ibo, const std::vector<GLuint> &indices) {
+    ibo.bind();
+    ibo.allocate(indices.data(), static_cast<int>(indices.size() * sizeof(GLuint)));
     ibo.release();
 }
 
 // program must be bound!!!!
-void create_vao(QOpenGLVertexArrayObject &vao, QOpenGLBuffer &vbo, QOpenGLShaderProgram &program) {
+void create_vao(QOpenGLVertexArrayObject &vao, QOpenGLBuffer &vbo, QOpenGLBuffer &tangents,
+                QOpenGLBuffer &instances, QOpenGLShaderProgram &program) {
     program.bind();
     vao.bind();
     vbo.bind();
@@ -99,15 +111,40 @@ void create_vao(QOpenGLVertexArrayObject &vao, QOpenGLBuffer &vbo, QOpenGLShader
     set_va_attribute(program.attributeLocation("position"), 3, GL_FLOAT, stride, offsetof(Vertex, position));
     set_va_attribute(program.attributeLocation("normal"), 3, GL_FLOAT, stride, offsetof(Vertex, normal));
     set_va_attribute(program.attributeLocation("texcoords"), 2, GL_FLOAT, stride, offsetof(Vertex, texcoords));
-    vao.release();
     vbo.release();
+    if (tangents.isCreated()) {  // a separate stream, so meshes without normal maps do not pay for it
+        tangents.bind();
+        set_va_attribute(TangentLocation, 4, GL_FLOAT, sizeof(glm::vec4), 0);
+        tangents.release();
+    }
+    if (instances.isCreated()) {
+        instances.bind();
+        for (auto column = 0u; column < 4; ++column) {  // a mat4 attribute takes a location per column
+            set_va_attribute(InstanceLocation + column, 4, GL_FLOAT, sizeof(mat4), column * sizeof(glm::vec4));
+            glVertexAttribDivisor(InstanceLocation + column, 1);
+        }
+        instances.release();
+    }
+    vao.release();
     program.release();
 }
 
 /*********************************************************
  *                     Assimp Mesh Code                  *
  *********************************************************/
-const aiScene *importScene(const std::filesystem::path &path) {
+struct SceneDeleter {
+    void operator()(const aiScene *scene) const noexcept {
+        aiReleaseImport(scene);
+    }
+};
+
+using ScenePointer = std::unique_ptr<aiScene, SceneDeleter>;  // not const, so meshes can be released early
+
+/**
+ * @param flags Assimp's post processing steps, existing normals and tangents are removed
+ *              if they include aiProcess_RemoveComponent
+ */
+ScenePointer importScene(const std::filesystem::path &path, unsigned int flags = ImportFlags) {
     if (!std::filesystem::exists(path)) {
         std::ostringstream oss;
         oss << "the file " << std::quoted(path.string()) << " does not exist";
@@ -120,36 +157,147 @@ const aiScene *importScene(const std::filesystem::path &path) {
     }
 
     aiSetImportPropertyInteger(props, AI_CONFIG_PP_PTV_NORMALIZE, 1);
-    const aiScene *scene{aiImportFileExWithProperties(path.string().c_str(),
-                                                      aiProcess_Triangulate |
-                                                      aiProcess_GenSmoothNormals |
-                                                      aiProcess_Triangulate |
-                                                      aiProcess_JoinIdenticalVertices | aiProcess_PreTransformVertices,
-                                                      nullptr, props)};
+    aiSetImportPropertyInteger(props, AI_CONFIG_PP_RVC_FLAGS, aiComponent_NORMALS | aiComponent_TANGENTS_AND_BITANGENTS);
+    aiSetImportPropertyFloat(props, AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, GetCreaseAngle());
+    const aiScene *scene{aiImportFileExWithProperties(path.string().c_str(), flags, nullptr, props)};
 
     aiReleasePropertyStore(props);
-    return scene ? scene
+    return scene ? ScenePointer { const_cast<aiScene*>(scene) }
                     : throw std::runtime_error{aiGetErrorString()};
 }
 
-void load_meshes(Model& model, const aiScene &scene, QOpenGLShaderProgram &program) {
+/**
+ * @brief Copies the vertices and triangles of an Assimp mesh.
+ */
+MeshData copy_mesh(const aiMesh &mesh) {
+    MeshData data;
+    data.vertices.resize(mesh.mNumVertices);
+    for (auto i = 0u; i < mesh.mNumVertices; ++i) {
+        data.vertices[i].position = vec3{mesh.mVertices[i].x, mesh.mVertices[i].y, mesh.mVertices[i].z};
+    }
+    if (mesh.mNormals != nullptr) {
+        for (auto i = 0u; i < mesh.mNumVertices; ++i) {
+            data.vertices[i].normal = vec3{mesh.mNormals[i].x, mesh.mNormals[i].y, mesh.mNormals[i].z};
+        }
+    }
+
+    if (is_textured(mesh)) {
+        if (mesh.mNumUVComponents[0] != 2) {
+            throw std::runtime_error{"only one texture channel supported"};
+        }
+        for (unsigned int i = 0; i < mesh.mNumVertices; ++i) {
+            data.vertices[i].texcoords = vec2{mesh.mTextureCoords[0][i].x, 1.0f - mesh.mTextureCoords[0][i].y};
+        }
+    }
+
+    data.indices.resize(std::size_t { mesh.mNumFaces } * 3);
+    for (auto i = 0u; i < mesh.mNumFaces; ++i) {
+        assert(mesh.mFaces[i].mNumIndices == 3);
+        std::copy_n(mesh.mFaces[i].mIndices, 3, &data.indices[std::size_t { i } * 3]);
+    }
+
+    if (has_material(mesh)) {
+        data.materialIndex = mesh.mMaterialIndex;
+    }
+    return data;
+}
+
+/**
+ * @param tangents whether tangents are generated for a normal map
+ */
+MeshData convert_mesh(const aiMesh &mesh, bool tangents, std::pmr::memory_resource *memory) {
+    MeshData data { copy_mesh(mesh) };
+    WeldVertices(data.vertices, data.indices, GetWeldEpsilon(), memory);
+    if (mesh.mNormals == nullptr) {
+        GenerateNormals(data.vertices, data.indices, GetCreaseAngle(), memory);
+    }
+
+    vec3 min { INFINITY };
+    vec3 max { -INFINITY };
+    for (auto &vertex : data.vertices) {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+    data.boundingBox = BoundingBox { (min + max) / 2.0f, max - min };
+
+    // also makes the indices compress well in the model cache
+    OptimizeVertexCache(data.indices, data.vertices.size(), memory);
+    OptimizeVertexFetch(data.indices, data.vertices, memory);
+    if (tangents) {
+        data.tangents = GenerateTangents(data.vertices, data.indices, memory);  // rarely appends vertices
+    }
+    return data;
+}
+
+/**
+ * @brief Converts all meshes of a scene, releasing each Assimp mesh as soon as it is converted,
+ *        so that a model is never held twice in memory.
+ */
+std::vector<MeshData> convert_meshes(aiScene &scene) {
     if (scene.mNumMeshes == 0) {
         throw std::runtime_error{"empty model"};
     }
 
-    std::vector<Mesh> &meshes { model.getMeshes() };
-    meshes = std::vector<Mesh>(scene.mNumMeshes);
+    std::cout << "loading " << scene.mNumMeshes << " meshes" << std::endl;
+    std::vector<MeshData> meshes;
+    meshes.reserve(scene.mNumMeshes);
+    for (auto i = 0u; i < scene.mNumMeshes; ++i) {
+        // the optimizers' temporary data of large meshes is freed at once after each mesh
+        std::pmr::monotonic_buffer_resource arena;
+        meshes.push_back(convert_mesh(*scene.mMeshes[i], has_normal_map(scene, *scene.mMeshes[i]), &arena));
+        delete scene.mMeshes[i];  // the scene's destructor skips null meshes
+        scene.mMeshes[i] = nullptr;
+    }
+    return meshes;
+}
+
+/**
+ * @note The instances of a mesh are baked into one occluder, so its CPU copy grows with their number.
+ */
+std::shared_ptr<const OccluderGeometry> create_occluder(const MeshData &data) {
+    const std::size_t instance_count { std::max<std::size_t>(data.instances.size(), 1) };
+    if (data.indices.size() / 3 * instance_count > OcclusionCuller::MaxOccluderTriangles) {
+        return {};
+    }
+    const auto occluder { std::make_shared<OccluderGeometry>() };
+    occluder->positions.reserve(data.vertices.size() * instance_count);
+    occluder->indices.reserve(data.indices.size() * instance_count);
+    for (auto instance = 0u; instance < instance_count; ++instance) {
+        const auto offset { static_cast<GLuint>(occluder->positions.size()) };
+        for (auto &vertex : data.vertices) {
+            occluder->positions.push_back(data.instances.empty()
+                ? vertex.position
+                : vec3 { data.instances[instance] * glm::vec4 { vertex.position, 1.0f } });
+        }
+        for (const GLuint index : data.indices) {
+            occluder->indices.push_back(offset + index);
+        }
+    }
+    return occluder;
+}
 
-    std::cout << "loading " << meshes.size() << " meshes" << std::endl;
+void create_meshes(Model &model, const std::vector<MeshData> &data, QOpenGLShaderProgram &program) {
+    std::vector<Mesh> &meshes { model.getMeshes() };
+    meshes = std::vector<Mesh>(data.size());
 
     for (auto i = 0u; i < meshes.size(); ++i) {
-        const aiMesh &ai_mesh{*scene.mMeshes[i]};
-        create_vbo(meshes[i]._vbo, ai_mesh);
-        create_ibo(meshes[i]._ibo, ai_mesh);
-        create_vao(meshes[i]._vao, meshes[i]._vbo, program);
-
-        if (has_material(ai_mesh)) {
-            meshes[i]._materialIndex = ai_mesh.mMaterialIndex;
+        create_vbo(meshes[i]._vbo, data[i].vertices);
+        create_ibo(meshes[i]._ibo, data[i].indices);
+        meshes[i]._vertexBytes = data[i].vertices.size() * sizeof(Vertex);
+        meshes[i]._indexBytes = data[i].indices.size() * sizeof(GLuint);
+        if (!data[i].tangents.empty()) {
+            create_tangents(meshes[i]._tangents, data[i].tangents);
+        }
+        if (!data[i].instances.empty()) {
+            create_instances(meshes[i]._instances, data[i].instances);
+            meshes[i]._instanceCount = static_cast<GLsizei>(data[i].instances.size());
+        }
+        create_vao(meshes[i]._vao, meshes[i]._vbo, meshes[i]._tangents, meshes[i]._instances, program);
+        meshes[i]._materialIndex = data[i].materialIndex;
+        meshes[i]._boundingBox = data[i].boundingBox;
+        meshes[i]._meshlets = data[i].meshlets;
+        if (IsOcclusionCullingEnabled()) {  // otherwise the CPU copy would never be used
+            meshes[i]._occluder = create_occluder(data[i]);
         }
     }
 }
@@ -207,20 +355,35 @@ const std::filesystem::path get_path(const aiMaterial &material, aiTextureType t
 	return { (base_path / str.data).string() };
 }
 
-std::shared_ptr<QOpenGLTexture> get_texture(const aiMaterial &material, aiTextureType type,
-	                                        const std::filesystem::path &base_path) {
+/**
+ * @brief Imports a texture, every file is only imported once per model.
+ */
+TextureData import_texture(const std::filesystem::path &path,
+                           TextureMap &textures) {
+    auto iterator { textures.find(path) };
+    if (iterator == textures.end()) {
+        std::cout << "loading " << path << std::endl;
+        iterator = textures.emplace(path, ImportTexture(path)).first;
+    }
+    return iterator->second;
+}
+
+TextureData get_texture(const aiMaterial &material, aiTextureType type,
+                        const std::filesystem::path &base_path,
+                        TextureMap &textures) {
     const unsigned int texture_count{material.GetTextureCount(type)};
-    if (texture_count >= 1) {
-        auto texture { LoadTexture(get_path(material, type, base_path)) };
-        if (texture_count > 1) {
-            std::cout << "warning: found more textures than expected" << std::endl;
-        }
-        return texture;
+    if (texture_count == 0) {
+        return {};
+    }
+    if (texture_count > 1) {
+        std::cout << "warning: found more textures than expected" << std::endl;
     }
-    return {};
+
+    return import_texture(get_path(material, type, base_path), textures);
 }
 
-Material load_material(const aiMaterial &material, const std::filesystem::path &base_path) {
+MaterialData load_material(const aiMaterial &material, const std::filesystem::path &base_path,
+                           TextureMap &textures) {
     return {
         .diffuse = get_color(material, AI_MATKEY_COLOR_DIFFUSE),
         .ambient = get_color(material, AI_MATKEY_COLOR_AMBIENT),
@@ -228,38 +391,190 @@ Material load_material(const aiMaterial &material, const std::filesystem::path &
         .emissive = get_color(material, AI_MATKEY_COLOR_EMISSIVE),
         .shininess = get_shininess(material),
         .textures{
-            .diffuse = get_texture(material, aiTextureType_DIFFUSE, base_path),
-            .ambient = get_texture(material, aiTextureType_AMBIENT, base_path),
-            .specular = get_texture(material, aiTextureType_SPECULAR, base_path),
-            .emissive = get_texture(material, aiTextureType_EMISSIVE, base_path)} };
+            .diffuse = get_texture(material, aiTextureType_DIFFUSE, base_path, textures),
+            .ambient = get_texture(material, aiTextureType_AMBIENT, base_path, textures),
+            .specular = get_texture(material, aiTextureType_SPECULAR, base_path, textures),
+            .emissive = get_texture(material, aiTextureType_EMISSIVE, base_path, textures)} };
 }
 
-std::vector<Material> load_materials(const aiScene &scene, const std::filesystem::path &base_path) {
+std::vector<MaterialData> load_materials(const aiScene &scene, const std::filesystem::path &base_path,
+                                         std::pmr::memory_resource *memory) {
     std::cout << "loading " << scene.mNumMaterials << " materials" << std::endl;
-    std::vector<Material> materials;
+    TextureMap textures { memory };
+    std::vector<MaterialData> materials;
     for (auto i = 0u; i < scene.mNumMaterials; ++i) {
-        materials.push_back(load_material(*scene.mMaterials[i], base_path));
+        materials.push_back(load_material(*scene.mMaterials[i], base_path, textures));
     }
     return materials;
 }
 
+/**
+ * @brief Imports the textures of materials read from the model cache, which only stores their paths.
+ */
+void import_textures(std::vector<MaterialData> &materials, std::pmr::memory_resource *memory) {
+    TextureMap textures { memory };
+    for (auto &material : materials) {
+        for (TextureData *texture : { &material.textures.diffuse, &material.textures.ambient,
+                                      &material.textures.specular, &material.textures.emissive }) {
+            if (!texture->path.empty()) {
+                *texture = import_texture(texture->path, textures);
+            }
+        }
+    }
+}
+
+std::shared_ptr<QOpenGLTexture> create_texture(const TextureData &texture) {
+    if (texture.path.empty()) {
+        return {};
+    }
+    return ResourceManager::instance().loadTexture(texture);
+}
+
+Material create_material(const MaterialData &material) {
+    return {
+        .diffuse = material.diffuse,
+        .ambient = material.ambient,
+        .specular = material.specular,
+        .emissive = material.emissive,
+        .shininess = material.shininess,
+        .textures{
+            .diffuse = create_texture(material.textures.diffuse),
+            .ambient = create_texture(material.textures.ambient),
+            .specular = create_texture(material.textures.specular),
+            .emissive = create_texture(material.textures.emissive)} };
+}
+
+/**
+ * @brief Marks the end of an import stage as a startup phase and prints its allocations if
+ *        allocation tracking is enabled.
+ */
+void finish_stage(const std::string &name, AllocationScope &allocations) {
+    MarkStartupPhase(name);
+    if (IsAllocationTrackingEnabled()) {
+        const AllocationStatistics statistics { allocations.getStatistics() };
+        std::cout << "allocations of stage " << std::quoted(name) << ": " << statistics.count
+                  << ", peak " << statistics.peakBytes / 1024 << " KiB" << std::endl;
+    }
+    allocations.restart();
+}
+
+ModelData import_model(const std::filesystem::path &path) {
+    const bool cached { IsModelCacheEnabled() };
+    const std::string name { path.filename().string() };
+    std::pmr::monotonic_buffer_resource arena;  // temporary data of this import, freed at once when it returns
+    AllocationScope allocations;
+
+    ModelData data;
+    std::optional<ModelData> cached_data;
+    if (cached && (cached_data = ReadCachedModel(path, &arena))) {
+        data = std::move(*cached_data);
+        finish_stage("read cached " + name, allocations);
+        import_textures(data.materials, &arena);
+        finish_stage("imported textures of " + name, allocations);
+    } else {
+        const ScenePointer scene { importScene(path) };
+        finish_stage("imported " + name, allocations);
+
+        data.boundingBox = calculate_bounding_box(*scene);
+        data.meshes = convert_meshes(*scene);
+        finish_stage("converted meshes of " + name, allocations);
+        if (IsInstancingEnabled()) {
+            const InstancingStatistics statistics { InstanceMeshes(data.meshes) };
+            std::cout << std::fixed << std::setprecision(1) << "instanced " << statistics.copies
+                      << " copies of " << statistics.instancedMeshes << " meshes of " << name << ": "
+                      << statistics.meshes << " -> " << data.meshes.size() << " draw calls, "
+                      << statistics.savedBytes / (1024.0 * 1024.0) << " MiB saved" << std::endl;
+            finish_stage("instanced meshes of " + name, allocations);
+        }
+        data.materials = load_materials(*scene, path.parent_path(), &arena);
+        finish_stage("imported textures of " + name, allocations);
+        if (cached) {
+            WriteCachedModel(path, data, &arena);
+            finish_stage("cached " + name, allocations);
+        }
+    }
+
+    if (IsMeshletCullingEnabled()) {
+        for (auto &mesh : data.meshes) {
+            if (mesh.instances.empty()) {  // the bounds of meshlets are only valid for one instance
+                mesh.meshlets = BuildMeshlets(mesh.indices, mesh.vertices);
+            }
+        }
+        finish_stage("built meshlets of " + name, allocations);
+    }
+    return data;
+}
+
 } // anonymous namespace
 
-std::shared_ptr<Model> LoadModel(const std::filesystem::path &path){
+ModelData ImportModel(const std::filesystem::path &path) {
+    return import_model(path);
+}
+
+bool RunNormalBenchmark(const std::vector<std::filesystem::path> &paths) {
+    using Clock = std::chrono::steady_clock;
+    const auto get_milliseconds = [] (Clock::time_point begin) {
+        return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+    };
+
+    const bool valid { RunTangentSpaceBenchmark() };
+    std::cout << std::fixed << std::setprecision(1);
+    for (auto &path : paths) {
+        constexpr unsigned int Flags { ImportFlags | aiProcess_RemoveComponent };  // drops the file's normals
+        importScene(path, Flags);  // reads the file into the page cache
+
+        Clock::time_point begin { Clock::now() };
+        ScenePointer scene { importScene(path, Flags) };
+        const double import_time { get_milliseconds(begin) };
+        std::vector<MeshData> meshes;
+        std::vector<bool> textured;
+        std::size_t triangles { 0 };
+        for (auto i = 0u; i < scene->mNumMeshes; ++i) {
+            meshes.push_back(copy_mesh(*scene->mMeshes[i]));
+            WeldVertices(meshes.back().vertices, meshes.back().indices, GetWeldEpsilon());
+            textured.push_back(is_textured(*scene->mMeshes[i]));
+            triangles += scene->mMeshes[i]->mNumFaces;
+        }
+        scene.reset();
+
+        begin = Clock::now();
+        for (auto i = 0u; i < meshes.size(); ++i) {
+            GenerateNormals(meshes[i].vertices, meshes[i].indices, GetCreaseAngle());
+            if (textured[i]) {
+                meshes[i].tangents = GenerateTangents(meshes[i].vertices, meshes[i].indices);
+            }
+        }
+        const double kernel_time { get_milliseconds(begin) };
+
+        begin = Clock::now();
+        scene = importScene(path, Flags | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+        const double assimp_time { get_milliseconds(begin) - import_time };
+        std::cout << path.filename().string() << ": " << triangles << " triangles, normals and tangents "
+                  << "by Assimp: " << assimp_time << " ms, by bgl: " << kernel_time << " ms ("
+                  << assimp_time / kernel_time << "x) on " << get_thread_count() << " threads" << std::endl;
+    }
+    return valid;
+}
+
+std::shared_ptr<Model> CreateModel(const ModelData &data) {
     const auto model { std::make_shared<Model>() };
-    const aiScene &scene { *importScene(path) };
+    model->setProgram(ResourceManager::instance().loadProgram("./assets/shaders/main.vs", "./assets/shaders/main.fs"));
+    model->setWireframeProgram(ResourceManager::instance().loadProgram("./assets/shaders/main.vs", "./assets/shaders/main.gs",
+                                                                       "./assets/shaders/main.fs", { "WIREFRAME" }));
+    create_meshes(*model, data.meshes, *model->getProgram());
 
-    model->setProgram(LoadProgram({ "./assets/shaders/main.vs", "./assets/shaders/main.fs" }));
-    load_meshes(*model, scene, *model->getProgram());
-    model->setMaterials(load_materials(scene, path.parent_path()));
-    model->setBoundingBox(calculate_bounding_box(scene));
+    std::vector<Material> materials;
+    for (auto &material : data.materials) {
+        materials.push_back(create_material(material));
+    }
+    model->setMaterials(std::move(materials));
+    model->setBoundingBox(data.boundingBox);
+    MarkStartupPhase("uploaded model");
     return model;
 }
 
-std::shared_ptr<QOpenGLTexture> LoadTexture(const std::filesystem::path &path) {
-	QImage image { path.string().c_str() };
-	std::cout << "loading " << path << std::endl;
-	return std::make_shared<QOpenGLTexture>(image);
+std::shared_ptr<Model> LoadModel(const std::filesystem::path &path){
+    return CreateModel(ImportModel(path));
 }
 
 } // namespace bgl
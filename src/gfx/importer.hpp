@@ -1,21 +1,83 @@
 /**
  * @file importer.hpp
  * @brief All 3D model and image import features.
- * 
+ *
  */
 #ifndef GFX_IMPORTER_HPP_
 #define GFX_IMPORTER_HPP_
 
 #include <memory>
 #include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "mesh.hpp"
+#include "bounding_box.hpp"
+#include "texture.hpp"  // bgl::TextureData
 
 
 namespace bgl {
 
+class Model;
+
+/**
+ * @brief CPU side data of a mesh ready to be uploaded.
+ */
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;  // triangles
+    std::vector<glm::vec4> tangents;  // per vertex, empty unless the mesh has a normal map
+    std::optional<unsigned int> materialIndex;
+    BoundingBox boundingBox;
+    std::vector<Meshlet> meshlets;  // only if meshlet culling is enabled, see BuildMeshlets()
+    std::vector<mat4> instances;  // model matrices if the mesh is drawn several times, see InstanceMeshes()
+};
+
+struct MaterialData {
+    vec3 diffuse;
+    vec3 ambient;
+    vec3 specular;
+    vec3 emissive;
+    float shininess;
+
+    struct {
+        TextureData diffuse;
+        TextureData ambient;
+        TextureData specular;
+        TextureData emissive;
+    } textures;
+};
+
+/**
+ * @brief Everything LoadModel() needs besides OpenGL.
+ */
+struct ModelData {
+    std::vector<MeshData> meshes;
+    std::vector<MaterialData> materials;
+    BoundingBox boundingBox;
+};
+
+/**
+ * @brief Imports a 3D model file and its textures.
+ * @details Duplicate vertices are merged by WeldVertices(), missing normals are computed by
+ *          GenerateNormals() and meshes with a normal map get tangents. Meshes are reordered for
+ *          the post-transform cache. Imports are stored in the model cache (see ReadCachedModel()),
+ *          so Assimp only imports a file again after it changed.
+ * @note Does not need an OpenGL context and may be called from any thread.
+ */
+ModelData ImportModel(const std::filesystem::path &path);
+
+/**
+ * @brief Runs RunTangentSpaceBenchmark(), then imports models without their normals and prints how
+ *        long Assimp and GenerateNormals() and GenerateTangents() take to compute them.
+ * @return the result of RunTangentSpaceBenchmark()
+ */
+bool RunNormalBenchmark(const std::vector<std::filesystem::path> &paths);
+
 /**
- * @brief Loads and creates an OpenGL texture from an image file.
+ * @brief Creates all OpenGL resources of an imported model.
  */
-std::shared_ptr<QOpenGLTexture> LoadTexture(const std::filesystem::path &path);
+std::shared_ptr<Model> CreateModel(const ModelData &data);
 
 /**
  * @brief Loads a 3D model from a given path.
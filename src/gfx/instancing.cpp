@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>  // std::memcpy()
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "instancing.hpp"
+#include "parallel.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr float PositionTolerance { 1e-4f };  // relative to the radius of a mesh
+constexpr float NormalTolerance { 1e-3f };    // between unit normals
+constexpr float MinFrameArea { 1e-2f };       // relative to the squared distance of the first axis vertex
+
+std::atomic<bool> enabled { false };
+
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+inline std::uint64_t mix(std::uint64_t hash, std::uint32_t bits) noexcept {
+    constexpr std::uint64_t Multiplier { 0x9E3779B97F4A7C15ull };
+    return (hash ^ (hash >> 32) ^ bits) * Multiplier;
+}
+
+inline std::uint32_t get_bits(float value) noexcept {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief Canonical local space of a mesh.
+ */
+struct Frame {
+    vec3 center;   // centroid of the vertices
+    vec3 axes[3];  // orthonormal and right-handed
+
+    vec3 toLocal(const vec3 &direction) const noexcept {
+        return { glm::dot(axes[0], direction), glm::dot(axes[1], direction), glm::dot(axes[2], direction) };
+    }
+
+    vec3 toModel(const vec3 &direction) const noexcept {
+        return axes[0] * direction.x + axes[1] * direction.y + axes[2] * direction.z;
+    }
+};
+
+/**
+ * @brief Describes a mesh independently of its position and orientation.
+ */
+struct Signature {
+    std::uint64_t hash;  // of the material, indices and texture coordinates
+    float radius;        // root mean square distance of the vertices to their centroid
+    Frame frame;
+    GLuint axisVertices[2];  // span the frame, the same vertices of a copy span the frame of the copy
+    bool valid;              // false if the mesh is empty or flat along a line
+};
+
+/**
+ * @brief Returns the frame whose x axis points to @p a and whose xy plane contains @p b.
+ */
+Frame get_frame(const std::vector<Vertex> &vertices, const vec3 &center, const GLuint (&axis_vertices)[2]) {
+    const vec3 a { vertices[axis_vertices[0]].position - center };
+    const vec3 b { vertices[axis_vertices[1]].position - center };
+    const vec3 x { glm::normalize(a) };
+    const vec3 z { glm::normalize(glm::cross(a, b)) };
+    return { center, { x, glm::cross(z, x), z } };
+}
+
+Signature get_signature(const MeshData &mesh) {
+    Signature signature {};
+    std::uint64_t hash { mix(mix(0, static_cast<std::uint32_t>(mesh.vertices.size())),
+                             mesh.materialIndex ? *mesh.materialIndex + 1 : 0) };
+    for (const GLuint index : mesh.indices) {
+        hash = mix(hash, index);
+    }
+    for (auto &vertex : mesh.vertices) {
+        hash = mix(mix(hash, get_bits(vertex.texcoords.x)), get_bits(vertex.texcoords.y));
+    }
+    signature.hash = hash ^ (hash >> 32);
+    if (mesh.vertices.empty()) {
+        return signature;
+    }
+
+    double sum[3] { 0.0, 0.0, 0.0 };  // a float sum would differ between copies at different positions
+    for (auto &vertex : mesh.vertices) {
+        for (auto c = 0; c < 3; ++c) {
+            sum[c] += vertex.position[c];
+        }
+    }
+    const double count { static_cast<double>(mesh.vertices.size()) };
+    const vec3 center { static_cast<float>(sum[0] / count), static_cast<float>(sum[1] / count),
+                        static_cast<float>(sum[2] / count) };
+
+    // the vertex farthest from the centroid and the one that spans the largest triangle with it
+    double squared_sum { 0.0 };
+    float max_distance { -1.0f };
+    for (auto i = 0u; i < mesh.vertices.size(); ++i) {
+        const vec3 offset { mesh.vertices[i].position - center };
+        const float distance { glm::dot(offset, offset) };
+        squared_sum += distance;
+        if (distance > max_distance) {
+            max_distance = distance;
+            signature.axisVertices[0] = i;
+        }
+    }
+    const vec3 a { mesh.vertices[signature.axisVertices[0]].position - center };
+    float max_area { -1.0f };
+    for (auto i = 0u; i < mesh.vertices.size(); ++i) {
+        const float area { glm::length(glm::cross(a, mesh.vertices[i].position - center)) };
+        if (area > max_area) {
+            max_area = area;
+            signature.axisVertices[1] = i;
+        }
+    }
+
+    signature.radius = static_cast<float>(std::sqrt(squared_sum / count));
+    signature.valid = max_area > MinFrameArea * max_distance;
+    if (signature.valid) {
+        signature.frame = get_frame(mesh.vertices, center, signature.axisVertices);
+    }
+    return signature;
+}
+
+/**
+ * @brief Returns the matrix that maps @p reference onto @p mesh if the mesh is a rigidly moved copy.
+ */
+std::optional<mat4> match(const MeshData &reference, const Signature &reference_signature,
+                          const MeshData &mesh, const Signature &signature) {
+    const float tolerance { PositionTolerance * reference_signature.radius };
+    if (signature.hash != reference_signature.hash ||
+        std::fabs(signature.radius - reference_signature.radius) > tolerance ||
+        mesh.vertices.size() != reference.vertices.size() || mesh.indices != reference.indices ||
+        mesh.materialIndex != reference.materialIndex || mesh.tangents.size() != reference.tangents.size()) {
+        return std::nullopt;
+    }
+
+    // the frame of the mesh is spanned by the vertices that span the frame of the reference
+    const Frame &from { reference_signature.frame };
+    const Frame to { get_frame(mesh.vertices, signature.frame.center, reference_signature.axisVertices) };
+    const auto rotate = [&from, &to] (const vec3 &direction) { return to.toModel(from.toLocal(direction)); };
+    for (auto i = 0u; i < mesh.vertices.size(); ++i) {
+        const Vertex &original { reference.vertices[i] };
+        const Vertex &copy { mesh.vertices[i] };
+        const vec3 position { rotate(original.position - from.center) + to.center };
+        // negated, so that NaNs of a degenerate frame fail
+        if (!(glm::length(position - copy.position) <= tolerance) ||
+            !(glm::length(rotate(original.normal) - copy.normal) <= NormalTolerance) ||
+            original.texcoords.x != copy.texcoords.x || original.texcoords.y != copy.texcoords.y) {
+            return std::nullopt;
+        }
+    }
+
+    mat4 matrix { 1.0f };
+    for (auto c = 0; c < 3; ++c) {
+        vec3 axis { 0.0f };
+        axis[c] = 1.0f;
+        matrix[c] = glm::vec4 { rotate(axis), 0.0f };
+    }
+    matrix[3] = glm::vec4 { to.center - rotate(from.center), 1.0f };
+    return matrix;
+}
+
+/**
+ * @brief Returns the bounding box of all instances of a mesh.
+ */
+BoundingBox get_bounding_box(const BoundingBox &box, const std::vector<mat4> &instances) {
+    vec3 min { INFINITY };
+    vec3 max { -INFINITY };
+    for (auto &matrix : instances) {
+        for (auto corner = 0u; corner < 8; ++corner) {
+            const vec3 sign { corner & 1 ? 0.5f : -0.5f, corner & 2 ? 0.5f : -0.5f, corner & 4 ? 0.5f : -0.5f };
+            const vec3 position { matrix * glm::vec4 { box.getCenter() + sign * box.getSize(), 1.0f } };
+            min = glm::min(min, position);
+            max = glm::max(max, position);
+        }
+    }
+    return BoundingBox { (min + max) / 2.0f, max - min };
+}
+
+inline std::size_t get_size(const MeshData &mesh) noexcept {
+    return mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(GLuint) +
+           mesh.tangents.size() * sizeof(glm::vec4);
+}
+
+/*********************************************************
+ *                       Benchmark                       *
+ *********************************************************/
+
+BoundingBox get_bounding_box(const std::vector<Vertex> &vertices) {
+    vec3 min { INFINITY };
+    vec3 max { -INFINITY };
+    for (auto &vertex : vertices) {
+        min = glm::min(min, vertex.position);
+        max = glm::max(max, vertex.position);
+    }
+    return BoundingBox { (min + max) / 2.0f, max - min };
+}
+
+/**
+ * @brief Creates a sphere with random bumps, so that it has no symmetries.
+ */
+MeshData create_rock(std::mt19937 &random) {
+    constexpr unsigned Segments { 32 };
+    constexpr unsigned Rings { 16 };
+    constexpr float Pi { 3.14159265f };
+    std::uniform_real_distribution<float> bump { 0.8f, 1.2f };
+
+    MeshData mesh;
+    for (auto ring = 0u; ring <= Rings; ++ring) {
+        for (auto segment = 0u; segment <= Segments; ++segment) {
+            const vec2 uv { static_cast<float>(segment) / Segments, static_cast<float>(ring) / Rings };
+            const float phi { 2.0f * Pi * uv.x }, theta { Pi * uv.y };
+            const vec3 direction { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+            mesh.vertices.push_back({ direction * bump(random), direction, uv });
+        }
+    }
+    for (auto ring = 0u; ring < Rings; ++ring) {
+        for (auto segment = 0u; segment < Segments; ++segment) {
+            const GLuint a { ring * (Segments + 1) + segment }, b { a + Segments + 1 };
+            mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+        }
+    }
+    mesh.boundingBox = get_bounding_box(mesh.vertices);
+    return mesh;
+}
+
+MeshData transform(const MeshData &mesh, const mat4 &matrix) {
+    MeshData copy { mesh };
+    for (auto &vertex : copy.vertices) {
+        vertex.position = vec3 { matrix * glm::vec4 { vertex.position, 1.0f } };
+        vertex.normal = vec3 { matrix * glm::vec4 { vertex.normal, 0.0f } };
+    }
+    copy.boundingBox = get_bounding_box(copy.vertices);
+    return copy;
+}
+
+/**
+ * @brief Checks that every instance of a mesh maps its vertices onto the ones of its copy and
+ *        lies within the bounding box of the mesh.
+ */
+bool check_instances(const MeshData &mesh, const std::vector<mat4> &matrices) {
+    if (mesh.instances.size() != matrices.size()) {
+        return false;
+    }
+    const vec3 min { mesh.boundingBox.getCenter() - mesh.boundingBox.getSize() / 2.0f - 1e-3f };
+    const vec3 max { mesh.boundingBox.getCenter() + mesh.boundingBox.getSize() / 2.0f + 1e-3f };
+    for (auto i = 0u; i < matrices.size(); ++i) {
+        for (auto &vertex : mesh.vertices) {
+            const vec3 position { mesh.instances[i] * glm::vec4 { vertex.position, 1.0f } };
+            const vec3 expected { matrices[i] * glm::vec4 { vertex.position, 1.0f } };
+            if (glm::length(position - expected) > 1e-3f || glm::min(position, min) != min ||
+                glm::max(position, max) != max) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+void EnableInstancing(bool value) noexcept {
+    enabled = value;
+}
+
+bool IsInstancingEnabled() noexcept {
+    return enabled;
+}
+
+InstancingStatistics InstanceMeshes(std::vector<MeshData> &meshes) {
+    InstancingStatistics statistics { meshes.size(), 0, 0, 0 };
+    std::vector<Signature> signatures(meshes.size());
+    parallel_for(0, meshes.size(), [&] (std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            signatures[i] = get_signature(meshes[i]);
+        }
+    }, 1);
+
+    // every mesh is compared with the earlier meshes of its hash that are not copies themselves
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> references;
+    std::vector<bool> copies(meshes.size(), false);
+    std::size_t removed_bytes { 0 };
+    for (auto i = 0u; i < meshes.size(); ++i) {
+        if (!signatures[i].valid) {
+            continue;
+        }
+        std::vector<std::size_t> &candidates { references[signatures[i].hash] };
+        for (const std::size_t reference : candidates) {
+            const std::optional<mat4> matrix { match(meshes[reference], signatures[reference], meshes[i], signatures[i]) };
+            if (matrix) {
+                std::vector<mat4> &instances { meshes[reference].instances };
+                if (instances.empty()) {
+                    instances.emplace_back(1.0f);
+                    ++statistics.instancedMeshes;
+                }
+                instances.push_back(*matrix);
+                copies[i] = true;
+                ++statistics.copies;
+                removed_bytes += get_size(meshes[i]);
+                break;
+            }
+        }
+        if (!copies[i]) {
+            candidates.push_back(i);
+        }
+    }
+    if (statistics.copies == 0) {
+        return statistics;
+    }
+
+    std::vector<MeshData> instanced;
+    instanced.reserve(meshes.size() - statistics.copies);
+    std::size_t matrix_bytes { 0 };
+    for (auto i = 0u; i < meshes.size(); ++i) {
+        if (copies[i]) {
+            continue;
+        }
+        MeshData &mesh { instanced.emplace_back(std::move(meshes[i])) };
+        if (!mesh.instances.empty()) {
+            mesh.boundingBox = get_bounding_box(mesh.boundingBox, mesh.instances);
+            matrix_bytes += mesh.instances.size() * sizeof(mat4);
+        }
+    }
+    meshes = std::move(instanced);
+    statistics.savedBytes = removed_bytes > matrix_bytes ? removed_bytes - matrix_bytes : 0;
+    return statistics;
+}
+
+bool RunInstancingBenchmark() {
+    constexpr unsigned Rocks { 64 };
+    constexpr unsigned Copies { 15 };  // of every rock, rotated and moved
+
+    // every rock is followed by its copies, a mirrored copy and a copy with one vertex moved
+    std::mt19937 random { 42 };
+    std::uniform_real_distribution<float> distribution { -1.0f, 1.0f };
+    std::vector<MeshData> meshes;
+    std::vector<std::vector<mat4>> matrices(Rocks);
+    for (auto rock = 0u; rock < Rocks; ++rock) {
+        meshes.push_back(create_rock(random));
+        const MeshData original { meshes.back() };
+        matrices[rock].emplace_back(1.0f);
+        for (auto copy = 0u; copy < Copies; ++copy) {
+            const vec3 axis { distribution(random), distribution(random), distribution(random) };
+            const vec3 offset { 10.0f * distribution(random), 10.0f * distribution(random), 10.0f * distribution(random) };
+            matrices[rock].push_back(glm::translate(offset) * glm::rotate(3.0f * distribution(random), axis));
+            meshes.push_back(transform(original, matrices[rock].back()));
+        }
+
+        mat4 mirror { 1.0f };
+        mirror[0][0] = -1.0f;
+        meshes.push_back(transform(original, glm::translate(vec3 { 5.0f, 0.0f, 0.0f }) * mirror));
+        meshes.push_back(transform(original, glm::translate(vec3 { 0.0f, 5.0f, 0.0f })));
+        vec3 &position { meshes.back().vertices[meshes.back().vertices.size() / 2].position };
+        position = position * 1.01f;
+    }
+    const std::size_t count { meshes.size() };
+
+    const Clock::time_point begin { Clock::now() };
+    const InstancingStatistics statistics { InstanceMeshes(meshes) };
+    const double time { get_milliseconds(begin) };
+
+    bool valid { statistics.instancedMeshes == Rocks && statistics.copies == Rocks * Copies &&
+                 meshes.size() == 3 * Rocks };
+    for (auto rock = 0u; valid && rock < Rocks; ++rock) {
+        valid = check_instances(meshes[3 * rock], matrices[rock]) &&
+                meshes[3 * rock + 1].instances.empty() && meshes[3 * rock + 2].instances.empty();
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << count << " meshes of " << Rocks << " rocks: " << statistics.copies << " copies of "
+              << statistics.instancedMeshes << " meshes instanced in " << time << " ms, "
+              << statistics.savedBytes / 1024.0 << " KiB saved" << (valid ? "" : " MISMATCH") << std::endl;
+    return valid;
+}
+
+}  // namespace bgl
@@ -0,0 +1,52 @@
+/**
+ * @file instancing.hpp
+ * @brief Detection of duplicate meshes in files whose exporter flattened the scene graph.
+ */
+#ifndef GFX_INSTANCING_HPP_
+#define GFX_INSTANCING_HPP_
+
+#include <cstddef>  // std::size_t
+#include <vector>
+
+#include "importer.hpp"  // bgl::MeshData
+
+
+namespace bgl {
+
+/**
+ * @brief Draws copies of a mesh as instances of one mesh, see InstanceMeshes().
+ * @note The model cache keeps separate imports with and without instancing.
+ */
+void EnableInstancing(bool enabled = true) noexcept;
+bool IsInstancingEnabled() noexcept;
+
+struct InstancingStatistics {
+    std::size_t meshes;           // before instancing
+    std::size_t instancedMeshes;  // that have copies
+    std::size_t copies;           // replaced by instances, i.e. draw calls removed
+    std::size_t savedBytes;       // of vertex and index buffers, minus the instance matrices
+};
+
+/**
+ * @brief Replaces meshes that equal another mesh up to a rotation and translation by instances of it.
+ * @details Every mesh gets a canonical local space: centered at the centroid of its vertices and
+ *          rotated into a frame spanned by two of its outermost vertices. Only meshes with the same
+ *          hash of their material, indices and texture coordinates and the same radius around their
+ *          centroid are compared. The rigid transformation between their frames must map all
+ *          positions and normals within a tolerance relative to the size of the mesh. Mirrored
+ *          copies are kept, as their triangles would face the other way.
+ * @note An instanced mesh keeps the vertices of its first occurrence, whose matrix is the identity,
+ *       and its bounding box encloses all instances.
+ */
+InstancingStatistics InstanceMeshes(std::vector<MeshData> &meshes);
+
+/**
+ * @brief Instances rotated and moved copies of random meshes, together with mirrored and deformed
+ *        copies that must be kept, and prints the time and the savings.
+ * @return whether exactly the rigid copies were instanced with the matrices they were created with
+ */
+bool RunInstancingBenchmark();
+
+}  // namespace bgl
+
+#endif  // GFX_INSTANCING_HPP_
@@ -0,0 +1,230 @@
+#include <sys/mman.h>  // mmap(), madvise()
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>  // std::memcmp()
+#include <fstream>
+#include <iomanip>  // std::quoted
+#include <sstream>
+#include <stdexcept>
+#include <utility>  // std::pair
+
+#include "ktx.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr std::array<std::uint8_t, 12> Identifier {
+    0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+constexpr std::size_t Alignment { 16 };  // a multiple of every block size
+
+struct Header {
+    std::uint8_t identifier[12];
+    std::uint32_t vkFormat;
+    std::uint32_t typeSize;
+    std::uint32_t pixelWidth;
+    std::uint32_t pixelHeight;
+    std::uint32_t pixelDepth;
+    std::uint32_t layerCount;
+    std::uint32_t faceCount;
+    std::uint32_t levelCount;
+    std::uint32_t supercompressionScheme;
+    std::uint32_t dfdByteOffset;
+    std::uint32_t dfdByteLength;
+    std::uint32_t kvdByteOffset;
+    std::uint32_t kvdByteLength;
+    std::uint64_t sgdByteOffset;
+    std::uint64_t sgdByteLength;
+};
+static_assert(sizeof(Header) == 80, "KTX2 header must not be padded");
+
+struct LevelIndex {
+    std::uint64_t byteOffset;
+    std::uint64_t byteLength;
+    std::uint64_t uncompressedByteLength;
+};
+
+/**
+ * @brief VkFormat values of the supported block formats.
+ */
+std::uint32_t to_vk_format(BlockFormat format) {
+    switch (format) {
+        case BlockFormat::BC1: return 131;  // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+        case BlockFormat::BC3: return 137;  // VK_FORMAT_BC3_UNORM_BLOCK
+        case BlockFormat::BC5: return 141;  // VK_FORMAT_BC5_UNORM_BLOCK
+        case BlockFormat::BC7: return 145;  // VK_FORMAT_BC7_UNORM_BLOCK
+        default: throw std::runtime_error { "unsupported block format" };
+    }
+}
+
+BlockFormat from_vk_format(std::uint32_t format) {
+    switch (format) {
+        case 131: return BlockFormat::BC1;
+        case 137: return BlockFormat::BC3;
+        case 141: return BlockFormat::BC5;
+        case 145: return BlockFormat::BC7;
+        default: throw std::runtime_error { "unsupported KTX2 format " + std::to_string(format) };
+    }
+}
+
+inline std::size_t align(std::size_t offset) noexcept {
+    return (offset + Alignment - 1) / Alignment * Alignment;
+}
+
+std::runtime_error make_error(const std::string &message, const std::filesystem::path &path) {
+    std::ostringstream oss;
+    oss << message << " " << std::quoted(path.string());
+    return std::runtime_error { oss.str() };
+}
+
+/**
+ * @brief Returns the pages a level occupies (they may be shared with neighbouring levels).
+ */
+std::pair<std::uint8_t*, std::uint8_t*> get_pages(const MappedTexture::Level &level) {
+    const auto page_size { static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE)) };
+    const auto begin { reinterpret_cast<std::uintptr_t>(level.data) / page_size * page_size };
+    const auto end { (reinterpret_cast<std::uintptr_t>(level.data) + level.size + page_size - 1) / page_size * page_size };
+    return { reinterpret_cast<std::uint8_t*>(begin), reinterpret_cast<std::uint8_t*>(end) };
+}
+
+}  // anonymous namespace
+
+void WriteKTX(const std::filesystem::path &path, BlockFormat format,
+              const std::vector<CompressedLevel> &levels) {
+    if (levels.empty()) {
+        throw make_error("no mip levels for", path);
+    }
+
+    Header header {};
+    std::copy(Identifier.begin(), Identifier.end(), header.identifier);
+    header.vkFormat = to_vk_format(format);
+    header.typeSize = 1;
+    header.pixelWidth = levels.front().width;
+    header.pixelHeight = levels.front().height;
+    header.faceCount = 1;
+    header.levelCount = static_cast<std::uint32_t>(levels.size());
+
+    // KTX2 stores the smallest level first, so streaming readers get a preview early
+    std::vector<LevelIndex> index(levels.size());
+    std::size_t offset { sizeof(Header) + sizeof(LevelIndex) * levels.size() };
+    for (auto i = levels.size(); i-- > 0;) {
+        offset = align(offset);
+        index[i] = { offset, levels[i].data.size(), levels[i].data.size() };
+        offset += levels[i].data.size();
+    }
+
+    std::ofstream file { path, std::ios::binary };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(index.data()), sizeof(LevelIndex) * index.size());
+    for (auto i = levels.size(); i-- > 0;) {
+        const std::vector<char> padding(index[i].byteOffset - static_cast<std::uint64_t>(file.tellp()), 0);
+        file.write(padding.data(), padding.size());
+        file.write(reinterpret_cast<const char*>(levels[i].data.data()), levels[i].data.size());
+    }
+    if (!file) {
+        throw make_error("could not write", path);
+    }
+}
+
+MappedTexture::MappedTexture(const std::filesystem::path &path) {
+    const int file { open(path.c_str(), O_RDONLY) };
+    if (file < 0) {
+        throw make_error("could not open", path);
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(Header))) {
+        close(file);
+        throw make_error("invalid KTX2 file", path);
+    }
+    _size = static_cast<std::size_t>(status.st_size);
+    _data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);  // the mapping keeps the file open
+    if (_data == MAP_FAILED) {
+        _data = nullptr;
+        throw make_error("could not map", path);
+    }
+
+    try {
+        const auto *bytes { static_cast<const std::uint8_t*>(_data) };
+        Header header;
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.identifier, Identifier.data(), Identifier.size()) != 0 ||
+            header.supercompressionScheme != 0 || header.levelCount == 0 ||
+            sizeof(Header) + sizeof(LevelIndex) * header.levelCount > _size) {
+            throw make_error("invalid KTX2 file", path);
+        }
+        _format = from_vk_format(header.vkFormat);
+
+        for (auto i = 0u; i < header.levelCount; ++i) {
+            LevelIndex index;
+            std::memcpy(&index, bytes + sizeof(Header) + sizeof(LevelIndex) * i, sizeof(index));
+            const unsigned width { std::max(header.pixelWidth >> i, 1u) };
+            const unsigned height { std::max(header.pixelHeight >> i, 1u) };
+            if (index.byteOffset + index.byteLength > _size ||
+                index.byteLength != GetCompressedSize(_format, width, height)) {
+                throw make_error("truncated KTX2 file", path);
+            }
+            _levels.push_back({ width, height, bytes + index.byteOffset, index.byteLength });
+        }
+    } catch (...) {
+        munmap(_data, _size);
+        throw;
+    }
+}
+
+MappedTexture::~MappedTexture() noexcept {
+    munmap(_data, _size);
+}
+
+BlockFormat MappedTexture::getFormat() const noexcept {
+    return _format;
+}
+
+unsigned MappedTexture::getWidth() const noexcept {
+    return _levels.front().width;
+}
+
+unsigned MappedTexture::getHeight() const noexcept {
+    return _levels.front().height;
+}
+
+const std::vector<MappedTexture::Level>& MappedTexture::getLevels() const noexcept {
+    return _levels;
+}
+
+std::size_t MappedTexture::getSize(unsigned firstLevel) const noexcept {
+    std::size_t size { 0 };
+    for (auto i = firstLevel; i < _levels.size(); ++i) {
+        size += _levels[i].size;
+    }
+    return size;
+}
+
+void MappedTexture::prefetch(unsigned level) const {
+    const auto [begin, end] { get_pages(_levels.at(level)) };
+    madvise(begin, static_cast<std::size_t>(end - begin), MADV_WILLNEED);
+
+    // touch every page, so uploading the level later does not wait for the disk
+    const std::size_t page_size { static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) };
+    volatile std::uint8_t sum { 0 };
+    for (auto *page = _levels[level].data; page < _levels[level].data + _levels[level].size; page += page_size) {
+        sum = sum + *page;
+    }
+}
+
+void MappedTexture::release(unsigned level) const noexcept {
+    if (level < _levels.size()) {
+        const auto [begin, end] { get_pages(_levels[level]) };
+        madvise(begin, static_cast<std::size_t>(end - begin), MADV_DONTNEED);
+    }
+}
+
+}  // namespace bgl
@@ -0,0 +1,79 @@
+/**
+ * @file ktx.hpp
+ * @brief A KTX2 style container for block compressed textures and their mip chains.
+ */
+#ifndef GFX_KTX_HPP_
+#define GFX_KTX_HPP_
+
+#include <cstddef>     // std::size_t
+#include <cstdint>
+#include <filesystem>  // std::filesystem::path
+#include <vector>
+
+#include "block_compression.hpp"
+
+
+namespace bgl {
+
+struct CompressedLevel {
+    unsigned width;
+    unsigned height;
+    std::vector<std::uint8_t> data;
+};
+
+/**
+ * @brief Writes a texture with its mip levels (largest first) to a KTX2 file.
+ * @details Only the parts of KTX2 needed by this viewer are written, i.e. there is no data
+ *          format descriptor, no key/value data and no supercompression.
+ * @throw std::runtime_error if the file could not be written
+ */
+void WriteKTX(const std::filesystem::path &path, BlockFormat format,
+              const std::vector<CompressedLevel> &levels);
+
+/**
+ * @brief A KTX2 file written by WriteKTX() that is mapped into memory.
+ * @details The level data points directly into the mapped file, so it can be passed to
+ *          glCompressedTexImage2D() without copying or decoding it first. Levels are only
+ *          read from disk when they are accessed or prefetched.
+ */
+class MappedTexture {
+ public:
+	struct Level {
+		unsigned width;
+		unsigned height;
+		const std::uint8_t *data;
+		std::size_t size;
+	};
+
+	/**
+	 * @throw std::runtime_error if the file could not be mapped or is no valid KTX2 file
+	 */
+	explicit MappedTexture(const std::filesystem::path &path);
+
+	MappedTexture(MappedTexture&&) = delete;
+	MappedTexture& operator=(MappedTexture&&) = delete;
+
+	MappedTexture(const MappedTexture&) = delete;
+	MappedTexture& operator=(const MappedTexture&) = delete;
+
+	virtual ~MappedTexture() noexcept;
+
+	BlockFormat getFormat() const noexcept;
+	unsigned getWidth() const noexcept;
+	unsigned getHeight() const noexcept;
+	const std::vector<Level>& getLevels() const noexcept;  // largest first
+	std::size_t getSize(unsigned firstLevel = 0) const noexcept;  // bytes of the levels from @p firstLevel on
+
+	void prefetch(unsigned level) const;  // blocks until the level was read from disk
+	void release(unsigned level) const noexcept;  // drops the level from memory until it is accessed again
+
+ private:
+	void *_data { nullptr };
+	std::size_t _size { 0 };
+	BlockFormat _format;
+	std::vector<Level> _levels;
+};
+
+}  // namespace bgl
+
+#endif  // GFX_KTX_HPP_
@@ -0,0 +1,272 @@
+#include "gl.hpp"
+
+#include <QOpenGLShaderProgram>
+#include <QVector2D>
+#include <QVector3D>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // __SSE2__
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "lighting.hpp"
+#include "parallel.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr unsigned Tiles { ClusteredLighting::TilesX * ClusteredLighting::TilesY };
+constexpr unsigned Clusters { Tiles * ClusteredLighting::Slices };
+static_assert(Tiles % 4 == 0, "clusters are binned four at a time");
+
+inline QVector3D to_qt(const vec3 &v) noexcept {
+    return { v.x, v.y, v.z };
+}
+
+inline void copy(const vec3 &v, float (&array)[3]) noexcept {
+    array[0] = v.x;
+    array[1] = v.y;
+    array[2] = v.z;
+}
+
+/**
+ * @brief Returns the view space point of a pixel that lies at @p depth in front of the camera.
+ */
+vec3 unproject(const mat4 &inverse_P, const vec2 &ndc, float depth) {
+    const glm::vec4 point { inverse_P * glm::vec4 { ndc, -1.0f, 1.0f } };
+    const vec3 near { vec3 { point } / point.w };
+    return near * (depth / -near.z);
+}
+
+/**
+ * @brief Tests which of four clusters intersect a sphere.
+ * @return a bit mask with one bit per cluster
+ */
+inline unsigned intersect(const float *min[3], const float *max[3], const float center[3], float radius) {
+#if defined(__SSE2__)
+    __m128 distance { _mm_setzero_ps() };
+    for (auto axis = 0; axis < 3; ++axis) {
+        const __m128 c { _mm_set1_ps(center[axis]) };
+        const __m128 below { _mm_sub_ps(_mm_loadu_ps(min[axis]), c) };
+        const __m128 above { _mm_sub_ps(c, _mm_loadu_ps(max[axis])) };
+        const __m128 d { _mm_max_ps(_mm_max_ps(below, above), _mm_setzero_ps()) };
+        distance = _mm_add_ps(distance, _mm_mul_ps(d, d));
+    }
+    return static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(distance, _mm_set1_ps(radius * radius))));
+#else
+    unsigned mask { 0 };
+    for (auto i = 0; i < 4; ++i) {
+        float distance { 0.0f };
+        for (auto axis = 0; axis < 3; ++axis) {
+            const float d { std::max({ min[axis][i] - center[axis], center[axis] - max[axis][i], 0.0f }) };
+            distance += d * d;
+        }
+        mask |= (distance <= radius * radius ? 1u : 0u) << i;
+    }
+    return mask;
+#endif  // __SSE2__
+}
+
+}  // anonymous namespace
+
+ClusteredLighting::~ClusteredLighting() noexcept {
+    if (_buffers[0] != 0) {
+        glDeleteBuffers(3, _buffers);
+    }
+}
+
+void ClusteredLighting::update(const Lights &lights, const mat4 &P, const mat4 &V, float near, float far) {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    updateBounds(P, { viewport[2], viewport[3] }, near, far);
+
+    _directional = lights.directional;
+    _directional.direction = mat3 { V } * lights.directional.direction;
+
+    // lights in view space
+    std::vector<GPULight> view_lights;
+    view_lights.reserve(lights.points.size() + lights.spots.size());
+    for (auto &light : lights.points) {
+        GPULight &view_light { view_lights.emplace_back() };
+        copy(vec3 { V * glm::vec4 { light.position, 1.0f } }, view_light.position);
+        copy(light.color, view_light.color);
+        copy(vec3 { 0.0f, 0.0f, -1.0f }, view_light.direction);
+        view_light.radius = light.radius;
+        view_light.cosInner = -1.0f;
+        view_light.cosOuter = -1.0f;
+    }
+    for (auto &light : lights.spots) {
+        GPULight &view_light { view_lights.emplace_back() };
+        copy(vec3 { V * glm::vec4 { light.position, 1.0f } }, view_light.position);
+        copy(light.color, view_light.color);
+        copy(glm::normalize(mat3 { V } * light.direction), view_light.direction);
+        view_light.radius = light.radius;
+        view_light.cosInner = std::cos(glm::radians(light.innerAngle));
+        view_light.cosOuter = std::cos(glm::radians(light.outerAngle));
+    }
+
+    const auto begin { std::chrono::steady_clock::now() };
+    bin(view_lights, near, far);
+    _binningTime = std::chrono::duration<double, std::milli> { std::chrono::steady_clock::now() - begin }.count();
+
+    upload(view_lights);
+    _lightCount = view_lights.size();
+}
+
+void ClusteredLighting::bind(QOpenGLShaderProgram &program) const {
+    program.setUniformValue("light.direction", to_qt(_directional.direction));
+    program.setUniformValue("light.diffuse", to_qt(_directional.diffuse));
+    program.setUniformValue("light.ambient", to_qt(_directional.ambient));
+
+    program.setUniformValue("clusters.tileSize", QVector2D(_tileSize.x, _tileSize.y));
+    program.setUniformValue("clusters.scale", _sliceScale);
+    program.setUniformValue("clusters.bias", _sliceBias);
+    for (auto i = 0u; i < 3; ++i) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, i, _buffers[i]);
+    }
+}
+
+double ClusteredLighting::getBinningTime() const noexcept {
+    return _binningTime;
+}
+
+std::size_t ClusteredLighting::getLightCount() const noexcept {
+    return _lightCount;
+}
+
+void ClusteredLighting::updateBounds(const mat4 &P, const ivec2 &viewport, float near, float far) {
+    if ((P == _projection && viewport == _viewport) || viewport.x <= 0 || viewport.y <= 0) {
+        return;
+    }
+    _projection = P;
+    _viewport = viewport;
+
+    const ivec2 tiles { static_cast<GLint>(TilesX), static_cast<GLint>(TilesY) };
+    _tileSize = (viewport + tiles - 1) / tiles;
+    _sliceScale = Slices / std::log(far / near);
+    _sliceBias = -_sliceScale * std::log(near);
+
+    const mat4 inverse_P { glm::inverse(P) };
+    _bounds.assign(Slices, {});
+    for (auto slice = 0u; slice < Slices; ++slice) {
+        // exponential slices keep clusters roughly cubic
+        const float slice_near { near * std::pow(far / near, static_cast<float>(slice) / Slices) };
+        const float slice_far { near * std::pow(far / near, static_cast<float>(slice + 1) / Slices) };
+
+        ClusterBounds &bounds { _bounds[slice] };
+        for (auto axis = 0; axis < 3; ++axis) {
+            bounds.min[axis].resize(Tiles);
+            bounds.max[axis].resize(Tiles);
+        }
+        for (auto tile = 0u; tile < Tiles; ++tile) {
+            const vec2 position { static_cast<float>(tile % TilesX), static_cast<float>(tile / TilesX) };
+            const vec2 pixel_min { position * vec2 { _tileSize } };
+            const vec2 ndc_min { pixel_min / vec2 { viewport } * 2.0f - 1.0f };
+            const vec2 ndc_max { (pixel_min + vec2 { _tileSize }) / vec2 { viewport } * 2.0f - 1.0f };
+
+            vec3 min { INFINITY };
+            vec3 max { -INFINITY };
+            for (auto corner = 0u; corner < 8; ++corner) {
+                const vec2 ndc { corner & 1 ? ndc_max.x : ndc_min.x, corner & 2 ? ndc_max.y : ndc_min.y };
+                const vec3 point { unproject(inverse_P, ndc, corner & 4 ? slice_far : slice_near) };
+                min = glm::min(min, point);
+                max = glm::max(max, point);
+            }
+            for (auto axis = 0; axis < 3; ++axis) {
+                bounds.min[axis][tile] = min[axis];
+                bounds.max[axis][tile] = max[axis];
+            }
+        }
+    }
+}
+
+void ClusteredLighting::bin(const std::vector<GPULight> &lights, float near, float far) {
+    if (_bounds.empty()) {
+        _grid.assign(std::size_t { Clusters } * 2, 0);  // there is no viewport yet
+        _list.clear();
+        return;
+    }
+
+    // the depth slices each light overlaps
+    std::vector<std::vector<std::uint32_t>> slice_lights(Slices);
+    for (auto i = 0u; i < lights.size(); ++i) {
+        const float depth { -lights[i].position[2] };
+        const float first { std::max(depth - lights[i].radius, near) };
+        const float last { std::min(depth + lights[i].radius, far) };
+        if (first > last) {
+            continue;  // in front of the near or behind the far plane
+        }
+        const auto to_slice = [&] (float z) {
+            return std::clamp(static_cast<int>(std::log(z) * _sliceScale + _sliceBias), 0, static_cast<int>(Slices) - 1);
+        };
+        for (auto slice = to_slice(first); slice <= to_slice(last); ++slice) {
+            slice_lights[slice].push_back(i);
+        }
+    }
+
+    // the clusters of a slice are only counted by the thread of the slice
+    _counts.assign(Clusters, 0);
+    _overlaps.resize(Slices);
+    parallel_for(0, Slices, [&] (std::size_t begin, std::size_t end) {
+        for (auto slice = begin; slice < end; ++slice) {
+            const ClusterBounds &bounds { _bounds[slice] };
+            std::vector<Overlap> &overlaps { _overlaps[slice] };
+            overlaps.clear();
+            for (const std::uint32_t light : slice_lights[slice]) {
+                for (auto tile = 0u; tile < Tiles; tile += 4) {
+                    const float *min[3] { &bounds.min[0][tile], &bounds.min[1][tile], &bounds.min[2][tile] };
+                    const float *max[3] { &bounds.max[0][tile], &bounds.max[1][tile], &bounds.max[2][tile] };
+                    unsigned mask { intersect(min, max, lights[light].position, lights[light].radius) };
+                    for (; mask != 0; mask &= mask - 1) {
+                        const auto cluster { static_cast<std::uint32_t>(slice * Tiles + tile + __builtin_ctz(mask)) };
+                        ++_counts[cluster];
+                        overlaps.push_back({ cluster, light });
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    // the offsets of the light lists in the compacted list
+    _grid.resize(std::size_t { Clusters } * 2);
+    std::uint32_t offset { 0 };
+    for (auto cluster = 0u; cluster < Clusters; ++cluster) {
+        _grid[cluster * 2] = offset;
+        _grid[cluster * 2 + 1] = _counts[cluster];
+        offset += _counts[cluster];
+        _counts[cluster] = 0;  // counts the written lights below
+    }
+
+    _list.resize(offset);
+    parallel_for(0, Slices, [&] (std::size_t begin, std::size_t end) {
+        for (auto slice = begin; slice < end; ++slice) {
+            for (const Overlap &overlap : _overlaps[slice]) {
+                _list[_grid[overlap.cluster * 2] + _counts[overlap.cluster]++] = overlap.light;
+            }
+        }
+    }, 1);
+}
+
+void ClusteredLighting::upload(const std::vector<GPULight> &lights) {
+    if (_buffers[0] == 0) {
+        glGenBuffers(3, _buffers);
+    }
+
+    const auto upload_buffer = [] (GLuint buffer, const void *data, std::size_t size) {
+        static const std::uint32_t empty[12] {};  // zero sized buffers must not be bound
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(size ? size : sizeof(empty)),
+                     size ? data : empty, GL_STREAM_DRAW);
+    };
+    upload_buffer(_buffers[0], lights.data(), lights.size() * sizeof(GPULight));
+    upload_buffer(_buffers[1], _grid.data(), _grid.size() * sizeof(std::uint32_t));
+    upload_buffer(_buffers[2], _list.data(), _list.size() * sizeof(std::uint32_t));
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+}  // namespace bgl
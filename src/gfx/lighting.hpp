@@ -0,0 +1,127 @@
+/**
+ * @file lighting.hpp
+ * @brief Light sources and clustered forward shading.
+ */
+#ifndef GFX_LIGHTING_HPP_
+#define GFX_LIGHTING_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "gl.hpp"
+
+class QOpenGLShaderProgram;
+
+
+namespace bgl {
+
+struct DirectionalLight {
+    vec3 direction;
+    vec3 diffuse;
+    vec3 ambient;
+};
+
+struct PointLight {
+    vec3 position;
+    vec3 color;
+    float radius;  // the light has no effect beyond
+};
+
+struct SpotLight {
+    vec3 position;
+    vec3 direction;
+    vec3 color;
+    float radius;
+    float innerAngle;  // [°] full intensity within
+    float outerAngle;  // [°] no light beyond
+};
+
+struct Lights {
+    DirectionalLight directional;
+    std::vector<PointLight> points;
+    std::vector<SpotLight> spots;
+};
+
+/**
+ * @brief Assigns point and spot lights to the clusters of the view frustum.
+ * @details The frustum is divided into screen space tiles and exponentially spaced depth
+ *          slices. Every frame, the lights are binned into the clusters they overlap on the CPU,
+ *          four clusters at a time with SSE and one depth slice per thread. The light list of
+ *          every cluster is uploaded into shader storage buffers, so the fragment shader only
+ *          loops over the lights of its own cluster. A cluster holds any number of lights: the
+ *          overlaps of all clusters are counted first and then written into one compacted list at
+ *          the offsets of their clusters.
+ */
+class ClusteredLighting {
+ public:
+	static constexpr unsigned TilesX { 16 };
+	static constexpr unsigned TilesY { 9 };
+	static constexpr unsigned Slices { 24 };
+
+	ClusteredLighting() = default;
+	ClusteredLighting(ClusteredLighting&&) = delete;
+	ClusteredLighting& operator=(ClusteredLighting&&) = delete;
+
+	ClusteredLighting(const ClusteredLighting&) = delete;
+	ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+	virtual ~ClusteredLighting() noexcept;
+
+	/**
+	 * @brief Bins and uploads the lights of a frame.
+	 */
+	void update(const Lights &lights, const mat4 &P, const mat4 &V, float near, float far);
+
+	/**
+	 * @brief Binds the light buffers and sets the uniforms of the program (must be bound).
+	 */
+	void bind(QOpenGLShaderProgram &program) const;
+
+	double getBinningTime() const noexcept;  // [ms] of the last update()
+	std::size_t getLightCount() const noexcept;
+
+ private:
+	struct ClusterBounds {  // view space AABBs of the clusters of one slice, in SoA layout
+		std::vector<float> min[3];
+		std::vector<float> max[3];
+	};
+
+	struct Overlap {  // of a light and a cluster
+		std::uint32_t cluster;
+		std::uint32_t light;
+	};
+
+	struct GPULight {  // std430 layout
+		float position[3];
+		float radius;
+		float color[3];
+		float cosInner;
+		float direction[3];
+		float cosOuter;  // -1 for point lights
+	};
+
+	void updateBounds(const mat4 &P, const ivec2 &viewport, float near, float far);
+	void bin(const std::vector<GPULight> &lights, float near, float far);
+	void upload(const std::vector<GPULight> &lights);
+
+	std::vector<ClusterBounds> _bounds;  // per slice
+	mat4 _projection { 0.0f };
+	ivec2 _viewport { 0, 0 };
+
+	std::vector<std::vector<Overlap>> _overlaps;  // per slice, in the order of the lights
+	std::vector<std::uint32_t> _counts;  // lights per cluster
+	std::vector<std::uint32_t> _grid;    // offset and count per cluster
+	std::vector<std::uint32_t> _list;    // compacted light indices
+
+	DirectionalLight _directional;  // in view space
+	ivec2 _tileSize { 1, 1 };
+	float _sliceScale { 0.0f };
+	float _sliceBias { 0.0f };
+	GLuint _buffers[3] { 0, 0, 0 };  // lights, grid, light indices
+	std::size_t _lightCount { 0 };
+	double _binningTime { 0.0 };
+};
+
+}  // namespace bgl
+
+#endif  // GFX_LIGHTING_HPP_
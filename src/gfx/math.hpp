@@ -29,6 +29,24 @@ template<typename T> using tvec3 = glm::tvec3<T>;
 using mat3 = glm::mat3;
 using mat4 = glm::mat4;
 
+/**
+ * @brief Extracts the normalized view frustum planes from the rows of @p MVP (Gribb & Hartmann).
+ * @details A point p lies in front of a plane if dot(plane.xyz, p) + plane.w >= 0, which is its
+ *          distance to the plane. The planes are in the space that @p MVP transforms from.
+ */
+inline void GetFrustumPlanes(const mat4 &MVP, glm::vec4 (&planes)[6]) {
+    const mat4 M { glm::transpose(MVP) };  // columns of the transpose are rows
+    planes[0] = M[3] + M[0];  // left
+    planes[1] = M[3] - M[0];  // right
+    planes[2] = M[3] + M[1];  // bottom
+    planes[3] = M[3] - M[1];  // top
+    planes[4] = M[3] + M[2];  // near
+    planes[5] = M[3] - M[2];  // far
+    for (auto &plane : planes) {
+        plane /= glm::length(glm::vec3 { plane });
+    }
+}
+
 
 template<typename T>
 std::ostream& operator<<(std::ostream &os, const tvec2<T> &v) {
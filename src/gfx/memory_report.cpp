@@ -0,0 +1,126 @@
+#include <atomic>
+#include <cstdio>  // std::snprintf()
+#include <string>
+
+#include "memory_report.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+std::atomic<bool> enabled { false };
+
+void write_string(std::ostream &os, const std::string &string) {
+    os << '"';
+    for (const char c : string) {
+        switch (c) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    os << escaped;
+                } else {
+                    os << c;
+                }
+                break;
+        }
+    }
+    os << '"';
+}
+
+template<typename T>
+void write_optional(std::ostream &os, const std::optional<T> &value) {
+    if (value) {
+        os << *value;
+    } else {
+        os << "null";
+    }
+}
+
+void write_texture(std::ostream &os, const TextureMemory &texture, const char *indent) {
+    os << indent << "{ \"slot\": ";
+    write_string(os, texture.slot);
+    os << ", \"path\": ";
+    write_string(os, texture.path);
+    os << ", \"gpuBytes\": " << texture.gpuBytes << ", \"residentLevel\": ";
+    write_optional(os, texture.residentLevel);
+    os << ", \"users\": " << texture.users << " }";
+}
+
+void write_mesh(std::ostream &os, const MeshMemory &mesh) {
+    os << "        { \"material\": ";
+    write_optional(os, mesh.materialIndex);
+    os << ", \"vertexBytes\": " << mesh.vertexBytes << ", \"indexBytes\": " << mesh.indexBytes
+       << ", \"meshletBytes\": " << mesh.meshletBytes << ", \"occluderBytes\": " << mesh.occluderBytes
+       << ", \"instances\": " << mesh.instances << " }";
+}
+
+void write_material(std::ostream &os, const MaterialMemory &material) {
+    os << "        { \"gpuBytes\": " << material.gpuBytes << ", \"textures\": [";
+    for (auto i = 0u; i < material.textures.size(); ++i) {
+        os << (i > 0 ? ",\n" : "\n");
+        write_texture(os, material.textures[i], "            ");
+    }
+    os << (material.textures.empty() ? "] }" : "\n        ] }");
+}
+
+void write_model(std::ostream &os, const ModelMemory &model) {
+    os << "    {\n      \"path\": ";
+    write_string(os, model.path);
+    os << ",\n      \"type\": ";
+    write_string(os, model.type);
+    os << ",\n      \"inScene\": " << (model.inScene ? "true" : "false")
+       << ",\n      \"bufferBytes\": " << model.bufferBytes
+       << ",\n      \"textureBytes\": " << model.textureBytes
+       << ",\n      \"cpuBytes\": " << model.cpuBytes
+       << ",\n      \"meshes\": [";
+    for (auto i = 0u; i < model.meshes.size(); ++i) {
+        os << (i > 0 ? ",\n" : "\n");
+        write_mesh(os, model.meshes[i]);
+    }
+    os << (model.meshes.empty() ? "]" : "\n      ]") << ",\n      \"materials\": [";
+    for (auto i = 0u; i < model.materials.size(); ++i) {
+        os << (i > 0 ? ",\n" : "\n");
+        write_material(os, model.materials[i]);
+    }
+    os << (model.materials.empty() ? "]" : "\n      ]") << "\n    }";
+}
+
+}  // anonymous namespace
+
+void EnableMemoryReport(bool value) noexcept {
+    enabled = value;
+}
+
+bool IsMemoryReportEnabled() noexcept {
+    return enabled;
+}
+
+void WriteMemoryReport(std::ostream &os, const MemoryReport &report) {
+    os << "{\n  \"bufferBytes\": " << report.bufferBytes
+       << ",\n  \"textureBytes\": " << report.textureBytes
+       << ",\n  \"cpuBytes\": " << report.cpuBytes
+       << ",\n  \"budget\": " << report.budget
+       << ",\n  \"residentBytes\": " << report.residentBytes
+       << ",\n  \"models\": [";
+    for (auto i = 0u; i < report.models.size(); ++i) {
+        os << (i > 0 ? ",\n" : "\n");
+        write_model(os, report.models[i]);
+    }
+    os << (report.models.empty() ? "]" : "\n  ]") << "\n}" << std::endl;
+}
+
+}  // namespace bgl
@@ -0,0 +1,72 @@
+/**
+ * @file memory_report.hpp
+ * @brief CPU and GPU memory of loaded models broken down by mesh, material and texture.
+ */
+#ifndef GFX_MEMORY_REPORT_HPP_
+#define GFX_MEMORY_REPORT_HPP_
+
+#include <cstddef>  // std::size_t
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace bgl {
+
+/**
+ * @brief Prints a memory report as JSON once all models given on the command line are loaded.
+ */
+void EnableMemoryReport(bool enabled = true) noexcept;
+bool IsMemoryReportEnabled() noexcept;
+
+struct TextureMemory {
+    std::string slot;  // e.g. "diffuse"
+    std::string path;  // empty if the texture was not loaded by the ResourceManager
+    std::size_t gpuBytes;  // of its resident mip levels
+    std::optional<unsigned> residentLevel;  // finest resident mip level if the texture is streamed
+    std::size_t users;  // models referencing the texture
+};
+
+struct MaterialMemory {
+    std::vector<TextureMemory> textures;
+    std::size_t gpuBytes;
+};
+
+struct MeshMemory {
+    std::optional<unsigned int> materialIndex;
+    std::size_t vertexBytes;    // VBO including tangents and instance matrices
+    std::size_t indexBytes;     // IBO
+    std::size_t meshletBytes;   // CPU
+    std::size_t occluderBytes;  // CPU
+    std::size_t instances;      // 1 unless the mesh is instanced
+};
+
+struct ModelMemory {
+    std::string path;
+    std::string type;  // "mesh", "paged" or "point cloud"
+    bool inScene;      // false if the model is only kept cached
+    std::vector<MeshMemory> meshes;  // empty for paged models and point clouds
+    std::vector<MaterialMemory> materials;
+    std::size_t bufferBytes;   // GPU
+    std::size_t textureBytes;  // GPU, textures shared with other models are included
+    std::size_t cpuBytes;
+};
+
+/**
+ * @note Textures shared by several models are counted once in the totals.
+ */
+struct MemoryReport {
+    std::vector<ModelMemory> models;
+    std::size_t bufferBytes;   // GPU
+    std::size_t textureBytes;  // GPU
+    std::size_t cpuBytes;      // CPU copies of meshes
+    std::size_t budget;        // of the ResourceManager
+    std::size_t residentBytes;  // of the process
+};
+
+void WriteMemoryReport(std::ostream &os, const MemoryReport &report);  // as JSON
+
+}  // namespace bgl
+
+#endif  // GFX_MEMORY_REPORT_HPP_
@@ -1,5 +1,6 @@
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 
 #include "mesh.hpp"
 
@@ -8,7 +9,12 @@ namespace bgl {
 
 Mesh::Mesh()
     : _vbo { QOpenGLBuffer::VertexBuffer },
-      _ibo { QOpenGLBuffer::IndexBuffer } {
+      _ibo { QOpenGLBuffer::IndexBuffer },
+      _tangents { QOpenGLBuffer::VertexBuffer },
+      _instances { QOpenGLBuffer::VertexBuffer },
+      _instanceCount { 0 },
+      _vertexBytes { 0 },
+      _indexBytes { 0 } {
     if (!_vbo.create()) {
         throw std::runtime_error { "could not create VBO" };
     }
@@ -22,7 +28,11 @@ Mesh::Mesh()
 
 void Mesh::render(GLenum mode, GLuint count) {
     bind();
-    glDrawElements(mode, count, GL_UNSIGNED_INT, nullptr);
+    if (_instanceCount > 0) {
+        glDrawElementsInstanced(mode, count, GL_UNSIGNED_INT, nullptr, _instanceCount);
+    } else {
+        glDrawElements(mode, count, GL_UNSIGNED_INT, nullptr);
+    }
     if (glGetError() != GL_NO_ERROR) {
         throw std::runtime_error { "glDrawElements() failed" };
     }
@@ -30,8 +40,39 @@ void Mesh::render(GLenum mode, GLuint count) {
 }
 
 void Mesh::render(GLenum mode) {
-    _ibo.bind();  // for each @p _ibo.size()
-    render(mode, static_cast<GLuint>(_ibo.size()) / sizeof(GLuint));
+    render(mode, static_cast<GLuint>(_indexBytes / sizeof(GLuint)));
+}
+
+void Mesh::renderMeshlets(GLenum mode, const glm::vec4 (&planes)[6], const vec3 &camera) {
+    // reused by all meshes, meshes are only drawn on the GUI thread
+    static std::vector<GLsizei> counts;
+    static std::vector<const void*> offsets;
+    counts.clear();
+    offsets.clear();
+
+    GLuint end { 0 };  // of the last visible meshlet
+    for (auto &meshlet : _meshlets) {
+        if (!IsMeshletVisible(meshlet, planes, camera)) {
+            continue;
+        }
+        if (!counts.empty() && meshlet.firstIndex == end) {
+            counts.back() += static_cast<GLsizei>(meshlet.indexCount);  // adjacent ranges are merged
+        } else {
+            counts.push_back(static_cast<GLsizei>(meshlet.indexCount));
+            offsets.push_back(reinterpret_cast<const void*>(std::size_t { meshlet.firstIndex } * sizeof(GLuint)));
+        }
+        end = meshlet.firstIndex + meshlet.indexCount;
+    }
+    if (counts.empty()) {
+        return;
+    }
+
+    bind();
+    glMultiDrawElements(mode, counts.data(), GL_UNSIGNED_INT, offsets.data(), static_cast<GLsizei>(counts.size()));
+    if (glGetError() != GL_NO_ERROR) {
+        throw std::runtime_error { "glMultiDrawElements() failed" };
+    }
+    release();
 }
 
 void Mesh::bind() {
@@ -1,9 +1,14 @@
 #ifndef GFX_MESH_HPP_
 #define GFX_MESH_HPP_
 
+#include <cstddef>  // std::size_t
+#include <memory>   // std::shared_ptr
 #include <optional>
+#include <vector>
 
 #include "gl.hpp"
+#include "bounding_box.hpp"
+#include "meshlet.hpp"
 
 #include <QOpenGLBuffer>             // NOLINT
 #include <QOpenGLVertexArrayObject>  // NOLINT
@@ -20,6 +25,14 @@ struct Vertex {
     vec2 texcoords;
 };
 
+/**
+ * @brief CPU copy of the triangles of a mesh for software occlusion culling.
+ */
+struct OccluderGeometry {
+    std::vector<vec3> positions;
+    std::vector<GLuint> indices;
+};
+
 /**
  * @brief Contains and manages all OpenGL resources (VBOs, IBOs, VAOs,
  *        shaders and textures) for a mesh.
@@ -40,10 +53,23 @@ struct Mesh {
 	void render(GLenum mode, GLuint count);
 	void render(GLenum mode);
 
+	/**
+	 * @brief Draws the meshlets that pass IsMeshletVisible() with one glMultiDrawElements().
+	 */
+	void renderMeshlets(GLenum mode, const glm::vec4 (&planes)[6], const vec3 &camera);
+
 	QOpenGLBuffer _vbo;
 	QOpenGLBuffer _ibo;
+	QOpenGLBuffer _tangents;  // a glm::vec4 per vertex, only created for meshes with a normal map
+	QOpenGLBuffer _instances;  // a model matrix per instance, only created for instanced meshes
+	GLsizei _instanceCount;  // 0 if the mesh is drawn once without a model matrix
+	std::size_t _vertexBytes;  // of _vbo, set on allocation since QOpenGLBuffer::size() is an int
+	std::size_t _indexBytes;   // of _ibo
 	QOpenGLVertexArrayObject _vao;
 	std::optional<unsigned int> _materialIndex;  // index to an Assimp material
+	BoundingBox _boundingBox;
+	std::vector<Meshlet> _meshlets;  // empty if they were not built on import
+	std::shared_ptr<const OccluderGeometry> _occluder;  // nullptr if too detailed to occlude
 };
 
 }  // namespace bgl
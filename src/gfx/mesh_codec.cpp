@@ -0,0 +1,604 @@
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // __SSE2__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>  // std::memcpy()
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+#include "mesh_codec.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr GLuint None { ~GLuint { 0 } };
+constexpr std::uint32_t CacheSize { 16 };  // vertices of the simulated post-transform cache
+
+constexpr std::size_t GroupSize { 16 };   // bytes sharing one bit width
+constexpr std::size_t BlockSize { 256 };  // vertices or indices whose bytes are encoded together
+constexpr std::size_t MaxStride { 256 };
+constexpr std::uint8_t VertexFormat { 0xA1 };  // first byte of every encoded buffer
+constexpr std::uint8_t IndexFormat { 0xE1 };
+constexpr unsigned Bits[4] { 0, 2, 4, 8 };  // per value of a group, selected by its 2-bit header
+
+std::atomic<bool> report { false };
+
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+std::runtime_error make_error() {
+    return std::runtime_error { "corrupt mesh data" };
+}
+
+inline std::uint8_t zigzag(std::uint8_t value) noexcept {
+    return static_cast<std::uint8_t>((value << 1) ^ (static_cast<std::int8_t>(value) >> 7));
+}
+
+inline std::uint8_t unzigzag(std::uint8_t value) noexcept {
+    return static_cast<std::uint8_t>((value >> 1) ^ -(value & 1));
+}
+
+inline std::uint32_t zigzag(std::uint32_t value) noexcept {
+    return (value << 1) ^ (0u - (value >> 31));
+}
+
+inline std::uint32_t unzigzag(std::uint32_t value) noexcept {
+    return (value >> 1) ^ (0u - (value & 1));
+}
+
+/*********************************************************
+ *                     Vertex Order                      *
+ *********************************************************/
+
+/**
+ * @brief The triangles around each vertex in compressed sparse rows.
+ */
+struct Adjacency {
+    std::pmr::vector<GLuint> offsets;  // per vertex and one past the last
+    std::pmr::vector<GLuint> triangles;
+
+    Adjacency(const std::vector<GLuint> &indices, std::size_t vertex_count, std::pmr::memory_resource *memory)
+        : offsets(vertex_count + 1, 0, memory), triangles(indices.size(), memory) {
+        for (auto index : indices) {
+            ++offsets[index + 1];
+        }
+        for (auto i = 1u; i < offsets.size(); ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+        std::pmr::vector<GLuint> fill { offsets.begin(), offsets.end() - 1, memory };
+        for (auto i = 0u; i < indices.size(); ++i) {
+            triangles[fill[indices[i]]++] = static_cast<GLuint>(i / 3);
+        }
+    }
+};
+
+/*********************************************************
+ *                      Byte Groups                      *
+ *********************************************************/
+
+/**
+ * @brief Appends a stream of bytes as groups of @p GroupSize values with the smallest bit width
+ *        that holds all of them, preceded by the 2-bit widths of all groups.
+ * @details The bits of a group are interleaved, so that SSE2 can unpack them with shifts and masks:
+ *          with 2 bits, byte j holds the values j, j + 4, j + 8 and j + 12, with 4 bits, byte j
+ *          holds the values j and j + 8.
+ */
+void encode_stream(const std::uint8_t *values, std::size_t group_count, std::vector<std::uint8_t> &output) {
+    const std::size_t header { output.size() };
+    output.resize(output.size() + (group_count + 3) / 4, 0);
+
+    for (auto g = 0u; g < group_count; ++g) {
+        const std::uint8_t *group { values + g * GroupSize };
+        const std::uint8_t max { *std::max_element(group, group + GroupSize) };
+        const unsigned code { max == 0 ? 0u : max < 4 ? 1u : max < 16 ? 2u : 3u };
+        output[header + g / 4] |= static_cast<std::uint8_t>(code << (2 * (g % 4)));
+
+        const unsigned bits { Bits[code] };
+        if (bits == 8) {
+            output.insert(output.end(), group, group + GroupSize);
+        } else if (bits > 0) {
+            const unsigned values_per_byte { 8 / bits };
+            const std::size_t stride { GroupSize / values_per_byte };
+            for (auto j = 0u; j < stride; ++j) {
+                std::uint8_t byte { 0 };
+                for (auto k = 0u; k < values_per_byte; ++k) {
+                    byte = static_cast<std::uint8_t>(byte | (group[j + k * stride] << (k * bits)));
+                }
+                output.push_back(byte);
+            }
+        }
+    }
+}
+
+#if defined(__SSE2__)
+
+__m128i unpack_group(const std::uint8_t *data, unsigned code) noexcept {
+    switch (code) {
+        case 0:
+            return _mm_setzero_si128();
+        case 1: {
+            int packed;
+            std::memcpy(&packed, data, sizeof(packed));
+            const __m128i v { _mm_cvtsi32_si128(packed) };
+            const __m128i mask { _mm_set1_epi8(0x03) };
+            const __m128i a { _mm_and_si128(v, mask) };
+            const __m128i b { _mm_and_si128(_mm_srli_epi16(v, 2), mask) };
+            const __m128i c { _mm_and_si128(_mm_srli_epi16(v, 4), mask) };
+            const __m128i d { _mm_and_si128(_mm_srli_epi16(v, 6), mask) };
+            return _mm_unpacklo_epi64(_mm_unpacklo_epi32(a, b), _mm_unpacklo_epi32(c, d));
+        }
+        case 2: {
+            const __m128i v { _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data)) };
+            const __m128i mask { _mm_set1_epi8(0x0F) };
+            return _mm_unpacklo_epi64(_mm_and_si128(v, mask), _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+        }
+        default:
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    }
+}
+
+/**
+ * @brief Undoes zigzag() and adds up the differences of 16 bytes, starting at @p last.
+ */
+__m128i integrate(__m128i v, __m128i last) noexcept {
+    const __m128i sign { _mm_sub_epi8(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi8(1))) };
+    v = _mm_xor_si128(_mm_and_si128(_mm_srli_epi16(v, 1), _mm_set1_epi8(0x7F)), sign);
+    v = _mm_add_epi8(v, _mm_slli_si128(v, 1));
+    v = _mm_add_epi8(v, _mm_slli_si128(v, 2));
+    v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+    v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+    return _mm_add_epi8(v, last);
+}
+
+__m128i broadcast_last(__m128i v) noexcept {
+    const __m128i high { _mm_shufflehi_epi16(_mm_unpackhi_epi8(v, v), 0xFF) };
+    return _mm_shuffle_epi32(high, 0xFF);
+}
+
+#else
+
+void unpack_group(const std::uint8_t *data, unsigned code, std::uint8_t *values) noexcept {
+    const unsigned bits { Bits[code] };
+    if (bits == 0) {
+        std::fill_n(values, GroupSize, 0);
+    } else if (bits == 8) {
+        std::copy_n(data, GroupSize, values);
+    } else {
+        const unsigned values_per_byte { 8 / bits };
+        const std::size_t stride { GroupSize / values_per_byte };
+        const unsigned mask { (1u << bits) - 1 };
+        for (auto j = 0u; j < stride; ++j) {
+            for (auto k = 0u; k < values_per_byte; ++k) {
+                values[j + k * stride] = static_cast<std::uint8_t>((data[j] >> (k * bits)) & mask);
+            }
+        }
+    }
+}
+
+#endif  // __SSE2__
+
+/**
+ * @brief Decodes a stream written by encode_stream().
+ * @param last if set, the values are the zigzag() encoded differences to their predecessors,
+ *             starting at @p *last, which is updated to the last value
+ */
+void decode_stream(const std::uint8_t *&data, const std::uint8_t *end, std::size_t group_count,
+                   std::uint8_t *values, std::uint8_t *last) {
+    const std::uint8_t *header { data };
+    if (static_cast<std::size_t>(end - data) < (group_count + 3) / 4) {
+        throw make_error();
+    }
+    data += (group_count + 3) / 4;
+
+#if defined(__SSE2__)
+    __m128i previous { _mm_set1_epi8(static_cast<char>(last ? *last : 0)) };
+#endif  // __SSE2__
+    for (auto g = 0u; g < group_count; ++g) {
+        const unsigned code { (header[g / 4] >> (2 * (g % 4))) & 3u };
+        const std::size_t size { Bits[code] * GroupSize / 8 };
+        if (static_cast<std::size_t>(end - data) < size) {
+            throw make_error();
+        }
+        std::uint8_t *group { values + g * GroupSize };
+#if defined(__SSE2__)
+        __m128i v { unpack_group(data, code) };
+        if (last) {
+            v = integrate(v, previous);
+            previous = broadcast_last(v);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(group), v);
+#else
+        unpack_group(data, code, group);
+        if (last) {
+            for (auto i = 0u; i < GroupSize; ++i) {
+                group[i] = *last = static_cast<std::uint8_t>(*last + unzigzag(group[i]));
+            }
+        }
+#endif  // __SSE2__
+        data += size;
+    }
+#if defined(__SSE2__)
+    if (last) {
+        *last = static_cast<std::uint8_t>(_mm_cvtsi128_si32(previous));
+    }
+#endif  // __SSE2__
+}
+
+/**
+ * @brief Interleaves the byte streams of a block into vertices.
+ * @param streams stream k holds byte k of every vertex, at k * BlockSize
+ */
+void interleave(const std::uint8_t *streams, std::size_t count, std::size_t stride, std::uint8_t *vertices) {
+    std::size_t begin { 0 };
+#if defined(__SSE2__)
+    // 16 bytes of 16 vertices at a time, transposed by four rounds of byte interleaving
+    if (stride % 16 == 0) {
+        for (; begin + 16 <= count; begin += 16) {
+            for (auto k = 0u; k < stride; k += 16) {
+                __m128i rows[16];
+                for (auto r = 0u; r < 16; ++r) {
+                    rows[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(streams + (k + r) * BlockSize + begin));
+                }
+                for (auto round = 0; round < 4; ++round) {
+                    __m128i next[16];
+                    for (auto j = 0u; j < 8; ++j) {
+                        next[2 * j] = _mm_unpacklo_epi8(rows[j], rows[j + 8]);
+                        next[2 * j + 1] = _mm_unpackhi_epi8(rows[j], rows[j + 8]);
+                    }
+                    std::copy(std::begin(next), std::end(next), std::begin(rows));
+                }
+                for (auto r = 0u; r < 16; ++r) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(vertices + (begin + r) * stride + k), rows[r]);
+                }
+            }
+        }
+    }
+#endif  // __SSE2__
+    for (auto i = begin; i < count; ++i) {
+        for (auto k = 0u; k < stride; ++k) {
+            vertices[i * stride + k] = streams[k * BlockSize + i];
+        }
+    }
+}
+
+/**
+ * @brief Combines the four byte streams of a block into indices and adds up their differences.
+ */
+void combine(const std::uint8_t *streams, std::size_t count, GLuint &previous, GLuint *indices) {
+    std::size_t begin { 0 };
+#if defined(__SSE2__)
+    __m128i last { _mm_set1_epi32(static_cast<int>(previous)) };
+    const __m128i one { _mm_set1_epi32(1) };
+    for (; begin + 16 <= count; begin += 16) {
+        __m128i bytes[4];
+        for (auto b = 0u; b < 4; ++b) {
+            bytes[b] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(streams + b * BlockSize + begin));
+        }
+        const __m128i low[2] { _mm_unpacklo_epi8(bytes[0], bytes[1]), _mm_unpackhi_epi8(bytes[0], bytes[1]) };
+        const __m128i high[2] { _mm_unpacklo_epi8(bytes[2], bytes[3]), _mm_unpackhi_epi8(bytes[2], bytes[3]) };
+        for (auto q = 0u; q < 4; ++q) {
+            __m128i v { q % 2 == 0 ? _mm_unpacklo_epi16(low[q / 2], high[q / 2])
+                                   : _mm_unpackhi_epi16(low[q / 2], high[q / 2]) };
+            v = _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, one)));
+            v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+            v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+            v = _mm_add_epi32(v, last);
+            last = _mm_shuffle_epi32(v, 0xFF);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(indices + begin + q * 4), v);
+        }
+    }
+    previous = static_cast<GLuint>(_mm_cvtsi128_si32(last));
+#endif  // __SSE2__
+    for (auto i = begin; i < count; ++i) {
+        const std::uint32_t value { std::uint32_t { streams[i] } | std::uint32_t { streams[BlockSize + i] } << 8 |
+                                    std::uint32_t { streams[2 * BlockSize + i] } << 16 |
+                                    std::uint32_t { streams[3 * BlockSize + i] } << 24 };
+        indices[i] = previous += unzigzag(value);
+    }
+}
+
+inline std::size_t get_group_count(std::size_t count) noexcept {
+    return (count + GroupSize - 1) / GroupSize;
+}
+
+/*********************************************************
+ *                       Benchmark                       *
+ *********************************************************/
+
+/**
+ * @brief A wavy grid of @p size x @p size vertices whose triangles are shuffled.
+ */
+void create_grid(unsigned size, std::vector<Vertex> &vertices, std::vector<GLuint> &indices) {
+    vertices.resize(std::size_t { size } * size);
+    for (auto y = 0u; y < size; ++y) {
+        for (auto x = 0u; x < size; ++x) {
+            const vec2 uv { static_cast<float>(x) / static_cast<float>(size - 1),
+                            static_cast<float>(y) / static_cast<float>(size - 1) };
+            const float height { 0.1f * std::sin(uv.x * 20.0f) * std::cos(uv.y * 20.0f) };
+            const vec3 normal { -2.0f * std::cos(uv.x * 20.0f) * std::cos(uv.y * 20.0f), 1.0f,
+                                 2.0f * std::sin(uv.x * 20.0f) * std::sin(uv.y * 20.0f) };
+            vertices[std::size_t { y } * size + x] = { vec3 { uv.x * 2.0f - 1.0f, height, uv.y * 2.0f - 1.0f },
+                                                       glm::normalize(normal), uv };
+        }
+    }
+
+    std::vector<std::size_t> cells(std::size_t { size - 1 } * (size - 1));
+    for (auto i = 0u; i < cells.size(); ++i) {
+        cells[i] = i;
+    }
+    std::shuffle(cells.begin(), cells.end(), std::mt19937 { 42 });  // like an unoptimized import
+    indices.clear();
+    indices.reserve(cells.size() * 6);
+    for (auto cell : cells) {
+        const auto corner { static_cast<GLuint>(cell / (size - 1) * size + cell % (size - 1)) };
+        indices.insert(indices.end(), { corner, corner + size, corner + 1,
+                                        corner + 1, corner + size, corner + size + 1 });
+    }
+}
+
+}  // anonymous namespace
+
+void EnableCodecReport(bool enabled) noexcept {
+    report = enabled;
+}
+
+bool IsCodecReportEnabled() noexcept {
+    return report;
+}
+
+void OptimizeVertexCache(std::vector<GLuint> &indices, std::size_t vertexCount,
+                         std::pmr::memory_resource *memory) {
+    const Adjacency adjacency { indices, vertexCount, memory };
+    std::pmr::vector<GLuint> live(vertexCount, memory);  // triangles not emitted yet
+    for (auto i = 0u; i < vertexCount; ++i) {
+        live[i] = adjacency.offsets[i + 1] - adjacency.offsets[i];
+    }
+
+    std::pmr::vector<std::uint32_t> timestamps(vertexCount, 0, memory);  // when a vertex last entered the cache
+    std::pmr::vector<bool> emitted(indices.size() / 3, false, memory);
+    std::pmr::vector<GLuint> dead_ends { memory };  // recently used vertices to continue with if a fan ends
+    std::pmr::vector<GLuint> candidates { memory };
+    std::vector<GLuint> reordered;
+    reordered.reserve(indices.size());
+    std::uint32_t time { CacheSize + 1 };
+    std::size_t cursor { 0 };  // vertices in input order once the dead-end stack is exhausted
+
+    const auto next_vertex = [&] () -> GLuint {
+        // the candidate that stays in the cache for all its remaining triangles, oldest first
+        GLuint best { None };
+        std::int64_t best_priority { -1 };
+        for (auto vertex : candidates) {
+            if (live[vertex] == 0) {
+                continue;
+            }
+            const std::uint32_t age { time - timestamps[vertex] };
+            const std::int64_t priority { age + 2 * live[vertex] <= CacheSize ? age : 0 };
+            if (priority > best_priority) {
+                best = vertex;
+                best_priority = priority;
+            }
+        }
+        if (best != None) {
+            return best;
+        }
+
+        while (!dead_ends.empty()) {
+            const GLuint vertex { dead_ends.back() };
+            dead_ends.pop_back();
+            if (live[vertex] > 0) {
+                return vertex;
+            }
+        }
+        for (; cursor < vertexCount; ++cursor) {
+            if (live[cursor] > 0) {
+                return static_cast<GLuint>(cursor);
+            }
+        }
+        return None;
+    };
+
+    for (GLuint fan { next_vertex() }; fan != None; fan = next_vertex()) {
+        candidates.clear();
+        for (auto i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; ++i) {
+            const GLuint triangle { adjacency.triangles[i] };
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = true;
+            for (auto corner = 0u; corner < 3; ++corner) {
+                const GLuint vertex { indices[std::size_t { triangle } * 3 + corner] };
+                reordered.push_back(vertex);
+                dead_ends.push_back(vertex);
+                candidates.push_back(vertex);
+                --live[vertex];
+                if (time - timestamps[vertex] > CacheSize) {
+                    timestamps[vertex] = time++;
+                }
+            }
+        }
+    }
+    indices = std::move(reordered);
+}
+
+void OptimizeVertexFetch(std::vector<GLuint> &indices, std::vector<Vertex> &vertices,
+                         std::pmr::memory_resource *memory) {
+    std::pmr::vector<GLuint> remap(vertices.size(), None, memory);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+    for (auto &index : indices) {
+        if (remap[index] == None) {
+            remap[index] = static_cast<GLuint>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices = std::move(reordered);
+}
+
+std::vector<std::uint8_t> EncodeIndexBuffer(const std::vector<GLuint> &indices) {
+    std::vector<std::uint8_t> output { IndexFormat };
+    std::uint8_t streams[4][BlockSize];
+    GLuint previous { 0 };
+    for (std::size_t first = 0; first < indices.size(); first += BlockSize) {
+        const std::size_t count { std::min(BlockSize, indices.size() - first) };
+        const std::size_t group_count { get_group_count(count) };
+        for (auto i = 0u; i < group_count * GroupSize; ++i) {
+            const std::uint32_t value { i < count ? zigzag(indices[first + i] - previous) : 0u };
+            if (i < count) {
+                previous = indices[first + i];
+            }
+            for (auto b = 0u; b < 4; ++b) {
+                streams[b][i] = static_cast<std::uint8_t>(value >> (8 * b));
+            }
+        }
+        for (auto &stream : streams) {
+            encode_stream(stream, group_count, output);
+        }
+    }
+    return output;
+}
+
+void DecodeIndexBuffer(GLuint *indices, std::size_t count, const std::uint8_t *data, std::size_t size) {
+    if (size == 0 || data[0] != IndexFormat) {
+        throw make_error();
+    }
+    const std::uint8_t *end { data + size };
+    ++data;
+
+    alignas(16) std::uint8_t streams[4 * BlockSize];
+    GLuint previous { 0 };
+    for (std::size_t first = 0; first < count; first += BlockSize) {
+        const std::size_t block_count { std::min(BlockSize, count - first) };
+        for (auto b = 0u; b < 4; ++b) {
+            decode_stream(data, end, get_group_count(block_count), streams + b * BlockSize, nullptr);
+        }
+        combine(streams, block_count, previous, indices + first);
+    }
+    if (data != end) {
+        throw make_error();
+    }
+}
+
+std::vector<std::uint8_t> EncodeVertexBuffer(const void *vertices, std::size_t count, std::size_t stride) {
+    if (stride == 0 || stride > MaxStride) {
+        throw std::runtime_error { "unsupported vertex size " + std::to_string(stride) };
+    }
+    const auto *bytes { static_cast<const std::uint8_t*>(vertices) };
+    std::vector<std::uint8_t> output { VertexFormat };
+    std::vector<std::uint8_t> last(stride, 0);
+    std::uint8_t stream[BlockSize];
+    for (std::size_t first = 0; first < count; first += BlockSize) {
+        const std::size_t block_count { std::min(BlockSize, count - first) };
+        const std::size_t group_count { get_group_count(block_count) };
+        for (auto k = 0u; k < stride; ++k) {
+            for (auto i = 0u; i < block_count; ++i) {
+                const std::uint8_t value { bytes[(first + i) * stride + k] };
+                stream[i] = zigzag(static_cast<std::uint8_t>(value - last[k]));
+                last[k] = value;
+            }
+            std::fill(stream + block_count, stream + group_count * GroupSize, 0);
+            encode_stream(stream, group_count, output);
+        }
+    }
+    return output;
+}
+
+void DecodeVertexBuffer(void *vertices, std::size_t count, std::size_t stride,
+                        const std::uint8_t *data, std::size_t size) {
+    if (stride == 0 || stride > MaxStride || size == 0 || data[0] != VertexFormat) {
+        throw make_error();
+    }
+    const std::uint8_t *end { data + size };
+    ++data;
+
+    auto *output { static_cast<std::uint8_t*>(vertices) };
+    std::vector<std::uint8_t> streams(stride * BlockSize);
+    std::vector<std::uint8_t> last(stride, 0);
+    for (std::size_t first = 0; first < count; first += BlockSize) {
+        const std::size_t block_count { std::min(BlockSize, count - first) };
+        for (auto k = 0u; k < stride; ++k) {
+            decode_stream(data, end, get_group_count(block_count), &streams[k * BlockSize], &last[k]);
+        }
+        interleave(streams.data(), block_count, stride, output + first * stride);
+    }
+    if (data != end) {
+        throw make_error();
+    }
+}
+
+std::size_t GetMaxEncodedCount(std::size_t size, std::size_t stride) noexcept {
+    if (size == 0 || stride == 0) {
+        return 0;
+    }
+    // after the format byte, every byte stream needs at least one header byte per 4 groups
+    return (size - 1) / stride * (4 * GroupSize);
+}
+
+bool RunCodecBenchmark() {
+    constexpr int Repetitions { 5 };  // of decoding, the fastest one counts
+
+    bool valid { true };
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    for (const unsigned size : { 256u, 1024u, 2048u }) {
+        create_grid(size, vertices, indices);
+        OptimizeVertexCache(indices, vertices.size());
+        OptimizeVertexFetch(indices, vertices);
+
+        const Clock::time_point begin { Clock::now() };
+        const std::vector<std::uint8_t> encoded_vertices {
+            EncodeVertexBuffer(vertices.data(), vertices.size(), sizeof(Vertex)) };
+        const std::vector<std::uint8_t> encoded_indices { EncodeIndexBuffer(indices) };
+        const double encode_time { get_milliseconds(begin) };
+
+        std::vector<Vertex> decoded_vertices(vertices.size());
+        std::vector<GLuint> decoded_indices(indices.size());
+        double vertex_time { INFINITY };
+        double index_time { INFINITY };
+        for (auto i = 0; i < Repetitions; ++i) {
+            Clock::time_point start { Clock::now() };
+            DecodeVertexBuffer(decoded_vertices.data(), decoded_vertices.size(), sizeof(Vertex),
+                               encoded_vertices.data(), encoded_vertices.size());
+            vertex_time = std::min(vertex_time, get_milliseconds(start));
+            start = Clock::now();
+            DecodeIndexBuffer(decoded_indices.data(), decoded_indices.size(),
+                              encoded_indices.data(), encoded_indices.size());
+            index_time = std::min(index_time, get_milliseconds(start));
+        }
+        const bool matches {
+            std::memcmp(decoded_vertices.data(), vertices.data(), vertices.size() * sizeof(Vertex)) == 0 &&
+            decoded_indices == indices };
+        valid = valid && matches;
+
+        const std::size_t vertex_bytes { vertices.size() * sizeof(Vertex) };
+        const std::size_t index_bytes { indices.size() * sizeof(GLuint) };
+        const auto throughput = [] (std::size_t bytes, double milliseconds) {
+            return static_cast<double>(bytes) / milliseconds / 1.0e6;  // [GB/s]
+        };
+        std::cout << std::fixed << std::setprecision(2)
+                  << "grid " << size << "x" << size << ": " << vertices.size() << " vertices, "
+                  << indices.size() / 3 << " triangles, "
+                  << (vertex_bytes + index_bytes) / (1024.0 * 1024.0) << " MiB -> "
+                  << (encoded_vertices.size() + encoded_indices.size()) / (1024.0 * 1024.0) << " MiB, "
+                  << "vertices " << static_cast<double>(vertex_bytes) / encoded_vertices.size() << ":1 "
+                  << "at " << throughput(vertex_bytes, vertex_time) << " GB/s, "
+                  << "indices " << static_cast<double>(index_bytes) / encoded_indices.size() << ":1 "
+                  << "at " << throughput(index_bytes, index_time) << " GB/s, "
+                  << "encoded in " << std::setprecision(1) << encode_time << " ms"
+                  << (matches ? "" : " MISMATCH") << std::endl;
+    }
+    return valid;
+}
+
+}  // namespace bgl
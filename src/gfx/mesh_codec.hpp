@@ -0,0 +1,80 @@
+/**
+ * @file mesh_codec.hpp
+ * @brief Lossless compression of vertex and index buffers for the model cache.
+ */
+#ifndef GFX_MESH_CODEC_HPP_
+#define GFX_MESH_CODEC_HPP_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <memory_resource>  // std::pmr::memory_resource
+#include <vector>
+
+#include "gl.hpp"
+#include "mesh.hpp"  // bgl::Vertex
+
+
+namespace bgl {
+
+/**
+ * @brief Prints the compression ratio and decoding throughput of every cached model.
+ */
+void EnableCodecReport(bool enabled = true) noexcept;
+bool IsCodecReportEnabled() noexcept;
+
+/**
+ * @brief Reorders triangles so that they reuse the vertices of their predecessors while those
+ *        are still in the post-transform cache (Tipsify).
+ * @param memory for temporary data, e.g. the arena of an import
+ */
+void OptimizeVertexCache(std::vector<GLuint> &indices, std::size_t vertexCount,
+                         std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+/**
+ * @brief Reorders vertices by their first use, so that indices mostly grow by small steps.
+ * @note Vertices that are not referenced by any triangle are removed.
+ */
+void OptimizeVertexFetch(std::vector<GLuint> &indices, std::vector<Vertex> &vertices,
+                         std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+/**
+ * @brief Encodes the differences between consecutive indices.
+ * @details Works best on buffers optimized by OptimizeVertexCache() and OptimizeVertexFetch().
+ */
+std::vector<std::uint8_t> EncodeIndexBuffer(const std::vector<GLuint> &indices);
+
+/**
+ * @throw std::runtime_error if @p data is not an encoded buffer of @p count indices
+ */
+void DecodeIndexBuffer(GLuint *indices, std::size_t count, const std::uint8_t *data, std::size_t size);
+
+/**
+ * @brief Encodes the bytewise differences between consecutive vertices.
+ * @details Every byte of the vertex layout is stored as a stream of its own, so bytes that
+ *          barely change (e.g. the exponents of positions) compress to almost nothing.
+ */
+std::vector<std::uint8_t> EncodeVertexBuffer(const void *vertices, std::size_t count, std::size_t stride);
+
+/**
+ * @throw std::runtime_error if @p data is not an encoded buffer of @p count vertices
+ */
+void DecodeVertexBuffer(void *vertices, std::size_t count, std::size_t stride,
+                        const std::uint8_t *data, std::size_t size);
+
+/**
+ * @brief Returns the most values of @p stride bytes that an encoded buffer of @p size bytes can hold.
+ * @details Used to reject corrupt counts before a buffer of that size is allocated. Indices are
+ *          encoded with a stride of 4.
+ */
+std::size_t GetMaxEncodedCount(std::size_t size, std::size_t stride) noexcept;
+
+/**
+ * @brief Encodes and decodes synthetic meshes of increasing size and prints the compression
+ *        ratio and the decoding throughput.
+ * @return whether all decoded buffers are bit-exact copies of the encoded ones
+ */
+bool RunCodecBenchmark();
+
+}  // namespace bgl
+
+#endif  // GFX_MESH_CODEC_HPP_
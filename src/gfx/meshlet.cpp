@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>  // INFINITY
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#include "meshlet.hpp"
+#include "mesh.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+bool Enabled { false };
+
+constexpr GLuint None { ~GLuint { 0 } };
+constexpr float Pi { 3.14159265f };
+
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+/**
+ * @brief The triangles around each vertex in compressed sparse rows.
+ */
+struct Adjacency {
+    std::vector<GLuint> offsets;  // per vertex and one past the last
+    std::vector<GLuint> triangles;
+
+    Adjacency(const std::vector<GLuint> &indices, std::size_t vertex_count)
+        : offsets(vertex_count + 1, 0), triangles(indices.size()) {
+        for (auto index : indices) {
+            ++offsets[index + 1];
+        }
+        for (auto i = 1u; i < offsets.size(); ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+        std::vector<GLuint> fill { offsets.begin(), offsets.end() - 1 };
+        for (auto i = 0u; i < indices.size(); ++i) {
+            triangles[fill[indices[i]]++] = static_cast<GLuint>(i / 3);
+        }
+    }
+};
+
+void compute_bounds(Meshlet &meshlet, const std::vector<GLuint> &indices, const std::vector<Vertex> &vertices) {
+    vec3 min { INFINITY };
+    vec3 max { -INFINITY };
+    vec3 normal_sum { 0.0f };
+    std::vector<vec3> normals;
+    normals.reserve(meshlet.indexCount / 3);
+    for (auto i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; i += 3) {
+        const vec3 &a { vertices[indices[i]].position };
+        const vec3 &b { vertices[indices[i + 1]].position };
+        const vec3 &c { vertices[indices[i + 2]].position };
+        min = glm::min(min, glm::min(a, glm::min(b, c)));
+        max = glm::max(max, glm::max(a, glm::max(b, c)));
+
+        const vec3 normal { glm::cross(b - a, c - a) };
+        const float length { glm::length(normal) };
+        if (length > 0.0f) {  // degenerate triangles are never drawn
+            normals.push_back(normal / length);
+            normal_sum += normals.back();
+        }
+    }
+
+    meshlet.center = (min + max) / 2.0f;
+    meshlet.radius = 0.0f;
+    for (auto i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; ++i) {
+        meshlet.radius = std::max(meshlet.radius, glm::distance(meshlet.center, vertices[indices[i]].position));
+    }
+
+    // the cone can only cull if all normals lie within less than a half space
+    meshlet.coneAxis = vec3 { 0.0f, 0.0f, 1.0f };
+    meshlet.coneCutoff = 1.0f;
+    const float sum_length { glm::length(normal_sum) };
+    if (sum_length <= 0.0f) {
+        return;
+    }
+    const vec3 axis { normal_sum / sum_length };
+    float min_dot { 1.0f };
+    for (auto &normal : normals) {
+        min_dot = std::min(min_dot, glm::dot(normal, axis));
+    }
+    if (min_dot > 0.0f) {
+        meshlet.coneAxis = axis;
+        meshlet.coneCutoff = std::sqrt(1.0f - min_dot * min_dot);
+    }
+}
+
+/*********************************************************
+ *                       Benchmark                       *
+ *********************************************************/
+
+/**
+ * @brief Creates a grid of @p size x @p size vertices over a surface, with the triangles in a
+ *        random order like an unoptimized import.
+ */
+template<typename Surface>
+void create_grid(unsigned size, Surface surface, std::vector<Vertex> &vertices, std::vector<GLuint> &indices) {
+    vertices.clear();
+    for (auto y = 0u; y < size; ++y) {
+        for (auto x = 0u; x < size; ++x) {
+            const vec2 uv { static_cast<float>(x) / static_cast<float>(size - 1),
+                            static_cast<float>(y) / static_cast<float>(size - 1) };
+            vertices.push_back({ surface(uv), vec3 { 0.0f }, uv });
+        }
+    }
+
+    std::vector<std::array<GLuint, 3>> triangles;
+    for (auto y = 0u; y + 1 < size; ++y) {
+        for (auto x = 0u; x + 1 < size; ++x) {
+            const GLuint corner { y * size + x };
+            triangles.push_back({ corner, corner + 1, corner + size });
+            triangles.push_back({ corner + 1, corner + size + 1, corner + size });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937 { 42 });
+    indices.clear();
+    for (auto &triangle : triangles) {
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+    }
+}
+
+std::vector<std::array<GLuint, 3>> get_sorted_triangles(const std::vector<GLuint> &indices) {
+    std::vector<std::array<GLuint, 3>> triangles(indices.size() / 3);
+    for (auto i = 0u; i < triangles.size(); ++i) {
+        triangles[i] = { indices[3 * i], indices[3 * i + 1], indices[3 * i + 2] };
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+/**
+ * @brief Checks that the meshlets partition the triangles within the limits of a meshlet and that
+ *        their bounding spheres enclose their vertices.
+ */
+bool check_meshlets(const std::vector<Meshlet> &meshlets, const std::vector<GLuint> &indices,
+                    const std::vector<Vertex> &vertices) {
+    GLuint next { 0 };
+    std::vector<GLuint> distinct;
+    for (auto &meshlet : meshlets) {
+        if (meshlet.firstIndex != next || meshlet.indexCount == 0 || meshlet.indexCount % 3 != 0 ||
+            meshlet.indexCount / 3 > Meshlet::MaxTriangles) {
+            return false;
+        }
+        next += meshlet.indexCount;
+
+        distinct.assign(indices.begin() + meshlet.firstIndex, indices.begin() + next);
+        std::sort(distinct.begin(), distinct.end());
+        distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+        if (distinct.size() > Meshlet::MaxVertices) {
+            return false;
+        }
+        for (auto vertex : distinct) {
+            if (glm::distance(meshlet.center, vertices[vertex].position) > meshlet.radius * 1.0001f) {
+                return false;
+            }
+        }
+    }
+    return next == indices.size();
+}
+
+/**
+ * @brief Counts the meshlets that IsMeshletVisible() culls as back-facing from cameras around the
+ *        mesh and checks that none of their triangles faces the camera.
+ */
+bool check_culling(const std::vector<Meshlet> &meshlets, const std::vector<GLuint> &indices,
+                   const std::vector<Vertex> &vertices, std::size_t &culled) {
+    constexpr int Cameras { 64 };
+    const glm::vec4 everything { 0.0f, 0.0f, 0.0f, 1.0f };  // a plane in front of which everything lies
+    const glm::vec4 planes[6] { everything, everything, everything, everything, everything, everything };
+
+    std::mt19937 random { 42 };
+    std::uniform_real_distribution<float> distribution { -1.0f, 1.0f };
+    culled = 0;
+    for (auto i = 0; i < Cameras; ++i) {
+        const vec3 camera { 3.0f * glm::normalize(vec3 { distribution(random), distribution(random), distribution(random) }) };
+        for (auto &meshlet : meshlets) {
+            if (IsMeshletVisible(meshlet, planes, camera)) {
+                continue;
+            }
+            ++culled;
+            for (auto j = meshlet.firstIndex; j < meshlet.firstIndex + meshlet.indexCount; j += 3) {
+                const vec3 &a { vertices[indices[j]].position };
+                const vec3 normal { glm::cross(vertices[indices[j + 1]].position - a, vertices[indices[j + 2]].position - a) };
+                if (glm::dot(normal, camera - a) > 1e-4f * glm::length(normal) * glm::length(camera - a)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+void SetMeshletCulling(bool enabled) noexcept {
+    Enabled = enabled;
+}
+
+bool IsMeshletCullingEnabled() noexcept {
+    return Enabled;
+}
+
+std::vector<Meshlet> BuildMeshlets(std::vector<GLuint> &indices, const std::vector<Vertex> &vertices) {
+    const std::size_t triangle_count { indices.size() / 3 };
+    const Adjacency adjacency { indices, vertices.size() };
+
+    std::vector<bool> emitted(triangle_count, false);
+    std::vector<GLuint> owner(vertices.size(), None);  // the meshlet a vertex was last added to
+    std::vector<GLuint> reordered;
+    reordered.reserve(triangle_count * 3);
+    std::vector<GLuint> candidates;  // triangles next to the meshlet
+
+    std::vector<Meshlet> meshlets;
+    std::size_t seed { 0 };
+    while (reordered.size() < triangle_count * 3) {
+        while (emitted[seed]) {
+            ++seed;
+        }
+
+        const auto id { static_cast<GLuint>(meshlets.size()) };
+        Meshlet &meshlet { meshlets.emplace_back() };
+        meshlet.firstIndex = static_cast<GLuint>(reordered.size());
+        std::size_t vertex_count { 0 };
+        std::size_t meshlet_triangles { 0 };
+        candidates.clear();
+
+        const auto new_vertices = [&] (std::size_t triangle) {
+            std::size_t count { 0 };
+            for (auto corner = 0u; corner < 3; ++corner) {
+                count += owner[indices[triangle * 3 + corner]] != id ? 1 : 0;
+            }
+            return count;
+        };
+        const auto add = [&] (std::size_t triangle) {
+            emitted[triangle] = true;
+            ++meshlet_triangles;
+            for (auto corner = 0u; corner < 3; ++corner) {
+                const GLuint vertex { indices[triangle * 3 + corner] };
+                reordered.push_back(vertex);
+                if (owner[vertex] != id) {
+                    owner[vertex] = id;
+                    ++vertex_count;
+                    for (auto i = adjacency.offsets[vertex]; i < adjacency.offsets[vertex + 1]; ++i) {
+                        if (!emitted[adjacency.triangles[i]]) {
+                            candidates.push_back(adjacency.triangles[i]);
+                        }
+                    }
+                }
+            }
+        };
+
+        add(seed);
+        while (meshlet_triangles < Meshlet::MaxTriangles) {
+            // the neighbour adding the fewest vertices, dropping those that were emitted meanwhile
+            std::size_t best { triangle_count };
+            std::size_t best_count { 4 };
+            std::size_t kept { 0 };
+            for (auto triangle : candidates) {
+                if (emitted[triangle]) {
+                    continue;
+                }
+                candidates[kept++] = triangle;
+                const std::size_t count { new_vertices(triangle) };
+                if (count < best_count && vertex_count + count <= Meshlet::MaxVertices) {
+                    best = triangle;
+                    best_count = count;
+                }
+            }
+            candidates.resize(kept);
+            if (best == triangle_count) {
+                break;  // no connected triangle fits, so the next meshlet starts elsewhere
+            }
+            add(best);
+        }
+
+        meshlet.indexCount = static_cast<GLuint>(reordered.size()) - meshlet.firstIndex;
+    }
+
+    indices = std::move(reordered);
+    for (auto &meshlet : meshlets) {
+        compute_bounds(meshlet, indices, vertices);
+    }
+    return meshlets;
+}
+
+bool IsMeshletVisible(const Meshlet &meshlet, const glm::vec4 (&planes)[6], const vec3 &camera) noexcept {
+    for (auto &plane : planes) {
+        if (glm::dot(vec3 { plane }, meshlet.center) + plane.w < -meshlet.radius) {
+            return false;
+        }
+    }
+
+    // back-facing if the whole sphere is seen within the cone mirrored around the meshlet
+    const vec3 direction { meshlet.center - camera };
+    return glm::dot(direction, meshlet.coneAxis) < meshlet.coneCutoff * glm::length(direction) + meshlet.radius;
+}
+
+bool RunMeshletBenchmark() {
+    constexpr unsigned Size { 512 };  // vertices along each side of a grid
+    const auto sphere = [] (const vec2 &uv) {
+        const float phi { 2.0f * Pi * uv.x }, theta { Pi * uv.y };
+        return vec3 { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+    };
+    const auto terrain = [] (const vec2 &uv) {
+        return vec3 { uv.x * 2.0f - 1.0f, 0.1f * std::sin(uv.x * 20.0f) * std::cos(uv.y * 20.0f), uv.y * 2.0f - 1.0f };
+    };
+
+    bool valid { true };
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    for (auto surface = 0; surface < 2; ++surface) {
+        if (surface == 0) {
+            create_grid(Size, sphere, vertices, indices);
+        } else {
+            create_grid(Size, terrain, vertices, indices);
+        }
+        const std::vector<std::array<GLuint, 3>> triangles { get_sorted_triangles(indices) };
+
+        const Clock::time_point begin { Clock::now() };
+        const std::vector<Meshlet> meshlets { BuildMeshlets(indices, vertices) };
+        const double time { get_milliseconds(begin) };
+
+        std::size_t culled { 0 };
+        const bool matches { get_sorted_triangles(indices) == triangles && check_meshlets(meshlets, indices, vertices) &&
+                             check_culling(meshlets, indices, vertices, culled) };
+        valid = valid && matches;
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << (surface == 0 ? "sphere " : "terrain ") << Size << "x" << Size << ": " << indices.size() / 3
+                  << " triangles -> " << meshlets.size() << " meshlets of "
+                  << static_cast<double>(indices.size()) / 3.0 / meshlets.size() << " triangles on average, built in "
+                  << time << " ms, " << 100.0 * culled / (64.0 * meshlets.size()) << "% culled as back-facing"
+                  << (matches ? "" : " MISMATCH") << std::endl;
+    }
+    return valid;
+}
+
+}  // namespace bgl
@@ -0,0 +1,63 @@
+/**
+ * @file meshlet.hpp
+ * @brief Clusters of triangles with their own bounds for fine-grained culling.
+ */
+#ifndef GFX_MESHLET_HPP_
+#define GFX_MESHLET_HPP_
+
+#include <cstddef>  // std::size_t
+#include <vector>
+
+#include "gl.hpp"
+
+
+namespace bgl {
+
+struct Vertex;
+
+void SetMeshletCulling(bool enabled) noexcept;  // must be set before models are imported
+bool IsMeshletCullingEnabled() noexcept;
+
+/**
+ * @brief A range of triangles in the index buffer of a mesh.
+ * @details The normal cone bounds the normals of all triangles. If the camera lies within the
+ *          cone's mirror image behind the meshlet, all triangles face away from it.
+ */
+struct Meshlet {
+    static constexpr std::size_t MaxVertices { 64 };
+    static constexpr std::size_t MaxTriangles { 124 };
+
+    vec3 center;  // bounding sphere
+    float radius;
+    vec3 coneAxis;
+    float coneCutoff;  // sine of the cone's half angle, 1 if the normals span a half space or more
+    GLuint firstIndex;
+    GLuint indexCount;
+};
+
+/**
+ * @brief Splits a mesh into meshlets and reorders its indices so that each meshlet is a
+ *        contiguous range.
+ * @details Triangles are added greedily, preferring those that share the most vertices with
+ *          the meshlet, so that meshlets are compact and their bounds are tight.
+ */
+std::vector<Meshlet> BuildMeshlets(std::vector<GLuint> &indices, const std::vector<Vertex> &vertices);
+
+/**
+ * @brief Tests a meshlet against the view frustum and its normal cone against the camera.
+ * @param planes normalized frustum planes in model space (see GetFrustumPlanes())
+ * @param camera the camera position in model space
+ */
+bool IsMeshletVisible(const Meshlet &meshlet, const glm::vec4 (&planes)[6], const vec3 &camera) noexcept;
+
+/**
+ * @brief Builds the meshlets of a sphere and a terrain of half a million triangles each and prints
+ *        their sizes, the build times and how many meshlets the cone test culls from random cameras.
+ * @return whether the meshlets partition the triangles within their limits and bounds and the cone
+ *         test never culled a meshlet with a triangle facing the camera
+ */
+bool RunMeshletBenchmark();
+
+}  // namespace bgl
+
+#endif  // GFX_MESHLET_HPP_
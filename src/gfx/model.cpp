@@ -6,12 +6,17 @@
 #include <QOpenGLTexture>
 
 #include <algorithm>
+#include <cmath>  // INFINITY
 #include <iostream>
 #include <list>
+#include <optional>
 #include <string>
 
 #include "model.hpp"
 #include "box.hpp"
+#include "occlusion.hpp"
+#include "texture_streamer.hpp"
+#include "upload_ring.hpp"
 
 
 namespace bgl {
@@ -22,15 +27,6 @@ inline QVector3D to_qt(const glm::vec3 &v) noexcept {
     return { v.x, v.y, v.z };
 }
 
-/*********************************************************
- *                      Lighting Code                    *
- *********************************************************/
-void setupLight(QOpenGLShaderProgram &program /* NOLINT */, const DirectionalLight &light) {
-    program.setUniformValue("light.direction", to_qt(light.direction));
-    program.setUniformValue("light.diffuse", to_qt(light.diffuse));
-    program.setUniformValue("light.ambient", to_qt(light.ambient));
-}
-
 void setupTexture(QOpenGLShaderProgram &program /* NOLINT */, QOpenGLTexture &texture,
                   const std::string &name, GLuint textureUnit = 0) {
     glActiveTexture(GL_TEXTURE0 + textureUnit);
@@ -38,44 +34,213 @@ void setupTexture(QOpenGLShaderProgram &program /* NOLINT */, QOpenGLTexture &te
     program.setUniformValue(name.c_str(), textureUnit);
 }
 
-void setupMaterial(QOpenGLShaderProgram &program /* NOLINT */, const Material &material) {
-    program.setUniformValue("material.ambient", to_qt(material.ambient));
-    program.setUniformValue("material.diffuse", to_qt(material.diffuse));
-    program.setUniformValue("material.specular", to_qt(material.specular));
-    program.setUniformValue("material.shininess", material.shininess);
+/**
+ * @brief The uniform block of a draw call (std140, see main.vs and main.fs).
+ */
+struct DrawConstants {
+    mat4 MVP;
+    mat4 MV;
+    glm::vec4 ambient;
+    glm::vec4 diffuse;
+    glm::vec4 specular;
+    float shininess;
+    GLuint isTextured;
+    float padding[2];
+    GLuint isInstanced;
+    float padding2[3];
+};
+static_assert(sizeof(DrawConstants) == 208, "DrawConstants must match the std140 layout");
+
+void setupMaterial(QOpenGLShaderProgram &program /* NOLINT */, DrawConstants &constants,
+                   const Material &material, bool textured) {
+    constants.ambient = glm::vec4 { material.ambient, 1.0f };
+    constants.diffuse = glm::vec4 { material.diffuse, 1.0f };
+    constants.specular = glm::vec4 { material.specular, 1.0f };
+    constants.shininess = material.shininess;
 
     /**
      * @note There is currently only support for diffuse texture maps. 
      */
-    const GLuint isTextured { material.textures.diffuse != nullptr };
-    program.setUniformValue("material.isTextured", isTextured);
-    if (isTextured) {
-        setupTexture(program, *material.textures.diffuse, "material.texture");
+    constants.isTextured = textured && material.textures.diffuse != nullptr;
+    if (constants.isTextured) {
+        setupTexture(program, *material.textures.diffuse, "diffuseMap");
+    }
+}
+
+/**
+ * @brief Binds the constants of a draw call, which are written into the upload ring.
+ */
+void bindConstants(const DrawConstants &constants) {
+    const UploadRing::Allocation allocation { UploadRing::instance().upload(constants) };
+    glBindBufferRange(GL_UNIFORM_BUFFER, 0, allocation.buffer, allocation.offset, allocation.size);
+}
+
+/*********************************************************
+ *                   Texture Streaming                   *
+ *********************************************************/
+
+/**
+ * @brief Estimates the size of a bounding box on screen in pixels.
+ * @return nothing if the box is off-screen and infinity if it crosses the near plane
+ */
+std::optional<float> get_screen_size(const BoundingBox &box, const mat4 &MVP, const ivec2 &viewport) {
+    vec2 min { INFINITY };
+    vec2 max { -INFINITY };
+    for (auto corner = 0u; corner < 8; ++corner) {
+        const vec3 sign { corner & 1 ? 0.5f : -0.5f, corner & 2 ? 0.5f : -0.5f, corner & 4 ? 0.5f : -0.5f };
+        const glm::vec4 position { MVP * glm::vec4 { box.getCenter() + sign * box.getSize(), 1.0f } };
+        if (position.w <= 1e-4f) {
+            return INFINITY;
+        }
+        const vec2 ndc { vec2 { position.x, position.y } / position.w };
+        min = glm::min(min, ndc);
+        max = glm::max(max, ndc);
+    }
+
+    if (max.x < -1.0f || min.x > 1.0f || max.y < -1.0f || min.y > 1.0f) {
+        return std::nullopt;
+    }
+    const vec2 size { (max - min) * vec2 { viewport } / 2.0f };
+    return std::max(size.x, size.y);
+}
+
+ivec2 get_viewport_size() {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    return { viewport[2], viewport[3] };
+}
+
+/*********************************************************
+ *                       Wireframe                       *
+ *********************************************************/
+
+constexpr float WireframeWidth { 1.5f };  // [pixels]
+
+void setupWireframe(QOpenGLShaderProgram &program /* NOLINT */, RenderMode mode, const ivec2 &viewport) {
+    const vec3 color { mode == RenderMode::Wireframe ? vec3 { 1.0f, 1.0f, 1.0f } : vec3 { 0.0f, 0.0f, 0.0f } };
+    program.setUniformValue("viewportSize", static_cast<float>(viewport.x), static_cast<float>(viewport.y));
+    program.setUniformValue("wireframe.color", to_qt(color));
+    program.setUniformValue("wireframe.width", WireframeWidth);
+    program.setUniformValue("wireframe.isFilled", static_cast<GLuint>(mode != RenderMode::Wireframe));
+}
+
+/**
+ * @brief Requests the mip levels a material's textures need to cover @p pixels on screen.
+ * @note Only the diffuse map is sampled (see setupMaterial()).
+ */
+void request_levels(const Material &material, float pixels) {
+    if (material.textures.diffuse) {
+        TextureStreamer::instance().request(*material.textures.diffuse, pixels);
     }
 }
 
 }  // anonymous namespace
 
 
-void Model::render(const mat4 &MVP, const DirectionalLight &light) {
-     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    _program->bind();
+void Model::render(const mat4 &P, const mat4 &MV, const ClusteredLighting &lighting, RenderMode mode,
+                   OcclusionCuller *occlusion) {
+    _lastRendered = std::chrono::steady_clock::now();
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    // edges are drawn in the same pass by the wireframe variant of the program
+    const bool wireframe { HasWireframe(mode) && _wireframeProgram };
+    QOpenGLShaderProgram &program { wireframe ? *_wireframeProgram : *_program };
+    const bool textured { mode == RenderMode::Textured };
+
+    const mat4 MVP { P * MV };
+    // streamed models select their meshes per frame, the merged buffers have no instance matrices
+    const bool gpu_culling { IsGPUCullingEnabled() && !_meshes.empty() &&
+                             std::none_of(_meshes.begin(), _meshes.end(),
+                                          [] (const Mesh &mesh) { return mesh._instanceCount > 0; }) };
+    if (gpu_culling) {
+        if (!_culling) {
+            _culling = std::make_unique<GPUCulling>(_meshes, _materials);  // merged on first use
+        }
+        _culling->cull(MVP);
+    }
+
+    program.bind();
+    lighting.bind(program);
+
+    DrawConstants constants {};
+    constants.MVP = MVP;
+    constants.MV = MV;
+    const ivec2 viewport { get_viewport_size() };
+    if (wireframe) {
+        setupWireframe(program, mode, viewport);
+    }
 
-    setupLight(*_program, light);
+    const bool blend { wireframe && mode == RenderMode::Wireframe };  // anti-aliased lines only
+    if (blend) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    }
 
-    const QMatrix4x4 matrix { glm::value_ptr(MVP) };
-    _program->setUniformValue("MVP", matrix.transposed());
+    if (gpu_culling) {
+        // the meshes are not culled on the CPU, so the textures are streamed for the whole model
+        const auto pixels { textured ? get_screen_size(_boundingBox, MVP, viewport) : std::nullopt };
+        _culling->render([&](const Material *material) {
+            if (material) {
+                setupMaterial(program, constants, *material, textured);
+                if (pixels) {
+                    request_levels(*material, *pixels);
+                }
+            }
+            bindConstants(constants);
+        });
+        if (blend) {
+            glDisable(GL_BLEND);
+        }
+        return;
+    }
 
     /**
      * @brief Render a mesh for each material as there is is one VBO per material
      * @details http://assimp.sourceforge.net/lib_html/materials.html
      */
-    for (auto i = 0u; i < _meshes.size(); ++i) {
-        if (_meshes[i]._materialIndex.has_value()) {
-            const unsigned int material_index { _meshes[i]._materialIndex.value() };
-            setupMaterial(*_program, _materials[material_index]);
+    glm::vec4 planes[6];
+    GetFrustumPlanes(MVP, planes);
+    const vec3 camera { glm::inverse(MV) * glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f } };  // in model space
+
+    for (Mesh *mesh : select(P, MV)) {
+        if (occlusion && !occlusion->isVisible(mesh->_boundingBox, MVP)) {
+            continue;
+        }
+        if (mesh->_materialIndex.has_value()) {
+            const unsigned int material_index { mesh->_materialIndex.value() };
+            setupMaterial(program, constants, _materials[material_index], textured);
+            const auto pixels { textured ? get_screen_size(mesh->_boundingBox, MVP, viewport) : std::nullopt };
+            if (pixels) {
+                request_levels(_materials[material_index], *pixels);
+            }
+        }
+        constants.isInstanced = mesh->_instanceCount > 0;
+        bindConstants(constants);
+        if (mesh->_meshlets.empty()) {
+            mesh->render(GL_TRIANGLES);
+        } else {
+            mesh->renderMeshlets(GL_TRIANGLES, planes, camera);
+        }
+    }
+
+    if (blend) {
+        glDisable(GL_BLEND);
+    }
+}
+
+const std::vector<Mesh*>& Model::select(const mat4 & /* P */, const mat4 & /* MV */) {
+    _selected.clear();
+    for (auto &mesh : _meshes) {
+        _selected.push_back(&mesh);
+    }
+    return _selected;
+}
+
+void Model::addOccluders(OcclusionCuller &occlusion, const mat4 &MVP) const {
+    for (auto &mesh : _meshes) {
+        if (mesh._occluder) {
+            occlusion.addOccluder(*mesh._occluder, mesh._boundingBox, MVP);
         }
-        _meshes[i].render(GL_TRIANGLES);
     }
 }
 
@@ -2,14 +2,17 @@
 #ifndef GFX_MODEL_HPP_
 #define GFX_MODEL_HPP_
 
+#include <chrono>
 #include <filesystem>
-#include <memory>  // std::shared_ptr
+#include <memory>  // std::shared_ptr, std::unique_ptr
 #include <vector>
 
 #include "gl.hpp"
 #include "mesh.hpp"
 #include "material.hpp"
 #include "bounding_box.hpp"
+#include "gpu_culling.hpp"
+#include "render_mode.hpp"
 #include "scene.hpp"
 
 #include <QOpenGLShaderProgram>  // NOLINT
@@ -17,6 +20,8 @@
 
 namespace bgl {
 
+class OcclusionCuller;
+
 /**
  * @brief An OpenGL renderable mesh.
  */
@@ -32,7 +37,13 @@ class Model {
 	virtual ~Model() noexcept = default;
 
 	virtual void render(const mat4 &MVP);
-	virtual void render(const mat4 &MVP, const DirectionalLight &light);
+	virtual void render(const mat4 &P, const mat4 &MV, const ClusteredLighting &lighting,
+	                    RenderMode mode = RenderMode::Textured, OcclusionCuller *occlusion = nullptr);
+
+	/**
+	 * @brief Adds the meshes that are simple enough as occluder candidates of the current frame.
+	 */
+	void addOccluders(OcclusionCuller &occlusion, const mat4 &MVP) const;
 
 	void resize(const vec3 &dimensions);
 	const BoundingBox& getBoundingBox() const;
@@ -45,6 +56,14 @@ class Model {
 		_program = program;
 	}
 
+	/**
+	 * @brief Sets the variant of the program that also draws triangle edges.
+	 * @note Its vertex attributes must have the same locations as those of the program.
+	 */
+	void setWireframeProgram(std::shared_ptr<QOpenGLShaderProgram> program) {
+		_wireframeProgram = program;
+	}
+
 	void setBoundingBox(const BoundingBox &boundingBox) {
 		_boundingBox = boundingBox;
 	}
@@ -57,16 +76,41 @@ class Model {
 		return _meshes;
 	}
 
+	const std::vector<Material>& getMaterials() const noexcept {
+		return _materials;
+	}
+
 	const std::shared_ptr<QOpenGLShaderProgram> getProgram() const noexcept {
 		return _program;
 	}
 
+	std::chrono::steady_clock::time_point getLastRendered() const noexcept {
+		return _lastRendered;
+	}
+
+	/**
+	 * @brief Returns whether parts of the model are still being read, so that more frames are needed.
+	 */
+	virtual bool isLoading() const noexcept {
+		return false;
+	}
+
  protected:
+	/**
+	 * @brief Returns the meshes to draw in the current frame.
+	 * @note The default selects all meshes.
+	 */
+	virtual const std::vector<Mesh*>& select(const mat4 &P, const mat4 &MV);
+
 	std::vector<Mesh> _meshes;
+	std::vector<Mesh*> _selected;  // see select()
 	std::vector<Material> _materials;
 
 	std::shared_ptr<QOpenGLShaderProgram> _program;
+	std::shared_ptr<QOpenGLShaderProgram> _wireframeProgram;
 	BoundingBox _boundingBox;
+	std::unique_ptr<GPUCulling> _culling;  // only if enabled
+	std::chrono::steady_clock::time_point _lastRendered;
 };
 
 /**
@@ -0,0 +1,391 @@
+#include <unistd.h>  // getpid()
+
+#include <atomic>
+#include <chrono>
+#include <cstring>  // std::memcpy()
+#include <fstream>
+#include <iomanip>  // std::hex
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "model_cache.hpp"
+#include "gfx.hpp"  // bgl::GetCacheDirectory(), bgl::Hash()
+#include "mesh_codec.hpp"
+#include "parallel.hpp"
+#include "tangent_space.hpp"  // bgl::GetCreaseAngle()
+#include "vertex_weld.hpp"    // bgl::GetWeldEpsilon()
+#include "instancing.hpp"     // bgl::IsInstancingEnabled()
+
+
+namespace bgl {
+
+namespace {
+
+constexpr unsigned CacheVersion { 4 };  // increment when the importer or the codec changes
+constexpr char Magic[8] { 'B', 'G', 'L', 'M', 'O', 'D', 'E', 'L' };
+
+std::atomic<bool> enabled { true };
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t meshCount;
+    std::uint32_t materialCount;
+    std::uint32_t vertexSize;  // of the importer's vertex layout
+    float center[3];
+    float size[3];
+};
+
+struct MeshHeader {
+    std::uint32_t vertexCount;
+    std::uint32_t indexCount;
+    std::int32_t materialIndex;  // -1 if the mesh has no material
+    std::uint32_t vertexBytes;   // encoded, followed by the encoded indices and tangents and the raw instances
+    std::uint32_t indexBytes;
+    std::uint32_t tangentBytes;  // 0 if the mesh has no tangents
+    std::uint32_t instanceCount;  // model matrices, 0 if the mesh is not instanced
+    float center[3];
+    float size[3];
+};
+
+static_assert(sizeof(Header) == 48, "the header must not be padded");
+static_assert(sizeof(MeshHeader) == 52, "the mesh header must not be padded");
+
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+std::runtime_error make_error(const std::string &message, const std::filesystem::path &path) {
+    std::ostringstream oss;
+    oss << message << " " << std::quoted(path.string());
+    return std::runtime_error { oss.str() };
+}
+
+std::filesystem::path get_cache_path(const std::filesystem::path &path) {
+    const std::filesystem::path directory { GetCacheDirectory() };
+    if (directory.empty()) {
+        return {};
+    }
+
+    std::ostringstream key;
+    key << std::filesystem::weakly_canonical(path).string() << '|'
+        << std::filesystem::last_write_time(path).time_since_epoch().count() << '|'
+        << std::filesystem::file_size(path) << '|' << CacheVersion << '|' << GetCreaseAngle() << '|'
+        << GetWeldEpsilon() << '|' << IsInstancingEnabled();
+
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << Hash(key.str()) << ".bglm";
+    return directory / "models" / name.str();
+}
+
+void copy(const vec3 &vector, float (&array)[3]) noexcept {
+    for (auto axis = 0; axis < 3; ++axis) {
+        array[axis] = vector[axis];
+    }
+}
+
+/*********************************************************
+ *                      Serialization                    *
+ *********************************************************/
+
+template<typename T>
+void append(std::pmr::vector<std::uint8_t> &buffer, const T &value) {
+    const auto *bytes { reinterpret_cast<const std::uint8_t*>(&value) };
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void append(std::pmr::vector<std::uint8_t> &buffer, const std::string &text) {
+    append(buffer, static_cast<std::uint32_t>(text.size()));
+    buffer.insert(buffer.end(), text.begin(), text.end());
+}
+
+/**
+ * @brief Reads values from a cached file and throws if they exceed it.
+ */
+class Reader {
+ public:
+	Reader(const std::pmr::vector<std::uint8_t> &data, const std::filesystem::path &path)
+	    : _data { data }, _path { path } {}
+
+	const std::uint8_t* skip(std::size_t size) {
+		if (_data.size() - _offset < size) {
+			throw make_error("truncated cached model", _path);
+		}
+		const std::uint8_t *bytes { _data.data() + _offset };
+		_offset += size;
+		return bytes;
+	}
+
+	template<typename T>
+	T read() {
+		T value;
+		std::memcpy(&value, skip(sizeof(T)), sizeof(T));
+		return value;
+	}
+
+	std::string readString() {
+		const auto size { read<std::uint32_t>() };
+		const auto *bytes { reinterpret_cast<const char*>(skip(size)) };
+		return { bytes, bytes + size };
+	}
+
+ private:
+	const std::pmr::vector<std::uint8_t> &_data;
+	const std::filesystem::path &_path;
+	std::size_t _offset { 0 };
+};
+
+MaterialData read_material(Reader &reader) {
+    MaterialData material {};
+    for (vec3 *color : { &material.diffuse, &material.ambient, &material.specular, &material.emissive }) {
+        for (auto c = 0; c < 3; ++c) {
+            (*color)[c] = reader.read<float>();
+        }
+    }
+    material.shininess = reader.read<float>();
+    for (TextureData *texture : { &material.textures.diffuse, &material.textures.ambient,
+                                  &material.textures.specular, &material.textures.emissive }) {
+        texture->path = reader.readString();
+    }
+    return material;
+}
+
+void append(std::pmr::vector<std::uint8_t> &buffer, const MaterialData &material) {
+    for (const vec3 *color : { &material.diffuse, &material.ambient, &material.specular, &material.emissive }) {
+        for (auto c = 0; c < 3; ++c) {
+            append(buffer, (*color)[c]);
+        }
+    }
+    append(buffer, material.shininess);
+    for (const TextureData *texture : { &material.textures.diffuse, &material.textures.ambient,
+                                        &material.textures.specular, &material.textures.emissive }) {
+        append(buffer, texture->path.string());
+    }
+}
+
+std::pmr::vector<std::uint8_t> read_file(const std::filesystem::path &path, std::pmr::memory_resource *memory) {
+    std::ifstream file { path, std::ios::binary };
+    if (!file) {
+        throw make_error("could not open", path);
+    }
+    std::pmr::vector<std::uint8_t> data(std::filesystem::file_size(path), memory);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file) {
+        throw make_error("could not read", path);
+    }
+    return data;
+}
+
+/**
+ * @brief Parses a cached model and decodes its meshes, one mesh per thread.
+ */
+ModelData decode(const std::pmr::vector<std::uint8_t> &data, const std::filesystem::path &path,
+                 std::pmr::memory_resource *memory) {
+    Reader reader { data, path };
+    const auto header { reader.read<Header>() };
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != CacheVersion ||
+        header.vertexSize != sizeof(Vertex)) {
+        throw make_error("outdated cached model", path);
+    }
+
+    ModelData model;
+    model.boundingBox = BoundingBox { vec3 { header.center[0], header.center[1], header.center[2] },
+                                      vec3 { header.size[0], header.size[1], header.size[2] } };
+    for (auto i = 0u; i < header.materialCount; ++i) {
+        model.materials.push_back(read_material(reader));
+    }
+
+    struct Encoded {
+        const std::uint8_t *vertices;
+        std::size_t vertexBytes;
+        const std::uint8_t *indices;
+        std::size_t indexBytes;
+        const std::uint8_t *tangents;
+        std::size_t tangentBytes;
+    };
+    std::pmr::vector<Encoded> encoded { memory };
+    for (auto i = 0u; i < header.meshCount; ++i) {
+        const auto mesh_header { reader.read<MeshHeader>() };
+        const std::uint8_t *vertices { reader.skip(mesh_header.vertexBytes) };
+        const std::uint8_t *indices { reader.skip(mesh_header.indexBytes) };
+        const std::uint8_t *tangents { reader.skip(mesh_header.tangentBytes) };
+        const std::uint8_t *instances { reader.skip(std::size_t { mesh_header.instanceCount } * sizeof(mat4)) };
+
+        // corrupt counts must not allocate more than the encoded buffers can hold
+        if (mesh_header.vertexCount > GetMaxEncodedCount(mesh_header.vertexBytes, sizeof(Vertex)) ||
+            mesh_header.indexCount > GetMaxEncodedCount(mesh_header.indexBytes, sizeof(GLuint)) ||
+            (mesh_header.tangentBytes > 0 &&
+             mesh_header.vertexCount > GetMaxEncodedCount(mesh_header.tangentBytes, sizeof(glm::vec4)))) {
+            throw make_error("corrupt cached model", path);
+        }
+
+        MeshData &mesh { model.meshes.emplace_back() };
+        mesh.vertices.resize(mesh_header.vertexCount);
+        mesh.indices.resize(mesh_header.indexCount);
+        mesh.tangents.resize(mesh_header.tangentBytes > 0 ? mesh_header.vertexCount : 0);
+        if (mesh_header.materialIndex >= 0) {
+            mesh.materialIndex = static_cast<unsigned>(mesh_header.materialIndex);
+        }
+        mesh.boundingBox = BoundingBox {
+            vec3 { mesh_header.center[0], mesh_header.center[1], mesh_header.center[2] },
+            vec3 { mesh_header.size[0], mesh_header.size[1], mesh_header.size[2] } };
+        encoded.push_back({ vertices, mesh_header.vertexBytes, indices, mesh_header.indexBytes,
+                            tangents, mesh_header.tangentBytes });
+        mesh.instances.resize(mesh_header.instanceCount);
+        std::memcpy(mesh.instances.data(), instances, mesh.instances.size() * sizeof(mat4));
+    }
+
+    std::atomic<bool> corrupt { false };  // exceptions must not escape the worker threads
+    parallel_for(0, model.meshes.size(), [&] (std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            MeshData &mesh { model.meshes[i] };
+            try {
+                DecodeVertexBuffer(mesh.vertices.data(), mesh.vertices.size(), sizeof(Vertex),
+                                   encoded[i].vertices, encoded[i].vertexBytes);
+                DecodeIndexBuffer(mesh.indices.data(), mesh.indices.size(),
+                                  encoded[i].indices, encoded[i].indexBytes);
+                if (!mesh.tangents.empty()) {
+                    DecodeVertexBuffer(mesh.tangents.data(), mesh.tangents.size(), sizeof(glm::vec4),
+                                       encoded[i].tangents, encoded[i].tangentBytes);
+                }
+            } catch (const std::runtime_error&) {
+                corrupt = true;
+            }
+        }
+    }, 1);
+    if (corrupt) {
+        throw make_error("corrupt cached model", path);
+    }
+    for (auto &mesh : model.meshes) {
+        for (auto index : mesh.indices) {
+            if (index >= mesh.vertices.size()) {
+                throw make_error("corrupt cached model", path);
+            }
+        }
+    }
+    return model;
+}
+
+std::size_t get_raw_size(const ModelData &model) noexcept {
+    std::size_t size { 0 };
+    for (auto &mesh : model.meshes) {
+        size += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(GLuint) +
+                mesh.tangents.size() * sizeof(glm::vec4);
+    }
+    return size;
+}
+
+void print_report(const std::filesystem::path &path, const char *action, const ModelData &model,
+                  std::size_t encoded_size, double time) {
+    const std::size_t raw_size { get_raw_size(model) };
+    std::cout << std::fixed << std::setprecision(2)
+              << "model " << path.filename().string() << ": " << action << " "
+              << model.meshes.size() << " meshes in " << time << " ms, "
+              << raw_size / (1024.0 * 1024.0) << " MiB -> " << encoded_size / (1024.0 * 1024.0) << " MiB ("
+              << static_cast<double>(raw_size) / static_cast<double>(encoded_size) << ":1), "
+              << static_cast<double>(raw_size) / time / 1.0e6 << " GB/s" << std::endl;
+}
+
+}  // anonymous namespace
+
+void EnableModelCache(bool value) noexcept {
+    enabled = value;
+}
+
+bool IsModelCacheEnabled() noexcept {
+    return enabled;
+}
+
+std::optional<ModelData> ReadCachedModel(const std::filesystem::path &path, std::pmr::memory_resource *memory) {
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+        return std::nullopt;  // reported by the importer
+    }
+    const std::filesystem::path cache_path { get_cache_path(path) };
+    if (cache_path.empty() || !std::filesystem::exists(cache_path, error)) {
+        return std::nullopt;
+    }
+
+    try {
+        const std::pmr::vector<std::uint8_t> data { read_file(cache_path, memory) };
+        const Clock::time_point begin { Clock::now() };
+        ModelData model { decode(data, cache_path, memory) };
+        if (IsCodecReportEnabled()) {
+            print_report(path, "decoded", model, data.size(), get_milliseconds(begin));
+        }
+        return model;
+    } catch (const std::runtime_error &error) {
+        std::cout << "warning: " << error.what() << std::endl;  // import it again
+        return std::nullopt;
+    }
+}
+
+void WriteCachedModel(const std::filesystem::path &path, const ModelData &data,
+                      std::pmr::memory_resource *memory) {
+    const std::filesystem::path cache_path { get_cache_path(path) };
+    if (cache_path.empty()) {
+        return;
+    }
+
+    const Clock::time_point begin { Clock::now() };
+    Header header { {}, CacheVersion, static_cast<std::uint32_t>(data.meshes.size()),
+                    static_cast<std::uint32_t>(data.materials.size()), sizeof(Vertex), {}, {} };
+    std::copy(std::begin(Magic), std::end(Magic), header.magic);
+    copy(data.boundingBox.getCenter(), header.center);
+    copy(data.boundingBox.getSize(), header.size);
+
+    std::pmr::vector<std::uint8_t> buffer { memory };
+    append(buffer, header);
+    for (auto &material : data.materials) {
+        append(buffer, material);
+    }
+    for (auto &mesh : data.meshes) {
+        const std::vector<std::uint8_t> vertices {
+            EncodeVertexBuffer(mesh.vertices.data(), mesh.vertices.size(), sizeof(Vertex)) };
+        const std::vector<std::uint8_t> indices { EncodeIndexBuffer(mesh.indices) };
+        const std::vector<std::uint8_t> tangents {
+            mesh.tangents.empty() ? std::vector<std::uint8_t> {}
+                                  : EncodeVertexBuffer(mesh.tangents.data(), mesh.tangents.size(), sizeof(glm::vec4)) };
+        MeshHeader mesh_header { static_cast<std::uint32_t>(mesh.vertices.size()),
+                                 static_cast<std::uint32_t>(mesh.indices.size()),
+                                 mesh.materialIndex ? static_cast<std::int32_t>(*mesh.materialIndex) : -1,
+                                 static_cast<std::uint32_t>(vertices.size()),
+                                 static_cast<std::uint32_t>(indices.size()),
+                                 static_cast<std::uint32_t>(tangents.size()),
+                                 static_cast<std::uint32_t>(mesh.instances.size()), {}, {} };
+        copy(mesh.boundingBox.getCenter(), mesh_header.center);
+        copy(mesh.boundingBox.getSize(), mesh_header.size);
+        append(buffer, mesh_header);
+        buffer.insert(buffer.end(), vertices.begin(), vertices.end());
+        buffer.insert(buffer.end(), indices.begin(), indices.end());
+        buffer.insert(buffer.end(), tangents.begin(), tangents.end());
+        const auto *instances { reinterpret_cast<const std::uint8_t*>(mesh.instances.data()) };
+        buffer.insert(buffer.end(), instances, instances + mesh.instances.size() * sizeof(mat4));  // not encoded
+    }
+    if (IsCodecReportEnabled()) {
+        print_report(path, "encoded", data, buffer.size(), get_milliseconds(begin));
+    }
+
+    // write to a temporary file first, so concurrent imports never read partial files
+    std::error_code error;
+    std::filesystem::create_directories(cache_path.parent_path(), error);
+    static std::atomic<unsigned> counter { 0 };
+    const std::filesystem::path temporary {
+        cache_path.string() + "." + std::to_string(getpid()) + "." + std::to_string(counter++) + ".tmp" };
+    {
+        std::ofstream file { temporary, std::ios::binary };
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        if (!file) {
+            std::cout << "warning: could not write cached model " << temporary << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, cache_path, error);
+}
+
+}  // namespace bgl
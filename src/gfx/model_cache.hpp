@@ -0,0 +1,42 @@
+/**
+ * @file model_cache.hpp
+ * @brief Imported models stored with compressed meshes, so that Assimp imports a file only once.
+ */
+#ifndef GFX_MODEL_CACHE_HPP_
+#define GFX_MODEL_CACHE_HPP_
+
+#include <filesystem>       // std::filesystem::path
+#include <memory_resource>  // std::pmr::memory_resource
+#include <optional>
+
+#include "importer.hpp"  // bgl::ModelData
+
+
+namespace bgl {
+
+/**
+ * @brief Enables reading and writing the model cache on import, which is the default.
+ */
+void EnableModelCache(bool enabled = true) noexcept;
+bool IsModelCacheEnabled() noexcept;
+
+/**
+ * @brief Reads the cached import of a model file.
+ * @details Meshes are decoded in parallel (see DecodeVertexBuffer()). Only the paths of
+ *          textures are restored, the textures themselves are not imported.
+ * @param memory for the file contents and other temporary data, e.g. the arena of an import
+ * @return std::nullopt if the model is not cached or its cached import is outdated or corrupt
+ */
+std::optional<ModelData> ReadCachedModel(const std::filesystem::path &path,
+                                         std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+/**
+ * @brief Stores an imported model without its meshlets in the cache.
+ * @note Failing to write the cache is not an error, the model is just imported again next time.
+ */
+void WriteCachedModel(const std::filesystem::path &path, const ModelData &data,
+                      std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+}  // namespace bgl
+
+#endif  // GFX_MODEL_CACHE_HPP_
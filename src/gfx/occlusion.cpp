@@ -0,0 +1,357 @@
+#include "gl.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // __SSE2__
+
+#include <algorithm>
+#include <cfloat>  // FLT_MAX
+#include <chrono>
+#include <cmath>
+#include <optional>
+
+#include "occlusion.hpp"
+#include "parallel.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+bool Enabled { false };
+
+constexpr unsigned TilesX { OcclusionCuller::Width / OcclusionCuller::TileWidth };
+constexpr unsigned TilesY { OcclusionCuller::Height / OcclusionCuller::TileHeight };
+constexpr float MinW { 1e-4f };  // nearer vertices are not projected
+constexpr float DepthBias { 1e-3f };  // relative to 1/w, moves tested boxes towards the camera
+
+static_assert(OcclusionCuller::Width % OcclusionCuller::TileWidth == 0, "the buffer consists of whole tiles");
+static_assert(OcclusionCuller::Height % OcclusionCuller::TileHeight == 0, "the buffer consists of whole tiles");
+static_assert(OcclusionCuller::SubtileWidth * OcclusionCuller::TileHeight == 32, "a subtile mask has 32 bits");
+
+using Clock = std::chrono::steady_clock;
+
+inline double elapsed(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+inline vec2 to_screen(const glm::vec4 &clip) noexcept {
+    const vec2 ndc { vec2 { clip.x, clip.y } / clip.w };
+    return (ndc * 0.5f + 0.5f) * vec2 { OcclusionCuller::Width, OcclusionCuller::Height };
+}
+
+struct ScreenRect {
+    vec2 min;
+    vec2 max;
+    float z;  // 1/w of the nearest corner
+};
+
+/**
+ * @return nothing if the box crosses the near plane
+ */
+std::optional<ScreenRect> project(const BoundingBox &box, const mat4 &MVP) {
+    ScreenRect rect { vec2 { INFINITY }, vec2 { -INFINITY }, 0.0f };
+    for (auto corner = 0u; corner < 8; ++corner) {
+        const vec3 sign { corner & 1 ? 0.5f : -0.5f, corner & 2 ? 0.5f : -0.5f, corner & 4 ? 0.5f : -0.5f };
+        const glm::vec4 clip { MVP * glm::vec4 { box.getCenter() + sign * box.getSize(), 1.0f } };
+        if (clip.w <= MinW) {
+            return std::nullopt;
+        }
+        const vec2 position { to_screen(clip) };
+        rect.min = glm::min(rect.min, position);
+        rect.max = glm::max(rect.max, position);
+        rect.z = std::max(rect.z, 1.0f / clip.w);
+    }
+    return rect;
+}
+
+inline bool is_off_screen(const ScreenRect &rect) noexcept {
+    return rect.max.x < 0.0f || rect.max.y < 0.0f ||
+           rect.min.x >= OcclusionCuller::Width || rect.min.y >= OcclusionCuller::Height;
+}
+
+}  // anonymous namespace
+
+void SetOcclusionCulling(bool enabled) noexcept {
+    Enabled = enabled;
+}
+
+bool IsOcclusionCullingEnabled() noexcept {
+    return Enabled;
+}
+
+/**
+ * @brief A front facing triangle in buffer space.
+ */
+struct OcclusionCuller::Triangle {
+    float edges[3][3];  // a, b and c of the edge functions a * x + b * y + c, positive inside
+    float plane[3];     // 1/w = plane[0] * x + plane[1] * y + plane[2]
+    float zMin;         // farthest vertex
+    unsigned minX, maxX, minY, maxY;  // [pixels] clamped to the buffer
+};
+
+OcclusionCuller::OcclusionCuller()
+    : _tiles(std::size_t { TilesX } * TilesY) {
+    clear();
+}
+
+void OcclusionCuller::clear() {
+    for (auto &tile : _tiles) {
+        std::fill_n(tile.zMin[0], 4, 0.0f);  // infinitely far
+        std::fill_n(tile.zMin[1], 4, FLT_MAX);
+        std::fill_n(tile.mask, 4, 0u);
+    }
+    _candidates.clear();
+    _statistics = {};
+}
+
+void OcclusionCuller::addOccluder(const OccluderGeometry &geometry, const BoundingBox &box, const mat4 &MVP) {
+    float area { static_cast<float>(Width * Height) };  // the camera is inside or close to the box
+    if (const std::optional<ScreenRect> rect { project(box, MVP) }) {
+        if (is_off_screen(*rect)) {
+            return;
+        }
+        const vec2 size { glm::min(rect->max, vec2 { Width, Height }) - glm::max(rect->min, vec2 { 0.0f }) };
+        area = size.x * size.y;
+    }
+    _candidates.push_back({ &geometry, MVP, area });
+}
+
+void OcclusionCuller::rasterize() {
+    const auto begin { Clock::now() };
+
+    // the largest occluders hide the most
+    std::sort(_candidates.begin(), _candidates.end(), [] (const Candidate &a, const Candidate &b) {
+        return a.area > b.area;
+    });
+    std::vector<Triangle> triangles;
+    std::size_t budget { MaxTriangles };
+    for (auto &candidate : _candidates) {
+        const std::size_t count { candidate.geometry->indices.size() / 3 };
+        if (count > budget) {
+            continue;
+        }
+        budget -= count;
+        setup(candidate, triangles);
+        ++_statistics.occluders;
+    }
+    _candidates.clear();
+    _statistics.triangles = triangles.size();
+
+    // each thread owns a band of tile rows
+    parallel_for(0, TilesY, [&] (std::size_t first_row, std::size_t last_row) {
+        for (auto &triangle : triangles) {
+            rasterize(triangle, static_cast<unsigned>(first_row), static_cast<unsigned>(last_row));
+        }
+    }, 1);
+
+    _statistics.rasterTime = elapsed(begin);
+}
+
+void OcclusionCuller::setup(const Candidate &candidate, std::vector<Triangle> &triangles) const {
+    const OccluderGeometry &geometry { *candidate.geometry };
+    std::vector<glm::vec4> clip(geometry.positions.size());
+    for (auto i = 0u; i < clip.size(); ++i) {
+        clip[i] = candidate.MVP * glm::vec4 { geometry.positions[i], 1.0f };
+    }
+
+    for (auto i = 0u; i + 2 < geometry.indices.size(); i += 3) {
+        const glm::vec4 *vertices[3] { &clip[geometry.indices[i]], &clip[geometry.indices[i + 1]],
+                                       &clip[geometry.indices[i + 2]] };
+        if (vertices[0]->w <= MinW || vertices[1]->w <= MinW || vertices[2]->w <= MinW) {
+            continue;  // not clipped, dropping an occluder is conservative
+        }
+
+        vec2 p[3];
+        float z[3];
+        for (auto v = 0; v < 3; ++v) {
+            p[v] = to_screen(*vertices[v]);
+            z[v] = 1.0f / vertices[v]->w;
+        }
+
+        // back faces are culled by OpenGL as well, so they must not occlude
+        const vec2 d1 { p[1] - p[0] };
+        const vec2 d2 { p[2] - p[0] };
+        const float area { d1.x * d2.y - d1.y * d2.x };
+        if (area <= 0.0f) {
+            continue;
+        }
+
+        const vec2 min { glm::max(glm::min(p[0], glm::min(p[1], p[2])), vec2 { 0.0f }) };
+        const vec2 max { glm::min(glm::max(p[0], glm::max(p[1], p[2])), vec2 { Width - 1, Height - 1 }) };
+        if (min.x > max.x || min.y > max.y) {
+            continue;
+        }
+
+        Triangle &triangle { triangles.emplace_back() };
+        for (auto e = 0; e < 3; ++e) {
+            const vec2 &from { p[e] };
+            const vec2 &to { p[(e + 1) % 3] };
+            triangle.edges[e][0] = from.y - to.y;
+            triangle.edges[e][1] = to.x - from.x;
+            triangle.edges[e][2] = -(triangle.edges[e][0] * from.x + triangle.edges[e][1] * from.y);
+        }
+        triangle.plane[0] = ((z[1] - z[0]) * d2.y - d1.y * (z[2] - z[0])) / area;
+        triangle.plane[1] = (d1.x * (z[2] - z[0]) - (z[1] - z[0]) * d2.x) / area;
+        triangle.plane[2] = z[0] - triangle.plane[0] * p[0].x - triangle.plane[1] * p[0].y;
+        triangle.zMin = std::min({ z[0], z[1], z[2] });
+        triangle.minX = static_cast<unsigned>(min.x);
+        triangle.maxX = static_cast<unsigned>(max.x);
+        triangle.minY = static_cast<unsigned>(min.y);
+        triangle.maxY = static_cast<unsigned>(max.y);
+    }
+}
+
+/**
+ * @brief Rasterizes a triangle into the tiles of the rows [@p first_row, @p last_row).
+ * @details The tiles are updated with the heuristic of section 3.2 of the paper: the working
+ *          layer is discarded if the triangle is much nearer than it, and merged otherwise.
+ */
+void OcclusionCuller::rasterize(const Triangle &triangle, unsigned first_row, unsigned last_row) {
+    first_row = std::max(first_row, triangle.minY / TileHeight);
+    last_row = std::min(last_row, triangle.maxY / TileHeight + 1);
+    const float (&e)[3][3] { triangle.edges };
+    const float (&plane)[3] { triangle.plane };
+
+    for (auto row = first_row; row < last_row; ++row) {
+        for (auto column = triangle.minX / TileWidth; column <= triangle.maxX / TileWidth; ++column) {
+            Tile &tile { _tiles[row * TilesX + column] };
+            const float x { static_cast<float>(column * TileWidth) };
+            const float y { static_cast<float>(row * TileHeight) };
+            // the farthest depth of the triangle within each subtile
+            const float z_x { plane[0] > 0.0f ? 0.0f : static_cast<float>(SubtileWidth) };
+            const float z_y { y + (plane[1] > 0.0f ? 0.0f : static_cast<float>(TileHeight)) };
+#if defined(__SSE2__)
+            const __m128 lane_x { _mm_add_ps(_mm_set1_ps(x), _mm_setr_ps(0.0f, 8.0f, 16.0f, 24.0f)) };
+            __m128 edge[3];
+            for (auto i = 0; i < 3; ++i) {  // at the center of the first pixel of each subtile
+                edge[i] = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(e[i][0]), _mm_add_ps(lane_x, _mm_set1_ps(0.5f))),
+                                     _mm_set1_ps(e[i][1] * (y + 0.5f) + e[i][2]));
+            }
+
+            __m128i coverage { _mm_setzero_si128() };
+            for (auto bit = 0u; bit < 32; ++bit) {
+                const float dx { static_cast<float>(bit % SubtileWidth) };
+                const float dy { static_cast<float>(bit / SubtileWidth) };
+                __m128 inside { _mm_cmpge_ps(_mm_add_ps(edge[0], _mm_set1_ps(e[0][0] * dx + e[0][1] * dy)), _mm_setzero_ps()) };
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(edge[1], _mm_set1_ps(e[1][0] * dx + e[1][1] * dy)), _mm_setzero_ps()));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(edge[2], _mm_set1_ps(e[2][0] * dx + e[2][1] * dy)), _mm_setzero_ps()));
+                coverage = _mm_or_si128(coverage, _mm_and_si128(_mm_castps_si128(inside), _mm_set1_epi32(static_cast<int>(1u << bit))));
+            }
+
+            const __m128 corner_z { _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), _mm_add_ps(lane_x, _mm_set1_ps(z_x))),
+                                               _mm_set1_ps(plane[1] * z_y + plane[2])) };
+            const __m128 z { _mm_max_ps(corner_z, _mm_set1_ps(triangle.zMin)) };
+
+            const auto blend = [] (__m128 a, __m128 b, __m128i mask) {  // mask ? b : a
+                return _mm_or_ps(_mm_andnot_ps(_mm_castsi128_ps(mask), a), _mm_and_ps(_mm_castsi128_ps(mask), b));
+            };
+            const __m128i ones { _mm_set1_epi32(-1) };
+            __m128 z_min0 { _mm_load_ps(tile.zMin[0]) };
+            __m128 z_min1 { _mm_load_ps(tile.zMin[1]) };
+            __m128i mask { _mm_load_si128(reinterpret_cast<const __m128i*>(tile.mask)) };
+
+            // subtiles which are not covered or where the triangle is behind the reference layer
+            __m128i dead { _mm_cmpeq_epi32(coverage, _mm_setzero_si128()) };
+            dead = _mm_or_si128(dead, _mm_srai_epi32(_mm_castps_si128(_mm_sub_ps(z, z_min0)), 31));
+            const __m128i raster { _mm_andnot_si128(dead, coverage) };
+
+            const __m128i covered { _mm_cmpeq_epi32(raster, ones) };
+            const __m128 distance { _mm_sub_ps(_mm_mul_ps(z_min1, _mm_set1_ps(2.0f)), _mm_add_ps(z, z_min0)) };
+            const __m128i discard { _mm_andnot_si128(dead, _mm_or_si128(_mm_srai_epi32(_mm_castps_si128(distance), 31), covered)) };
+
+            mask = _mm_or_si128(_mm_andnot_si128(discard, mask), raster);
+            const __m128i full { _mm_cmpeq_epi32(mask, ones) };
+            const __m128 merged { _mm_min_ps(blend(z, z_min1, dead), blend(z_min1, z, discard)) };
+            z_min1 = blend(merged, _mm_set1_ps(FLT_MAX), full);
+            z_min0 = blend(z_min0, merged, full);
+
+            _mm_store_ps(tile.zMin[0], z_min0);
+            _mm_store_ps(tile.zMin[1], z_min1);
+            _mm_store_si128(reinterpret_cast<__m128i*>(tile.mask), _mm_andnot_si128(full, mask));
+#else
+            for (auto lane = 0u; lane < 4; ++lane) {
+                const float subtile_x { x + static_cast<float>(lane * SubtileWidth) };
+                std::uint32_t coverage { 0 };
+                for (auto bit = 0u; bit < 32; ++bit) {
+                    const float px { subtile_x + static_cast<float>(bit % SubtileWidth) + 0.5f };
+                    const float py { y + static_cast<float>(bit / SubtileWidth) + 0.5f };
+                    bool inside { true };
+                    for (auto i = 0; i < 3; ++i) {
+                        inside = inside && e[i][0] * px + e[i][1] * py + e[i][2] >= 0.0f;
+                    }
+                    coverage |= (inside ? 1u : 0u) << bit;
+                }
+
+                const float z { std::max(plane[0] * (subtile_x + z_x) + plane[1] * z_y + plane[2], triangle.zMin) };
+                float &z_min0 { tile.zMin[0][lane] };
+                float &z_min1 { tile.zMin[1][lane] };
+                std::uint32_t &mask { tile.mask[lane] };
+                if (coverage == 0 || z < z_min0) {
+                    continue;
+                }
+
+                const bool discard { coverage == ~0u || 2.0f * z_min1 < z + z_min0 };
+                mask = (discard ? 0u : mask) | coverage;
+                const float merged { discard ? z : std::min(z, z_min1) };
+                if (mask == ~0u) {
+                    z_min0 = merged;
+                    z_min1 = FLT_MAX;
+                    mask = 0;
+                } else {
+                    z_min1 = merged;
+                }
+            }
+#endif  // __SSE2__
+        }
+    }
+}
+
+bool OcclusionCuller::isVisible(const BoundingBox &box, const mat4 &MVP) {
+    const auto begin { Clock::now() };
+    ++_statistics.tested;
+
+    const std::optional<ScreenRect> rect { project(box, MVP) };
+    bool visible { !rect || is_off_screen(*rect) };
+    if (!visible) {
+        // the occluder of a mesh lies within its box, so it can only hide the box through rounding,
+        // e.g. a wall facing the camera whose depth equals that of its box
+        const float z { rect->z * (1.0f + DepthBias) };
+        const unsigned min_x { static_cast<unsigned>(std::max(rect->min.x, 0.0f)) };
+        const unsigned min_y { static_cast<unsigned>(std::max(rect->min.y, 0.0f)) };
+        const unsigned max_x { static_cast<unsigned>(std::min(rect->max.x, Width - 1.0f)) };
+        const unsigned max_y { static_cast<unsigned>(std::min(rect->max.y, Height - 1.0f)) };
+
+        for (auto row = min_y / TileHeight; row <= max_y / TileHeight && !visible; ++row) {
+            for (auto column = min_x / TileWidth; column <= max_x / TileWidth && !visible; ++column) {
+                // the subtiles overlapped by the rectangle
+                const unsigned tile_x { column * TileWidth };
+                const unsigned first { (std::max(min_x, tile_x) - tile_x) / SubtileWidth };
+                const unsigned last { (std::min(max_x, tile_x + TileWidth - 1) - tile_x) / SubtileWidth };
+                const unsigned lanes { ((2u << last) - 1) & ~((1u << first) - 1) };
+
+                const Tile &tile { _tiles[row * TilesX + column] };
+#if defined(__SSE2__)
+                const int nearer { _mm_movemask_ps(_mm_cmple_ps(_mm_load_ps(tile.zMin[0]), _mm_set1_ps(z))) };
+                visible = (static_cast<unsigned>(nearer) & lanes) != 0;
+#else
+                for (auto lane = first; lane <= last; ++lane) {
+                    visible = visible || tile.zMin[0][lane] <= z;
+                }
+#endif  // __SSE2__
+            }
+        }
+    }
+
+    if (!visible) {
+        ++_statistics.culled;
+    }
+    _statistics.testTime += elapsed(begin);
+    return visible;
+}
+
+const OcclusionCuller::Statistics& OcclusionCuller::getStatistics() const noexcept {
+    return _statistics;
+}
+
+}  // namespace bgl
@@ -0,0 +1,113 @@
+/**
+ * @file occlusion.hpp
+ * @brief Masked software occlusion culling.
+ */
+#ifndef GFX_OCCLUSION_HPP_
+#define GFX_OCCLUSION_HPP_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <vector>
+
+#include "gl.hpp"
+#include "bounding_box.hpp"
+#include "mesh.hpp"  // bgl::OccluderGeometry
+
+
+namespace bgl {
+
+void SetOcclusionCulling(bool enabled) noexcept;
+bool IsOcclusionCullingEnabled() noexcept;
+
+/**
+ * @brief Culls meshes hidden behind a few large occluders on the CPU.
+ * @details Follows "Masked Software Occlusion Culling" (Hasselgren et al., 2016). The depth
+ *          buffer has a low resolution and stores 1/w, so larger values are nearer. Each tile
+ *          consists of four 8x4 subtiles, one per SSE lane. Instead of a depth per pixel, a
+ *          subtile keeps a conservative reference depth for all of its pixels and a working layer
+ *          with a coverage mask and the farthest depth of the triangles that were merged into
+ *          it. Once the working layer covers the whole subtile, it replaces the reference.
+ *
+ *          Every frame, the occluders with the largest bounding boxes on screen are chosen up
+ *          to @p MaxTriangles and rasterized in horizontal bands, one per thread. Meshes are
+ *          then tested by the screen rectangle and nearest depth of their bounding box.
+ */
+class OcclusionCuller {
+ public:
+	static constexpr unsigned Width { 256 };  // [pixels]
+	static constexpr unsigned Height { 128 };
+	static constexpr unsigned TileWidth { 32 };
+	static constexpr unsigned TileHeight { 4 };
+	static constexpr unsigned SubtileWidth { 8 };
+	static constexpr std::size_t MaxTriangles { 16384 };  // rasterized per frame
+	static constexpr std::size_t MaxOccluderTriangles { 4096 };  // more detailed meshes do not occlude
+
+	struct Statistics {  // of the current frame
+		std::size_t occluders;
+		std::size_t triangles;  // rasterized
+		std::size_t tested;
+		std::size_t culled;
+		double rasterTime;  // [ms]
+		double testTime;    // [ms]
+	};
+
+	OcclusionCuller();
+	OcclusionCuller(OcclusionCuller&&) = delete;
+	OcclusionCuller& operator=(OcclusionCuller&&) = delete;
+
+	OcclusionCuller(const OcclusionCuller&) = delete;
+	OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+	virtual ~OcclusionCuller() noexcept = default;
+
+	/**
+	 * @brief Starts a new frame.
+	 */
+	void clear();
+
+	/**
+	 * @brief Adds an occluder candidate of the current frame.
+	 * @note @p geometry must stay alive until rasterize() has returned.
+	 */
+	void addOccluder(const OccluderGeometry &geometry, const BoundingBox &box, const mat4 &MVP);
+
+	/**
+	 * @brief Rasterizes the largest occluder candidates.
+	 */
+	void rasterize();
+
+	/**
+	 * @brief Tests whether a bounding box may be visible.
+	 * @details Boxes are moved slightly towards the camera and count as visible at equal depth, so
+	 *          that meshes whose own occluder was rasterized are not hidden by it.
+	 * @return false only if it is completely hidden behind the rasterized occluders
+	 */
+	bool isVisible(const BoundingBox &box, const mat4 &MVP);
+
+	const Statistics& getStatistics() const noexcept;
+
+ private:
+	struct alignas(16) Tile {
+		float zMin[2][4];          // reference and working layer per subtile
+		std::uint32_t mask[4];     // coverage of the working layer
+	};
+
+	struct Candidate {
+		const OccluderGeometry *geometry;
+		mat4 MVP;
+		float area;  // of the bounding box on screen [pixels]
+	};
+
+	struct Triangle;
+
+	void setup(const Candidate &candidate, std::vector<Triangle> &triangles) const;
+	void rasterize(const Triangle &triangle, unsigned first_row, unsigned last_row);
+
+	std::vector<Tile> _tiles;
+	std::vector<Candidate> _candidates;
+	Statistics _statistics {};
+};
+
+}  // namespace bgl
+
+#endif  // GFX_OCCLUSION_HPP_
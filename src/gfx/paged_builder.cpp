@@ -0,0 +1,578 @@
+#include <sys/mman.h>  // mmap()
+#include <fcntl.h>
+#include <unistd.h>    // pread(), pwrite()
+
+#include <algorithm>
+#include <cmath>    // INFINITY
+#include <cstdint>
+#include <cstdlib>  // std::strtof(), std::strtoll()
+#include <fstream>
+#include <iomanip>  // std::quoted
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "paged_builder.hpp"
+#include "paged_model.hpp"
+#include "ply.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr std::size_t LeafTriangles { 32768 };  // at most this many triangles per leaf on average
+constexpr unsigned MaxLevel { 7 };  // 128^3 leaf cells
+constexpr std::uint32_t ClusterResolution { 64 };  // vertex clusters per axis of a cell, about a leaf per page
+constexpr std::size_t ChunkTriangles { std::size_t { 1 } << 20 };  // triangles sorted into cells at once
+
+std::runtime_error make_error(const std::string &message, const std::filesystem::path &path) {
+    std::ostringstream oss;
+    oss << message << " " << std::quoted(path.string());
+    return std::runtime_error { oss.str() };
+}
+
+/*********************************************************
+ *                        Files                          *
+ *********************************************************/
+
+/**
+ * @brief Removes a temporary file when the build finishes or fails.
+ */
+struct TemporaryFile {
+    std::filesystem::path path;
+
+    explicit TemporaryFile(std::filesystem::path path) : path { std::move(path) } {}
+    ~TemporaryFile() noexcept {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+};
+
+class File {
+ public:
+    File(const std::filesystem::path &path, int flags)
+        : _path { path }, _descriptor { open(path.c_str(), flags, 0644) } {
+        if (_descriptor < 0) {
+            throw make_error("could not open", path);
+        }
+    }
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+    ~File() noexcept {
+        close(_descriptor);
+    }
+
+    void read(void *data, std::size_t size, std::uint64_t offset) const {
+        auto *bytes { static_cast<std::uint8_t*>(data) };
+        while (size > 0) {
+            const ssize_t count { pread(_descriptor, bytes, size, static_cast<off_t>(offset)) };
+            if (count <= 0) {
+                throw make_error("could not read", _path);
+            }
+            bytes += count;
+            size -= static_cast<std::size_t>(count);
+            offset += static_cast<std::uint64_t>(count);
+        }
+    }
+
+    void write(const void *data, std::size_t size, std::uint64_t offset) const {
+        const auto *bytes { static_cast<const std::uint8_t*>(data) };
+        while (size > 0) {
+            const ssize_t count { pwrite(_descriptor, bytes, size, static_cast<off_t>(offset)) };
+            if (count <= 0) {
+                throw make_error("could not write", _path);
+            }
+            bytes += count;
+            size -= static_cast<std::size_t>(count);
+            offset += static_cast<std::uint64_t>(count);
+        }
+    }
+
+    int getDescriptor() const noexcept {
+        return _descriptor;
+    }
+
+ private:
+    std::filesystem::path _path;
+    int _descriptor;
+};
+
+/**
+ * @brief The positions of all vertices, read from disk on demand.
+ */
+class MappedPositions {
+ public:
+    MappedPositions(const File &file, std::size_t count)
+        : _size { count * sizeof(vec3) } {
+        _data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file.getDescriptor(), 0);
+        if (_data == MAP_FAILED) {
+            throw std::runtime_error { "could not map vertex positions" };
+        }
+    }
+    MappedPositions(const MappedPositions&) = delete;
+    MappedPositions& operator=(const MappedPositions&) = delete;
+    ~MappedPositions() noexcept {
+        munmap(_data, _size);
+    }
+
+    const vec3& operator[](std::size_t index) const noexcept {
+        return static_cast<const vec3*>(_data)[index];
+    }
+
+ private:
+    void *_data;
+    std::size_t _size;
+};
+
+/*********************************************************
+ *                        Parsing                        *
+ *********************************************************/
+
+/**
+ * @brief Appends positions and triangles to temporary files.
+ */
+struct Geometry {
+    std::ofstream positions;
+    std::ofstream triangles;
+    std::uint64_t vertexCount { 0 };
+    std::uint64_t triangleCount { 0 };
+    vec3 min { INFINITY };
+    vec3 max { -INFINITY };
+
+    void addVertex(const vec3 &position) {
+        positions.write(reinterpret_cast<const char*>(&position), sizeof(position));
+        min = glm::min(min, position);
+        max = glm::max(max, position);
+        ++vertexCount;
+    }
+
+    void addTriangle(std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+        const std::uint32_t triangle[3] { a, b, c };
+        triangles.write(reinterpret_cast<const char*>(triangle), sizeof(triangle));
+        ++triangleCount;
+    }
+};
+
+/**
+ * @brief Reads the positions and faces of an ASCII Wavefront OBJ file, other lines are ignored.
+ */
+void parse_obj(const std::filesystem::path &path, Geometry &geometry) {
+    std::ifstream file { path };
+    if (!file) {
+        throw make_error("could not open", path);
+    }
+
+    std::string line;
+    std::vector<std::uint32_t> face;
+    while (std::getline(file, line)) {
+        const char *text { line.c_str() };
+        if (line.rfind("v ", 0) == 0) {
+            char *end { const_cast<char*>(text) + 1 };  // NOLINT
+            vec3 position;
+            for (auto axis = 0; axis < 3; ++axis) {
+                const char *begin { end };
+                position[axis] = std::strtof(begin, &end);
+                if (end == begin) {
+                    throw make_error("invalid vertex in", path);
+                }
+            }
+            geometry.addVertex(position);
+        } else if (line.rfind("f ", 0) == 0) {
+            // v, v/vt, v//vn and v/vt/vn, negative indices are relative to the last vertex
+            face.clear();
+            char *end { const_cast<char*>(text) + 1 };  // NOLINT
+            for (;;) {
+                const char *begin { end };
+                const long long index { std::strtoll(begin, &end, 10) };
+                if (end == begin) {
+                    break;
+                }
+                const long long vertex { index < 0 ? static_cast<long long>(geometry.vertexCount) + index : index - 1 };
+                if (vertex < 0 || vertex >= static_cast<long long>(geometry.vertexCount)) {
+                    throw make_error("invalid vertex index in", path);
+                }
+                face.push_back(static_cast<std::uint32_t>(vertex));
+                while (*end != '\0' && *end != ' ' && *end != '\t') {
+                    ++end;  // skips texture coordinate and normal indices
+                }
+            }
+            for (auto i = 2u; i < face.size(); ++i) {
+                geometry.addTriangle(face[0], face[i - 1], face[i]);  // a fan for polygons
+            }
+        }
+    }
+}
+
+/**
+ * @brief Reads the positions and faces of a binary little-endian PLY file.
+ */
+void parse_ply(const std::filesystem::path &path, Geometry &geometry) {
+    PLYFile file { path };
+    file.read([&] (const vec3 &position, std::uint32_t /* color */) {
+        geometry.addVertex(position);
+    }, [&] (const std::vector<std::uint32_t> &face) {
+        for (auto i = 2u; i < face.size(); ++i) {
+            geometry.addTriangle(face[0], face[i - 1], face[i]);
+        }
+    });
+}
+
+/*********************************************************
+ *                        Octree                         *
+ *********************************************************/
+
+/**
+ * @brief A cube around the model whose cells at level l are 2^l cubes per axis.
+ */
+struct Grid {
+    vec3 origin;
+    float size;
+
+    float getCellSize(unsigned level) const noexcept {
+        return size / static_cast<float>(1u << level);
+    }
+
+    vec3 getCellOrigin(unsigned level, std::uint64_t key) const noexcept {
+        const std::uint64_t resolution { 1u << level };
+        const vec3 cell { static_cast<float>(key % resolution),
+                          static_cast<float>(key / resolution % resolution),
+                          static_cast<float>(key / resolution / resolution) };
+        return origin + cell * getCellSize(level);
+    }
+};
+
+/**
+ * @brief Returns x + r * (y + r * z) of the cell of a cube that contains @p position.
+ */
+std::uint64_t get_key(const vec3 &position, const vec3 &origin, float size, std::uint32_t resolution) noexcept {
+    std::uint64_t key { 0 };
+    for (auto axis = 3; axis-- > 0;) {
+        const float cell { std::floor((position[axis] - origin[axis]) / size * static_cast<float>(resolution)) };
+        key = key * resolution + static_cast<std::uint64_t>(std::clamp(cell, 0.0f, static_cast<float>(resolution - 1)));
+    }
+    return key;
+}
+
+std::uint64_t get_parent_key(std::uint64_t key, unsigned level) noexcept {
+    const std::uint64_t resolution { 1u << level };
+    const std::uint64_t x { key % resolution / 2 };
+    const std::uint64_t y { key / resolution % resolution / 2 };
+    const std::uint64_t z { key / resolution / resolution / 2 };
+    return x + resolution / 2 * (y + resolution / 2 * z);
+}
+
+struct BuildNode {
+    std::uint64_t key;
+    vec3 min;
+    vec3 max;
+    float error;
+    std::uint32_t vertexCount;
+    std::uint32_t indexCount;
+    std::uint64_t offset;
+    std::vector<std::uint32_t> children;
+};
+
+/**
+ * @brief Appends the page of a node to the output.
+ */
+void write_page(const File &output, std::uint64_t &end, BuildNode &node,
+                const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices) {
+    node.vertexCount = static_cast<std::uint32_t>(vertices.size());
+    node.indexCount = static_cast<std::uint32_t>(indices.size());
+    node.offset = end;
+    output.write(vertices.data(), sizeof(Vertex) * vertices.size(), end);
+    end += sizeof(Vertex) * vertices.size();
+    output.write(indices.data(), sizeof(GLuint) * indices.size(), end);
+    end += sizeof(GLuint) * indices.size();
+}
+
+/**
+ * @brief Area weighted vertex normals.
+ */
+void compute_normals(std::vector<Vertex> &vertices, const std::vector<GLuint> &indices) {
+    for (auto &vertex : vertices) {
+        vertex.normal = vec3 { 0.0f };
+    }
+    for (auto i = 0u; i + 2 < indices.size(); i += 3) {
+        Vertex &a { vertices[indices[i]] };
+        Vertex &b { vertices[indices[i + 1]] };
+        Vertex &c { vertices[indices[i + 2]] };
+        const vec3 normal { glm::cross(b.position - a.position, c.position - a.position) };
+        a.normal += normal;
+        b.normal += normal;
+        c.normal += normal;
+    }
+    for (auto &vertex : vertices) {
+        const float length { glm::length(vertex.normal) };
+        vertex.normal = length > 0.0f ? vertex.normal / length : vec3 { 0.0f, 0.0f, 1.0f };
+    }
+}
+
+BuildNode build_leaf(const File &output, std::uint64_t &end, std::uint64_t key,
+                     const std::vector<std::uint32_t> &triangles, const MappedPositions &positions,
+                     std::uint64_t vertex_count) {
+    BuildNode node { key, vec3 { INFINITY }, vec3 { -INFINITY }, 0.0f, 0, 0, 0, {} };
+    std::unordered_map<std::uint32_t, GLuint> local;  // of the vertices in the whole model
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    indices.reserve(triangles.size());
+    for (auto index : triangles) {
+        if (index >= vertex_count) {
+            throw std::runtime_error { "invalid vertex index " + std::to_string(index) };
+        }
+        const auto [iterator, inserted] = local.emplace(index, static_cast<GLuint>(vertices.size()));
+        if (inserted) {
+            const vec3 &position { positions[index] };
+            vertices.push_back({ position, vec3 { 0.0f }, vec2 { 0.0f } });
+            node.min = glm::min(node.min, position);
+            node.max = glm::max(node.max, position);
+        }
+        indices.push_back(iterator->second);
+    }
+    compute_normals(vertices, indices);
+    write_page(output, end, node, vertices, indices);
+    return node;
+}
+
+/**
+ * @brief Merges the pages of the children and clusters their vertices.
+ * @details All vertices within a cluster are replaced by their average, and triangles that
+ *          collapse are dropped.
+ */
+void build_parent(const File &output, std::uint64_t &end, const Grid &grid, unsigned level,
+                  BuildNode &node, std::vector<BuildNode> &nodes) {
+    std::vector<Vertex> merged;
+    std::vector<GLuint> merged_indices;
+    node.min = vec3 { INFINITY };
+    node.max = vec3 { -INFINITY };
+    float child_error { 0.0f };
+    for (auto child : node.children) {
+        const BuildNode &data { nodes[child] };
+        const auto base { static_cast<GLuint>(merged.size()) };
+        merged.resize(merged.size() + data.vertexCount);
+        output.read(merged.data() + base, sizeof(Vertex) * data.vertexCount, data.offset);
+        std::vector<GLuint> indices(data.indexCount);
+        output.read(indices.data(), sizeof(GLuint) * indices.size(), data.offset + sizeof(Vertex) * data.vertexCount);
+        for (auto index : indices) {
+            merged_indices.push_back(base + index);
+        }
+        node.min = glm::min(node.min, data.min);
+        node.max = glm::max(node.max, data.max);
+        child_error = std::max(child_error, data.error);
+    }
+
+    const vec3 origin { grid.getCellOrigin(level, node.key) };
+    const float size { grid.getCellSize(level) };
+    std::unordered_map<std::uint64_t, GLuint> clusters;
+    std::vector<GLuint> cluster_of(merged.size());
+    std::vector<Vertex> vertices;
+    std::vector<float> weights;
+    for (auto i = 0u; i < merged.size(); ++i) {
+        const auto [iterator, inserted] = clusters.emplace(get_key(merged[i].position, origin, size, ClusterResolution),
+                                                           static_cast<GLuint>(vertices.size()));
+        if (inserted) {
+            vertices.push_back({ vec3 { 0.0f }, vec3 { 0.0f }, vec2 { 0.0f } });
+            weights.push_back(0.0f);
+        }
+        cluster_of[i] = iterator->second;
+        vertices[iterator->second].position += merged[i].position;
+        vertices[iterator->second].normal += merged[i].normal;
+        weights[iterator->second] += 1.0f;
+    }
+    for (auto i = 0u; i < vertices.size(); ++i) {
+        vertices[i].position /= weights[i];
+        const float length { glm::length(vertices[i].normal) };
+        vertices[i].normal = length > 0.0f ? vertices[i].normal / length : vec3 { 0.0f, 0.0f, 1.0f };
+    }
+
+    float error { 0.0f };
+    for (auto i = 0u; i < merged.size(); ++i) {
+        error = std::max(error, glm::distance(merged[i].position, vertices[cluster_of[i]].position));
+    }
+    node.error = child_error + error;  // never less than that of a child
+
+    std::vector<GLuint> indices;
+    for (auto i = 0u; i + 2 < merged_indices.size(); i += 3) {
+        const GLuint a { cluster_of[merged_indices[i]] };
+        const GLuint b { cluster_of[merged_indices[i + 1]] };
+        const GLuint c { cluster_of[merged_indices[i + 2]] };
+        if (a != b && b != c && c != a) {
+            indices.insert(indices.end(), { a, b, c });
+        }
+    }
+    write_page(output, end, node, vertices, indices);
+}
+
+}  // anonymous namespace
+
+void BuildPagedModel(const std::filesystem::path &input, const std::filesystem::path &output) {
+    const TemporaryFile positions_file { output.string() + ".positions" };
+    const TemporaryFile triangles_file { output.string() + ".triangles" };
+    const TemporaryFile sorted_file { output.string() + ".sorted" };
+
+    // 1. streams the input into positions and triangles
+    Geometry geometry;
+    geometry.positions.open(positions_file.path, std::ios::binary);
+    geometry.triangles.open(triangles_file.path, std::ios::binary);
+    const std::string extension { input.extension().string() };
+    if (extension == ".obj" || extension == ".OBJ") {
+        parse_obj(input, geometry);
+    } else if (extension == ".ply" || extension == ".PLY") {
+        parse_ply(input, geometry);
+    } else {
+        throw make_error("unsupported file type", input);
+    }
+    geometry.positions.close();
+    geometry.triangles.close();
+    if (!geometry.positions || !geometry.triangles) {
+        throw make_error("could not write temporary files next to", output);
+    }
+    if (geometry.triangleCount == 0) {
+        throw make_error("no triangles in", input);
+    }
+
+    const File positions_data { positions_file.path, O_RDONLY };
+    const MappedPositions positions { positions_data, geometry.vertexCount };
+    const File triangles { triangles_file.path, O_RDONLY };
+    const File sorted { sorted_file.path, O_RDWR | O_CREAT | O_TRUNC };
+
+    // 2. splits the cube around the model until a leaf holds about LeafTriangles triangles
+    unsigned levels { 0 };
+    while (levels < MaxLevel && geometry.triangleCount > (LeafTriangles << (2 * levels))) {
+        ++levels;  // surfaces gain about four times as many triangles per level
+    }
+    const vec3 extent { geometry.max - geometry.min };
+    const float size { std::max(std::max(extent.x, extent.y), std::max(extent.z, 1e-6f)) * 1.0001f };
+    const Grid grid { geometry.min, size };
+    const std::uint32_t resolution { 1u << levels };
+
+    const auto for_each_chunk = [&] (auto &&function) {
+        std::vector<std::uint32_t> chunk;
+        for (std::uint64_t first = 0; first < geometry.triangleCount; first += ChunkTriangles) {
+            chunk.resize(std::min<std::uint64_t>(ChunkTriangles, geometry.triangleCount - first) * 3);
+            triangles.read(chunk.data(), sizeof(std::uint32_t) * chunk.size(), first * sizeof(std::uint32_t) * 3);
+            function(chunk);
+        }
+    };
+    const auto get_triangle_key = [&] (const std::uint32_t *triangle) {
+        const auto get = [&] (std::uint32_t index) -> vec3 {
+            if (index >= geometry.vertexCount) {
+                throw make_error("invalid vertex index in", input);
+            }
+            return positions[index];
+        };
+        const vec3 centroid { (get(triangle[0]) + get(triangle[1]) + get(triangle[2])) / 3.0f };
+        return get_key(centroid, grid.origin, grid.size, resolution);
+    };
+
+    // 3. sorts the triangles by the leaf cell of their centroid with a counting sort on disk
+    std::vector<std::uint64_t> starts(std::size_t { resolution } * resolution * resolution + 1, 0);
+    for_each_chunk([&] (const std::vector<std::uint32_t> &chunk) {
+        for (auto i = 0u; i < chunk.size(); i += 3) {
+            ++starts[get_triangle_key(&chunk[i]) + 1];
+        }
+    });
+    for (auto i = 1u; i < starts.size(); ++i) {
+        starts[i] += starts[i - 1];
+    }
+    std::vector<std::uint64_t> cursors { starts.begin(), starts.end() - 1 };
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> keys;  // and triangle in the chunk
+    std::vector<std::uint32_t> run;
+    for_each_chunk([&] (const std::vector<std::uint32_t> &chunk) {
+        keys.clear();
+        for (auto i = 0u; i < chunk.size(); i += 3) {
+            keys.emplace_back(get_triangle_key(&chunk[i]), i);
+        }
+        std::sort(keys.begin(), keys.end());
+        for (auto first = keys.begin(); first != keys.end();) {
+            run.clear();
+            auto last { first };
+            for (; last != keys.end() && last->first == first->first; ++last) {
+                run.insert(run.end(), &chunk[last->second], &chunk[last->second] + 3);
+            }
+            sorted.write(run.data(), sizeof(std::uint32_t) * run.size(), cursors[first->first] * sizeof(std::uint32_t) * 3);
+            cursors[first->first] += run.size() / 3;
+            first = last;
+        }
+    });
+
+    // 4. writes a page for each leaf and then for each inner node, level by level
+    const File file { output, O_RDWR | O_CREAT | O_TRUNC };
+    std::uint64_t end { sizeof(paged::Header) };
+    std::vector<BuildNode> nodes;
+    std::vector<std::uint32_t> level_nodes;  // of the current level
+    std::vector<std::uint32_t> cell;
+    for (std::uint64_t key = 0; key + 1 < starts.size(); ++key) {
+        if (starts[key + 1] == starts[key]) {
+            continue;
+        }
+        cell.resize((starts[key + 1] - starts[key]) * 3);
+        sorted.read(cell.data(), sizeof(std::uint32_t) * cell.size(), starts[key] * sizeof(std::uint32_t) * 3);
+        level_nodes.push_back(static_cast<std::uint32_t>(nodes.size()));
+        nodes.push_back(build_leaf(file, end, key, cell, positions, geometry.vertexCount));
+    }
+    for (auto level = levels; level-- > 0;) {
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> parents;  // key and child
+        for (auto child : level_nodes) {
+            parents.emplace_back(get_parent_key(nodes[child].key, level + 1), child);
+        }
+        std::sort(parents.begin(), parents.end());
+        level_nodes.clear();
+        for (auto &[key, child] : parents) {
+            if (level_nodes.empty() || nodes[level_nodes.back()].key != key) {
+                level_nodes.push_back(static_cast<std::uint32_t>(nodes.size()));
+                nodes.push_back({ key, vec3 { 0.0f }, vec3 { 0.0f }, 0.0f, 0, 0, 0, {} });
+            }
+            nodes[level_nodes.back()].children.push_back(child);
+        }
+        for (auto parent : level_nodes) {
+            build_parent(file, end, grid, level, nodes[parent], nodes);
+        }
+    }
+
+    // 5. stores the nodes breadth first, so the root comes first and siblings are adjacent
+    std::vector<std::uint32_t> order { level_nodes.front() };
+    for (auto i = 0u; i < order.size(); ++i) {
+        const auto &children { nodes[order[i]].children };
+        order.insert(order.end(), children.begin(), children.end());
+    }
+    std::vector<paged::Node> table;
+    for (auto index : order) {
+        const BuildNode &node { nodes[index] };
+        const vec3 center { (node.min + node.max) / 2.0f };
+        paged::Node entry {};
+        entry.center[0] = center.x;
+        entry.center[1] = center.y;
+        entry.center[2] = center.z;
+        entry.radius = glm::length(node.max - node.min) / 2.0f;
+        entry.error = node.error;
+        entry.childCount = static_cast<std::uint32_t>(node.children.size());
+        entry.vertexCount = node.vertexCount;
+        entry.indexCount = node.indexCount;
+        entry.offset = node.offset;
+        table.push_back(entry);
+    }
+    std::uint32_t next { 1 };  // children are appended in the same order as their parents
+    for (auto &entry : table) {
+        entry.firstChild = entry.childCount > 0 ? next : 0;
+        next += entry.childCount;
+    }
+    file.write(table.data(), sizeof(paged::Node) * table.size(), end);
+
+    paged::Header header {};
+    std::copy(std::begin(paged::Magic), std::end(paged::Magic), header.magic);
+    header.version = paged::Version;
+    header.nodeCount = static_cast<std::uint32_t>(table.size());
+    header.nodeOffset = end;
+    for (auto axis = 0; axis < 3; ++axis) {
+        header.min[axis] = geometry.min[axis];
+        header.max[axis] = geometry.max[axis];
+    }
+    file.write(&header, sizeof(header), 0);
+}
+
+}  // namespace bgl
@@ -0,0 +1,28 @@
+/**
+ * @file paged_builder.hpp
+ * @brief Offline conversion of large models into paged models (see paged_model.hpp).
+ */
+#ifndef GFX_PAGED_BUILDER_HPP_
+#define GFX_PAGED_BUILDER_HPP_
+
+#include <filesystem>  // std::filesystem::path
+
+
+namespace bgl {
+
+/**
+ * @brief Converts a model that may not fit into memory into a paged model file (.bglp).
+ * @details The input is streamed into temporary files next to @p output, so memory use
+ *          depends on the size of the pages rather than on the size of the model. Triangles
+ *          are bucketed into the cells of an octree that are split until a cell holds about
+ *          32768 triangles. Each non-empty leaf cell becomes a page, and each inner cell
+ *          becomes a page that merges its children and simplifies them by vertex clustering.
+ *          Only ASCII Wavefront OBJ files (positions and faces) and binary little-endian PLY
+ *          files (float positions and faces) are supported.
+ * @throw std::runtime_error if the input could not be read or the output could not be written
+ */
+void BuildPagedModel(const std::filesystem::path &input, const std::filesystem::path &output);
+
+}  // namespace bgl
+
+#endif  // GFX_PAGED_BUILDER_HPP_
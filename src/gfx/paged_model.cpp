@@ -0,0 +1,347 @@
+#include "gfx.hpp"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>  // pread()
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>  // offsetof
+#include <cstring>  // std::memcmp()
+#include <iomanip>  // std::quoted
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "paged_model.hpp"
+#include "resource_manager.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+std::size_t Budget { PagedModel::DefaultBudget };
+
+std::runtime_error make_error(const std::string &message, const std::filesystem::path &path) {
+    std::ostringstream oss;
+    oss << message << " " << std::quoted(path.string());
+    return std::runtime_error { oss.str() };
+}
+
+/**
+ * @brief Reads exactly @p size bytes or throws.
+ */
+void read(int file, void *data, std::size_t size, std::uint64_t offset) {
+    auto *bytes { static_cast<std::uint8_t*>(data) };
+    while (size > 0) {
+        const ssize_t count { pread(file, bytes, size, static_cast<off_t>(offset)) };
+        if (count <= 0) {
+            throw std::runtime_error { "could not read page of paged model" };
+        }
+        bytes += count;
+        size -= static_cast<std::size_t>(count);
+        offset += static_cast<std::uint64_t>(count);
+    }
+}
+
+inline bool is_ready(const std::future<std::vector<std::uint8_t>> &future) {
+    return future.wait_for(std::chrono::seconds { 0 }) == std::future_status::ready;
+}
+
+inline vec3 get_center(const paged::Node &node) noexcept {
+    return { node.center[0], node.center[1], node.center[2] };
+}
+
+inline bool fits(std::uint64_t offset, std::uint64_t size, std::uint64_t file_size) noexcept {
+    return size <= file_size && offset <= file_size - size;
+}
+
+/**
+ * @brief Checks that the children of every node follow it and that every page lies in the file.
+ * @details Children that follow their parent keep the traversal from recursing endlessly.
+ */
+bool is_valid(const std::vector<paged::Node> &nodes, std::uint64_t file_size) noexcept {
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const paged::Node &node { nodes[i] };
+        if (node.childCount > 0 && (node.firstChild <= i || node.firstChild >= nodes.size() ||
+                                    node.childCount > nodes.size() - node.firstChild)) {
+            return false;
+        }
+        if (!fits(node.offset, paged::GetPageSize(node), file_size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+void SetPagedModelBudget(std::size_t bytes) noexcept {
+    Budget = bytes;
+}
+
+PagedModel::PagedModel(const std::filesystem::path &path)
+    : _budget { Budget } {
+    _file = open(path.c_str(), O_RDONLY);
+    if (_file < 0) {
+        throw make_error("could not open", path);
+    }
+
+    try {
+        struct stat status;
+        if (fstat(_file, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(paged::Header))) {
+            throw make_error("invalid paged model", path);
+        }
+        const auto file_size { static_cast<std::uint64_t>(status.st_size) };
+
+        paged::Header header;
+        read(_file, &header, sizeof(header), 0);
+        if (std::memcmp(header.magic, paged::Magic, sizeof(paged::Magic)) != 0 ||
+            header.version != paged::Version || header.nodeCount == 0 ||
+            !fits(header.nodeOffset, std::uint64_t { header.nodeCount } * sizeof(paged::Node), file_size)) {
+            throw make_error("invalid paged model", path);
+        }
+        _nodes.resize(header.nodeCount);
+        read(_file, _nodes.data(), sizeof(paged::Node) * _nodes.size(), header.nodeOffset);
+        if (!is_valid(_nodes, file_size)) {
+            throw make_error("invalid paged model", path);
+        }
+
+        const vec3 min { header.min[0], header.min[1], header.min[2] };
+        const vec3 max { header.max[0], header.max[1], header.max[2] };
+        const float extent { std::max(std::max(max.x - min.x, max.y - min.y), std::max(max.z - min.z, 1e-6f)) };
+        _normalization = glm::scale(vec3 { 2.0f / extent }) * glm::translate(-(min + max) / 2.0f);
+        setBoundingBox(BoundingBox { vec3 { 0.0f }, (max - min) * 2.0f / extent });
+    } catch (...) {
+        close(_file);
+        throw;
+    }
+    _pages.resize(_nodes.size());
+    _lastUsed.assign(_nodes.size(), 0);
+    _failed.assign(_nodes.size(), false);
+
+    // scans have no materials
+    setMaterials({ Material { vec3 { 0.8f }, vec3 { 0.2f }, vec3 { 0.0f }, vec3 { 0.0f }, 0.0f, {} } });
+    setProgram(ResourceManager::instance().loadProgram("./assets/shaders/main.vs", "./assets/shaders/main.fs"));
+    setWireframeProgram(ResourceManager::instance().loadProgram("./assets/shaders/main.vs", "./assets/shaders/main.gs",
+                                                                "./assets/shaders/main.fs", { "WIREFRAME" }));
+}
+
+PagedModel::~PagedModel() noexcept {
+    _loads.clear();  // waits for running reads
+    close(_file);
+}
+
+std::size_t PagedModel::getBudget() const noexcept {
+    return _budget;
+}
+
+const PagedModel::Statistics& PagedModel::getStatistics() const noexcept {
+    return _statistics;
+}
+
+void PagedModel::render(const mat4 &P, const mat4 &MV, const ClusteredLighting &lighting, RenderMode mode,
+                        OcclusionCuller *occlusion) {
+    Model::render(P, MV * _normalization, lighting, mode, occlusion);  // select() works in file space
+}
+
+bool PagedModel::isLoading() const noexcept {
+    return !_loads.empty() || !_requests.empty();
+}
+
+const std::vector<Mesh*>& PagedModel::select(const mat4 &P, const mat4 &MV) {
+    ++_frame;
+    upload();
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glm::vec4 planes[6];
+    GetFrustumPlanes(P * MV, planes);
+    const vec3 camera { glm::inverse(MV) * glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f } };  // in model space
+    const float scale { P[1][1] * static_cast<float>(viewport[3]) / 2.0f };  // pixels per unit at distance 1
+
+    _selected.clear();
+    _requests.clear();
+    _statistics.neededPages = 0;
+    _statistics.pageFaults = 0;
+    traverse(0, 0, planes, camera, scale);
+    load(_requests);
+
+    _statistics.drawnPages = _selected.size();
+    return _selected;
+}
+
+void PagedModel::traverse(std::uint32_t node, unsigned depth, const glm::vec4 (&planes)[6],
+                          const vec3 &camera, float scale) {
+    if (!isVisible(node, planes)) {
+        return;
+    }
+    const float error { getScreenError(node, camera, scale) };
+    need(node, depth, error);
+    if (!_pages[node]) {
+        return;  // nothing is drawn here until the page was read
+    }
+
+    const paged::Node &data { _nodes[node] };
+    if (data.childCount > 0 && error > MaxScreenError) {
+        // children replace their parent only once all of them can be drawn
+        bool resident { true };
+        for (auto child = data.firstChild; child < data.firstChild + data.childCount; ++child) {
+            if (isVisible(child, planes)) {
+                need(child, depth + 1, getScreenError(child, camera, scale));
+                resident = resident && _pages[child];
+            }
+        }
+        if (resident) {
+            for (auto child = data.firstChild; child < data.firstChild + data.childCount; ++child) {
+                traverse(child, depth + 1, planes, camera, scale);
+            }
+            return;
+        }
+    }
+    _selected.push_back(_pages[node].get());
+}
+
+bool PagedModel::isVisible(std::uint32_t node, const glm::vec4 (&planes)[6]) const noexcept {
+    const vec3 center { get_center(_nodes[node]) };
+    for (auto &plane : planes) {
+        if (glm::dot(vec3 { plane }, center) + plane.w < -_nodes[node].radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Projects the geometric error of a node at its nearest point to the camera.
+ */
+float PagedModel::getScreenError(std::uint32_t node, const vec3 &camera, float scale) const noexcept {
+    const paged::Node &data { _nodes[node] };
+    const float distance { glm::distance(get_center(data), camera) - data.radius };
+    if (distance <= 0.0f) {
+        return data.error > 0.0f ? INFINITY : 0.0f;
+    }
+    return data.error / distance * scale;
+}
+
+void PagedModel::need(std::uint32_t node, unsigned depth, float error) {
+    if (_lastUsed[node] == _frame) {
+        return;  // refinement of the parent visits a node twice
+    }
+    _lastUsed[node] = _frame;
+    ++_statistics.neededPages;
+    if (!_pages[node]) {
+        ++_statistics.pageFaults;
+        ++_statistics.totalPageFaults;
+        if (_loads.count(node) == 0 && !_failed[node]) {
+            _requests.push_back({ node, depth, error });
+        }
+    }
+}
+
+void PagedModel::upload() {
+    std::size_t uploaded { 0 };
+    for (auto iterator = _loads.begin(); iterator != _loads.end() && uploaded < UploadLimit;) {
+        if (!is_ready(iterator->second)) {
+            ++iterator;
+            continue;
+        }
+
+        const std::uint32_t node { iterator->first };
+        const paged::Node &data { _nodes[node] };
+        std::vector<std::uint8_t> page;
+        try {
+            page = iterator->second.get();  // rethrows read errors
+        } catch (const std::exception &error) {
+            std::cout << "warning: " << error.what() << std::endl;
+            _statistics.residentBytes -= paged::GetPageSize(data);  // releases the reservation of load()
+            _failed[node] = true;
+            iterator = _loads.erase(iterator);
+            continue;
+        }
+        iterator = _loads.erase(iterator);
+
+        const std::size_t vertex_size { std::size_t { data.vertexCount } * sizeof(Vertex) };
+        auto mesh { std::make_unique<Mesh>() };
+        mesh->_vbo.bind();
+        mesh->_vbo.allocate(page.data(), static_cast<int>(vertex_size));
+        mesh->_vbo.release();
+        mesh->_ibo.bind();
+        mesh->_ibo.allocate(page.data() + vertex_size, static_cast<int>(page.size() - vertex_size));
+        mesh->_ibo.release();
+        mesh->_vertexBytes = vertex_size;
+        mesh->_indexBytes = page.size() - vertex_size;
+
+        // the program is not bound, since select() runs while the wireframe variant may be
+        QOpenGLShaderProgram &program { *_program };
+        mesh->_vao.bind();
+        mesh->_vbo.bind();
+        const auto stride { sizeof(Vertex) };
+        set_va_attribute(program.attributeLocation("position"), 3, GL_FLOAT, stride, offsetof(Vertex, position));
+        set_va_attribute(program.attributeLocation("normal"), 3, GL_FLOAT, stride, offsetof(Vertex, normal));
+        set_va_attribute(program.attributeLocation("texcoords"), 2, GL_FLOAT, stride, offsetof(Vertex, texcoords));
+        mesh->_vao.release();
+        mesh->_vbo.release();
+
+        mesh->_materialIndex = 0;
+        mesh->_boundingBox = BoundingBox { get_center(data), vec3 { data.radius * 2.0f } };
+        _pages[node] = std::move(mesh);
+        ++_statistics.residentPages;
+        uploaded += page.size();
+    }
+}
+
+/**
+ * @brief Starts reading the pages of @p requests, the coarsest and most inaccurate first.
+ */
+void PagedModel::load(const std::vector<Request> &requests) {
+    std::vector<Request> sorted { requests };
+    std::sort(sorted.begin(), sorted.end(), [] (const Request &a, const Request &b) {
+        return a.depth != b.depth ? a.depth < b.depth : a.error > b.error;
+    });
+
+    for (auto &request : sorted) {
+        if (_loads.size() >= MaxLoads) {
+            break;
+        }
+        const paged::Node &data { _nodes[request.node] };
+        const std::size_t size { paged::GetPageSize(data) };
+        if (_statistics.residentBytes + size > _budget &&
+            !evict(_statistics.residentBytes + size - _budget)) {
+            continue;  // a smaller page may still fit
+        }
+
+        _statistics.residentBytes += size;  // reserved until the page is evicted
+        _loads[request.node] = std::async(std::launch::async, [file = _file, offset = data.offset, size] {
+            std::vector<std::uint8_t> page(size);
+            read(file, page.data(), size, offset);
+            return page;
+        });
+    }
+}
+
+bool PagedModel::evict(std::size_t bytes) {
+    std::size_t released { 0 };
+    while (released < bytes) {
+        std::uint32_t lru { static_cast<std::uint32_t>(_nodes.size()) };
+        for (auto node = 0u; node < _nodes.size(); ++node) {
+            if (_pages[node] && _lastUsed[node] != _frame &&  // pages needed in this frame are never evicted
+                (lru == _nodes.size() || _lastUsed[node] < _lastUsed[lru])) {
+                lru = node;
+            }
+        }
+        if (lru == _nodes.size()) {
+            return false;
+        }
+
+        _pages[lru].reset();
+        const std::size_t size { paged::GetPageSize(_nodes[lru]) };
+        _statistics.residentBytes -= size;
+        --_statistics.residentPages;
+        released += size;
+    }
+    return true;
+}
+
+}  // namespace bgl
@@ -0,0 +1,152 @@
+/**
+ * @file paged_model.hpp
+ * @brief Out-of-core rendering of models that are paged in from a cluster hierarchy on disk.
+ */
+#ifndef GFX_PAGED_MODEL_HPP_
+#define GFX_PAGED_MODEL_HPP_
+
+#include <cstddef>     // std::size_t
+#include <cstdint>
+#include <filesystem>  // std::filesystem::path
+#include <future>      // std::future
+#include <map>
+#include <memory>      // std::unique_ptr
+#include <vector>
+
+#include "gl.hpp"
+#include "mesh.hpp"
+#include "model.hpp"
+
+
+namespace bgl {
+
+/**
+ * @brief Layout of a paged model file (.bglp).
+ * @details The header is followed by the pages and the node table. A page holds the Vertex
+ *          array and the 32-bit triangle indices of a node. The root is the first node, and the
+ *          children of each node are stored next to each other. Every inner node is a simplified
+ *          version of its children, whose geometric error is the largest distance that any
+ *          vertex was moved.
+ */
+namespace paged {
+
+constexpr char Magic[8] { 'B', 'G', 'L', 'P', 'A', 'G', 'E', 'D' };
+constexpr std::uint32_t Version { 1 };
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t nodeCount;
+    std::uint64_t nodeOffset;  // of the node table
+    float min[3];  // bounds of the model
+    float max[3];
+};
+static_assert(sizeof(Header) == 48, "the header must not be padded");
+
+struct Node {
+    float center[3];  // bounding sphere of the node and all of its descendants
+    float radius;
+    float error;  // [model units] 0 for leaves
+    std::uint32_t firstChild;
+    std::uint32_t childCount;
+    std::uint32_t vertexCount;
+    std::uint32_t indexCount;
+    std::uint32_t padding;
+    std::uint64_t offset;  // of the page
+};
+static_assert(sizeof(Node) == 48, "nodes must not be padded");
+
+inline std::size_t GetPageSize(const Node &node) noexcept {
+    return std::size_t { node.vertexCount } * sizeof(Vertex) + std::size_t { node.indexCount } * sizeof(GLuint);
+}
+
+}  // namespace paged
+
+void SetPagedModelBudget(std::size_t bytes) noexcept;  // of each paged model created afterwards
+
+/**
+ * @brief A model whose pages are streamed in and out by view and distance.
+ * @details Each frame, the hierarchy is traversed from the root. Nodes outside the view frustum
+ *          are skipped, and a node is refined into its children while its geometric error
+ *          projects to more than @p MaxScreenError pixels and all of its visible children are
+ *          resident. Missing pages are page faults. They are read on worker threads, the
+ *          coarsest and most inaccurate ones first, and uploaded in one of the next frames.
+ *          Pages that are resident or being read never exceed the memory budget. To make room,
+ *          the least recently used pages that are not needed in the current frame are evicted,
+ *          and a page is not read if that is not enough. A page that could not be read is
+ *          reported once and never requested again, so its parent keeps being drawn instead.
+ */
+class PagedModel : public Model {
+ public:
+	static constexpr std::size_t DefaultBudget { std::size_t { 512 } * 1024 * 1024 };  // 512 MiB
+	static constexpr float MaxScreenError { 1.0f };  // [pixels]
+	static constexpr unsigned MaxLoads { 4 };  // pages read from disk at the same time
+	static constexpr std::size_t UploadLimit { std::size_t { 32 } * 1024 * 1024 };  // per frame
+
+	struct Statistics {
+		std::size_t residentBytes;  // including pages being read
+		std::size_t residentPages;
+		std::size_t drawnPages;     // in the last frame
+		std::size_t neededPages;    // in the last frame
+		std::size_t pageFaults;     // in the last frame
+		std::uint64_t totalPageFaults;
+	};
+
+	/**
+	 * @throw std::runtime_error if the file could not be opened or is no valid paged model
+	 */
+	explicit PagedModel(const std::filesystem::path &path);
+	PagedModel(PagedModel&&) = delete;
+	PagedModel& operator=(PagedModel&&) = delete;
+
+	PagedModel(const PagedModel&) = delete;
+	PagedModel& operator=(const PagedModel&) = delete;
+
+	virtual ~PagedModel() noexcept;
+
+	/**
+	 * @brief Renders the model scaled into [-1, 1] like imported models (see ImportModel()).
+	 */
+	void render(const mat4 &P, const mat4 &MV, const ClusteredLighting &lighting,
+	            RenderMode mode = RenderMode::Textured, OcclusionCuller *occlusion = nullptr) override;
+
+	std::size_t getBudget() const noexcept;
+	const Statistics& getStatistics() const noexcept;
+	bool isLoading() const noexcept override;
+
+ protected:
+	const std::vector<Mesh*>& select(const mat4 &P, const mat4 &MV) override;
+
+ private:
+	struct Request {
+		std::uint32_t node;
+		unsigned depth;
+		float error;  // [pixels]
+	};
+
+	void traverse(std::uint32_t node, unsigned depth, const glm::vec4 (&planes)[6], const vec3 &camera, float scale);
+	bool isVisible(std::uint32_t node, const glm::vec4 (&planes)[6]) const noexcept;
+	float getScreenError(std::uint32_t node, const vec3 &camera, float scale) const noexcept;
+	void need(std::uint32_t node, unsigned depth, float error);  // marks a page as used and faults it in if needed
+
+	void upload();
+	void load(const std::vector<Request> &requests);
+	bool evict(std::size_t bytes);
+
+	int _file { -1 };
+	std::vector<paged::Node> _nodes;
+	std::vector<std::unique_ptr<Mesh>> _pages;  // per node, nullptr if not resident
+	std::vector<std::uint64_t> _lastUsed;       // frame each page was needed last
+	std::vector<bool> _failed;                  // pages that could not be read are not requested again
+	std::map<std::uint32_t, std::future<std::vector<std::uint8_t>>> _loads;
+	std::vector<Request> _requests;  // of the current frame
+
+	mat4 _normalization;  // from the bounds in the file into [-1, 1]
+	std::size_t _budget;
+	std::uint64_t _frame { 0 };
+	Statistics _statistics {};
+};
+
+}  // namespace bgl
+
+#endif  // GFX_PAGED_MODEL_HPP_
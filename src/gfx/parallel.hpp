@@ -0,0 +1,54 @@
+/**
+ * @file parallel.hpp
+ * @brief Minimal data parallel helpers.
+ */
+#ifndef GFX_PARALLEL_HPP_
+#define GFX_PARALLEL_HPP_
+
+#include <algorithm>  // std::min()
+#include <cstddef>    // std::size_t
+#include <thread>
+#include <vector>
+
+
+namespace bgl {
+
+/**
+ * @brief Returns the number of worker threads used by parallel_for().
+ */
+inline std::size_t get_thread_count() noexcept {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Splits [@p begin, @p end) into one chunk per hardware thread and calls
+ *        @p function(chunk_begin, chunk_end) for each chunk.
+ * @details Ranges smaller than @p min_chunk are processed on the calling thread.
+ */
+template<typename Function>
+void parallel_for(std::size_t begin, std::size_t end, Function &&function,
+                  std::size_t min_chunk = 1024) {
+    const std::size_t count { end > begin ? end - begin : 0 };
+    const std::size_t num_chunks { std::min(get_thread_count(), std::max<std::size_t>(1, count / min_chunk)) };
+    if (num_chunks <= 1) {
+        function(begin, end);
+        return;
+    }
+
+    const std::size_t chunk_size { (count + num_chunks - 1) / num_chunks };
+    std::vector<std::thread> threads;
+    threads.reserve(num_chunks - 1);
+    for (auto chunk_begin = begin + chunk_size; chunk_begin < end; chunk_begin += chunk_size) {
+        const std::size_t chunk_end { std::min(chunk_begin + chunk_size, end) };
+        threads.emplace_back([&function, chunk_begin, chunk_end] () { function(chunk_begin, chunk_end); });
+    }
+
+    function(begin, std::min(begin + chunk_size, end));  // the calling thread takes the first chunk
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+}  // namespace bgl
+
+#endif  // GFX_PARALLEL_HPP_
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cstring>  // std::memcpy()
+#include <iomanip>  // std::quoted
+#include <sstream>
+#include <stdexcept>
+
+#include "ply.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr std::size_t None { ~std::size_t { 0 } };
+constexpr std::size_t ChunkVertices { 65536 };  // read at once
+
+std::runtime_error make_error(const std::string &message, const std::filesystem::path &path) {
+    std::ostringstream oss;
+    oss << message << " " << std::quoted(path.string());
+    return std::runtime_error { oss.str() };
+}
+
+std::size_t get_size(const std::string &type) {
+    if (type == "char" || type == "int8" || type == "uchar" || type == "uint8") {
+        return 1;
+    } else if (type == "short" || type == "int16" || type == "ushort" || type == "uint16") {
+        return 2;
+    } else if (type == "int" || type == "int32" || type == "uint" || type == "uint32" ||
+               type == "float" || type == "float32") {
+        return 4;
+    } else if (type == "double" || type == "float64") {
+        return 8;
+    }
+    throw std::runtime_error { "unsupported PLY type " + type };
+}
+
+int get_channel(const std::string &name) noexcept {
+    if (name == "red" || name == "r") {
+        return 0;
+    } else if (name == "green" || name == "g") {
+        return 1;
+    } else if (name == "blue" || name == "b") {
+        return 2;
+    } else if (name == "alpha" || name == "a") {
+        return 3;
+    }
+    return -1;
+}
+
+std::uint32_t read_index(std::istream &file, std::size_t size) {
+    std::uint32_t value { 0 };  // little-endian like the host
+    file.read(reinterpret_cast<char*>(&value), static_cast<std::streamsize>(size));
+    return value;
+}
+
+}  // anonymous namespace
+
+PLYFile::PLYFile(const std::filesystem::path &path)
+    : _path { path }, _file { path, std::ios::binary } {
+    if (!_file) {
+        throw make_error("could not open", path);
+    }
+
+    std::string line;
+    if (!std::getline(_file, line) || line != "ply") {
+        throw make_error("invalid PLY file", path);
+    }
+    while (std::getline(_file, line) && line != "end_header") {
+        std::istringstream tokens { line };
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "format") {
+            std::string format;
+            tokens >> format;
+            if (format != "binary_little_endian") {
+                throw make_error("only binary little-endian PLY files are supported, not", path);
+            }
+        } else if (keyword == "element") {
+            Element element { {}, 0, 0, { None, None, None }, { None, None, None, None }, 0, 0 };
+            tokens >> element.name >> element.count;
+            if (element.name != "vertex" && element.name != "face" && element.count > 0) {
+                throw make_error("unsupported PLY element " + element.name + " in", path);
+            }
+            _elements.push_back(element);
+        } else if (keyword == "property" && !_elements.empty()) {
+            Element &element { _elements.back() };
+            std::string type;
+            tokens >> type;
+            if (element.name == "vertex") {
+                std::string name;
+                tokens >> name;
+                const auto axis { name == "x" ? 0 : name == "y" ? 1 : name == "z" ? 2 : -1 };
+                const auto channel { get_channel(name) };
+                if (axis >= 0) {
+                    if (type != "float" && type != "float32") {
+                        throw make_error("only float positions are supported in", path);
+                    }
+                    element.position[axis] = element.size;
+                } else if (channel >= 0 && get_size(type) == 1) {
+                    element.color[channel] = element.size;
+                }
+                element.size += get_size(type);
+            } else if (element.name == "face") {
+                std::string count_type, index_type;
+                tokens >> count_type >> index_type;
+                if (type != "list" || element.countSize != 0) {
+                    throw make_error("only a list of vertex indices is supported for faces in", path);
+                }
+                element.countSize = get_size(count_type);
+                element.indexSize = get_size(index_type);
+                if (element.indexSize > sizeof(std::uint32_t)) {
+                    throw make_error("invalid vertex index type in", path);
+                }
+            }
+        }
+    }
+    if (!_file) {
+        throw make_error("truncated PLY header in", path);
+    }
+}
+
+std::uint64_t PLYFile::getVertexCount() const noexcept {
+    for (auto &element : _elements) {
+        if (element.name == "vertex") {
+            return element.count;
+        }
+    }
+    return 0;
+}
+
+std::uint64_t PLYFile::getFaceCount() const noexcept {
+    for (auto &element : _elements) {
+        if (element.name == "face") {
+            return element.count;
+        }
+    }
+    return 0;
+}
+
+bool PLYFile::hasColors() const noexcept {
+    for (auto &element : _elements) {
+        if (element.name == "vertex") {
+            return element.color[0] != None && element.color[1] != None && element.color[2] != None;
+        }
+    }
+    return false;
+}
+
+void PLYFile::read(const VertexFunction &vertex, const FaceFunction &face) {
+    for (auto &element : _elements) {
+        if (element.name == "vertex") {
+            readVertices(element, vertex);
+        } else if (element.name == "face") {
+            readFaces(element, face);
+        }
+        if (!_file) {
+            throw make_error("truncated PLY file", _path);
+        }
+    }
+}
+
+void PLYFile::readVertices(const Element &element, const VertexFunction &vertex) {
+    if (std::count(std::begin(element.position), std::end(element.position), None) > 0) {
+        throw make_error("missing vertex positions in", _path);
+    }
+
+    std::vector<std::uint8_t> chunk;
+    for (std::uint64_t first = 0; first < element.count; first += ChunkVertices) {
+        const auto count { static_cast<std::size_t>(std::min<std::uint64_t>(ChunkVertices, element.count - first)) };
+        chunk.resize(count * element.size);
+        _file.read(reinterpret_cast<char*>(chunk.data()), static_cast<std::streamsize>(chunk.size()));
+        if (!_file) {
+            return;  // reported by read()
+        }
+
+        for (auto i = 0u; i < count; ++i) {
+            const std::uint8_t *record { chunk.data() + i * element.size };
+            vec3 position;
+            for (auto axis = 0; axis < 3; ++axis) {
+                std::memcpy(&position[axis], record + element.position[axis], sizeof(float));
+            }
+            std::uint32_t color { 0xFFFFFFFF };
+            for (auto channel = 0; channel < 4; ++channel) {
+                if (element.color[channel] != None) {
+                    color &= ~(std::uint32_t { 0xFF } << (8 * channel));
+                    color |= std::uint32_t { record[element.color[channel]] } << (8 * channel);
+                }
+            }
+            vertex(position, color);
+        }
+    }
+}
+
+void PLYFile::readFaces(const Element &element, const FaceFunction &face) {
+    std::vector<std::uint32_t> indices;
+    for (std::uint64_t i = 0; i < element.count && _file; ++i) {
+        indices.resize(read_index(_file, element.countSize));
+        for (auto &index : indices) {
+            index = read_index(_file, element.indexSize);
+        }
+        face(indices);
+    }
+}
+
+}  // namespace bgl
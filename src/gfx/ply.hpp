@@ -0,0 +1,71 @@
+/**
+ * @file ply.hpp
+ * @brief A streaming reader for binary PLY files too large to be imported by Assimp.
+ */
+#ifndef GFX_PLY_HPP_
+#define GFX_PLY_HPP_
+
+#include <cstddef>     // std::size_t
+#include <cstdint>
+#include <filesystem>  // std::filesystem::path
+#include <fstream>
+#include <functional>  // std::function
+#include <string>
+#include <vector>
+
+#include "gl.hpp"
+
+
+namespace bgl {
+
+/**
+ * @brief A binary little-endian PLY file with float positions and optional faces.
+ * @details The header is read on construction, the elements are passed to callbacks in file
+ *          order by read(), so a file never needs to fit into memory.
+ */
+class PLYFile {
+ public:
+	using VertexFunction = std::function<void(const vec3 &position, std::uint32_t color)>;  // RGBA8
+	using FaceFunction = std::function<void(const std::vector<std::uint32_t> &indices)>;
+
+	/**
+	 * @throw std::runtime_error if the file could not be opened or has an unsupported format
+	 */
+	explicit PLYFile(const std::filesystem::path &path);
+
+	PLYFile(const PLYFile&) = delete;
+	PLYFile& operator=(const PLYFile&) = delete;
+
+	virtual ~PLYFile() noexcept = default;
+
+	std::uint64_t getVertexCount() const noexcept;
+	std::uint64_t getFaceCount() const noexcept;
+	bool hasColors() const noexcept;  // otherwise all vertices are white
+
+	/**
+	 * @throw std::runtime_error if the file is truncated
+	 */
+	void read(const VertexFunction &vertex, const FaceFunction &face);
+
+ private:
+	struct Element {
+		std::string name;
+		std::uint64_t count;
+		std::size_t size;           // of a vertex
+		std::size_t position[3];    // offsets within a vertex
+		std::size_t color[4];       // offsets of red, green, blue and alpha
+		std::size_t countSize;      // of the index list of a face
+		std::size_t indexSize;
+	};
+
+	void readVertices(const Element &element, const VertexFunction &vertex);
+	void readFaces(const Element &element, const FaceFunction &face);
+
+	std::filesystem::path _path;
+	std::ifstream _file;
+	std::vector<Element> _elements;
+};
+
+}  // namespace bgl
+
+#endif  // GFX_PLY_HPP_
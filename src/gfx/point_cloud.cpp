@@ -0,0 +1,597 @@
+#include "gfx.hpp"
+
+#include <QMatrix4x4>
+#include <QOpenGLShaderProgram>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>    // INFINITY, std::sqrt()
+#include <cstddef>  // offsetof
+#include <cstdlib>  // std::strtof()
+#include <fstream>
+#include <iomanip>  // std::quoted
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+#include "parallel.hpp"
+#include "ply.hpp"
+#include "point_cloud.hpp"
+#include "resource_manager.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+std::size_t Budget { PointCloud::DefaultBudget };
+
+constexpr unsigned MortonBits { 21 };   // per axis
+constexpr unsigned SampleLevels { 6 };  // inner nodes keep a point per cell of a 64^3 grid
+constexpr unsigned MaxDepth { MortonBits - SampleLevels };
+constexpr std::size_t NodeCapacity { 16384 };  // points of a leaf above MaxDepth
+constexpr unsigned BucketLevels { 3 };  // the points are sorted in 512 buckets in parallel
+
+struct Keyed {
+    std::uint64_t code;
+    Point point;
+};
+
+struct Range {
+    std::size_t begin;
+    std::size_t end;
+};
+
+std::runtime_error make_error(const std::string &message, const std::filesystem::path &path) {
+    std::ostringstream oss;
+    oss << message << " " << std::quoted(path.string());
+    return std::runtime_error { oss.str() };
+}
+
+inline QMatrix4x4 to_qt(const mat4 &matrix) {
+    return QMatrix4x4 { glm::value_ptr(matrix) }.transposed();
+}
+
+/*********************************************************
+ *                        Import                         *
+ *********************************************************/
+
+/**
+ * @brief Reads "x y z [r g b]" lines, other lines are skipped.
+ */
+bool read_xyz(const std::filesystem::path &path, std::vector<Point> &points) {
+    std::ifstream file { path };
+    if (!file) {
+        throw make_error("could not open", path);
+    }
+
+    bool has_colors { false };
+    std::string line;
+    while (std::getline(file, line)) {
+        char *end { const_cast<char*>(line.c_str()) };  // NOLINT
+        float values[6];
+        auto count { 0u };
+        for (; count < 6; ++count) {
+            const char *begin { end };
+            values[count] = std::strtof(begin, &end);
+            if (end == begin) {
+                break;
+            }
+        }
+        if (count < 3) {
+            continue;  // e.g. a header with the number of points
+        }
+
+        std::uint32_t color { 0xFFFFFFFF };
+        if (count == 6) {
+            color = 0xFF000000;
+            for (auto channel = 0u; channel < 3; ++channel) {
+                color |= static_cast<std::uint32_t>(std::clamp(values[3 + channel], 0.0f, 255.0f)) << (8 * channel);
+            }
+            has_colors = true;
+        }
+        points.push_back({ vec3 { values[0], values[1], values[2] }, color });
+    }
+    return has_colors;
+}
+
+/**
+ * @brief Moves the points into [-1, 1] and returns their bounding box before.
+ */
+BoundingBox normalize(std::vector<Point> &points) {
+    vec3 min { INFINITY };
+    vec3 max { -INFINITY };
+    std::mutex mutex;
+    parallel_for(0, points.size(), [&] (std::size_t begin, std::size_t end) {
+        vec3 chunk_min { INFINITY };
+        vec3 chunk_max { -INFINITY };
+        for (auto i = begin; i < end; ++i) {
+            chunk_min = glm::min(chunk_min, points[i].position);
+            chunk_max = glm::max(chunk_max, points[i].position);
+        }
+        const std::lock_guard<std::mutex> lock { mutex };
+        min = glm::min(min, chunk_min);
+        max = glm::max(max, chunk_max);
+    });
+
+    const vec3 center { (min + max) / 2.0f };
+    const float scale { 2.0f / std::max(std::max(max.x - min.x, max.y - min.y), std::max(max.z - min.z, 1e-6f)) };
+    parallel_for(0, points.size(), [&] (std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            points[i].position = (points[i].position - center) * scale;
+        }
+    });
+    return BoundingBox { vec3 { 0.0f }, (max - min) * scale };
+}
+
+/*********************************************************
+ *                        Octree                         *
+ *********************************************************/
+
+/**
+ * @brief Inserts two zero bits between each of the lower 21 bits.
+ */
+inline std::uint64_t spread(std::uint64_t x) noexcept {
+    x &= 0x1FFFFF;
+    x = (x | x << 32) & 0x1F00000000FFFF;
+    x = (x | x << 16) & 0x1F0000FF0000FF;
+    x = (x | x << 8) & 0x100F00F00F00F00F;
+    x = (x | x << 4) & 0x10C30C30C30C30C3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+inline std::uint64_t compact(std::uint64_t x) noexcept {
+    x &= 0x1249249249249249;
+    x = (x ^ (x >> 2)) & 0x10C30C30C30C30C3;
+    x = (x ^ (x >> 4)) & 0x100F00F00F00F00F;
+    x = (x ^ (x >> 8)) & 0x1F0000FF0000FF;
+    x = (x ^ (x >> 16)) & 0x1F00000000FFFF;
+    x = (x ^ (x >> 32)) & 0x1FFFFF;
+    return x;
+}
+
+/**
+ * @brief Returns the Morton code of a position in [-1, 1], whose top 3 * l bits are the cell at level l.
+ */
+inline std::uint64_t get_code(const vec3 &position) noexcept {
+    constexpr float Resolution { static_cast<float>(1u << MortonBits) };
+    std::uint64_t code { 0 };
+    for (auto axis = 0; axis < 3; ++axis) {
+        const float cell { std::clamp((position[axis] + 1.0f) / 2.0f * Resolution, 0.0f, Resolution - 1.0f) };
+        code |= spread(static_cast<std::uint64_t>(cell)) << axis;
+    }
+    return code;
+}
+
+/**
+ * @brief Sorts the points by their Morton code.
+ * @details A counting sort by the top levels distributes the points into buckets, which are
+ *          then sorted on their own. Both run on all hardware threads.
+ */
+std::vector<Keyed> sort_points(std::vector<Point> &&points) {
+    const std::size_t buckets { std::size_t { 1 } << (3 * BucketLevels) };
+    const std::size_t chunks { get_thread_count() };
+    const std::size_t chunk_size { (points.size() + chunks - 1) / chunks };
+    const auto get_bucket = [] (std::uint64_t code) { return code >> (3 * (MortonBits - BucketLevels)); };
+    const auto for_each_chunk = [&] (auto &&function) {
+        parallel_for(0, chunks, [&] (std::size_t begin, std::size_t end) {
+            for (auto chunk = begin; chunk < end; ++chunk) {
+                function(chunk, chunk * chunk_size, std::min(points.size(), (chunk + 1) * chunk_size));
+            }
+        }, 1);
+    };
+
+    std::vector<std::size_t> offsets(chunks * buckets, 0);  // per chunk and bucket
+    for_each_chunk([&] (std::size_t chunk, std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            ++offsets[chunk * buckets + get_bucket(get_code(points[i].position))];
+        }
+    });
+    std::vector<std::size_t> starts(buckets + 1);
+    std::size_t offset { 0 };
+    for (auto bucket = 0u; bucket < buckets; ++bucket) {
+        starts[bucket] = offset;
+        for (auto chunk = 0u; chunk < chunks; ++chunk) {
+            const std::size_t count { offsets[chunk * buckets + bucket] };
+            offsets[chunk * buckets + bucket] = offset;
+            offset += count;
+        }
+    }
+    starts[buckets] = offset;
+
+    std::vector<Keyed> sorted(points.size());
+    for_each_chunk([&] (std::size_t chunk, std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            const std::uint64_t code { get_code(points[i].position) };
+            sorted[offsets[chunk * buckets + get_bucket(code)]++] = { code, points[i] };
+        }
+    });
+    points = {};  // the keyed copy replaces them
+
+    parallel_for(0, buckets, [&] (std::size_t begin, std::size_t end) {
+        for (auto bucket = begin; bucket < end; ++bucket) {
+            std::sort(sorted.begin() + starts[bucket], sorted.begin() + starts[bucket + 1],
+                      [] (const Keyed &a, const Keyed &b) { return a.code < b.code; });
+        }
+    }, 1);
+    return sorted;
+}
+
+PointNode create_node(std::uint64_t code, unsigned depth) noexcept {
+    const std::uint64_t cell { code >> (3 * (MortonBits - depth)) };
+    const float size { 2.0f / static_cast<float>(1u << depth) };
+    const vec3 coordinates { static_cast<float>(compact(cell)), static_cast<float>(compact(cell >> 1)),
+                             static_cast<float>(compact(cell >> 2)) };
+    return { vec3 { -1.0f } + (coordinates + vec3 { 0.5f }) * size, size, 0.0f, 0, 0, 0, 0 };
+}
+
+/**
+ * @brief Builds the octree level by level, the nodes of each level are sampled in parallel.
+ */
+void build_octree(std::vector<Keyed> &&sorted, PointCloudData &data) {
+    data.points.clear();
+    data.points.reserve(sorted.size() + sorted.size() / 4);  // inner nodes of surfaces add about a quarter
+    data.nodes.push_back(create_node(sorted.front().code, 0));
+    std::vector<Range> ranges { { 0, sorted.size() } };  // of the points of each node in the sorted points
+    std::vector<std::uint32_t> level { 0 };
+    std::vector<std::vector<Point>> samples;
+    for (auto depth = 0u; !level.empty(); ++depth) {
+        // children are appended in the order of their parents, so siblings are adjacent
+        std::vector<std::uint32_t> next;
+        for (auto node : level) {
+            const Range range { ranges[node] };
+            if (range.end - range.begin <= NodeCapacity || depth == MaxDepth) {
+                continue;
+            }
+            const unsigned shift { 3 * (MortonBits - depth - 1) };
+            data.nodes[node].firstChild = static_cast<std::uint32_t>(data.nodes.size());
+            for (auto begin = range.begin; begin < range.end;) {
+                const std::uint64_t digit { (sorted[begin].code >> shift) & 7 };
+                const auto end { std::partition_point(sorted.begin() + begin, sorted.begin() + range.end,
+                    [&] (const Keyed &point) { return ((point.code >> shift) & 7) == digit; }) - sorted.begin() };
+                next.push_back(static_cast<std::uint32_t>(data.nodes.size()));
+                data.nodes.push_back(create_node(sorted[begin].code, depth + 1));
+                ranges.push_back({ begin, static_cast<std::size_t>(end) });
+                ++data.nodes[node].childCount;
+                begin = static_cast<std::size_t>(end);
+            }
+        }
+
+        // inner nodes keep the first point of each cell of their sample grid
+        samples.assign(level.size(), {});
+        parallel_for(0, level.size(), [&] (std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const Range range { ranges[level[i]] };
+                const bool leaf { data.nodes[level[i]].childCount == 0 };
+                const unsigned shift { leaf ? 0 : 3 * (MortonBits - depth - SampleLevels) };
+                std::uint64_t last { ~std::uint64_t { 0 } };
+                for (auto j = range.begin; j < range.end; ++j) {
+                    const std::uint64_t cell { sorted[j].code >> shift };
+                    if (leaf || cell != last) {
+                        samples[i].push_back(sorted[j].point);
+                        last = cell;
+                    }
+                }
+            }
+        }, 1);
+
+        for (auto i = 0u; i < level.size(); ++i) {
+            PointNode &node { data.nodes[level[i]] };
+            node.firstPoint = static_cast<std::uint32_t>(data.points.size());
+            node.pointCount = static_cast<std::uint32_t>(samples[i].size());
+            node.spacing = node.size / std::sqrt(static_cast<float>(node.pointCount));
+            data.points.insert(data.points.end(), samples[i].begin(), samples[i].end());
+            // glDrawArrays() takes the first point as a GLint, the VBO is sized in GLsizeiptr bytes
+            if (data.points.size() > static_cast<std::size_t>(std::numeric_limits<GLint>::max()) ||
+                data.points.size() > static_cast<std::size_t>(std::numeric_limits<GLsizeiptr>::max()) / sizeof(Point)) {
+                throw std::runtime_error { "too many points" };
+            }
+        }
+        level = std::move(next);
+    }
+}
+
+/*********************************************************
+ *                       Benchmark                       *
+ *********************************************************/
+
+/**
+ * @brief Creates a scan of a bumpy sphere and a noisy ground plane, whose colors are the indices of
+ *        the points.
+ */
+std::vector<Point> create_scan(std::size_t count) {
+    std::mt19937 random { 42 };
+    std::normal_distribution<float> normal { 0.0f, 1.0f };
+    std::uniform_real_distribution<float> uniform { -1.0f, 1.0f };
+    std::vector<Point> points(count);
+    for (auto i = 0u; i < count; ++i) {
+        vec3 position;
+        if (i % 4 == 0) {
+            position = vec3 { 4.0f * uniform(random), -1.0f + 0.01f * uniform(random), 4.0f * uniform(random) };
+        } else {
+            const vec3 direction { glm::normalize(vec3 { normal(random), normal(random), normal(random) }) };
+            position = direction * (1.0f + 0.05f * std::sin(20.0f * direction.x) * std::cos(20.0f * direction.z));
+        }
+        points[i] = { position, static_cast<std::uint32_t>(i) };
+    }
+    return points;
+}
+
+inline bool contains(const PointNode &node, const vec3 &position) noexcept {
+    const float extent { node.size / 2.0f * (1.0f + 1e-5f) };
+    for (auto axis = 0; axis < 3; ++axis) {
+        if (std::fabs(position[axis] - node.center[axis]) > extent) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks the structure of an octree built from the points of create_scan().
+ * @details Every point must be in exactly one leaf, every node and point must lie within the cell
+ *          of its parent, leaves above the last level must not exceed their capacity and inner
+ *          nodes must not keep two points of a cell of their sample grid.
+ */
+bool check_octree(const PointCloudData &data, std::size_t count) {
+    std::vector<bool> seen(count, false);
+    std::unordered_set<std::uint64_t> cells;
+    for (auto i = 0u; i < data.nodes.size(); ++i) {
+        const PointNode &node { data.nodes[i] };
+        const auto depth { static_cast<unsigned>(std::lround(std::log2(2.0f / node.size))) };
+        if (node.firstPoint + std::size_t { node.pointCount } > data.points.size() ||
+            (node.childCount > 0 && (node.firstChild <= i || node.firstChild + node.childCount > data.nodes.size())) ||
+            (node.childCount == 0 && node.pointCount > NodeCapacity && depth < MaxDepth)) {
+            return false;
+        }
+        for (auto child = node.firstChild; child < node.firstChild + node.childCount; ++child) {
+            if (!contains(node, data.nodes[child].center) || data.nodes[child].size != node.size / 2.0f) {
+                return false;
+            }
+        }
+
+        cells.clear();
+        const unsigned shift { 3 * (MortonBits - depth - SampleLevels) };
+        for (auto j = node.firstPoint; j < node.firstPoint + node.pointCount; ++j) {
+            const Point &point { data.points[j] };
+            if (point.color >= count || !contains(node, point.position)) {
+                return false;
+            }
+            if (node.childCount == 0) {
+                if (seen[point.color]) {
+                    return false;
+                }
+                seen[point.color] = true;
+            } else if (!cells.insert(get_code(point.position) >> shift).second) {
+                return false;
+            }
+        }
+    }
+    return std::all_of(seen.begin(), seen.end(), [] (bool leaf) { return leaf; });
+}
+
+/*********************************************************
+ *                     OpenGL Code                       *
+ *********************************************************/
+
+/**
+ * @brief Uploads the points into the bound VBO.
+ * @note QOpenGLBuffer::allocate() takes an int, which overflows at 2 GiB, i.e. about 134 million points.
+ */
+void upload_points(const std::vector<Point> &points) {
+    constexpr std::size_t ChunkSize { std::size_t { 256 } * 1024 * 1024 };  // [bytes] per glBufferSubData()
+    const std::size_t size { sizeof(Point) * points.size() };
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(size), nullptr, GL_STATIC_DRAW);
+    const char * const bytes { reinterpret_cast<const char*>(points.data()) };
+    for (std::size_t offset = 0; offset < size; offset += ChunkSize) {
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset),
+                        static_cast<GLsizeiptr>(std::min(ChunkSize, size - offset)), bytes + offset);
+    }
+}
+
+// vao must be bound!
+void set_color_attribute(GLint location, GLsizei stride, GLsizei offset) {
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, reinterpret_cast<void*>(offset));
+    if (glGetError() != GL_NO_ERROR) {
+        throw std::runtime_error { "glVertexAttribPointer() failed for the point color" };
+    }
+}
+
+}  // anonymous namespace
+
+void SetPointBudget(std::size_t points) noexcept {
+    Budget = points;
+}
+
+std::size_t GetPointBudget() noexcept {
+    return Budget;
+}
+
+bool IsPointCloud(const std::filesystem::path &path) noexcept {
+    const std::string extension { path.extension().string() };
+    if (extension == ".xyz" || extension == ".XYZ") {
+        return true;
+    }
+    if (extension != ".ply" && extension != ".PLY") {
+        return false;
+    }
+    try {
+        return PLYFile { path }.getFaceCount() == 0;
+    } catch (const std::exception&) {
+        return false;  // e.g. an ASCII PLY file for Assimp
+    }
+}
+
+PointCloudData ImportPointCloud(const std::filesystem::path &path) {
+    const auto begin { std::chrono::steady_clock::now() };
+    std::vector<Point> points;
+    PointCloudData data;
+    const std::string extension { path.extension().string() };
+    if (extension == ".xyz" || extension == ".XYZ") {
+        data.hasColors = read_xyz(path, points);
+    } else {
+        PLYFile file { path };
+        points.reserve(file.getVertexCount());
+        file.read([&] (const vec3 &position, std::uint32_t color) {
+            points.push_back({ position, color });
+        }, [] (const std::vector<std::uint32_t>& /* face */) {});
+        data.hasColors = file.hasColors();
+    }
+    if (points.empty()) {
+        throw make_error("no points in", path);
+    }
+
+    const auto read { std::chrono::steady_clock::now() };
+    const std::size_t count { points.size() };
+    data.boundingBox = normalize(points);
+    build_octree(sort_points(std::move(points)), data);
+    const auto built { std::chrono::steady_clock::now() };
+
+    const auto milliseconds = [] (auto duration) { return std::chrono::duration<double, std::milli> { duration }.count(); };
+    std::cout << std::fixed << std::setprecision(1) << "read " << count << " points of " << path.filename()
+              << " in " << milliseconds(read - begin) << " ms (" << count / milliseconds(read - begin) / 1000.0
+              << " Mpoints/s), built an octree of " << data.nodes.size() << " nodes in " << milliseconds(built - read)
+              << " ms (" << count / milliseconds(built - read) / 1000.0 << " Mpoints/s)" << std::endl;
+    return data;
+}
+
+bool RunOctreeBenchmark() {
+    constexpr std::size_t Count { std::size_t { 8 } * 1000 * 1000 };
+    std::vector<Point> points { create_scan(Count) };
+
+    const auto begin { std::chrono::steady_clock::now() };
+    PointCloudData data;
+    data.boundingBox = normalize(points);
+    build_octree(sort_points(std::move(points)), data);
+    const double time { std::chrono::duration<double, std::milli> { std::chrono::steady_clock::now() - begin }.count() };
+    const bool valid { check_octree(data, Count) };
+
+    std::cout << std::fixed << std::setprecision(1) << Count << " points: octree of " << data.nodes.size()
+              << " nodes and " << data.points.size() << " points built in " << time << " ms ("
+              << Count / time / 1000.0 << " Mpoints/s) on " << get_thread_count() << " threads"
+              << (valid ? "" : " MISMATCH") << std::endl;
+    return valid;
+}
+
+PointCloud::PointCloud(const PointCloudData &data)
+    : _vbo { QOpenGLBuffer::VertexBuffer }, _nodes { data.nodes },
+      _pointCount { data.points.size() }, _hasColors { data.hasColors } {
+    setProgram(ResourceManager::instance().loadProgram("./assets/shaders/points.vs", "./assets/shaders/points.fs"));
+    setBoundingBox(data.boundingBox);
+
+    if (!_vbo.create()) {
+        throw std::runtime_error { "could not create VBO" };
+    }
+    if (!_vao.create()) {
+        throw std::runtime_error { "could not create VAO" };
+    }
+    _vbo.bind();
+    upload_points(data.points);
+    _vao.bind();
+    set_va_attribute(_program->attributeLocation("position"), 3, GL_FLOAT, sizeof(Point), offsetof(Point, position));
+    set_color_attribute(_program->attributeLocation("color"), sizeof(Point), offsetof(Point, color));
+    _vao.release();
+    _vbo.release();
+}
+
+void PointCloud::render(const mat4 &P, const mat4 &MV, const ClusteredLighting & /* lighting */, RenderMode mode,
+                        OcclusionCuller * /* occlusion */) {
+    _lastRendered = std::chrono::steady_clock::now();
+    selectNodes(P, MV);
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    QOpenGLShaderProgram &program { *_program };
+    program.bind();
+    program.setUniformValue("MVP", to_qt(P * MV));
+    program.setUniformValue("MV", to_qt(MV));
+    program.setUniformValue("pixelScale", P[1][1] * static_cast<float>(viewport[3]) / 2.0f);
+    program.setUniformValue("maxPointSize", MaxPointSize);
+    program.setUniformValue("isColored", static_cast<GLuint>(_hasColors && mode == RenderMode::Textured));
+    program.setUniformValue("solidColor", 0.8f, 0.8f, 0.8f);
+
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    _vao.bind();
+    _statistics = {};
+    for (auto node : _selectedNodes) {
+        const PointNode &data { _nodes[node] };
+        program.setUniformValue("spacing", data.spacing);
+        glDrawArrays(GL_POINTS, static_cast<GLint>(data.firstPoint), static_cast<GLsizei>(data.pointCount));
+        _statistics.drawnPoints += data.pointCount;
+    }
+    _statistics.drawnNodes = _selectedNodes.size();
+    _vao.release();
+    glDisable(GL_PROGRAM_POINT_SIZE);
+    program.release();
+}
+
+std::size_t PointCloud::getSize() const noexcept {
+    return sizeof(Point) * _pointCount;
+}
+
+const PointCloud::Statistics& PointCloud::getStatistics() const noexcept {
+    return _statistics;
+}
+
+void PointCloud::selectNodes(const mat4 &P, const mat4 &MV) {
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glm::vec4 planes[6];
+    GetFrustumPlanes(P * MV, planes);
+    const vec3 camera { glm::inverse(MV) * glm::vec4 { 0.0f, 0.0f, 0.0f, 1.0f } };  // in model space
+    const float scale { P[1][1] * static_cast<float>(viewport[3]) / 2.0f };  // pixels per unit at distance 1
+
+    const auto is_visible = [&] (const PointNode &node) {
+        const float radius { node.size * 0.8660254f };  // half the diagonal of the cell
+        for (auto &plane : planes) {
+            if (glm::dot(vec3 { plane }, node.center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    _selectedNodes.clear();
+    if (!is_visible(_nodes.front())) {
+        return;
+    }
+    std::priority_queue<std::pair<float, std::uint32_t>> queue;  // screen spacing and node
+    queue.push({ getScreenSpacing(_nodes.front(), camera, scale), 0 });
+    std::size_t points { _nodes.front().pointCount };
+    const std::size_t budget { GetPointBudget() };
+    while (!queue.empty()) {
+        const auto [spacing, node] = queue.top();
+        queue.pop();
+        const PointNode &data { _nodes[node] };
+
+        std::size_t child_points { 0 };
+        for (auto child = data.firstChild; child < data.firstChild + data.childCount; ++child) {
+            child_points += is_visible(_nodes[child]) ? _nodes[child].pointCount : 0;
+        }
+        if (data.childCount == 0 || spacing <= MinScreenSpacing || points - data.pointCount + child_points > budget) {
+            _selectedNodes.push_back(node);  // smaller nodes may still fit into the budget
+            continue;
+        }
+
+        points = points - data.pointCount + child_points;
+        for (auto child = data.firstChild; child < data.firstChild + data.childCount; ++child) {
+            if (is_visible(_nodes[child])) {
+                queue.push({ getScreenSpacing(_nodes[child], camera, scale), child });
+            }
+        }
+    }
+}
+
+float PointCloud::getScreenSpacing(const PointNode &node, const vec3 &camera, float scale) const noexcept {
+    const float distance { glm::distance(node.center, camera) - node.size * 0.8660254f };
+    return distance > 0.0f ? node.spacing / distance * scale : INFINITY;
+}
+
+}  // namespace bgl
@@ -0,0 +1,123 @@
+/**
+ * @file point_cloud.hpp
+ * @brief Rendering of large scans from an octree with subsampled levels of detail.
+ */
+#ifndef GFX_POINT_CLOUD_HPP_
+#define GFX_POINT_CLOUD_HPP_
+
+#include <cstddef>     // std::size_t
+#include <cstdint>
+#include <filesystem>  // std::filesystem::path
+#include <vector>
+
+#include "gl.hpp"
+#include "bounding_box.hpp"
+#include "model.hpp"
+
+#include <QOpenGLBuffer>             // NOLINT
+#include <QOpenGLVertexArrayObject>  // NOLINT
+
+
+namespace bgl {
+
+void SetPointBudget(std::size_t points) noexcept;  // drawn per point cloud and frame
+std::size_t GetPointBudget() noexcept;
+
+struct Point {
+    vec3 position;
+    std::uint32_t color;  // RGBA8
+};
+
+/**
+ * @brief A cell of the octree around a point cloud.
+ * @details Inner nodes hold about one point per cell of a 64^3 grid over their cell, leaves
+ *          hold all of their points. A node is drawn instead of its children, not in addition.
+ */
+struct PointNode {
+    vec3 center;
+    float size;     // edge length of the cell
+    float spacing;  // between neighbouring points, assuming they lie on a surface
+    std::uint32_t firstPoint;
+    std::uint32_t pointCount;
+    std::uint32_t firstChild;
+    std::uint32_t childCount;
+};
+
+/**
+ * @brief Everything a PointCloud needs besides OpenGL.
+ */
+struct PointCloudData {
+    std::vector<Point> points;  // of all nodes, each node's points are contiguous
+    std::vector<PointNode> nodes;  // breadth first, so the root comes first and siblings are adjacent
+    BoundingBox boundingBox;
+    bool hasColors;
+};
+
+/**
+ * @brief Returns whether a file is a point cloud, i.e. an XYZ file or a PLY file without faces.
+ */
+bool IsPointCloud(const std::filesystem::path &path) noexcept;
+
+/**
+ * @brief Reads an XYZ (x y z [r g b] per line) or binary PLY file, scales it into [-1, 1]
+ *        like imported models and builds its octree in parallel.
+ * @note Does not need an OpenGL context and may be called from any thread.
+ * @throw std::runtime_error if the file could not be read
+ */
+PointCloudData ImportPointCloud(const std::filesystem::path &path);
+
+/**
+ * @brief Builds the octree of a synthetic scan of 8 million points and prints the throughput.
+ * @return whether every point ended up in one leaf and the nodes and their samples lie within
+ *         their cells and limits
+ */
+bool RunOctreeBenchmark();
+
+/**
+ * @brief A point cloud drawn as round points whose size follows the spacing of their node.
+ * @details Each frame, the node whose points lie furthest apart on screen is refined into
+ *          its visible children until the point budget would be exceeded or all points lie
+ *          less than @p MinScreenSpacing pixels apart.
+ */
+class PointCloud : public Model {
+ public:
+	static constexpr std::size_t DefaultBudget { std::size_t { 5 } * 1000 * 1000 };  // points
+	static constexpr float MinScreenSpacing { 1.0f };  // [pixels]
+	static constexpr float MaxPointSize { 16.0f };     // [pixels]
+
+	struct Statistics {
+		std::size_t drawnPoints;  // in the last frame
+		std::size_t drawnNodes;
+	};
+
+	explicit PointCloud(const PointCloudData &data);
+	PointCloud(PointCloud&&) = delete;
+	PointCloud& operator=(PointCloud&&) = delete;
+
+	PointCloud(const PointCloud&) = delete;
+	PointCloud& operator=(const PointCloud&) = delete;
+
+	virtual ~PointCloud() noexcept = default;
+
+	void render(const mat4 &P, const mat4 &MV, const ClusteredLighting &lighting,
+	            RenderMode mode = RenderMode::Textured, OcclusionCuller *occlusion = nullptr) override;
+
+	std::size_t getSize() const noexcept;  // [bytes] of GPU memory
+	const Statistics& getStatistics() const noexcept;
+
+ private:
+	void selectNodes(const mat4 &P, const mat4 &MV);
+	float getScreenSpacing(const PointNode &node, const vec3 &camera, float scale) const noexcept;
+
+	QOpenGLBuffer _vbo;
+	QOpenGLVertexArrayObject _vao;
+	std::vector<PointNode> _nodes;
+	std::vector<std::uint32_t> _selectedNodes;  // of the current frame
+	std::size_t _pointCount;
+	bool _hasColors;
+	Statistics _statistics {};
+};
+
+}  // namespace bgl
+
+#endif  // GFX_POINT_CLOUD_HPP_
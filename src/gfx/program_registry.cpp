@@ -0,0 +1,278 @@
+#include <unistd.h>  // getpid()
+
+#include "gl.hpp"
+
+#include <QOpenGLShaderProgram>
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>   // std::hex
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "program_registry.hpp"
+#include "gfx.hpp"  // bgl::GetCacheDirectory(), bgl::Hash()
+
+
+namespace bgl {
+
+namespace {
+
+constexpr std::uint32_t BinaryMagic { 0x50474c42 };  // "BGLP"
+
+struct BinaryHeader {
+    std::uint32_t magic;
+    std::uint32_t format;  // GLenum
+    std::uint32_t size;
+};
+
+std::string read_file(const std::filesystem::path &path) {
+    std::ifstream file { path, std::ios::binary };
+    if (!file) {
+        std::ostringstream oss;
+        oss << "could not open " << std::quoted(path.string());
+        throw std::runtime_error { oss.str() };
+    }
+    std::ostringstream oss;
+    oss << file.rdbuf();
+    return oss.str();
+}
+
+/**
+ * @brief Inserts @p defines right after the #version directive of @p source.
+ */
+std::string add_defines(const std::string &source, const ProgramRegistry::Defines &defines) {
+    if (defines.empty()) {
+        return source;
+    }
+
+    std::string lines;
+    for (auto &define : defines) {
+        lines += "#define " + define + "\n";
+    }
+
+    std::size_t position { 0 };
+    if (source.compare(0, 8, "#version") == 0) {
+        position = source.find('\n');
+        position = position == std::string::npos ? source.size() : position + 1;
+    }
+    return source.substr(0, position) + lines + source.substr(position);
+}
+
+std::string get_binary_name(std::uint64_t key) {
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << key << ".bin";
+    return oss.str();
+}
+
+std::filesystem::path get_default_cache_directory() {
+    const std::filesystem::path directory { GetCacheDirectory() };
+    return directory.empty() ? directory : directory / "programs";
+}
+
+std::string get_driver() {
+    const auto to_string = [] (GLenum name) {
+        const GLubyte *string { glGetString(name) };
+        return string ? std::string { reinterpret_cast<const char*>(string) } : std::string {};
+    };
+    return to_string(GL_VENDOR) + "|" + to_string(GL_RENDERER) + "|" + to_string(GL_VERSION);
+}
+
+bool is_binary_supported() {
+    if (!GLEW_ARB_get_program_binary) {
+        return false;
+    }
+    GLint formats { 0 };
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+}  // anonymous namespace
+
+ProgramRegistry& ProgramRegistry::instance() {
+    static ProgramRegistry registry;
+    return registry;
+}
+
+ProgramRegistry::ProgramRegistry()
+    : _cacheDirectory { get_default_cache_directory() } {
+}
+
+std::shared_ptr<QOpenGLShaderProgram> ProgramRegistry::get(const std::filesystem::path &vs,
+                                                           const std::filesystem::path &fs,
+                                                           const Defines &defines) {
+    return get(vs, {}, fs, defines);
+}
+
+std::shared_ptr<QOpenGLShaderProgram> ProgramRegistry::get(const std::filesystem::path &vs,
+                                                           const std::filesystem::path &gs,
+                                                           const std::filesystem::path &fs,
+                                                           const Defines &defines) {
+    const std::string vs_source { add_defines(getSource(vs), defines) };
+    const std::string gs_source { gs.empty() ? std::string {} : add_defines(getSource(gs), defines) };
+    const std::string fs_source { add_defines(getSource(fs), defines) };
+    const std::uint64_t key { Hash(fs_source, gs.empty() ? Hash(vs_source) : Hash(gs_source, Hash(vs_source))) };
+
+    if (auto program { _programs[key].lock() }) {
+        return program;
+    }
+
+    const auto program { link({ vs_source, gs_source, fs_source, {} }, key) };
+    _programs[key] = program;
+    return program;
+}
+
+std::shared_ptr<QOpenGLShaderProgram> ProgramRegistry::getCompute(const std::filesystem::path &cs,
+                                                                  const Defines &defines) {
+    const std::string cs_source { add_defines(getSource(cs), defines) };
+    const std::uint64_t key { Hash(cs_source) };
+
+    if (auto program { _programs[key].lock() }) {
+        return program;
+    }
+
+    const auto program { link({ {}, {}, {}, cs_source }, key) };
+    _programs[key] = program;
+    return program;
+}
+
+void ProgramRegistry::prefetch(const std::filesystem::path &vs, const std::filesystem::path &fs) {
+    prefetch(vs);
+    prefetch(fs);
+}
+
+void ProgramRegistry::prefetch(const std::filesystem::path &path) {
+    if (_sources.count(path) == 0) {
+        _sources[path] = std::async(std::launch::async, &read_file, path).share();
+    }
+}
+
+std::string ProgramRegistry::getSource(const std::filesystem::path &path) {
+    const auto iterator { _sources.find(path) };
+    if (iterator == _sources.end()) {
+        return read_file(path);
+    }
+
+    const std::string source { iterator->second.get() };
+    _sources.erase(iterator);
+    return source;
+}
+
+void ProgramRegistry::setCacheDirectory(const std::filesystem::path &directory) {
+    _cacheDirectory = directory;
+}
+
+const std::filesystem::path& ProgramRegistry::getCacheDirectory() const noexcept {
+    return _cacheDirectory;
+}
+
+std::shared_ptr<QOpenGLShaderProgram> ProgramRegistry::link(const Sources &sources, std::uint64_t key) {
+    if (_driver.empty()) {
+        _driver = get_driver();
+    }
+    const std::uint64_t binary_key { Hash(_driver, key) };
+    const bool binaries { !_cacheDirectory.empty() && is_binary_supported() };
+
+    const auto program { std::make_shared<QOpenGLShaderProgram>() };
+    if (!program->create()) {
+        throw std::runtime_error { "could not create shader program" };
+    }
+    if (binaries && loadBinary(*program, binary_key)) {
+        return program;
+    }
+
+    if (!sources.vs.empty() && !program->addShaderFromSourceCode(QOpenGLShader::Vertex, sources.vs.c_str())) {
+        throw std::runtime_error { "could not add vertex shader" };
+    }
+    if (!sources.gs.empty() && !program->addShaderFromSourceCode(QOpenGLShader::Geometry, sources.gs.c_str())) {
+        throw std::runtime_error { "could not add geometry shader" };
+    }
+    if (!sources.fs.empty() && !program->addShaderFromSourceCode(QOpenGLShader::Fragment, sources.fs.c_str())) {
+        throw std::runtime_error { "could not add fragment shader" };
+    }
+    if (!sources.cs.empty() && !program->addShaderFromSourceCode(QOpenGLShader::Compute, sources.cs.c_str())) {
+        throw std::runtime_error { "could not add compute shader" };
+    }
+    if (binaries) {
+        glProgramParameteri(program->programId(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+    if (!program->link()) {
+        throw std::runtime_error { "could not link shader program: " + program->log().toStdString() };
+    }
+
+    if (binaries) {
+        storeBinary(*program, binary_key);
+    }
+    return program;
+}
+
+bool ProgramRegistry::loadBinary(QOpenGLShaderProgram &program, std::uint64_t key) const {
+    const std::filesystem::path path { _cacheDirectory / get_binary_name(key) };
+    std::error_code error;
+    const std::uintmax_t file_size { std::filesystem::file_size(path, error) };
+    if (error || file_size < sizeof(BinaryHeader)) {
+        return false;
+    }
+
+    std::ifstream file { path, std::ios::binary };
+    BinaryHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != BinaryMagic ||
+        header.size != file_size - sizeof(header)) {
+        return false;  // e.g. a truncated file, whose size must not be allocated
+    }
+    std::vector<char> binary(header.size);
+    if (!file.read(binary.data(), binary.size())) {
+        return false;
+    }
+
+    glProgramBinary(program.programId(), header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+    if (glGetError() != GL_NO_ERROR) {
+        return false;  // e.g. the binary format is no longer supported after a driver update
+    }
+    return program.link();  // only checks the link status as there are no shaders attached
+}
+
+void ProgramRegistry::storeBinary(QOpenGLShaderProgram &program, std::uint64_t key) const {
+    GLint size { 0 };
+    glGetProgramiv(program.programId(), GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0) {
+        return;
+    }
+
+    BinaryHeader header { BinaryMagic, 0, static_cast<std::uint32_t>(size) };
+    std::vector<char> binary(header.size);
+    GLenum format { 0 };
+    glGetProgramBinary(program.programId(), size, nullptr, &format, binary.data());
+    if (glGetError() != GL_NO_ERROR) {
+        return;
+    }
+    header.format = format;
+
+    const std::filesystem::path path { _cacheDirectory / get_binary_name(key) };
+
+    std::error_code error;
+    std::filesystem::create_directories(_cacheDirectory, error);
+
+    // write to a temporary file first, so concurrent instances never read partial binaries
+    static std::atomic<unsigned> counter { 0 };
+    const std::filesystem::path temporary {
+        path.string() + "." + std::to_string(getpid()) + "." + std::to_string(counter++) + ".tmp" };
+    {
+        std::ofstream file { temporary, std::ios::binary };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), binary.size());
+        if (!file) {
+            std::cout << "warning: could not write program binary " << temporary << std::endl;
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+}  // namespace bgl
@@ -0,0 +1,80 @@
+/**
+ * @file program_registry.hpp
+ * @brief Shared and disk-cached shader programs.
+ */
+#ifndef GFX_PROGRAM_REGISTRY_HPP_
+#define GFX_PROGRAM_REGISTRY_HPP_
+
+#include <cstdint>
+#include <filesystem>  // std::filesystem::path
+#include <future>      // std::shared_future
+#include <map>
+#include <memory>      // std::shared_ptr, std::weak_ptr
+#include <string>
+#include <vector>
+
+class QOpenGLShaderProgram;
+
+
+namespace bgl {
+
+/**
+ * @brief Compiles every shader program once and shares it between all its users.
+ * @details Programs are keyed by their shader sources and preprocessor defines. Linked programs
+ *          are additionally stored as program binaries on disk, keyed by the OpenGL driver, so
+ *          later runs skip GLSL compilation and linking. All methods but prefetch() must be
+ *          called with the OpenGL context being current.
+ */
+class ProgramRegistry {
+ public:
+	using Defines = std::vector<std::string>;
+
+	static ProgramRegistry& instance();
+
+	ProgramRegistry(ProgramRegistry&&) = delete;
+	ProgramRegistry& operator=(ProgramRegistry&&) = delete;
+
+	ProgramRegistry(const ProgramRegistry&) = delete;
+	ProgramRegistry& operator=(const ProgramRegistry&) = delete;
+
+	virtual ~ProgramRegistry() noexcept = default;
+
+	std::shared_ptr<QOpenGLShaderProgram> get(const std::filesystem::path &vs,
+	                                          const std::filesystem::path &fs,
+	                                          const Defines &defines = {});
+	std::shared_ptr<QOpenGLShaderProgram> get(const std::filesystem::path &vs,
+	                                          const std::filesystem::path &gs,  // geometry shader
+	                                          const std::filesystem::path &fs,
+	                                          const Defines &defines);
+	std::shared_ptr<QOpenGLShaderProgram> getCompute(const std::filesystem::path &cs,
+	                                                 const Defines &defines = {});
+	void prefetch(const std::filesystem::path &vs, const std::filesystem::path &fs);  // reads sources on a worker thread
+	void prefetch(const std::filesystem::path &path);
+
+	void setCacheDirectory(const std::filesystem::path &directory);
+	const std::filesystem::path& getCacheDirectory() const noexcept;
+
+ private:
+	ProgramRegistry();
+
+	struct Sources {  // empty if there is no such shader
+		std::string vs;
+		std::string gs;
+		std::string fs;
+		std::string cs;
+	};
+
+	std::string getSource(const std::filesystem::path &path);
+	std::shared_ptr<QOpenGLShaderProgram> link(const Sources &sources, std::uint64_t key);
+	bool loadBinary(QOpenGLShaderProgram &program, std::uint64_t key) const;
+	void storeBinary(QOpenGLShaderProgram &program, std::uint64_t key) const;
+
+	std::map<std::uint64_t, std::weak_ptr<QOpenGLShaderProgram>> _programs;
+	std::map<std::filesystem::path, std::shared_future<std::string>> _sources;  // prefetched sources
+	std::filesystem::path _cacheDirectory;
+	std::string _driver;  // identifies the OpenGL implementation that created the binaries
+};
+
+}  // namespace bgl
+
+#endif  // GFX_PROGRAM_REGISTRY_HPP_
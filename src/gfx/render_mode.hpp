@@ -0,0 +1,42 @@
+/**
+ * @file render_mode.hpp
+ * @brief How models are drawn.
+ */
+#ifndef GFX_RENDER_MODE_HPP_
+#define GFX_RENDER_MODE_HPP_
+
+
+namespace bgl {
+
+enum class RenderMode {
+    Solid,           // lit, without textures
+    Textured,        // lit and textured
+    Wireframe,       // triangle edges only
+    SolidWireframe   // triangle edges on top of solid
+};
+
+inline const char* GetName(RenderMode mode) noexcept {
+    switch (mode) {
+        case RenderMode::Solid:
+            return "Solid";
+        case RenderMode::Textured:
+            return "Textured";
+        case RenderMode::Wireframe:
+            return "Wireframe";
+        case RenderMode::SolidWireframe:
+            return "Solid + Wireframe";
+        default:
+            return "";
+    }
+}
+
+/**
+ * @brief Whether triangle edges are drawn (in the same pass, see main.gs).
+ */
+inline bool HasWireframe(RenderMode mode) noexcept {
+    return mode == RenderMode::Wireframe || mode == RenderMode::SolidWireframe;
+}
+
+}  // namespace bgl
+
+#endif  // GFX_RENDER_MODE_HPP_
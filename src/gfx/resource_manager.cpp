@@ -0,0 +1,362 @@
+#include "gfx.hpp"
+
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+#include <utility>  // std::pair
+
+#include "resource_manager.hpp"
+#include "allocation.hpp"
+#include "importer.hpp"
+#include "paged_model.hpp"
+#include "program_registry.hpp"
+#include "texture.hpp"
+#include "texture_streamer.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+inline std::string get_key(const std::filesystem::path &path) {
+    return std::filesystem::weakly_canonical(path).string();
+}
+
+inline bool is_paged(const std::filesystem::path &path) {
+    return path.extension() == ".bglp";
+}
+
+/**
+ * @brief Returns the bytes of a mesh's vertex, tangent and instance buffers.
+ */
+std::size_t get_vertex_size(const Mesh &mesh) noexcept {
+    const std::size_t vertices { mesh._vertexBytes / sizeof(Vertex) };
+    const std::size_t tangents { mesh._tangents.isCreated() ? vertices * sizeof(glm::vec4) : 0 };
+    const std::size_t instances { mesh._instances.isCreated() ? mesh._instanceCount * sizeof(mat4) : 0 };
+    return mesh._vertexBytes + tangents + instances;
+}
+
+/**
+ * @brief Returns the CPU memory of a mesh's occluder, 0 if it has none.
+ */
+std::size_t get_occluder_size(const Mesh &mesh) noexcept {
+    if (!mesh._occluder) {
+        return 0;
+    }
+    return mesh._occluder->positions.capacity() * sizeof(vec3) +
+           mesh._occluder->indices.capacity() * sizeof(GLuint);
+}
+
+/**
+ * @brief Estimates the memory of a model's meshes (its textures are shared and counted separately).
+ * @note Includes the CPU copies of occluders, which hold every instance of a mesh.
+ */
+std::size_t estimate_size(const Model &model) {
+    if (const auto *cloud { dynamic_cast<const PointCloud*>(&model) }) {
+        return cloud->getSize();
+    }
+    std::size_t size { 0 };
+    for (auto &mesh : model.getMeshes()) {
+        size += get_vertex_size(mesh) + mesh._indexBytes + get_occluder_size(mesh);
+    }
+    return size;
+}
+
+/**
+ * @brief Estimates the GPU memory of a texture including its mip chain.
+ */
+std::size_t estimate_size(const QOpenGLTexture &texture) {
+    const std::size_t texels { static_cast<std::size_t>(texture.width()) * texture.height() };
+    std::size_t size;
+    switch (texture.format()) {
+        case QOpenGLTexture::RGB_DXT1:
+            size = texels / 2;
+            break;
+        case QOpenGLTexture::RGBA_DXT5:
+        case QOpenGLTexture::RG_ATI2N_UNorm:
+        case QOpenGLTexture::RGB_BP_UNorm:
+            size = texels;
+            break;
+        default:
+            size = texels * 4;  // RGBA8
+            break;
+    }
+    return texture.mipLevels() > 1 ? size * 4 / 3 : size;
+}
+
+/**
+ * @brief Returns the GPU memory of a texture's resident mip levels.
+ */
+std::size_t get_resident_size(const QOpenGLTexture &texture) {
+    const std::optional<unsigned> level { TextureStreamer::instance().getResidentLevel(texture) };
+    const std::size_t size { estimate_size(texture) };
+    return level ? size >> std::min(2 * *level, 62u) : size;  // every level has a quarter of the texels
+}
+
+std::vector<std::pair<const char*, const QOpenGLTexture*>> get_textures(const Material &material) {
+    std::vector<std::pair<const char*, const QOpenGLTexture*>> textures;
+    for (const auto &[slot, texture] : { std::pair { "diffuse", material.textures.diffuse.get() },
+                                         std::pair { "ambient", material.textures.ambient.get() },
+                                         std::pair { "specular", material.textures.specular.get() },
+                                         std::pair { "emissive", material.textures.emissive.get() } }) {
+        if (texture != nullptr) {
+            textures.emplace_back(slot, texture);
+        }
+    }
+    return textures;
+}
+
+MeshMemory measure_mesh(const Mesh &mesh) {
+    return { mesh._materialIndex, get_vertex_size(mesh), mesh._indexBytes,
+             mesh._meshlets.capacity() * sizeof(Meshlet), get_occluder_size(mesh),
+             static_cast<std::size_t>(std::max<GLsizei>(mesh._instanceCount, 1)) };
+}
+
+const char* get_type(const Model &model) {
+    if (dynamic_cast<const PagedModel*>(&model) != nullptr) {
+        return "paged";
+    }
+    return dynamic_cast<const PointCloud*>(&model) != nullptr ? "point cloud" : "mesh";
+}
+
+}  // anonymous namespace
+
+ResourceManager& ResourceManager::instance() {
+    static ResourceManager manager;
+    return manager;
+}
+
+void ResourceManager::prefetchModel(const std::filesystem::path &path) {
+    if (is_paged(path)) {
+        return;  // paged models are streamed after they were created
+    }
+    const std::string key { get_key(path) };
+    if (_models.count(key) > 0 || _prefetched.count(key) > 0 || _prefetchedClouds.count(key) > 0) {
+        return;
+    }
+    if (IsPointCloud(path)) {
+        _prefetchedClouds[key] = std::async(std::launch::async, &ImportPointCloud, path);
+    } else {
+        _prefetched[key] = std::async(std::launch::async, &ImportModel, path);
+    }
+}
+
+bool ResourceManager::isModelReady(const std::filesystem::path &path) const {
+    const std::string key { get_key(path) };
+    const auto prefetched { _prefetched.find(key) };
+    if (prefetched != _prefetched.end()) {
+        return prefetched->second.wait_for(std::chrono::seconds { 0 }) == std::future_status::ready;
+    }
+    const auto cloud { _prefetchedClouds.find(key) };
+    return cloud == _prefetchedClouds.end() ||
+           cloud->second.wait_for(std::chrono::seconds { 0 }) == std::future_status::ready;
+}
+
+std::shared_ptr<Model> ResourceManager::loadModel(const std::filesystem::path &path) {
+    const std::string key { get_key(path) };
+    const auto iterator { _models.find(key) };
+    if (iterator != _models.end()) {
+        return iterator->second.model;
+    }
+
+    std::shared_ptr<Model> model;
+    const auto prefetched { _prefetched.find(key) };
+    const auto cloud { _prefetchedClouds.find(key) };
+    if (is_paged(path)) {
+        model = std::make_shared<PagedModel>(path);  // its pages are budgeted on their own
+    } else if (cloud != _prefetchedClouds.end()) {
+        std::future<PointCloudData> data { std::move(cloud->second) };
+        _prefetchedClouds.erase(cloud);
+        model = std::make_shared<PointCloud>(data.get());  // rethrows import errors
+    } else if (IsPointCloud(path)) {
+        model = std::make_shared<PointCloud>(ImportPointCloud(path));
+    } else if (prefetched != _prefetched.end()) {
+        std::future<ModelData> data { std::move(prefetched->second) };
+        _prefetched.erase(prefetched);
+        model = CreateModel(data.get());  // rethrows import errors
+    } else {
+        model = LoadModel(path);
+    }
+    _models[key] = { model, estimate_size(*model) };
+    ++_revision;
+    collect();
+    return model;
+}
+
+std::shared_ptr<QOpenGLTexture> ResourceManager::loadTexture(const std::filesystem::path &path) {
+    if (auto texture { findTexture(get_key(path)) }) {
+        return texture;
+    }
+    return loadTexture(ImportTexture(path));
+}
+
+std::shared_ptr<QOpenGLTexture> ResourceManager::loadTexture(const TextureData &data) {
+    const std::string key { get_key(data.path) };
+    if (auto texture { findTexture(key) }) {
+        return texture;
+    }
+
+    const std::shared_ptr<QOpenGLTexture> texture { CreateTexture(data) };
+    _textures[key] = { texture, estimate_size(*texture) };
+    ++_revision;
+    return texture;
+}
+
+std::shared_ptr<QOpenGLShaderProgram> ResourceManager::loadProgram(const std::filesystem::path &vs,
+                                                                   const std::filesystem::path &fs) {
+    return ProgramRegistry::instance().get(vs, fs);
+}
+
+std::shared_ptr<QOpenGLShaderProgram> ResourceManager::loadProgram(const std::filesystem::path &vs,
+                                                                   const std::filesystem::path &gs,
+                                                                   const std::filesystem::path &fs,
+                                                                   const std::vector<std::string> &defines) {
+    return ProgramRegistry::instance().get(vs, gs, fs, defines);
+}
+
+void ResourceManager::setBudget(std::size_t bytes) noexcept {
+    _budget = bytes;
+}
+
+std::size_t ResourceManager::getBudget() const noexcept {
+    return _budget;
+}
+
+std::size_t ResourceManager::getUsage() const noexcept {
+    std::size_t usage { 0 };
+    for (auto &[key, entry] : _models) {
+        usage += entry.size;
+    }
+    for (auto &[key, entry] : _textures) {
+        usage += entry.texture.expired() ? 0 : entry.size;
+    }
+    return usage;
+}
+
+MemoryReport ResourceManager::getMemoryReport() {
+    releaseExpired();
+
+    std::map<const QOpenGLTexture*, std::string> paths;
+    for (auto &[key, entry] : _textures) {
+        if (const auto texture { entry.texture.lock() }) {
+            paths[texture.get()] = key;
+        }
+    }
+    std::map<const QOpenGLTexture*, std::size_t> users;
+    for (auto &[key, entry] : _models) {
+        std::set<const QOpenGLTexture*> used;
+        for (const Material &material : entry.model->getMaterials()) {
+            for (auto &[slot, texture] : get_textures(material)) {
+                used.insert(texture);
+            }
+        }
+        for (const QOpenGLTexture *texture : used) {
+            ++users[texture];
+        }
+    }
+
+    MemoryReport report { {}, 0, 0, 0, _budget, GetResidentMemory() };
+    std::set<const QOpenGLTexture*> counted;  // textures shared by several models are counted once
+    for (auto &[key, entry] : _models) {
+        Model &model { *entry.model };
+        ModelMemory memory { key, get_type(model), entry.model.use_count() > 1, {}, {}, 0, 0, 0 };
+        if (const auto *paged { dynamic_cast<const PagedModel*>(&model) }) {
+            memory.bufferBytes = paged->getStatistics().residentBytes;
+        } else if (const auto *cloud { dynamic_cast<const PointCloud*>(&model) }) {
+            memory.bufferBytes = cloud->getSize();
+        } else {
+            for (auto &mesh : model.getMeshes()) {
+                const MeshMemory &mesh_memory { memory.meshes.emplace_back(measure_mesh(mesh)) };
+                memory.bufferBytes += mesh_memory.vertexBytes + mesh_memory.indexBytes;
+                memory.cpuBytes += mesh_memory.meshletBytes + mesh_memory.occluderBytes;
+            }
+        }
+
+        std::set<const QOpenGLTexture*> used;
+        for (const Material &material : model.getMaterials()) {
+            MaterialMemory &material_memory { memory.materials.emplace_back(MaterialMemory { {}, 0 }) };
+            for (auto &[slot, texture] : get_textures(material)) {
+                const auto path { paths.find(texture) };
+                const TextureMemory &texture_memory { material_memory.textures.emplace_back(TextureMemory {
+                    slot, path != paths.end() ? path->second : std::string {}, get_resident_size(*texture),
+                    TextureStreamer::instance().getResidentLevel(*texture), users[texture] }) };
+                material_memory.gpuBytes += texture_memory.gpuBytes;
+                if (used.insert(texture).second) {
+                    memory.textureBytes += texture_memory.gpuBytes;
+                }
+                if (counted.insert(texture).second) {
+                    report.textureBytes += texture_memory.gpuBytes;
+                }
+            }
+        }
+        report.bufferBytes += memory.bufferBytes;
+        report.cpuBytes += memory.cpuBytes;
+        report.models.push_back(std::move(memory));
+    }
+    for (auto &[texture, path] : paths) {
+        if (counted.count(texture) == 0) {  // still referenced outside of the cached models
+            report.textureBytes += get_resident_size(*texture);
+        }
+    }
+    return report;
+}
+
+std::size_t ResourceManager::getRevision() const noexcept {
+    return _revision;
+}
+
+void ResourceManager::collect() {
+    releaseExpired();
+
+    while (getUsage() > _budget) {
+        // the manager holds the only reference to models that are not part of any scene
+        auto lru { _models.end() };
+        for (auto iterator = _models.begin(); iterator != _models.end(); ++iterator) {
+            if (iterator->second.model.use_count() == 1 &&
+                (lru == _models.end() ||
+                 iterator->second.model->getLastRendered() < lru->second.model->getLastRendered())) {
+                lru = iterator;
+            }
+        }
+        if (lru == _models.end()) {
+            break;  // everything left is in use
+        }
+
+        _models.erase(lru);
+        ++_revision;
+        releaseExpired();  // textures only the evicted model used
+    }
+}
+
+void ResourceManager::clear() {
+    for (auto iterator = _models.begin(); iterator != _models.end();) {
+        if (iterator->second.model.use_count() == 1) {
+            iterator = _models.erase(iterator);
+            ++_revision;
+        } else {
+            ++iterator;
+        }
+    }
+    collect();
+}
+
+std::shared_ptr<QOpenGLTexture> ResourceManager::findTexture(const std::string &key) const {
+    const auto iterator { _textures.find(key) };
+    return iterator != _textures.end() ? iterator->second.texture.lock() : nullptr;
+}
+
+void ResourceManager::releaseExpired() {
+    for (auto iterator = _textures.begin(); iterator != _textures.end();) {
+        if (iterator->second.texture.expired()) {
+            iterator = _textures.erase(iterator);
+            ++_revision;
+        } else {
+            ++iterator;
+        }
+    }
+}
+
+}  // namespace bgl
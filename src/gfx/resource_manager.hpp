@@ -0,0 +1,105 @@
+/**
+ * @file resource_manager.hpp
+ * @brief Shared ownership and budgeting of models, textures and shader programs.
+ */
+#ifndef GFX_RESOURCE_MANAGER_HPP_
+#define GFX_RESOURCE_MANAGER_HPP_
+
+#include <cstddef>     // std::size_t
+#include <filesystem>  // std::filesystem::path
+#include <future>      // std::future
+#include <map>
+#include <memory>      // std::shared_ptr, std::weak_ptr
+#include <string>
+#include <vector>
+
+#include "importer.hpp"     // bgl::ModelData, bgl::TextureData
+#include "memory_report.hpp"  // bgl::MemoryReport
+#include "point_cloud.hpp"  // bgl::PointCloudData
+
+class QOpenGLTexture;
+class QOpenGLShaderProgram;
+
+
+namespace bgl {
+
+class Model;
+
+/**
+ * @brief Hands out shared models, textures and shader programs.
+ * @details Textures and programs (see ProgramRegistry) are shared as long as anyone references
+ *          them. Models are kept cached after they were removed from a scene, so loading them
+ *          again is free, until the memory budget is exceeded. Then the least recently rendered
+ *          unreferenced models are evicted first. All methods but prefetchModel() must be
+ *          called with the OpenGL context being current.
+ */
+class ResourceManager {
+ public:
+	static constexpr std::size_t DefaultBudget { std::size_t { 1024 } * 1024 * 1024 };  // 1 GiB
+
+	static ResourceManager& instance();
+
+	ResourceManager(ResourceManager&&) = delete;
+	ResourceManager& operator=(ResourceManager&&) = delete;
+
+	ResourceManager(const ResourceManager&) = delete;
+	ResourceManager& operator=(const ResourceManager&) = delete;
+
+	virtual ~ResourceManager() noexcept = default;
+
+	void prefetchModel(const std::filesystem::path &path);  // imports a model on a worker thread
+	bool isModelReady(const std::filesystem::path &path) const;  // false while a prefetch is running
+	std::shared_ptr<Model> loadModel(const std::filesystem::path &path);
+	std::shared_ptr<QOpenGLTexture> loadTexture(const std::filesystem::path &path);
+	std::shared_ptr<QOpenGLTexture> loadTexture(const TextureData &data);  // e.g. imported by a worker thread
+	std::shared_ptr<QOpenGLShaderProgram> loadProgram(const std::filesystem::path &vs,
+	                                                  const std::filesystem::path &fs);
+	std::shared_ptr<QOpenGLShaderProgram> loadProgram(const std::filesystem::path &vs,
+	                                                  const std::filesystem::path &gs,
+	                                                  const std::filesystem::path &fs,
+	                                                  const std::vector<std::string> &defines);
+
+	void setBudget(std::size_t bytes) noexcept;
+	std::size_t getBudget() const noexcept;
+	std::size_t getUsage() const noexcept;  // estimated bytes of all cached resources
+
+	/**
+	 * @brief Measures the buffers, textures and CPU copies of all cached models, including
+	 *        those that are not part of any scene.
+	 */
+	MemoryReport getMemoryReport();
+
+	/**
+	 * @brief Returns a number that changes whenever a model or texture is cached or released.
+	 */
+	std::size_t getRevision() const noexcept;
+
+	void collect();  // evicts unreferenced models until the usage is within budget
+	void clear();    // drops all unreferenced resources
+
+ private:
+	ResourceManager() = default;
+	std::shared_ptr<QOpenGLTexture> findTexture(const std::string &key) const;
+	void releaseExpired();
+
+	struct ModelEntry {
+		std::shared_ptr<Model> model;
+		std::size_t size;
+	};
+
+	struct TextureEntry {
+		std::weak_ptr<QOpenGLTexture> texture;
+		std::size_t size;
+	};
+
+	std::map<std::string, std::future<ModelData>> _prefetched;
+	std::map<std::string, std::future<PointCloudData>> _prefetchedClouds;
+	std::map<std::string, ModelEntry> _models;
+	std::map<std::string, TextureEntry> _textures;
+	std::size_t _budget { DefaultBudget };
+	std::size_t _revision { 0 };
+};
+
+}  // namespace bgl
+
+#endif  // GFX_RESOURCE_MANAGER_HPP_
@@ -0,0 +1,60 @@
+#include <algorithm>
+
+#include "scene.hpp"
+#include "model.hpp"
+
+
+namespace bgl {
+
+Scene::Node Scene::add(std::shared_ptr<Model> model, Node parent, const mat4 &transform) {
+    const Node node { _graph.create(parent, transform) };
+    if (model) {
+        _models.emplace_back(node, std::move(model));
+    }
+    return node;
+}
+
+void Scene::remove(Node node) {
+    std::vector<Node> removed { _graph.destroy(node) };
+    std::sort(removed.begin(), removed.end());
+    const auto end { std::remove_if(_models.begin(), _models.end(), [&] (const auto &entry) {
+        return std::binary_search(removed.begin(), removed.end(), entry.first);
+    }) };
+    _models.erase(end, _models.end());
+}
+
+void Scene::clear() noexcept {
+    _models.clear();
+    _graph.clear();
+}
+
+void Scene::render(const Camera &camera) {
+    const mat4 P { camera.getProjection() };
+    const mat4 V { camera.getView() };
+    if (!_lighting) {
+        _lighting = std::make_unique<ClusteredLighting>();
+    }
+    _lighting->update(_lights, P, V, camera.getNear(), camera.getFar());
+
+    _graph.update();
+
+    // the occluders of all models hide the meshes of all models
+    OcclusionCuller *occlusion { nullptr };
+    if (IsOcclusionCullingEnabled()) {
+        if (!_occlusion) {
+            _occlusion = std::make_unique<OcclusionCuller>();
+        }
+        _occlusion->clear();
+        for (auto &[node, model] : _models) {
+            model->addOccluders(*_occlusion, P * V * _graph.getWorldTransform(node));
+        }
+        _occlusion->rasterize();
+        occlusion = _occlusion.get();
+    }
+
+    for (auto &[node, model] : _models) {
+        model->render(P, V * _graph.getWorldTransform(node), *_lighting, _renderMode, occlusion);
+    }
+}
+
+}  // namespace bgl
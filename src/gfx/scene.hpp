@@ -1,15 +1,88 @@
 #ifndef GFX_SCENE_HPP_
 #define GFX_SCENE_HPP_
 
+#include <memory>   // std::shared_ptr, std::unique_ptr
+#include <utility>  // std::pair
+#include <vector>
+
 #include "math.hpp"
+#include "camera.hpp"
+#include "lighting.hpp"
+#include "occlusion.hpp"
+#include "render_mode.hpp"
+#include "scene_graph.hpp"
 
 
 namespace bgl {
 
-struct DirectionalLight {
-    vec3 direction;
-    vec3 diffuse;
-    vec3 ambient;
+class Model;
+
+/**
+ * @brief A set of models placed in a transform hierarchy and the lights shining on them.
+ */
+class Scene {
+ public:
+	using Node = SceneGraph::Node;
+
+	Scene() = default;
+	Scene(Scene&&) = default;
+	Scene& operator=(Scene&&) = default;
+
+	Scene(const Scene&) = delete;
+	Scene& operator=(const Scene&) = delete;
+
+	virtual ~Scene() noexcept = default;
+
+	Node add(std::shared_ptr<Model> model, Node parent = SceneGraph::None,
+	         const mat4 &transform = mat4 { 1.0f });
+	void remove(Node node);  // removes the node, its descendants and their models
+	void clear() noexcept;
+
+	void render(const Camera &camera);
+
+	Lights& getLights() noexcept {
+		return _lights;
+	}
+
+	const Lights& getLights() const noexcept {
+		return _lights;
+	}
+
+	void setRenderMode(RenderMode mode) noexcept {
+		_renderMode = mode;
+	}
+
+	RenderMode getRenderMode() const noexcept {
+		return _renderMode;
+	}
+
+	const ClusteredLighting* getLighting() const noexcept {  // nullptr before the first frame
+		return _lighting.get();
+	}
+
+	const OcclusionCuller* getOcclusionCuller() const noexcept {  // nullptr if occlusion culling is disabled
+		return _occlusion.get();
+	}
+
+	SceneGraph& getGraph() noexcept {
+		return _graph;
+	}
+
+	const SceneGraph& getGraph() const noexcept {
+		return _graph;
+	}
+
+	const std::vector<std::pair<Node, std::shared_ptr<Model>>>& getModels() const noexcept {
+		return _models;
+	}
+
+ private:
+	SceneGraph _graph;
+	std::vector<std::pair<Node, std::shared_ptr<Model>>> _models;
+	Lights _lights;
+	std::unique_ptr<ClusteredLighting> _lighting;  // created with the first frame (needs OpenGL)
+	std::unique_ptr<OcclusionCuller> _occlusion;
+	RenderMode _renderMode { RenderMode::Textured };
 };
 
 }  // namepace bgl
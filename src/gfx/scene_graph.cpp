@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>    // INFINITY, std::pow()
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#include "scene_graph.hpp"
+#include "parallel.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+/**
+ * @brief Levels with fewer nodes are updated on the calling thread.
+ */
+constexpr std::size_t ParallelLevelSize { 4096 };
+
+/**
+ * @brief Depth of destroyed nodes, whose slots wait for reuse.
+ */
+constexpr std::uint32_t FreedDepth { ~std::uint32_t { 0 } };
+
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+/**
+ * @brief Creates about @p count nodes in @p depth levels below 16 roots that fan out evenly.
+ * @return the roots
+ */
+std::vector<SceneGraph::Node> create_tree(SceneGraph &graph, std::size_t count, unsigned depth) {
+    const std::size_t roots { depth > 1 ? 16 : count };
+
+    // the fan-out for which the levels add up to the count
+    double low { 1.0 }, high { static_cast<double>(count) };
+    for (auto i = 0; i < 64; ++i) {
+        const double fan_out { (low + high) / 2.0 };
+        double total { 0.0 };
+        for (auto level = 0u; level < depth; ++level) {
+            total += roots * std::pow(fan_out, level);
+        }
+        (total < count ? low : high) = fan_out;
+    }
+
+    std::vector<SceneGraph::Node> parents;
+    for (auto i = 0u; i < roots; ++i) {
+        parents.push_back(graph.create(SceneGraph::None, glm::translate(vec3 { static_cast<float>(i), 0.0f, 0.0f })));
+    }
+    const std::vector<SceneGraph::Node> root_nodes { parents };
+    const mat4 transform { glm::rotate(glm::translate(vec3 { 0.0f, 1.0f, 0.0f }), 0.1f, vec3 { 0.0f, 1.0f, 0.0f }) };
+    for (auto level = 1u; level < depth; ++level) {
+        const std::size_t size { level + 1 == depth ? count - graph.size()
+                                                    : static_cast<std::size_t>(roots * std::pow(low, level)) };
+        std::vector<SceneGraph::Node> nodes;
+        for (auto i = 0u; i < size; ++i) {
+            nodes.push_back(graph.create(parents[i % parents.size()], transform));  // siblings are spread over parents
+        }
+        parents = std::move(nodes);
+    }
+    return root_nodes;
+}
+
+/**
+ * @brief Returns whether the world transforms equal those computed serially in creation order.
+ */
+bool check_world_transforms(const SceneGraph &graph) {
+    std::vector<mat4> world(graph.size());
+    for (SceneGraph::Node node = 0; node < graph.size(); ++node) {  // parents are created before their children
+        const SceneGraph::Node parent { graph.getParent(node) };
+        world[node] = parent == SceneGraph::None ? graph.getTransform(node) : world[parent] * graph.getTransform(node);
+        if (world[node] != graph.getWorldTransform(node)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t count_descendants(const SceneGraph &graph, SceneGraph::Node root) {
+    std::vector<std::uint8_t> inside(graph.size(), 0);
+    std::size_t count { 0 };
+    for (SceneGraph::Node node = 0; node < graph.size(); ++node) {
+        const SceneGraph::Node parent { graph.getParent(node) };
+        inside[node] = node == root || (parent != SceneGraph::None && inside[parent]);
+        count += inside[node];
+    }
+    return count;
+}
+
+}  // anonymous namespace
+
+SceneGraph::Node SceneGraph::create(Node parent, const mat4 &transform) {
+    if (parent != None) {
+        check(parent);
+    }
+    const std::uint32_t depth { parent == None ? 0 : _depths[parent] + 1 };
+
+    Node node;
+    if (_free.empty()) {
+        node = static_cast<Node>(_parents.size());
+        _parents.push_back(parent);
+        _depths.push_back(depth);
+        _local.push_back(transform);
+        _world.push_back(transform);
+        _dirty.push_back(1);
+    } else {
+        node = _free.back();
+        _free.pop_back();
+        _parents[node] = parent;
+        _depths[node] = depth;
+        _local[node] = transform;
+        _dirty[node] = 1;
+    }
+
+    if (_levels.size() <= depth) {
+        _levels.resize(depth + 1);
+    }
+    _levels[depth].push_back(node);
+    _firstDirtyLevel = std::min<std::size_t>(_firstDirtyLevel, depth);
+    return node;
+}
+
+std::vector<SceneGraph::Node> SceneGraph::destroy(Node node) {
+    check(node);
+
+    std::vector<std::uint8_t> removed(_parents.size(), 0);
+    std::vector<Node> nodes { node };
+    removed[node] = 1;
+
+    auto &level { _levels[_depths[node]] };
+    level.erase(std::find(level.begin(), level.end(), node));
+
+    for (auto depth = _depths[node] + 1; depth < _levels.size(); ++depth) {
+        auto &children { _levels[depth] };
+        const auto end { std::remove_if(children.begin(), children.end(), [&] (Node child) {
+            if (removed[_parents[child]]) {
+                removed[child] = 1;
+                nodes.push_back(child);
+                return true;
+            }
+            return false;
+        }) };
+        children.erase(end, children.end());
+    }
+
+    for (auto removed_node : nodes) {
+        _parents[removed_node] = None;
+        _depths[removed_node] = FreedDepth;
+        _dirty[removed_node] = 0;
+        _free.push_back(removed_node);
+    }
+    while (!_levels.empty() && _levels.back().empty()) {
+        _levels.pop_back();
+    }
+    return nodes;
+}
+
+void SceneGraph::clear() noexcept {
+    _parents.clear();
+    _depths.clear();
+    _local.clear();
+    _world.clear();
+    _dirty.clear();
+    _levels.clear();
+    _free.clear();
+    _firstDirtyLevel = SIZE_MAX;
+}
+
+void SceneGraph::setTransform(Node node, const mat4 &transform) {
+    check(node);
+    _local[node] = transform;
+    _dirty[node] = 1;
+    _firstDirtyLevel = std::min<std::size_t>(_firstDirtyLevel, _depths[node]);
+}
+
+const mat4& SceneGraph::getTransform(Node node) const {
+    check(node);
+    return _local[node];
+}
+
+const mat4& SceneGraph::getWorldTransform(Node node) const {
+    check(node);
+    return _world[node];
+}
+
+SceneGraph::Node SceneGraph::getParent(Node node) const {
+    check(node);
+    return _parents[node];
+}
+
+std::size_t SceneGraph::size() const noexcept {
+    return _parents.size() - _free.size();
+}
+
+void SceneGraph::update() {
+    if (_firstDirtyLevel >= _levels.size()) {
+        _firstDirtyLevel = SIZE_MAX;
+        return;  // nothing has changed
+    }
+
+    for (auto depth = _firstDirtyLevel; depth < _levels.size(); ++depth) {
+        const std::vector<Node> &level { _levels[depth] };
+
+        // a node is dirty if its own or one of its ancestors' transforms changed
+        auto update_range = [&] (std::size_t begin, std::size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                const Node node { level[i] };
+                const Node parent { _parents[node] };
+                if (parent == None) {
+                    if (_dirty[node]) {
+                        _world[node] = _local[node];
+                    }
+                } else if (_dirty[node] || _dirty[parent]) {
+                    _dirty[node] = 1;
+                    _world[node] = _world[parent] * _local[node];
+                }
+            }
+        };
+
+        if (level.size() >= ParallelLevelSize) {
+            parallel_for(0, level.size(), update_range, ParallelLevelSize / 4);
+        } else {
+            update_range(0, level.size());
+        }
+    }
+
+    std::fill(_dirty.begin(), _dirty.end(), 0);
+    _firstDirtyLevel = SIZE_MAX;
+}
+
+void SceneGraph::check(Node node) const {
+    if (node >= _parents.size() || _depths[node] == FreedDepth) {
+        throw std::out_of_range { "invalid scene graph node" };
+    }
+}
+
+bool RunSceneGraphBenchmark() {
+    constexpr std::size_t NodeCount { 100 * 1000 };
+    constexpr int Repetitions { 10 };  // of each update, the fastest one counts
+
+    bool valid { true };
+    for (const unsigned depth : { 1u, 2u, 4u, 8u, 16u }) {
+        SceneGraph graph;
+        const std::vector<SceneGraph::Node> roots { create_tree(graph, NodeCount, depth) };
+        graph.update();
+
+        // moving every root dirties all nodes, moving one root dirties its subtree
+        double full_time { INFINITY }, partial_time { INFINITY };
+        for (auto i = 0; i < Repetitions; ++i) {
+            for (auto root : roots) {
+                graph.setTransform(root, glm::translate(graph.getTransform(root), vec3 { 0.0f, 0.0f, 1.0f }));
+            }
+            Clock::time_point begin { Clock::now() };
+            graph.update();
+            full_time = std::min(full_time, get_milliseconds(begin));
+
+            graph.setTransform(roots.front(), glm::translate(graph.getTransform(roots.front()), vec3 { 0.0f, 1.0f, 0.0f }));
+            begin = Clock::now();
+            graph.update();
+            partial_time = std::min(partial_time, get_milliseconds(begin));
+        }
+        const bool matches { check_world_transforms(graph) };
+        valid = valid && matches;
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "depth " << std::setw(2) << depth << ": " << graph.size() << " nodes, full update "
+                  << full_time << " ms (" << std::setprecision(1) << graph.size() / full_time / 1000.0
+                  << " M nodes/s), subtree of " << count_descendants(graph, roots.front()) << " nodes "
+                  << std::setprecision(3) << partial_time << " ms on " << get_thread_count() << " threads"
+                  << (matches ? "" : " MISMATCH") << std::endl;
+    }
+    return valid;
+}
+
+}  // namespace bgl
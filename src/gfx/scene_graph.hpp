@@ -0,0 +1,72 @@
+/**
+ * @file scene_graph.hpp
+ * @brief Transform hierarchy of a scene.
+ */
+#ifndef GFX_SCENE_GRAPH_HPP_
+#define GFX_SCENE_GRAPH_HPP_
+
+#include <cstdint>
+#include <vector>
+
+#include "math.hpp"
+
+
+namespace bgl {
+
+/**
+ * @brief A transform hierarchy stored as a structure of arrays.
+ * @details Nodes are grouped by their depth, so every parent is updated before its
+ *          children and all nodes of one level can be updated independently of each other.
+ *          World transforms are only recomputed for nodes whose local transform or one
+ *          of whose ancestors changed since the last update().
+ */
+class SceneGraph {
+ public:
+	using Node = std::uint32_t;
+	static constexpr Node None { ~Node { 0 } };
+
+	SceneGraph() = default;
+	SceneGraph(SceneGraph&&) = default;
+	SceneGraph& operator=(SceneGraph&&) = default;
+
+	SceneGraph(const SceneGraph&) = delete;
+	SceneGraph& operator=(const SceneGraph&) = delete;
+
+	virtual ~SceneGraph() noexcept = default;
+
+	Node create(Node parent = None, const mat4 &transform = mat4 { 1.0f });
+	std::vector<Node> destroy(Node node);  // returns the node and all its removed descendants
+	void clear() noexcept;
+
+	void setTransform(Node node, const mat4 &transform);
+	const mat4& getTransform(Node node) const;
+	const mat4& getWorldTransform(Node node) const;  // valid after update()
+	Node getParent(Node node) const;
+
+	std::size_t size() const noexcept;
+	void update();
+
+ private:
+	void check(Node node) const;  // throws std::out_of_range for nodes that do not exist or were destroyed
+
+	std::vector<Node> _parents;
+	std::vector<std::uint32_t> _depths;
+	std::vector<mat4> _local;
+	std::vector<mat4> _world;
+	std::vector<std::uint8_t> _dirty;
+
+	std::vector<std::vector<Node>> _levels;  // alive nodes per depth
+	std::vector<Node> _free;
+	std::size_t _firstDirtyLevel { SIZE_MAX };
+};
+
+/**
+ * @brief Updates hierarchies of 100000 nodes in 1 to 16 levels, once after moving all roots and once
+ *        after moving a single subtree, and prints the update times.
+ * @return whether all world transforms equal those computed serially
+ */
+bool RunSceneGraphBenchmark();
+
+}  // namespace bgl
+
+#endif  // GFX_SCENE_GRAPH_HPP_
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <iomanip>   // std::setw()
+#include <iostream>
+#include <mutex>
+#include <utility>   // std::pair
+#include <vector>
+
+#include "startup.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct {
+    const Clock::time_point start { Clock::now() };  // set when the library is loaded
+    std::mutex mutex;
+    std::vector<std::pair<std::string, Clock::time_point>> phases;
+    bool finished { false };
+    bool report { false };
+} Startup;
+
+inline double to_milliseconds(Clock::duration duration) noexcept {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+}  // anonymous namespace
+
+void MarkStartupPhase(const std::string &name) {
+    const Clock::time_point now { Clock::now() };
+    const std::lock_guard<std::mutex> lock { Startup.mutex };
+    if (!Startup.finished) {
+        Startup.phases.emplace_back(name, now);
+    }
+}
+
+void FinishStartup() {
+    MarkStartupPhase("first complete frame");
+    {
+        const std::lock_guard<std::mutex> lock { Startup.mutex };
+        if (Startup.finished) {
+            return;
+        }
+        Startup.finished = true;
+    }
+
+    if (Startup.report) {
+        PrintStartupReport(std::cout);
+    }
+}
+
+void EnableStartupReport(bool enabled) noexcept {
+    Startup.report = enabled;
+}
+
+void PrintStartupReport(std::ostream &os) {
+    const std::lock_guard<std::mutex> lock { Startup.mutex };
+    const auto flags { os.flags() };
+    const std::streamsize precision { os.precision(1) };
+
+    os << "\nstartup report (time since start)\n";
+    for (auto &[name, time] : Startup.phases) {
+        os << std::fixed << std::setw(9) << to_milliseconds(time - Startup.start) << " ms  " << name << '\n';
+    }
+    os << std::flush;
+
+    os.precision(precision);
+    os.flags(flags);
+}
+
+}  // namespace bgl
@@ -0,0 +1,31 @@
+/**
+ * @file startup.hpp
+ * @brief Timestamps of the startup phases up to the first rendered frame.
+ */
+#ifndef GFX_STARTUP_HPP_
+#define GFX_STARTUP_HPP_
+
+#include <ostream>
+#include <string>
+
+
+namespace bgl {
+
+/**
+ * @brief Records that the startup phase @p name has just finished.
+ * @details Thread-safe. Calls after FinishStartup() are ignored.
+ */
+void MarkStartupPhase(const std::string &name);
+
+/**
+ * @brief Marks the first frame showing all initially loaded models and prints the
+ *        startup report if it was enabled.
+ */
+void FinishStartup();
+
+void EnableStartupReport(bool enabled = true) noexcept;
+void PrintStartupReport(std::ostream &os);
+
+}  // namespace bgl
+
+#endif  // GFX_STARTUP_HPP_
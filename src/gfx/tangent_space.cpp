@@ -0,0 +1,573 @@
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // __SSE2__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>  // std::memcpy()
+#include <iomanip>
+#include <iostream>
+#include <numeric>  // std::partial_sum()
+#include <vector>
+
+#include "tangent_space.hpp"
+#include "parallel.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr GLuint None { ~GLuint { 0 } };
+constexpr float SplitThreshold { 0.9999f };  // cosine below which two normals need their own vertices
+constexpr float Pi { 3.14159265f };
+
+std::atomic<float> crease_angle { DefaultCreaseAngle };
+
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+/**
+ * @brief Approximates acos() with an error below 0.0001 (Abramowitz and Stegun 4.4.45).
+ */
+inline float approximate_acos(float x) noexcept {
+    const float a { std::min(std::fabs(x), 1.0f) };
+    const float angle { std::sqrt(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f - 0.0187293f * a))) };
+    return x < 0.0f ? Pi - angle : angle;
+}
+
+inline vec3 normalize_or(const vec3 &vector, const vec3 &fallback) noexcept {
+    const float length { glm::length(vector) };
+    return length > 0.0f ? vector / length : fallback;
+}
+
+/**
+ * @brief Returns any unit vector orthogonal to @p normal.
+ */
+inline vec3 get_orthogonal(const vec3 &normal) noexcept {
+    const vec3 axis { std::fabs(normal.x) < 0.9f ? vec3 { 1.0f, 0.0f, 0.0f } : vec3 { 0.0f, 1.0f, 0.0f } };
+    return normalize_or(glm::cross(normal, axis), vec3 { 1.0f, 0.0f, 0.0f });
+}
+
+/*********************************************************
+ *                        Corners                        *
+ *********************************************************/
+
+/**
+ * @brief Corners (3 * triangle + corner) grouped by a key, e.g. by their position, so that each
+ *        key can gather the values of its corners without atomics.
+ */
+struct Adjacency {
+    std::pmr::vector<GLuint> offsets;  // of the corners of each key, followed by the corner count
+    std::pmr::vector<GLuint> corners;
+};
+
+Adjacency group_corners(const GLuint *keys, std::size_t count, std::size_t key_count,
+                        std::pmr::memory_resource *memory) {
+    Adjacency adjacency { std::pmr::vector<GLuint>(key_count + 1, 0, memory),
+                          std::pmr::vector<GLuint>(count, memory) };
+    for (auto corner = 0u; corner < count; ++corner) {
+        ++adjacency.offsets[keys[corner] + 1];
+    }
+    std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+    std::pmr::vector<GLuint> cursors { adjacency.offsets.begin(), adjacency.offsets.end() - 1, memory };
+    for (auto corner = 0u; corner < count; ++corner) {
+        adjacency.corners[cursors[keys[corner]]++] = corner;
+    }
+    return adjacency;
+}
+
+inline std::uint32_t get_bits(float value) noexcept {
+    value += 0.0f;  // -0 becomes +0
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+inline std::uint64_t hash(const vec3 &position) noexcept {
+    constexpr std::uint64_t Multiplier { 0x9E3779B97F4A7C15ull };  // mixes the bits of all coordinates
+    std::uint64_t hash { get_bits(position.x) * Multiplier };
+    hash = (hash ^ (hash >> 32) ^ get_bits(position.y)) * Multiplier;
+    hash = (hash ^ (hash >> 32) ^ get_bits(position.z)) * Multiplier;
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * @brief Numbers the distinct positions of the vertices with an open addressing hash table.
+ * @return the number of every vertex's position
+ */
+std::pmr::vector<GLuint> number_positions(const std::vector<Vertex> &vertices, std::size_t &count,
+                                          std::pmr::memory_resource *memory) {
+    std::size_t capacity { 16 };
+    while (capacity < vertices.size() * 2) {
+        capacity *= 2;
+    }
+    std::pmr::vector<GLuint> table(capacity, None, memory);  // first vertex of each position
+    std::pmr::vector<GLuint> positions(vertices.size(), memory);
+    count = 0;
+    for (auto i = 0u; i < vertices.size(); ++i) {
+        const vec3 &position { vertices[i].position };
+        auto slot { hash(position) & (capacity - 1) };
+        while (table[slot] != None && vertices[table[slot]].position != position) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        if (table[slot] == None) {
+            table[slot] = i;
+            positions[i] = static_cast<GLuint>(count++);
+        } else {
+            positions[i] = positions[table[slot]];
+        }
+    }
+    return positions;
+}
+
+/*********************************************************
+ *                         Faces                         *
+ *********************************************************/
+
+/**
+ * @brief Unit normals and corner angles of the triangles, zero for degenerate ones.
+ */
+struct Faces {
+    std::pmr::vector<vec3> normals;
+    std::pmr::vector<float> angles;  // per corner
+};
+
+inline float get_angle(const vec3 &a, const vec3 &b) noexcept {
+    const float lengths { glm::length(a) * glm::length(b) };
+    return lengths > 0.0f ? approximate_acos(std::clamp(glm::dot(a, b) / lengths, -1.0f, 1.0f)) : 0.0f;
+}
+
+void compute_face(const std::vector<Vertex> &vertices, const GLuint *triangle, vec3 &normal, float *angles) noexcept {
+    const vec3 &p0 { vertices[triangle[0]].position };
+    const vec3 &p1 { vertices[triangle[1]].position };
+    const vec3 &p2 { vertices[triangle[2]].position };
+    const vec3 e01 { p1 - p0 }, e02 { p2 - p0 }, e12 { p2 - p1 };
+    normal = normalize_or(glm::cross(e01, e02), vec3 { 0.0f });
+    angles[0] = get_angle(e01, e02);
+    angles[1] = get_angle(-e01, e12);
+    angles[2] = get_angle(e02, e12);
+}
+
+#if defined(__SSE2__)
+inline __m128 dot(const __m128 (&a)[3], const __m128 (&b)[3]) noexcept {
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[0], b[0]), _mm_mul_ps(a[1], b[1])), _mm_mul_ps(a[2], b[2]));
+}
+
+/**
+ * @brief approximate_acos() of the cosine between the vectors, 0 if one of them is zero.
+ */
+inline __m128 get_angle(__m128 dots, __m128 lengths) noexcept {
+    const __m128 zero { _mm_setzero_ps() }, one { _mm_set1_ps(1.0f) };
+    const __m128 valid { _mm_cmpgt_ps(lengths, zero) };
+    __m128 cosine { _mm_div_ps(dots, _mm_or_ps(_mm_and_ps(valid, lengths), _mm_andnot_ps(valid, one))) };
+    cosine = _mm_or_ps(_mm_and_ps(valid, cosine), _mm_andnot_ps(valid, one));
+    cosine = _mm_max_ps(_mm_min_ps(cosine, one), _mm_set1_ps(-1.0f));
+
+    const __m128 negative { _mm_cmplt_ps(cosine, zero) };
+    const __m128 a { _mm_andnot_ps(_mm_set1_ps(-0.0f), cosine) };
+    __m128 polynomial { _mm_add_ps(_mm_set1_ps(0.0742610f), _mm_mul_ps(a, _mm_set1_ps(-0.0187293f))) };
+    polynomial = _mm_add_ps(_mm_set1_ps(-0.2121144f), _mm_mul_ps(a, polynomial));
+    polynomial = _mm_add_ps(_mm_set1_ps(1.5707288f), _mm_mul_ps(a, polynomial));
+    const __m128 angle { _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(one, a)), polynomial) };
+    return _mm_or_ps(_mm_and_ps(negative, _mm_sub_ps(_mm_set1_ps(Pi), angle)), _mm_andnot_ps(negative, angle));
+}
+
+/**
+ * @brief Computes four triangles at once, their vertices are transposed into SSE registers.
+ */
+void compute_faces(const std::vector<Vertex> &vertices, const GLuint *triangles, vec3 *normals, float *angles) noexcept {
+    alignas(16) float p[3][3][4];  // [corner][axis][triangle]
+    for (auto t = 0; t < 4; ++t) {
+        for (auto corner = 0; corner < 3; ++corner) {
+            const vec3 &position { vertices[triangles[3 * t + corner]].position };
+            for (auto axis = 0; axis < 3; ++axis) {
+                p[corner][axis][t] = position[axis];
+            }
+        }
+    }
+
+    __m128 e01[3], e02[3], e12[3], n01[3];
+    for (auto axis = 0; axis < 3; ++axis) {
+        const __m128 p0 { _mm_load_ps(p[0][axis]) }, p1 { _mm_load_ps(p[1][axis]) }, p2 { _mm_load_ps(p[2][axis]) };
+        e01[axis] = _mm_sub_ps(p1, p0);
+        e02[axis] = _mm_sub_ps(p2, p0);
+        e12[axis] = _mm_sub_ps(p2, p1);
+        n01[axis] = _mm_sub_ps(p0, p1);
+    }
+    const __m128 normal[3] {
+        _mm_sub_ps(_mm_mul_ps(e01[1], e02[2]), _mm_mul_ps(e01[2], e02[1])),
+        _mm_sub_ps(_mm_mul_ps(e01[2], e02[0]), _mm_mul_ps(e01[0], e02[2])),
+        _mm_sub_ps(_mm_mul_ps(e01[0], e02[1]), _mm_mul_ps(e01[1], e02[0])) };
+    const __m128 length { _mm_sqrt_ps(dot(normal, normal)) };
+    const __m128 valid { _mm_cmpgt_ps(length, _mm_setzero_ps()) };
+    const __m128 scale { _mm_and_ps(valid, _mm_div_ps(_mm_set1_ps(1.0f), _mm_or_ps(length, _mm_andnot_ps(valid, _mm_set1_ps(1.0f))))) };
+
+    const __m128 l01 { _mm_sqrt_ps(dot(e01, e01)) }, l02 { _mm_sqrt_ps(dot(e02, e02)) }, l12 { _mm_sqrt_ps(dot(e12, e12)) };
+    alignas(16) float results[6][4];
+    for (auto axis = 0; axis < 3; ++axis) {
+        _mm_store_ps(results[axis], _mm_mul_ps(normal[axis], scale));
+    }
+    _mm_store_ps(results[3], get_angle(dot(e01, e02), _mm_mul_ps(l01, l02)));
+    _mm_store_ps(results[4], get_angle(dot(n01, e12), _mm_mul_ps(l01, l12)));
+    _mm_store_ps(results[5], get_angle(dot(e02, e12), _mm_mul_ps(l02, l12)));
+    for (auto t = 0; t < 4; ++t) {
+        normals[t] = vec3 { results[0][t], results[1][t], results[2][t] };
+        for (auto corner = 0; corner < 3; ++corner) {
+            angles[3 * t + corner] = results[3 + corner][t];
+        }
+    }
+}
+#endif  // __SSE2__
+
+Faces compute_faces(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices,
+                    std::pmr::memory_resource *memory) {
+    const std::size_t triangle_count { indices.size() / 3 };
+    Faces faces { std::pmr::vector<vec3>(triangle_count, memory), std::pmr::vector<float>(indices.size(), memory) };
+    parallel_for(0, triangle_count, [&] (std::size_t begin, std::size_t end) {
+        auto f { begin };
+#if defined(__SSE2__)
+        for (; f + 4 <= end; f += 4) {
+            compute_faces(vertices, &indices[3 * f], &faces.normals[f], &faces.angles[3 * f]);
+        }
+#endif  // __SSE2__
+        for (; f < end; ++f) {
+            compute_face(vertices, &indices[3 * f], faces.normals[f], &faces.angles[3 * f]);
+        }
+    });
+    return faces;
+}
+
+/*********************************************************
+ *                       Splitting                       *
+ *********************************************************/
+
+/**
+ * @brief Assigns every corner's value to its vertex and appends copies of vertices whose
+ *        corners need different values.
+ * @param get reads the value of a vertex
+ * @param set writes the value of a vertex
+ * @param equal compares two values
+ */
+template<typename Value, typename Get, typename Set, typename Equal>
+void split_vertices(std::vector<Vertex> &vertices, std::vector<GLuint> &indices,
+                    const std::pmr::vector<Value> &values, Get &&get, Set &&set, Equal &&equal,
+                    std::pmr::memory_resource *memory) {
+    std::pmr::vector<GLuint> copies(vertices.size(), None, memory);  // next copy of each vertex
+    std::pmr::vector<std::uint8_t> assigned(vertices.size(), 0, memory);
+    for (auto corner = 0u; corner < indices.size(); ++corner) {
+        GLuint vertex { indices[corner] };
+        const Value &value { values[corner] };
+        if (!assigned[vertex]) {
+            set(vertex, value);
+            assigned[vertex] = 1;
+            continue;
+        }
+
+        while (!equal(get(vertex), value) && copies[vertex] != None) {
+            vertex = copies[vertex];
+        }
+        if (!equal(get(vertex), value)) {
+            const Vertex copy { vertices[vertex] };
+            copies[vertex] = static_cast<GLuint>(vertices.size());
+            vertex = copies[vertex];
+            vertices.push_back(copy);
+            copies.push_back(None);
+            assigned.push_back(1);
+            set(vertex, value);
+        }
+        indices[corner] = vertex;
+    }
+}
+
+/*********************************************************
+ *                       Benchmark                       *
+ *********************************************************/
+
+constexpr float MaxError { 0.5f };  // [degrees] of a generated normal or tangent
+
+inline float get_degrees(const vec3 &a, const vec3 &b) noexcept {
+    return glm::degrees(std::acos(std::clamp(glm::dot(glm::normalize(a), glm::normalize(b)), -1.0f, 1.0f)));
+}
+
+/**
+ * @brief Creates a unit sphere with u along the longitude and v along the latitude, whose seam
+ *        and poles consist of separate vertices at equal positions.
+ */
+void create_sphere(unsigned segments, unsigned rings, std::vector<Vertex> &vertices, std::vector<GLuint> &indices) {
+    vertices.clear();
+    for (auto ring = 0u; ring <= rings; ++ring) {
+        for (auto segment = 0u; segment <= segments; ++segment) {
+            const vec2 uv { static_cast<float>(segment) / static_cast<float>(segments),
+                            static_cast<float>(ring) / static_cast<float>(rings) };
+            const float phi { 2.0f * Pi * uv.x }, theta { Pi * uv.y };
+            vertices.push_back({ vec3 { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) },
+                                 vec3 { 0.0f }, uv });
+        }
+    }
+
+    indices.clear();
+    for (auto ring = 0u; ring < rings; ++ring) {
+        for (auto segment = 0u; segment < segments; ++segment) {
+            const GLuint a { ring * (segments + 1) + segment }, b { a + segments + 1 };
+            if (ring > 0) {  // the triangles at the poles would be degenerate
+                indices.insert(indices.end(), { a, a + 1, b });
+            }
+            if (ring < rings - 1) {
+                indices.insert(indices.end(), { a + 1, b + 1, b });
+            }
+        }
+    }
+}
+
+/**
+ * @brief Creates a cube of [-1, 1] with separate vertices for every face.
+ * @details The corners of the cube belong to one or two triangles of each of their faces.
+ */
+void create_cube(std::vector<Vertex> &vertices, std::vector<GLuint> &indices) {
+    vertices.clear();
+    indices.clear();
+    for (auto axis = 0; axis < 3; ++axis) {
+        for (const float side : { -1.0f, 1.0f }) {
+            const auto first { static_cast<GLuint>(vertices.size()) };
+            for (const vec2 uv : { vec2 { 0.0f, 0.0f }, vec2 { 1.0f, 0.0f }, vec2 { 1.0f, 1.0f }, vec2 { 0.0f, 1.0f } }) {
+                vec3 position;
+                position[axis] = side;
+                position[(axis + 1) % 3] = (uv.x * 2.0f - 1.0f) * side;
+                position[(axis + 2) % 3] = uv.y * 2.0f - 1.0f;
+                vertices.push_back({ position, vec3 { 0.0f }, uv });
+            }
+            if (side < 0.0f) {
+                indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+            } else {  // along the other diagonal
+                indices.insert(indices.end(), { first, first + 1, first + 3, first + 1, first + 2, first + 3 });
+            }
+        }
+    }
+}
+
+/**
+ * @return the largest angle [degrees] between a generated normal of the sphere and its radius
+ */
+float get_sphere_error(const std::vector<Vertex> &vertices) noexcept {
+    float error { 0.0f };
+    for (auto &vertex : vertices) {
+        error = std::max(error, get_degrees(vertex.normal, vertex.position));
+    }
+    return error;
+}
+
+/**
+ * @return the largest angle [degrees] between a generated tangent of the sphere and the direction
+ *         of increasing longitude, or 180 if a bitangent does not point along the latitude
+ */
+float get_tangent_error(const std::vector<Vertex> &vertices, const std::vector<glm::vec4> &tangents) noexcept {
+    float error { 0.0f };
+    for (auto i = 0u; i < vertices.size(); ++i) {
+        const vec3 &p { vertices[i].position };
+        const float radius { std::sqrt(p.x * p.x + p.z * p.z) };  // sin(theta)
+        if (radius < 0.05f) {
+            continue;  // the tangent is undefined at the poles
+        }
+        const vec3 tangent { tangents[i] };
+        const vec3 bitangent { tangents[i].w * glm::cross(vertices[i].normal, tangent) };
+        const vec3 latitude { p.y * p.x / radius, -radius, p.y * p.z / radius };
+        error = std::max(error, glm::dot(bitangent, latitude) > 0.0f ? get_degrees(tangent, vec3 { -p.z, 0.0f, p.x })
+                                                                      : 180.0f);
+    }
+    return error;
+}
+
+/**
+ * @return the largest angle [degrees] between a generated normal of the cube and the normal of its
+ *         face if @p sharp is set, or the diagonal through its corner otherwise
+ */
+float get_cube_error(const std::vector<Vertex> &vertices, const std::vector<GLuint> &indices, bool sharp) noexcept {
+    float error { 0.0f };
+    for (auto corner = 0u; corner < indices.size(); ++corner) {
+        const GLuint *triangle { &indices[corner / 3 * 3] };
+        const vec3 face { glm::cross(vertices[triangle[1]].position - vertices[triangle[0]].position,
+                                     vertices[triangle[2]].position - vertices[triangle[0]].position) };
+        const Vertex &vertex { vertices[indices[corner]] };
+        error = std::max(error, get_degrees(vertex.normal, sharp ? face : vertex.position));
+    }
+    return error;
+}
+
+}  // anonymous namespace
+
+void SetCreaseAngle(float degrees) noexcept {
+    crease_angle = degrees;
+}
+
+float GetCreaseAngle() noexcept {
+    return crease_angle;
+}
+
+void GenerateNormals(std::vector<Vertex> &vertices, std::vector<GLuint> &indices, float creaseAngle,
+                     std::pmr::memory_resource *memory) {
+    std::size_t position_count { 0 };
+    const std::pmr::vector<GLuint> positions { number_positions(vertices, position_count, memory) };
+    const Faces faces { compute_faces(vertices, indices, memory) };
+
+    std::pmr::vector<GLuint> corner_positions(indices.size(), memory);
+    for (auto corner = 0u; corner < indices.size(); ++corner) {
+        corner_positions[corner] = positions[indices[corner]];
+    }
+    const Adjacency adjacency { group_corners(corner_positions.data(), indices.size(), position_count, memory) };
+
+    // every corner gathers the faces around its position that do not meet its face at a crease
+    const float crease { creaseAngle >= 180.0f ? -2.0f : std::cos(glm::radians(std::max(creaseAngle, 0.0f))) };
+    const float half_crease { std::cos(glm::radians(std::clamp(creaseAngle, 0.0f, 180.0f) / 2.0f)) };
+    std::pmr::vector<vec3> normals(indices.size(), memory);
+    parallel_for(0, position_count, [&] (std::size_t begin, std::size_t end) {
+        std::vector<vec3> around, weighted;  // face normals around a position, contiguous for the inner loop
+        for (auto position = begin; position < end; ++position) {
+            const GLuint first { adjacency.offsets[position] }, last { adjacency.offsets[position + 1] };
+            around.clear();
+            weighted.clear();
+            vec3 sum { 0.0f };
+            for (auto i = first; i < last; ++i) {
+                const GLuint corner { adjacency.corners[i] };
+                around.push_back(faces.normals[corner / 3]);
+                sum += weighted.emplace_back(around.back() * faces.angles[corner]);
+            }
+
+            // faces within half the crease angle of their average do not meet at a crease with each other
+            const vec3 average { normalize_or(sum, vec3 { 0.0f }) };
+            const bool smooth { crease <= -1.0f || std::all_of(around.begin(), around.end(), [&] (const vec3 &face) {
+                return glm::dot(face, average) >= half_crease;
+            }) };
+            for (auto i = 0u; i < around.size(); ++i) {
+                if (!smooth) {
+                    sum = vec3 { 0.0f };
+                    for (auto j = 0u; j < around.size(); ++j) {
+                        if (glm::dot(around[j], around[i]) >= crease) {
+                            sum += weighted[j];
+                        }
+                    }
+                }
+                normals[adjacency.corners[first + i]] = normalize_or(sum, around[i]);
+            }
+        }
+    });
+
+    split_vertices(vertices, indices, normals,
+                   [&] (GLuint vertex) { return vertices[vertex].normal; },
+                   [&] (GLuint vertex, const vec3 &normal) { vertices[vertex].normal = normal; },
+                   [] (const vec3 &a, const vec3 &b) { return glm::dot(a, b) >= SplitThreshold; }, memory);
+}
+
+std::vector<glm::vec4> GenerateTangents(std::vector<Vertex> &vertices, std::vector<GLuint> &indices,
+                                       std::pmr::memory_resource *memory) {
+    const std::size_t triangle_count { indices.size() / 3 };
+    const Faces faces { compute_faces(vertices, indices, memory) };
+
+    // the direction of increasing u of each triangle and whether its texture is mirrored
+    std::pmr::vector<vec3> face_tangents(triangle_count, memory);
+    std::pmr::vector<float> signs(triangle_count, memory);  // 0 if its texture coordinates are degenerate
+    parallel_for(0, triangle_count, [&] (std::size_t begin, std::size_t end) {
+        for (auto f = begin; f < end; ++f) {
+            const Vertex &v0 { vertices[indices[3 * f]] };
+            const Vertex &v1 { vertices[indices[3 * f + 1]] };
+            const Vertex &v2 { vertices[indices[3 * f + 2]] };
+            const vec3 d1 { v1.position - v0.position }, d2 { v2.position - v0.position };
+            const vec2 t21 { v1.texcoords - v0.texcoords }, t31 { v2.texcoords - v0.texcoords };
+            const float area { t21.x * t31.y - t21.y * t31.x };  // signed, twice the area in texture space
+            const float sign { area > 0.0f ? 1.0f : (area < 0.0f ? -1.0f : 0.0f) };
+            face_tangents[f] = sign * normalize_or(t31.y * d1 - t21.y * d2, vec3 { 0.0f });
+            signs[f] = sign;
+        }
+    });
+
+    // every vertex gathers the tangents of its corners, separately for mirrored corners
+    const Adjacency adjacency { group_corners(indices.data(), indices.size(), vertices.size(), memory) };
+    std::vector<glm::vec4> tangents(vertices.size());
+    std::pmr::vector<glm::vec4> mirrored(vertices.size(), glm::vec4 { 0.0f }, memory);  // w is 0 if no corner is mirrored
+    parallel_for(0, vertices.size(), [&] (std::size_t begin, std::size_t end) {
+        for (auto vertex = begin; vertex < end; ++vertex) {
+            const vec3 &normal { vertices[vertex].normal };
+            vec3 sums[2] { vec3 { 0.0f }, vec3 { 0.0f } };  // [preserving, mirrored]
+            bool used[2] { false, false };
+            for (auto i = adjacency.offsets[vertex]; i < adjacency.offsets[vertex + 1]; ++i) {
+                const GLuint corner { adjacency.corners[i] };
+                const float sign { signs[corner / 3] };
+                if (sign != 0.0f) {
+                    const vec3 &tangent { face_tangents[corner / 3] };
+                    const vec3 projected { normalize_or(tangent - normal * glm::dot(normal, tangent), vec3 { 0.0f }) };
+                    sums[sign < 0.0f] += projected * faces.angles[corner];
+                    used[sign < 0.0f] = true;
+                }
+            }
+
+            const bool primary { used[1] && !used[0] };  // preserving corners keep the vertex
+            const vec3 tangent { normalize_or(sums[primary], get_orthogonal(normal)) };
+            tangents[vertex] = glm::vec4 { tangent, primary ? -1.0f : 1.0f };
+            if (used[0] && used[1]) {
+                mirrored[vertex] = glm::vec4 { normalize_or(sums[1], get_orthogonal(normal)), -1.0f };
+            }
+        }
+    });
+
+    // mirrored corners of vertices that are also used unmirrored get their own vertex
+    for (auto vertex = 0u; vertex < mirrored.size(); ++vertex) {
+        if (mirrored[vertex].w == 0.0f) {
+            continue;
+        }
+        const auto copy { static_cast<GLuint>(vertices.size()) };
+        vertices.push_back(vertices[vertex]);
+        tangents.push_back(mirrored[vertex]);
+        for (auto i = adjacency.offsets[vertex]; i < adjacency.offsets[vertex + 1]; ++i) {
+            const GLuint corner { adjacency.corners[i] };
+            if (signs[corner / 3] < 0.0f) {
+                indices[corner] = copy;
+            }
+        }
+    }
+    return tangents;
+}
+
+bool RunTangentSpaceBenchmark() {
+    constexpr unsigned Segments { 1024 };
+    constexpr unsigned Rings { 512 };
+
+    std::vector<Vertex> vertices;
+    std::vector<GLuint> indices;
+    create_sphere(Segments, Rings, vertices, indices);
+    Clock::time_point begin { Clock::now() };
+    GenerateNormals(vertices, indices, DefaultCreaseAngle);
+    const double normal_time { get_milliseconds(begin) };
+    begin = Clock::now();
+    const std::vector<glm::vec4> tangents { GenerateTangents(vertices, indices) };
+    const double tangent_time { get_milliseconds(begin) };
+    const float normal_error { get_sphere_error(vertices) };
+    const float tangent_error { get_tangent_error(vertices, tangents) };
+    bool valid { normal_error <= MaxError && tangent_error <= MaxError };
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "sphere " << Segments << "x" << Rings << ": " << indices.size() / 3 << " triangles, normals in "
+              << normal_time << " ms, tangents in " << tangent_time << " ms on " << get_thread_count()
+              << " threads, max. error of normals " << normal_error << " deg, of tangents " << tangent_error << " deg"
+              << (valid ? "" : " MISMATCH") << std::endl;
+
+    // the faces of the cube meet at 90 degrees
+    for (const float crease_angle : { 45.0f, DefaultCreaseAngle }) {
+        create_cube(vertices, indices);
+        GenerateNormals(vertices, indices, crease_angle);
+        const float error { get_cube_error(vertices, indices, crease_angle < 90.0f) };
+        const bool matches { error <= MaxError };
+        valid = valid && matches;
+        std::cout << "cube at a crease angle of " << crease_angle << " deg: " << vertices.size() << " vertices, "
+                  << "max. error of normals " << error << " deg" << (matches ? "" : " MISMATCH") << std::endl;
+    }
+    return valid;
+}
+
+}  // namespace bgl
@@ -0,0 +1,58 @@
+/**
+ * @file tangent_space.hpp
+ * @brief Parallel generation of smooth normals and MikkTSpace tangents on imported meshes.
+ */
+#ifndef GFX_TANGENT_SPACE_HPP_
+#define GFX_TANGENT_SPACE_HPP_
+
+#include <memory_resource>  // std::pmr::memory_resource
+#include <vector>
+
+#include "gl.hpp"
+#include "mesh.hpp"  // bgl::Vertex
+
+
+namespace bgl {
+
+constexpr float DefaultCreaseAngle { 175.0f };  // [degrees], as the default of aiProcess_GenSmoothNormals
+
+/**
+ * @brief Sets the angle between faces above which GenerateNormals() keeps their edge sharp.
+ * @note The model cache keeps separate imports for every crease angle.
+ */
+void SetCreaseAngle(float degrees) noexcept;
+float GetCreaseAngle() noexcept;
+
+/**
+ * @brief Computes smooth vertex normals, weighting every triangle by its angle at the vertex.
+ * @details Triangles sharing a position are smoothed with each other, even across vertices that
+ *          differ in texture coordinates, unless their faces meet at more than @p creaseAngle.
+ *          Vertices whose triangles end up with different normals are split, the copies are
+ *          appended and the indices are rewritten. Face normals are computed in parallel (SSE2)
+ *          and gathered per position without atomics.
+ * @param memory for temporary data, e.g. the arena of an import
+ */
+void GenerateNormals(std::vector<Vertex> &vertices, std::vector<GLuint> &indices, float creaseAngle,
+                     std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+/**
+ * @brief Computes per vertex tangents as MikkTSpace defines them for normal maps.
+ * @details The tangent points along increasing u, is orthogonal to the vertex normal and averages
+ *          the triangles of the vertex weighted by their angle. Its w component is the sign of the
+ *          bitangent, i.e. bitangent = w * cross(normal, tangent.xyz). Vertices shared by
+ *          triangles with mirrored texture coordinates are split like in GenerateNormals().
+ * @return one tangent per vertex after splitting
+ */
+std::vector<glm::vec4> GenerateTangents(std::vector<Vertex> &vertices, std::vector<GLuint> &indices,
+                                       std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+/**
+ * @brief Generates the normals and tangents of a sphere of a million triangles and the normals of
+ *        a cube with and without creases, prints the times and the errors to the exact ones.
+ * @return whether no normal or tangent deviates by more than half a degree
+ */
+bool RunTangentSpaceBenchmark();
+
+}  // namespace bgl
+
+#endif  // GFX_TANGENT_SPACE_HPP_
@@ -0,0 +1,332 @@
+#include <unistd.h>  // getpid()
+
+#include "gl.hpp"
+
+#include <QOpenGLTexture>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>   // std::hex
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>   // std::move
+#include <vector>
+
+#include "texture.hpp"
+#include "gfx.hpp"  // bgl::GetCacheDirectory(), bgl::Hash()
+#include "texture_streamer.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr unsigned CacheVersion { 1 };  // increment when the encoders change
+
+std::atomic<TextureCompression> compression { TextureCompression::BC };
+std::atomic<bool> report { false };
+
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+/*********************************************************
+ *                      Mip Chains                       *
+ *********************************************************/
+
+struct Image {
+    unsigned width;
+    unsigned height;
+    std::vector<std::uint8_t> rgba;
+};
+
+/**
+ * @brief Halves an image with a 2x2 box filter.
+ */
+Image downsample(const Image &image) {
+    Image level { std::max(image.width / 2, 1u), std::max(image.height / 2, 1u), {} };
+    level.rgba.resize(std::size_t { level.width } * level.height * 4);
+
+    for (auto y = 0u; y < level.height; ++y) {
+        const unsigned y0 { std::min(y * 2, image.height - 1) };
+        const unsigned y1 { std::min(y * 2 + 1, image.height - 1) };
+        for (auto x = 0u; x < level.width; ++x) {
+            const unsigned x0 { std::min(x * 2, image.width - 1) };
+            const unsigned x1 { std::min(x * 2 + 1, image.width - 1) };
+            for (auto c = 0u; c < 4; ++c) {
+                const auto texel = [&] (unsigned tx, unsigned ty) {
+                    return unsigned { image.rgba[(std::size_t { ty } * image.width + tx) * 4 + c] };
+                };
+                const unsigned sum { texel(x0, y0) + texel(x1, y0) + texel(x0, y1) + texel(x1, y1) };
+                level.rgba[(std::size_t { y } * level.width + x) * 4 + c] = static_cast<std::uint8_t>((sum + 2) / 4);
+            }
+        }
+    }
+    return level;
+}
+
+/**
+ * @brief Copies the texels of an RGBA8888 image and checks on the way whether all of them are opaque.
+ */
+Image copy_image(const QImage &image, bool &opaque) {
+    Image copy { static_cast<unsigned>(image.width()), static_cast<unsigned>(image.height()), {} };
+    copy.rgba.resize(std::size_t { copy.width } * copy.height * 4);
+    std::uint8_t alpha { 255 };
+    for (auto y = 0u; y < copy.height; ++y) {
+        const std::uint8_t *line { image.constScanLine(static_cast<int>(y)) };
+        std::copy_n(line, copy.width * 4, &copy.rgba[std::size_t { y } * copy.width * 4]);
+        for (auto x = 0u; x < copy.width; ++x) {  // while the line is still in the cache
+            alpha &= line[x * 4 + 3];
+        }
+    }
+    opaque = alpha == 255;
+    return copy;
+}
+
+BlockFormat choose_format(bool opaque, TextureUsage usage) {
+    if (usage == TextureUsage::Normal) {
+        return BlockFormat::BC5;
+    }
+    if (compression == TextureCompression::BC7) {
+        return BlockFormat::BC7;
+    }
+    return opaque ? BlockFormat::BC1 : BlockFormat::BC3;
+}
+
+/**
+ * @brief Compresses an image and all of its mip levels.
+ */
+std::vector<CompressedLevel> compress(Image level, BlockFormat format) {
+    std::vector<CompressedLevel> levels;
+    for (;;) {
+        levels.push_back({ level.width, level.height,
+                           CompressImage(level.rgba.data(), level.width, level.height, format) });
+        if (level.width == 1 && level.height == 1) {
+            break;
+        }
+        level = downsample(level);
+    }
+    return levels;
+}
+
+/*********************************************************
+ *                         Cache                         *
+ *********************************************************/
+
+std::filesystem::path get_cache_path(const std::filesystem::path &path, TextureUsage usage) {
+    const std::filesystem::path directory { GetCacheDirectory() };
+    if (directory.empty()) {
+        return {};
+    }
+
+    std::ostringstream key;
+    key << std::filesystem::weakly_canonical(path).string() << '|'
+        << std::filesystem::last_write_time(path).time_since_epoch().count() << '|'
+        << std::filesystem::file_size(path) << '|'
+        << static_cast<int>(usage) << '|' << static_cast<int>(compression.load()) << '|' << CacheVersion;
+
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << Hash(key.str()) << ".ktx2";
+    return directory / "textures" / name.str();
+}
+
+std::shared_ptr<const MappedTexture> map_cached(const std::filesystem::path &cache_path) {
+    std::error_code error;
+    if (cache_path.empty() || !std::filesystem::exists(cache_path, error)) {
+        return {};
+    }
+    try {
+        return std::make_shared<const MappedTexture>(cache_path);
+    } catch (const std::runtime_error &error) {
+        std::cout << "warning: " << error.what() << std::endl;  // transcode it again
+        return {};
+    }
+}
+
+std::shared_ptr<const MappedTexture> transcode(const std::filesystem::path &path,
+                                               const std::filesystem::path &cache_path,
+                                               TextureUsage usage) {
+    const QImage image { QImage { path.string().c_str() }.convertToFormat(QImage::Format_RGBA8888) };
+    if (image.isNull()) {
+        throw std::runtime_error { "could not decode " + path.string() };
+    }
+    bool opaque;
+    Image copy { copy_image(image, opaque) };
+    const BlockFormat format { choose_format(opaque, usage) };
+    const std::vector<CompressedLevel> levels { compress(std::move(copy), format) };
+
+    // write to a temporary file first, so concurrent imports never map partial files
+    std::error_code error;
+    std::filesystem::create_directories(cache_path.parent_path(), error);
+    static std::atomic<unsigned> counter { 0 };
+    const std::filesystem::path temporary {
+        cache_path.string() + "." + std::to_string(getpid()) + "." + std::to_string(counter++) + ".tmp" };
+    WriteKTX(temporary, format, levels);
+    std::filesystem::rename(temporary, cache_path);
+    return std::make_shared<const MappedTexture>(cache_path);
+}
+
+/*********************************************************
+ *                        Upload                         *
+ *********************************************************/
+
+bool is_supported(BlockFormat format) {
+    switch (format) {
+        case BlockFormat::BC1:
+        case BlockFormat::BC3:
+            return GLEW_EXT_texture_compression_s3tc;
+        case BlockFormat::BC5:
+            return GLEW_ARB_texture_compression_rgtc;
+        case BlockFormat::BC7:
+            return GLEW_ARB_texture_compression_bptc;
+        default:
+            return false;
+    }
+}
+
+QOpenGLTexture::TextureFormat to_texture_format(BlockFormat format) {
+    switch (format) {
+        case BlockFormat::BC1: return QOpenGLTexture::RGB_DXT1;
+        case BlockFormat::BC3: return QOpenGLTexture::RGBA_DXT5;
+        case BlockFormat::BC5: return QOpenGLTexture::RG_ATI2N_UNorm;
+        case BlockFormat::BC7: return QOpenGLTexture::RGB_BP_UNorm;
+        default: throw std::runtime_error { "unsupported block format" };
+    }
+}
+
+const char* get_name(BlockFormat format) noexcept {
+    switch (format) {
+        case BlockFormat::BC1: return "BC1";
+        case BlockFormat::BC3: return "BC3";
+        case BlockFormat::BC5: return "BC5";
+        case BlockFormat::BC7: return "BC7";
+        default: return "?";
+    }
+}
+
+void print_report(const TextureData &data, const QOpenGLTexture &texture, double upload_time) {
+    const std::size_t rgba8 { std::size_t(texture.width()) * texture.height() * 4 * 4 / 3 };  // incl. mip maps
+    std::size_t size { rgba8 };
+    if (data.compressed) {
+        const auto resident { TextureStreamer::instance().getResidentLevel(texture) };
+        size = data.compressed->getSize(resident.value_or(0));
+    }
+
+    std::cout << "texture " << data.path.filename().string() << ": "
+              << (data.compressed ? get_name(data.compressed->getFormat()) : "RGBA8") << ", "
+              << (data.compressed ? (data.cached ? "mapped" : "transcoded") : "decoded") << " in "
+              << std::fixed << std::setprecision(1) << data.importTime << " ms, "
+              << "uploaded in " << upload_time << " ms, "
+              << size / 1024 << " KiB resident (RGBA8: " << rgba8 / 1024 << " KiB)" << std::endl;
+}
+
+}  // anonymous namespace
+
+void SetTextureCompression(TextureCompression value) noexcept {
+    compression = value;
+}
+
+TextureCompression GetTextureCompression() noexcept {
+    return compression;
+}
+
+void EnableTextureReport(bool enabled) noexcept {
+    report = enabled;
+}
+
+std::shared_ptr<QOpenGLTexture> CreateTexture(const MappedTexture &mapped, unsigned baseLevel) {
+    const auto texture { std::make_shared<QOpenGLTexture>(QOpenGLTexture::Target2D) };
+    if (!texture->create()) {
+        throw std::runtime_error { "could not create texture" };
+    }
+    texture->setFormat(to_texture_format(mapped.getFormat()));
+    texture->setSize(static_cast<int>(mapped.getWidth()), static_cast<int>(mapped.getHeight()));
+    texture->setMipLevels(static_cast<int>(mapped.getLevels().size()));
+
+    // the values of QOpenGLTexture::TextureFormat are the OpenGL internal formats
+    const auto format { static_cast<GLenum>(to_texture_format(mapped.getFormat())) };
+    texture->bind();
+    const auto &levels { mapped.getLevels() };
+    for (auto i = baseLevel; i < levels.size(); ++i) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(i), format,
+                               static_cast<GLsizei>(levels[i].width), static_cast<GLsizei>(levels[i].height),
+                               0, static_cast<GLsizei>(levels[i].size), levels[i].data);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(baseLevel));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size() - 1));
+    texture->release();
+
+    const GLenum error { glGetError() };
+    if (error != GL_NO_ERROR) {
+        std::ostringstream oss;
+        oss << "glCompressedTexImage2D() failed due to " << gluErrorString(error);
+        throw std::runtime_error { oss.str() };
+    }
+
+    texture->setMinMagFilters(QOpenGLTexture::LinearMipMapLinear, QOpenGLTexture::Linear);
+    texture->setWrapMode(QOpenGLTexture::Repeat);
+    return texture;
+}
+
+TextureData ImportTexture(const std::filesystem::path &path, TextureUsage usage) {
+    const auto begin { Clock::now() };
+    TextureData data { path, {}, {}, 0.0, false };
+
+    try {
+        const std::filesystem::path cache_path {
+            compression == TextureCompression::None ? std::filesystem::path {} : get_cache_path(path, usage) };
+        if (!cache_path.empty()) {
+            data.compressed = map_cached(cache_path);
+            data.cached = data.compressed != nullptr;
+            if (!data.compressed) {
+                data.compressed = transcode(path, cache_path, usage);
+            }
+        }
+    } catch (const std::runtime_error &error) {
+        std::cout << "warning: could not compress texture: " << error.what() << std::endl;
+    }
+    if (!data.compressed) {
+        data.image = QImage { path.string().c_str() };
+    }
+
+    data.importTime = get_milliseconds(begin);
+    return data;
+}
+
+std::shared_ptr<QOpenGLTexture> CreateTexture(const TextureData &data) {
+    const auto begin { Clock::now() };
+
+    std::shared_ptr<QOpenGLTexture> texture;
+    if (data.compressed && is_supported(data.compressed->getFormat())) {
+        TextureStreamer &streamer { TextureStreamer::instance() };
+        texture = streamer.isEnabled() ? streamer.create(data.compressed) : CreateTexture(*data.compressed);
+    } else if (data.compressed) {
+        std::cout << "warning: " << get_name(data.compressed->getFormat())
+                  << " is not supported, falling back to RGBA8" << std::endl;
+        texture = LoadTexture(data.path);
+    } else {
+        texture = CreateTexture(data.image);
+    }
+
+    if (report) {
+        print_report(data, *texture, get_milliseconds(begin));
+    }
+    return texture;
+}
+
+std::shared_ptr<QOpenGLTexture> CreateTexture(const QImage &image) {
+    return std::make_shared<QOpenGLTexture>(image);
+}
+
+std::shared_ptr<QOpenGLTexture> LoadTexture(const std::filesystem::path &path) {
+    QImage image { path.string().c_str() };
+    std::cout << "loading " << path << std::endl;
+    return CreateTexture(image);
+}
+
+}  // namespace bgl
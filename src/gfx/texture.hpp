@@ -0,0 +1,87 @@
+/**
+ * @file texture.hpp
+ * @brief Texture import with block compression and mip chains baked into a disk cache.
+ */
+#ifndef GFX_TEXTURE_HPP_
+#define GFX_TEXTURE_HPP_
+
+#include <filesystem>  // std::filesystem::path
+#include <memory>      // std::shared_ptr
+
+#include "ktx.hpp"
+
+#include <QImage>  // NOLINT
+
+class QOpenGLTexture;
+
+
+namespace bgl {
+
+enum class TextureCompression {
+    None,  // RGBA8, mip maps are generated by the driver
+    BC,    // BC1 for opaque and BC3 for translucent textures
+    BC7    // BC7 for all color textures
+};
+
+enum class TextureUsage {
+    Color,
+    Normal  // tangent space normal maps are stored as BC5 (x and y only)
+};
+
+/**
+ * @brief An imported texture.
+ * @details Either @p compressed or @p image is set. An empty path means there is no texture.
+ */
+struct TextureData {
+    std::filesystem::path path;
+    QImage image;
+    std::shared_ptr<const MappedTexture> compressed;
+    double importTime;  // [ms] decoding or mapping the cached file
+    bool cached;        // true if the compressed file was found in the cache
+};
+
+void SetTextureCompression(TextureCompression compression) noexcept;
+TextureCompression GetTextureCompression() noexcept;
+
+/**
+ * @brief Prints decode and upload times and the texture memory in comparison to RGBA8
+ *        of every created texture.
+ */
+void EnableTextureReport(bool enabled = true) noexcept;
+
+/**
+ * @brief Imports a texture file.
+ * @details Compressed textures are looked up in the cache first. On a miss the image is decoded,
+ *          its mip chain is box filtered, every level is block compressed and the result is
+ *          stored in the cache. Either way the returned texture is memory-mapped from the cache.
+ * @note Does not need an OpenGL context and may be called from any thread.
+ */
+TextureData ImportTexture(const std::filesystem::path &path, TextureUsage usage = TextureUsage::Color);
+
+/**
+ * @brief Creates an OpenGL texture from an imported texture.
+ * @details Compressed textures are streamed by the TextureStreamer if it is enabled.
+ * @note Falls back to decoding the original file if the driver does not support the compressed format.
+ */
+std::shared_ptr<QOpenGLTexture> CreateTexture(const TextureData &data);
+
+/**
+ * @brief Creates an OpenGL texture from a compressed texture.
+ * @details Only the levels from @p baseLevel on are uploaded, finer levels are left undefined
+ *          and excluded from sampling by GL_TEXTURE_BASE_LEVEL.
+ */
+std::shared_ptr<QOpenGLTexture> CreateTexture(const MappedTexture &texture, unsigned baseLevel = 0);
+
+/**
+ * @brief Creates an OpenGL texture from a decoded image.
+ */
+std::shared_ptr<QOpenGLTexture> CreateTexture(const QImage &image);
+
+/**
+ * @brief Loads and creates an OpenGL texture from an image file.
+ */
+std::shared_ptr<QOpenGLTexture> LoadTexture(const std::filesystem::path &path);
+
+}  // namespace bgl
+
+#endif  // GFX_TEXTURE_HPP_
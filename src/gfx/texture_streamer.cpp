@@ -0,0 +1,239 @@
+#include "gl.hpp"
+
+#include <QOpenGLTexture>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "texture_streamer.hpp"
+#include "texture.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+/**
+ * @brief Uploads a level or frees its storage if @p level is nullptr.
+ * @note The texture must be bound.
+ */
+void specify_level(const QOpenGLTexture &texture, unsigned index, const MappedTexture::Level *level) {
+    // the values of QOpenGLTexture::TextureFormat are the OpenGL internal formats
+    const auto format { static_cast<GLenum>(texture.format()) };
+    if (level) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(index), format,
+                               static_cast<GLsizei>(level->width), static_cast<GLsizei>(level->height),
+                               0, static_cast<GLsizei>(level->size), level->data);
+    } else {
+        // a zero sized image releases the storage of a level of a mutable texture
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(index), format, 0, 0, 0, 0, nullptr);
+    }
+}
+
+void set_base_level(unsigned level) {
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(level));
+}
+
+inline bool is_ready(const std::future<void> &future) {
+    return future.wait_for(std::chrono::seconds { 0 }) == std::future_status::ready;
+}
+
+}  // anonymous namespace
+
+TextureStreamer& TextureStreamer::instance() {
+    static TextureStreamer streamer;
+    return streamer;
+}
+
+std::shared_ptr<QOpenGLTexture> TextureStreamer::create(std::shared_ptr<const MappedTexture> source) {
+    releaseExpired();
+
+    const auto &levels { source->getLevels() };
+    unsigned coarse { 0 };
+    while (coarse + 1 < levels.size() && std::max(levels[coarse].width, levels[coarse].height) > CoarseSize) {
+        ++coarse;
+    }
+
+    const std::shared_ptr<QOpenGLTexture> texture { CreateTexture(*source, coarse) };
+    _usage += source->getSize(coarse);
+    _entries[texture.get()] = Entry { texture, source, coarse, coarse, coarse,
+                                      std::vector<std::uint64_t>(levels.size(), 0), {} };
+    return texture;
+}
+
+void TextureStreamer::request(const QOpenGLTexture &texture, float pixels) {
+    Entry *entry { find(texture) };
+    if (entry == nullptr) {
+        return;  // not streamed
+    }
+
+    // assumes the texture is mapped once across the projected area
+    const auto &levels { entry->source->getLevels() };
+    const float size { static_cast<float>(std::max(levels[0].width, levels[0].height)) };
+    const float lod { pixels > 0.0f ? std::floor(std::log2(size / pixels)) : INFINITY };
+    const auto level { static_cast<unsigned>(std::clamp(lod, 0.0f, static_cast<float>(levels.size() - 1))) };
+
+    const bool first_request { entry->lastUsed.back() != _frame };
+    entry->requestedLevel = first_request ? level : std::min(entry->requestedLevel, level);
+    std::fill(entry->lastUsed.begin() + level, entry->lastUsed.end(), _frame);
+}
+
+void TextureStreamer::update() {
+    releaseExpired();
+    if (_usage > _budget) {
+        evict(_usage - _budget, nullptr);  // the budget was lowered
+    }
+
+    // upload levels that were read in the meantime
+    std::size_t uploaded { 0 };
+    unsigned loads { 0 };
+    for (auto &[key, entry] : _entries) {
+        if (entry.load.valid() && is_ready(entry.load) && uploaded < UploadLimit) {
+            upload(entry, uploaded);
+        }
+        loads += entry.load.valid() ? 1 : 0;
+    }
+
+    // read the next finer level of visible textures, the blurriest ones first
+    std::vector<Entry*> requests;
+    for (auto &[key, entry] : _entries) {
+        if (entry.lastUsed.back() == _frame && entry.requestedLevel < entry.residentLevel && !entry.load.valid()) {
+            requests.push_back(&entry);
+        }
+    }
+    std::sort(requests.begin(), requests.end(), [] (const Entry *a, const Entry *b) {
+        return a->residentLevel - a->requestedLevel > b->residentLevel - b->requestedLevel;
+    });
+    for (auto *entry : requests) {
+        if (loads >= MaxLoads) {
+            break;
+        }
+        const std::size_t size { entry->source->getLevels()[entry->residentLevel - 1].size };
+        if (_usage + size > _budget && !evict(_usage + size - _budget, entry)) {
+            continue;
+        }
+        load(*entry);
+        ++loads;
+    }
+
+    _idle = loads == 0;
+    ++_frame;
+}
+
+void TextureStreamer::setBudget(std::size_t bytes) noexcept {
+    _budget = bytes;
+}
+
+std::size_t TextureStreamer::getBudget() const noexcept {
+    return _budget;
+}
+
+std::size_t TextureStreamer::getUsage() const noexcept {
+    return _usage;
+}
+
+bool TextureStreamer::isEnabled() const noexcept {
+    return _budget > 0;
+}
+
+bool TextureStreamer::isIdle() const noexcept {
+    return _idle;
+}
+
+std::optional<unsigned> TextureStreamer::getResidentLevel(const QOpenGLTexture &texture) const {
+    const auto iterator { _entries.find(&texture) };
+    if (iterator == _entries.end() || iterator->second.texture.expired()) {
+        return std::nullopt;
+    }
+    return iterator->second.residentLevel;
+}
+
+std::size_t TextureStreamer::getRevision() const noexcept {
+    return _revision;
+}
+
+TextureStreamer::Entry* TextureStreamer::find(const QOpenGLTexture &texture) {
+    const auto iterator { _entries.find(&texture) };
+    if (iterator == _entries.end() || iterator->second.texture.expired()) {
+        return nullptr;
+    }
+    return &iterator->second;
+}
+
+void TextureStreamer::releaseExpired() {
+    for (auto iterator = _entries.begin(); iterator != _entries.end();) {
+        Entry &entry { iterator->second };
+        if (!entry.texture.expired()) {
+            ++iterator;
+            continue;
+        }
+
+        _usage -= entry.source->getSize(entry.residentLevel);
+        if (entry.load.valid()) {
+            _usage -= entry.source->getLevels()[entry.residentLevel - 1].size;
+        }
+        iterator = _entries.erase(iterator);  // waits for a running load
+    }
+}
+
+void TextureStreamer::upload(Entry &entry, std::size_t &uploaded) {
+    entry.load.get();
+
+    const unsigned level { entry.residentLevel - 1 };
+    const MappedTexture::Level &data { entry.source->getLevels()[level] };
+    const std::shared_ptr<QOpenGLTexture> texture { entry.texture.lock() };
+    texture->bind();
+    specify_level(*texture, level, &data);
+    set_base_level(level);
+    texture->release();
+
+    entry.residentLevel = level;
+    uploaded += data.size;
+    ++_revision;
+}
+
+void TextureStreamer::load(Entry &entry) {
+    const unsigned level { entry.residentLevel - 1 };
+    _usage += entry.source->getLevels()[level].size;  // reserved until the level is evicted
+    entry.load = std::async(std::launch::async, [source = entry.source, level] {
+        source->prefetch(level);
+    });
+}
+
+bool TextureStreamer::evict(std::size_t bytes, const Entry *keep) {
+    std::size_t released { 0 };
+    while (released < bytes) {
+        // the finest level of each texture is the least recently used one of that texture
+        Entry *lru { nullptr };
+        for (auto &[key, entry] : _entries) {
+            if (&entry == keep || entry.load.valid() || entry.residentLevel >= entry.coarseLevel ||
+                entry.lastUsed[entry.residentLevel] == _frame) {
+                continue;  // levels needed in this frame are never evicted
+            }
+            if (lru == nullptr || entry.lastUsed[entry.residentLevel] < lru->lastUsed[lru->residentLevel]) {
+                lru = &entry;
+            }
+        }
+        if (lru == nullptr) {
+            return false;
+        }
+
+        const unsigned level { lru->residentLevel };
+        const std::shared_ptr<QOpenGLTexture> texture { lru->texture.lock() };
+        texture->bind();
+        set_base_level(level + 1);
+        specify_level(*texture, level, nullptr);
+        texture->release();
+        lru->source->release(level);
+
+        const std::size_t size { lru->source->getLevels()[level].size };
+        lru->residentLevel = level + 1;
+        ++_revision;
+        _usage -= size;
+        released += size;
+    }
+    return true;
+}
+
+}  // namespace bgl
@@ -0,0 +1,92 @@
+/**
+ * @file texture_streamer.hpp
+ * @brief Streaming of texture mip levels driven by their size on screen.
+ */
+#ifndef GFX_TEXTURE_STREAMER_HPP_
+#define GFX_TEXTURE_STREAMER_HPP_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <future>   // std::future
+#include <map>
+#include <memory>   // std::shared_ptr, std::weak_ptr
+#include <optional>
+#include <vector>
+
+#include "ktx.hpp"
+
+class QOpenGLTexture;
+
+
+namespace bgl {
+
+/**
+ * @brief Keeps only the mip levels of compressed textures resident that are visible.
+ * @details Textures start with their coarse levels only. While rendering, request() records the
+ *          finest level each texture needs for its projected size on screen. update() then pages
+ *          finer levels in from the mapped files on worker threads and uploads them once they are
+ *          read. If the memory budget is exhausted, the least recently used fine levels of other
+ *          textures are evicted first. Levels of a texture are always resident from its finest
+ *          uploaded level down to the 1x1 level. All methods must be called with the OpenGL
+ *          context being current.
+ */
+class TextureStreamer {
+ public:
+	static constexpr std::size_t DefaultBudget { std::size_t { 512 } * 1024 * 1024 };  // 512 MiB
+	static constexpr unsigned CoarseSize { 64 };  // levels up to 64x64 texels are always resident
+	static constexpr std::size_t UploadLimit { std::size_t { 16 } * 1024 * 1024 };  // per frame
+	static constexpr unsigned MaxLoads { 4 };  // levels read from disk at the same time
+
+	static TextureStreamer& instance();
+
+	TextureStreamer(TextureStreamer&&) = delete;
+	TextureStreamer& operator=(TextureStreamer&&) = delete;
+
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	virtual ~TextureStreamer() noexcept = default;
+
+	std::shared_ptr<QOpenGLTexture> create(std::shared_ptr<const MappedTexture> source);
+	void request(const QOpenGLTexture &texture, float pixels);  // @p pixels is the size on screen
+	void update();  // call once per frame after rendering
+
+	void setBudget(std::size_t bytes) noexcept;  // 0 disables streaming of new textures
+	std::size_t getBudget() const noexcept;
+	std::size_t getUsage() const noexcept;  // bytes of all resident and loading levels
+	bool isEnabled() const noexcept;
+	bool isIdle() const noexcept;  // false while levels are loaded or waiting for their upload
+
+	std::optional<unsigned> getResidentLevel(const QOpenGLTexture &texture) const;
+	std::size_t getRevision() const noexcept;  // changes whenever a level is uploaded or evicted
+
+ private:
+	TextureStreamer() = default;
+
+	struct Entry {
+		std::weak_ptr<QOpenGLTexture> texture;
+		std::shared_ptr<const MappedTexture> source;
+		unsigned residentLevel;   // finest uploaded level
+		unsigned coarseLevel;     // finest level that is never evicted
+		unsigned requestedLevel;  // finest level needed in the last frame it was used
+		std::vector<std::uint64_t> lastUsed;  // frame each level was needed last
+		std::future<void> load;   // reads residentLevel - 1
+	};
+
+	Entry* find(const QOpenGLTexture &texture);
+	void releaseExpired();
+	void upload(Entry &entry, std::size_t &uploaded);
+	void load(Entry &entry);
+	bool evict(std::size_t bytes, const Entry *keep);  // frees LRU levels of all textures but @p keep
+
+	std::map<const QOpenGLTexture*, Entry> _entries;
+	std::size_t _budget { DefaultBudget };
+	std::size_t _usage { 0 };
+	std::uint64_t _frame { 1 };
+	std::size_t _revision { 0 };
+	bool _idle { true };
+};
+
+}  // namespace bgl
+
+#endif  // GFX_TEXTURE_STREAMER_HPP_
@@ -0,0 +1,142 @@
+#include "gl.hpp"
+
+#include <algorithm>  // std::max()
+#include <stdexcept>
+
+#include "upload_ring.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr GLbitfield MapFlags { GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+constexpr GLuint64 WaitTimeout { 1000000000 };  // [ns]
+
+inline std::size_t align(std::size_t offset, std::size_t alignment) noexcept {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+}  // anonymous namespace
+
+UploadRing& UploadRing::instance() {
+    static UploadRing ring;
+    return ring;
+}
+
+void UploadRing::beginFrame() {
+    if (_buffer == 0) {
+        create(DefaultSectionSize);
+    }
+    wait(_section);
+    _head = 0;
+}
+
+void UploadRing::endFrame() {
+    if (_buffer == 0) {
+        return;
+    }
+    _fences[_section] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    _frameUsage = _head;
+    _section = (_section + 1) % FramesInFlight;
+}
+
+UploadRing::Allocation UploadRing::allocate(std::size_t size, std::size_t alignment) {
+    if (_buffer == 0) {
+        create(DefaultSectionSize);
+    }
+
+    std::size_t offset { align(_head, alignment) };
+    if (offset + size > _sectionSize) {
+        // the new buffer is not used by the GPU yet, so the frame continues in its first section
+        ++_overflows;
+        create(std::max(_sectionSize * 2, align(size, alignment)));
+        _section = 0;
+        offset = 0;
+    }
+
+    _head = offset + size;
+    const std::size_t position { _section * _sectionSize + offset };
+    return { _data + position, _buffer, static_cast<GLintptr>(position), static_cast<GLsizeiptr>(size) };
+}
+
+std::size_t UploadRing::getUniformAlignment() {
+    if (_uniformAlignment == 0) {
+        GLint alignment { 0 };
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        _uniformAlignment = static_cast<std::size_t>(std::max(alignment, 16));
+    }
+    return _uniformAlignment;
+}
+
+std::size_t UploadRing::getSectionSize() const noexcept {
+    return _sectionSize;
+}
+
+std::size_t UploadRing::getFrameUsage() const noexcept {
+    return _frameUsage;
+}
+
+std::uint64_t UploadRing::getStallCount() const noexcept {
+    return _stalls;
+}
+
+std::uint64_t UploadRing::getOverflowCount() const noexcept {
+    return _overflows;
+}
+
+void UploadRing::create(std::size_t sectionSize) {
+    if (!GLEW_ARB_buffer_storage) {
+        throw std::runtime_error { "persistently mapped buffers are not supported (requires OpenGL 4.4)" };
+    }
+    release();
+
+    const auto size { static_cast<GLsizeiptr>(sectionSize * FramesInFlight) };
+    glGenBuffers(1, &_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+    glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, MapFlags);
+    _data = static_cast<std::uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, MapFlags));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    if (_data == nullptr) {
+        release();
+        throw std::runtime_error { "could not map upload buffer" };
+    }
+    _sectionSize = sectionSize;
+}
+
+void UploadRing::release() noexcept {
+    for (GLsync &fence : _fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (_buffer != 0) {
+        // the driver keeps the storage alive until pending draws have read it
+        glBindBuffer(GL_COPY_WRITE_BUFFER, _buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &_buffer);
+        _buffer = 0;
+        _data = nullptr;
+    }
+}
+
+void UploadRing::wait(unsigned section) {
+    GLsync &fence { _fences[section] };
+    if (fence == nullptr) {
+        return;
+    }
+
+    GLenum result { glClientWaitSync(fence, 0, 0) };
+    if (result == GL_TIMEOUT_EXPIRED) {
+        ++_stalls;  // the GPU is more than FramesInFlight frames behind
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WaitTimeout);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+}  // namespace bgl
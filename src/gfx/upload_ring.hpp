@@ -0,0 +1,101 @@
+/**
+ * @file upload_ring.hpp
+ * @brief Sub-allocation of per-frame data from a persistently mapped buffer.
+ */
+#ifndef GFX_UPLOAD_RING_HPP_
+#define GFX_UPLOAD_RING_HPP_
+
+#include <cstddef>  // std::size_t
+#include <cstdint>
+#include <cstring>  // std::memcpy()
+
+#include "gl.hpp"
+
+
+namespace bgl {
+
+/**
+ * @brief Hands out transient buffer memory for per-draw constants and vertices.
+ * @details The buffer is created with glBufferStorage and stays mapped with coherent writes, so
+ *          allocations are plain pointer bumps without any driver calls. It is split into one
+ *          section per frame in flight. A fence guards each section, and beginFrame() only waits
+ *          if the GPU is still reading the section from @p FramesInFlight frames ago, which is
+ *          counted as a stall. If a frame needs more than a section, the buffer is replaced by
+ *          one twice as large, which is counted as an overflow. The old buffer is released by
+ *          the driver once the GPU has finished reading it. All methods must be called with the
+ *          OpenGL context being current.
+ */
+class UploadRing {
+ public:
+	static constexpr std::size_t DefaultSectionSize { std::size_t { 1 } * 1024 * 1024 };  // per frame
+	static constexpr unsigned FramesInFlight { 3 };
+
+	struct Allocation {
+		void *data;  // write-only
+		GLuint buffer;
+		GLintptr offset;
+		GLsizeiptr size;
+	};
+
+	static UploadRing& instance();
+
+	UploadRing(UploadRing&&) = delete;
+	UploadRing& operator=(UploadRing&&) = delete;
+
+	UploadRing(const UploadRing&) = delete;
+	UploadRing& operator=(const UploadRing&) = delete;
+
+	virtual ~UploadRing() noexcept = default;  // leaves the OpenGL objects to release()
+
+	void beginFrame();
+	void endFrame();
+
+	/**
+	 * @note The memory is only valid until the GPU has finished the current frame.
+	 */
+	Allocation allocate(std::size_t size, std::size_t alignment = 16);
+
+	/**
+	 * @brief Allocates and copies a uniform block, aligned as required for glBindBufferRange().
+	 */
+	template<typename T>
+	Allocation upload(const T &block) {
+		const Allocation allocation { allocate(sizeof(T), getUniformAlignment()) };
+		std::memcpy(allocation.data, &block, sizeof(T));
+		return allocation;
+	}
+
+	std::size_t getUniformAlignment();
+	std::size_t getSectionSize() const noexcept;
+	std::size_t getFrameUsage() const noexcept;  // bytes allocated in the last finished frame
+	std::uint64_t getStallCount() const noexcept;
+	std::uint64_t getOverflowCount() const noexcept;
+
+	/**
+	 * @brief Deletes the buffer and fences, the next frame creates a new buffer.
+	 * @note Must be called before the OpenGL context is destroyed, as the ring outlives it.
+	 */
+	void release() noexcept;
+
+ private:
+	UploadRing() = default;
+
+	void create(std::size_t sectionSize);
+	void wait(unsigned section);
+
+	GLuint _buffer { 0 };
+	std::uint8_t *_data { nullptr };
+	std::size_t _sectionSize { 0 };
+	GLsync _fences[FramesInFlight] { nullptr, nullptr, nullptr };
+
+	unsigned _section { 0 };  // of the current frame
+	std::size_t _head { 0 };  // offset within the section
+	std::size_t _frameUsage { 0 };
+	std::size_t _uniformAlignment { 0 };
+	std::uint64_t _stalls { 0 };
+	std::uint64_t _overflows { 0 };
+};
+
+}  // namespace bgl
+
+#endif  // GFX_UPLOAD_RING_HPP_
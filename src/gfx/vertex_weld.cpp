@@ -0,0 +1,359 @@
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // __SSE2__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>    // std::floor()
+#include <cstdint>
+#include <cstring>  // std::memcpy()
+#include <iomanip>
+#include <iostream>
+#include <numeric>  // std::partial_sum()
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "vertex_weld.hpp"
+#include "parallel.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+constexpr std::size_t PartitionsPerThread { 8 };  // balances partitions of different sizes
+constexpr std::size_t PartitionSize { 16384 };   // vertices, so that the table of a partition stays in the cache
+constexpr std::size_t PrefetchDistance { 16 };   // entries, the vertices of a partition are scattered over the mesh
+
+std::atomic<float> weld_epsilon { 0.0f };
+
+using Clock = std::chrono::steady_clock;
+
+inline double get_milliseconds(Clock::time_point begin) {
+    return std::chrono::duration<double, std::milli> { Clock::now() - begin }.count();
+}
+
+inline std::uint32_t get_bits(float value) noexcept {
+    value += 0.0f;  // -0 becomes +0
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+/**
+ * @brief The bits two vertices are compared by: the position or its grid cell, normal and texture coordinates.
+ */
+struct Key {
+    std::uint32_t bits[8];
+
+    bool operator==(const Key &other) const noexcept {
+        return std::memcmp(bits, other.bits, sizeof(bits)) == 0;
+    }
+};
+
+inline Key get_key(const Vertex &vertex, float epsilon) noexcept {
+    const vec3 &position { vertex.position };
+    const vec3 cell { epsilon > 0.0f ? vec3 { std::floor(position.x / epsilon), std::floor(position.y / epsilon),
+                                              std::floor(position.z / epsilon) }
+                                     : position };
+    return { { get_bits(cell.x), get_bits(cell.y), get_bits(cell.z),
+               get_bits(vertex.normal.x), get_bits(vertex.normal.y), get_bits(vertex.normal.z),
+               get_bits(vertex.texcoords.x), get_bits(vertex.texcoords.y) } };
+}
+
+inline std::uint64_t hash(const Key &key) noexcept {
+    constexpr std::uint64_t Multiplier { 0x9E3779B97F4A7C15ull };  // mixes the bits of all components
+    std::uint64_t hash { 0 };
+    for (const std::uint32_t bits : key.bits) {
+        hash = (hash ^ (hash >> 32) ^ bits) * Multiplier;
+    }
+    return hash ^ (hash >> 32);
+}
+
+struct Entry {
+    std::uint64_t hash;
+    GLuint vertex;
+};
+
+/**
+ * @param first receives the first occurrence of every distinct vertex if it is not null
+ */
+std::pmr::vector<GLuint> build_remap(const std::vector<Vertex> &vertices, float epsilon, std::size_t &count,
+                                     std::pmr::vector<GLuint> *first, std::pmr::memory_resource *memory) {
+    const std::size_t vertex_count { vertices.size() };
+    std::pmr::vector<std::uint64_t> hashes(vertex_count, memory);
+    parallel_for(0, vertex_count, [&] (std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            hashes[i] = hash(get_key(vertices[i], epsilon));
+        }
+    });
+
+    // the high bits of a hash select its partition, the low bits its slot in the partition's table
+    const std::size_t chunk_count { get_thread_count() };
+    std::size_t partition_bits { 1 };
+    while ((std::size_t { 1 } << partition_bits) < chunk_count * PartitionsPerThread ||
+           (std::size_t { 1 } << partition_bits) * PartitionSize < vertex_count) {
+        ++partition_bits;
+    }
+    const std::size_t partition_count { std::size_t { 1 } << partition_bits };
+    const auto get_partition = [partition_bits] (std::uint64_t hash) {
+        return static_cast<std::size_t>(hash >> (64 - partition_bits));
+    };
+    const auto get_chunk_begin = [vertex_count, chunk_count] (std::size_t chunk) {
+        return vertex_count * chunk / chunk_count;
+    };
+
+    // scatters the vertices into their partitions, keeping their order so the first occurrence comes first
+    std::pmr::vector<std::size_t> offsets(chunk_count * partition_count, 0, memory);  // [chunk][partition]
+    parallel_for(0, chunk_count, [&] (std::size_t begin, std::size_t end) {
+        for (auto chunk = begin; chunk < end; ++chunk) {
+            std::size_t *counts { &offsets[chunk * partition_count] };
+            for (auto i = get_chunk_begin(chunk); i < get_chunk_begin(chunk + 1); ++i) {
+                ++counts[get_partition(hashes[i])];
+            }
+        }
+    }, 1);
+    std::pmr::vector<std::size_t> partitions(partition_count + 1, memory);  // first vertex of each partition
+    std::pmr::vector<std::size_t> tables(partition_count + 1, memory);      // first slot of each partition
+    partitions[0] = tables[0] = 0;
+    for (auto partition = 0u; partition < partition_count; ++partition) {
+        std::size_t offset { partitions[partition] };
+        for (auto chunk = 0u; chunk < chunk_count; ++chunk) {
+            const std::size_t size { offsets[chunk * partition_count + partition] };
+            offsets[chunk * partition_count + partition] = offset;
+            offset += size;
+        }
+        partitions[partition + 1] = offset;
+
+        std::size_t capacity { 4 };
+        while (capacity < (offset - partitions[partition]) * 2) {
+            capacity *= 2;
+        }
+        tables[partition + 1] = tables[partition] + capacity;
+    }
+    std::pmr::vector<Entry> entries(vertex_count, memory);
+    parallel_for(0, chunk_count, [&] (std::size_t begin, std::size_t end) {
+        for (auto chunk = begin; chunk < end; ++chunk) {
+            std::size_t *next { &offsets[chunk * partition_count] };
+            for (auto i = get_chunk_begin(chunk); i < get_chunk_begin(chunk + 1); ++i) {
+                entries[next[get_partition(hashes[i])]++] = { hashes[i], static_cast<GLuint>(i) };
+            }
+        }
+    }, 1);
+    hashes = std::pmr::vector<std::uint64_t> { memory };
+
+    // finds the first occurrence of every vertex with an open addressing hash table per partition
+    std::pmr::vector<GLuint> table(tables.back(), 0, memory);  // entry in the partition + 1, 0 for empty slots
+    std::pmr::vector<GLuint> representatives(vertex_count, memory);
+    parallel_for(0, partition_count, [&] (std::size_t begin, std::size_t end) {
+        for (auto partition = begin; partition < end; ++partition) {
+            const Entry *partition_entries { &entries[partitions[partition]] };
+            GLuint *slots { &table[tables[partition]] };
+            const std::size_t mask { tables[partition + 1] - tables[partition] - 1 };
+            const std::size_t size { partitions[partition + 1] - partitions[partition] };
+            for (auto i = 0u; i < size; ++i) {
+                const Entry &entry { partition_entries[i] };
+#if defined(__SSE2__)
+                if (i + PrefetchDistance < size) {
+                    const GLuint ahead { partition_entries[i + PrefetchDistance].vertex };
+                    _mm_prefetch(reinterpret_cast<const char*>(&vertices[ahead]), _MM_HINT_T0);
+                    _mm_prefetch(reinterpret_cast<const char*>(&representatives[ahead]), _MM_HINT_T0);
+                }
+#endif  // __SSE2__
+                for (auto slot = entry.hash & mask; ; slot = (slot + 1) & mask) {
+                    if (slots[slot] == 0) {
+                        slots[slot] = i + 1;
+                        representatives[entry.vertex] = entry.vertex;
+                        break;
+                    }
+                    const Entry &other { partition_entries[slots[slot] - 1] };
+                    if (other.hash == entry.hash &&
+                        get_key(vertices[other.vertex], epsilon) == get_key(vertices[entry.vertex], epsilon)) {
+                        representatives[entry.vertex] = other.vertex;
+                        break;
+                    }
+                }
+            }
+        }
+    }, 1);
+
+    // numbers the distinct vertices by their first occurrence
+    std::pmr::vector<std::size_t> firsts(chunk_count + 1, 0, memory);  // distinct vertices before each chunk
+    parallel_for(0, chunk_count, [&] (std::size_t begin, std::size_t end) {
+        for (auto chunk = begin; chunk < end; ++chunk) {
+            for (auto i = get_chunk_begin(chunk); i < get_chunk_begin(chunk + 1); ++i) {
+                firsts[chunk + 1] += representatives[i] == i;
+            }
+        }
+    }, 1);
+    std::partial_sum(firsts.begin(), firsts.end(), firsts.begin());
+    count = firsts.back();
+
+    std::pmr::vector<GLuint> remap(vertex_count, memory);
+    if (first != nullptr) {
+        first->resize(count);
+    }
+    parallel_for(0, chunk_count, [&] (std::size_t begin, std::size_t end) {
+        for (auto chunk = begin; chunk < end; ++chunk) {
+            auto next { static_cast<GLuint>(firsts[chunk]) };
+            for (auto i = get_chunk_begin(chunk); i < get_chunk_begin(chunk + 1); ++i) {
+                if (representatives[i] == i) {
+                    if (first != nullptr) {
+                        (*first)[next] = static_cast<GLuint>(i);
+                    }
+                    remap[i] = next++;
+                }
+            }
+        }
+    }, 1);
+    parallel_for(0, vertex_count, [&] (std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            if (representatives[i] != i) {
+                remap[i] = remap[representatives[i]];  // of a first occurrence, which is numbered already
+            }
+        }
+    });
+    return remap;
+}
+
+/**
+ * @brief Creates a grid of size x size positions whose triangles have vertices of their own,
+ *        in random order like a file that was imported without joining its vertices.
+ */
+std::vector<Vertex> create_soup(unsigned size) {
+    std::vector<std::size_t> cells(std::size_t { size - 1 } * (size - 1));
+    std::iota(cells.begin(), cells.end(), std::size_t { 0 });
+    std::shuffle(cells.begin(), cells.end(), std::mt19937 { 42 });
+
+    const auto get_vertex = [size] (std::size_t x, std::size_t y) {
+        const vec2 uv { static_cast<float>(x) / static_cast<float>(size - 1),
+                        static_cast<float>(y) / static_cast<float>(size - 1) };
+        return Vertex { vec3 { uv.x * 2.0f - 1.0f, 0.1f * std::sin(uv.x * 20.0f) * std::cos(uv.y * 20.0f),
+                               uv.y * 2.0f - 1.0f },
+                        vec3 { 0.0f, 1.0f, 0.0f }, uv };
+    };
+    std::vector<Vertex> vertices;
+    vertices.reserve(cells.size() * 6);
+    for (auto cell : cells) {
+        const std::size_t x { cell % (size - 1) }, y { cell / (size - 1) };
+        vertices.insert(vertices.end(), { get_vertex(x, y), get_vertex(x, y + 1), get_vertex(x + 1, y),
+                                          get_vertex(x + 1, y), get_vertex(x, y + 1), get_vertex(x + 1, y + 1) });
+    }
+    return vertices;
+}
+
+struct KeyHash {
+    std::size_t operator()(const Key &key) const noexcept {
+        return static_cast<std::size_t>(hash(key));
+    }
+};
+
+std::vector<GLuint> build_remap_serially(const std::vector<Vertex> &vertices, std::size_t &count) {
+    std::unordered_map<Key, GLuint, KeyHash> numbers;
+    numbers.reserve(vertices.size());
+    std::vector<GLuint> remap(vertices.size());
+    for (auto i = 0u; i < vertices.size(); ++i) {
+        remap[i] = numbers.emplace(get_key(vertices[i], 0.0f), static_cast<GLuint>(numbers.size())).first->second;
+    }
+    count = numbers.size();
+    return remap;
+}
+
+/**
+ * @brief Welds a copy of a triangle soup and checks that every index refers to an identical vertex.
+ */
+bool check_welding(const std::vector<Vertex> &soup, std::size_t count) {
+    std::vector<Vertex> vertices { soup };
+    std::vector<GLuint> indices(soup.size());
+    std::iota(indices.begin(), indices.end(), GLuint { 0 });
+    WeldVertices(vertices, indices);
+
+    if (vertices.size() != count) {
+        return false;
+    }
+    for (auto i = 0u; i < indices.size(); ++i) {
+        if (indices[i] >= vertices.size() || std::memcmp(&vertices[indices[i]], &soup[i], sizeof(Vertex)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // anonymous namespace
+
+void SetWeldEpsilon(float epsilon) noexcept {
+    weld_epsilon = epsilon;
+}
+
+float GetWeldEpsilon() noexcept {
+    return weld_epsilon;
+}
+
+std::pmr::vector<GLuint> GenerateVertexRemap(const std::vector<Vertex> &vertices, float positionEpsilon,
+                                             std::size_t &count, std::pmr::memory_resource *memory) {
+    return build_remap(vertices, positionEpsilon, count, nullptr, memory);
+}
+
+std::size_t WeldVertices(std::vector<Vertex> &vertices, std::vector<GLuint> &indices, float positionEpsilon,
+                         std::pmr::memory_resource *memory) {
+    std::size_t count { 0 };
+    std::pmr::vector<GLuint> first { memory };
+    const std::pmr::vector<GLuint> remap { build_remap(vertices, positionEpsilon, count, &first, memory) };
+    if (count == vertices.size()) {
+        return 0;  // the remap table is the identity
+    }
+
+    parallel_for(0, indices.size(), [&] (std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            indices[i] = remap[indices[i]];
+        }
+    });
+    std::vector<Vertex> welded(count);
+    parallel_for(0, count, [&] (std::size_t begin, std::size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            welded[i] = vertices[first[i]];
+        }
+    });
+
+    const std::size_t removed { vertices.size() - count };
+    vertices = std::move(welded);  // frees the duplicates
+    return removed;
+}
+
+bool RunWeldBenchmark() {
+    constexpr int Repetitions { 3 };  // of welding, the fastest one counts
+
+    bool valid { true };
+    for (const unsigned size : { 256u, 1024u, 1415u }) {
+        const std::vector<Vertex> vertices { create_soup(size) };
+
+        std::size_t count { 0 };
+        std::pmr::vector<GLuint> remap;
+        double parallel_time { INFINITY };
+        for (auto i = 0; i < Repetitions; ++i) {
+            const Clock::time_point begin { Clock::now() };
+            remap = GenerateVertexRemap(vertices, 0.0f, count);
+            parallel_time = std::min(parallel_time, get_milliseconds(begin));
+        }
+
+        std::size_t serial_count { 0 };
+        const Clock::time_point begin { Clock::now() };
+        const std::vector<GLuint> serial_remap { build_remap_serially(vertices, serial_count) };
+        const double serial_time { get_milliseconds(begin) };
+        const bool matches { count == serial_count && std::equal(remap.begin(), remap.end(), serial_remap.begin()) &&
+                             check_welding(vertices, count) };
+        valid = valid && matches;
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "soup " << size << "x" << size << ": " << vertices.size() << " vertices -> "
+                  << count << " distinct, welded in " << parallel_time << " ms ("
+                  << static_cast<double>(vertices.size()) / parallel_time / 1000.0 << " M vertices/s) on "
+                  << get_thread_count() << " threads, serial hash map " << serial_time << " ms ("
+                  << serial_time / parallel_time << "x)" << (matches ? "" : " MISMATCH") << std::endl;
+    }
+    return valid;
+}
+
+}  // namespace bgl
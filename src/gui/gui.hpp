@@ -1,4 +1,5 @@
 
 #include "window.hpp"
 #include "viewport.hpp"
+#include "panel.hpp"
 
@@ -7,24 +7,41 @@
 
 #include <optional>
 #include <filesystem>
-#include <memory>
 
 #include "menu.hpp"
-#include "../gfx/model.hpp"  // TODO
 
 
 namespace {
 
 inline std::optional<std::filesystem::path> chooseFile() {
     const QString fileName { QFileDialog::getOpenFileName(nullptr, "Load 3D Model", "", "All Files (*)") };
-    return fileName.isEmpty() ? std::filesystem::path{} : std::filesystem::path { fileName.toStdString() };
+    return fileName.isEmpty() ? std::nullopt : std::optional { std::filesystem::path { fileName.toStdString() } };
+}
+
+inline void showAboutBox() {
+    QMessageBox::about(nullptr, "About,", "A simple Qt OpenGL demo.");
+}
+
+}  // anonymous namespace
+
+namespace bgl {
+
+MenuBar::MenuBar(Window &window)
+    : _window { window } {
+    QMenu * const fileMenu { this->addMenu("&File") };
+    fileMenu->addAction("Load", [this] () { loadModel(); });
+    fileMenu->addAction("Unload All", [this] () { _window.unloadModels(); });
+    fileMenu->addAction("Exit", [this] () { _window.close(); });
+
+    QMenu * const helpMenu { this->addMenu("&Help") };
+    helpMenu->addAction("About", &showAboutBox);
 }
 
 /**
  * @brief Selects and loads a 3D model.
  */
-void load3DModel() {
-    std::optional<std::filesystem::path> path { chooseFile() };
+void MenuBar::loadModel() noexcept {
+    const std::optional<std::filesystem::path> path { chooseFile() };
     if (!path.has_value()) {
         QMessageBox::information(nullptr, "Warning", "No file chosen.");
         return;
@@ -34,9 +51,8 @@ void load3DModel() {
     progressBar.show();
     progressBar.setValue(0);
 
-    std::shared_ptr<bgl::Model> model;
     try {
-        model = bgl::LoadModel(path.value());
+        onLoadModel(path.value());
         // TODO: update progress bar
     } catch (std::exception &exception) {
         QMessageBox::critical(nullptr, "Error", exception.what());
@@ -48,29 +64,10 @@ void load3DModel() {
     // TODO: update model statistics panel
     progressBar.setValue(100);
     progressBar.hide();
-    // TODO: update model in viewport
-}
-
-inline void showAboutBox() {
-    QMessageBox::about(nullptr, "About,", "A simple Qt OpenGL demo.");
-}
-
-}  // anonymous namespace
-
-namespace bgl {
-
-MenuBar::MenuBar(QMainWindow &window)
-    : _window { window } {
-    QMenu * const fileMenu { this->addMenu("&File") };
-    fileMenu->addAction("Load", this, &load3DModel);
-    fileMenu->addAction("Exit", [this] () { _window.close(); });
-
-    QMenu * const helpMenu { this->addMenu("&Help") };
-    helpMenu->addAction("About", &showAboutBox);
 }
 
 void MenuBar::onLoadModel(const std::filesystem::path &path) {
-    QMessageBox::warning(nullptr, "Warning,", "Not implemented yet.");
+    _window.loadModel(path);
 }
 
 }  // namespace bgl
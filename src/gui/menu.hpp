@@ -1,17 +1,18 @@
 #ifndef GUI_MENU_BAR_HPP
 #define GUI_MENU_BAR_HPP
 
-#include <QMainWindow>
 #include <QMenuBar>
 
 #include <filesystem>
 
+#include "window.hpp"
+
 
 namespace bgl {
 
 class MenuBar : public QMenuBar {
  public:
-	explicit MenuBar(QMainWindow &window);  // NOLINT
+	explicit MenuBar(Window &window);  // NOLINT
 
 	MenuBar(MenuBar&&) = default;
 	MenuBar& operator=(MenuBar&&) = default;
@@ -24,10 +25,10 @@ class MenuBar : public QMenuBar {
  protected:
 	virtual void onLoadModel(const std::filesystem::path &path);
 
-	private:
+ private:
 	void loadModel() noexcept;
 
-	QMainWindow &_window;
+	Window &_window;
 };
 
 }  // namespace bgl
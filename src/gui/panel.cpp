@@ -1,161 +1,213 @@
-#if 0
-#include "panel.hpp"
-
-#include <QFrame>
-#include <QCheckBox>
 #include <QComboBox>
-#include <QLayout>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QFrame>
 #include <QLabel>
+#include <QTreeWidget>
+#include <QVBoxLayout>
 
-#include <iostream>
+#include <filesystem>
+#include <iomanip>   // std::setprecision()
+#include <iterator>  // std::size()
+#include <set>
 #include <sstream>
-#include <iosfwd>
-#include <iomanip>
-
+#include <string>
+#include <utility>   // std::move()
 
-namespace bgl {
+#include "panel.hpp"
 
-SettingsPanel::SettingsPanel()
-        : _renderMode { "Render Mode:" },
-          _lighting { "Lighting" },
-          _boundingBox { "Bounding Box" } {
-	_renderMode->addItem("Solid");
-	_renderMode->addItem("Textured");
-	_renderMode->addItem("Wireframe");
-	connect(_renderMode, &QComboBox::currentTextChanged, this, &onSettingsChanged);
-	connect(_lighting, &QCheckBox::stateChanged, this, &onSettingsChanged);
-	connect(_boundingBox, &QCheckBox::stateChanged, this, &onSettingsChanged);
-
-	this->setLayout(&layout);
-}
 
-void SettingsPanel::onSettingsChanged() {
-	// TODO
-}
+namespace bgl {
 
-bool SettingsPanel::is_set(Settings settings) {
-	const QCheckBox *checkBox { nullptr };
-	switch (settings) {
-		case 0:
-			break;
-		default:
-			assert(false, "");
-	}
+namespace {
 
-	return checkBox->checkState() == Qt::Checked;
-}
+constexpr RenderMode RenderModes[] {
+    RenderMode::Solid, RenderMode::Textured, RenderMode::Wireframe, RenderMode::SolidWireframe
+};
 
-RenderMode SettingsPanel::get_mode() {
-	return {};  // TODO
-}
+constexpr Antialiasing AntialiasingModes[] {
+    Antialiasing::None, Antialiasing::MSAA2, Antialiasing::MSAA4, Antialiasing::MSAA8, Antialiasing::FXAA
+};
 
+constexpr double MaxTargetFrameTime { 1000.0 };  // [ms]
 
-StatisticsPanel::StatisticsPanel()
-	: _statistics { "Vertices", "Triangles", "Materials" } {
-	_layout { new QVBoxLayout();
-	_layout.addWidget(&_statistics.triangles);
-	_layout.addWidget(&_statistics.vertices);
-	_layout.addWidget(&_statistics.materials);
-	_layout.addStretch();
-	this->setLayout(&layout);
+std::string format_bytes(std::size_t bytes) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    if (bytes >= 1024 * 1024) {
+        oss << bytes / (1024.0 * 1024.0) << " MiB";
+    } else if (bytes >= 1024) {
+        oss << bytes / 1024.0 << " KiB";
+    } else {
+        oss << bytes << " B";
+    }
+    return oss.str();
 }
 
-void StatisticsPanel::update(StatisticsType type, unsigned int value) {
-	// TODO
+/**
+ * @brief Sets the name, GPU and CPU memory columns of a statistics tree item.
+ */
+QTreeWidgetItem* set_columns(QTreeWidgetItem *item, const std::string &name, std::size_t gpu, std::size_t cpu) {
+    item->setText(0, QString::fromStdString(name));
+    item->setText(1, QString::fromStdString(format_bytes(gpu)));
+    item->setText(2, QString::fromStdString(format_bytes(cpu)));
+    item->setTextAlignment(1, Qt::AlignRight | Qt::AlignVCenter);
+    item->setTextAlignment(2, Qt::AlignRight | Qt::AlignVCenter);
+    return item;
 }
 
-Panel::Panel() {
-	_layout.addStretch();
-	_layout.addWidget(&_satistics);
-	_layout.addWidget(&_settings);
-	this->setLayout(&_layout);
+void add_materials(QTreeWidgetItem *parent, const ModelMemory &model) {
+    for (auto i = 0u; i < model.materials.size(); ++i) {
+        const MaterialMemory &material { model.materials[i] };
+        QTreeWidgetItem * const item { new QTreeWidgetItem { parent } };
+        set_columns(item, "Material " + std::to_string(i), material.gpuBytes, 0);
+        for (const TextureMemory &texture : material.textures) {
+            const std::string name { texture.path.empty() ? std::string { "unnamed" }
+                                                          : std::filesystem::path { texture.path }.filename().string() };
+            QTreeWidgetItem * const child { new QTreeWidgetItem { item } };
+            set_columns(child, texture.slot + ": " + name, texture.gpuBytes, 0);
+
+            std::ostringstream tooltip;
+            tooltip << texture.path;
+            if (texture.residentLevel) {
+                tooltip << "\nstreamed, mip level " << *texture.residentLevel << " and coarser resident";
+            }
+            if (texture.users > 1) {
+                tooltip << "\nshared by " << texture.users << " models";
+            }
+            child->setToolTip(0, QString::fromStdString(tooltip.str()));
+        }
+    }
 }
 
-namespace {
+}  // anonymous namespace
 
-void onStateChange(QCheckBox * checkbox, int state) {
-    std::cout << checkbox->text().toStdString() << " changed to " 
-              << (state == Qt::Checked ? "on" : "off")
-              << std::endl;
+SettingsPanel::SettingsPanel()
+    : _layout { this } {
+    for (const RenderMode mode : RenderModes) {
+        _renderMode.addItem(GetName(mode));
+    }
+    setRenderMode(RenderMode::Textured);
+    _layout.addRow("Render mode:", &_renderMode);
+
+    for (const Antialiasing mode : AntialiasingModes) {
+        _antialiasing.addItem(GetName(mode));
+    }
+    _layout.addRow("Anti-aliasing:", &_antialiasing);
+
+    _targetFrameTime.setRange(0.0, MaxTargetFrameTime);
+    _targetFrameTime.setDecimals(1);
+    _targetFrameTime.setSuffix(" ms");
+    _targetFrameTime.setSpecialValueText("Off");  // shown for 0, i.e. full resolution
+    _targetFrameTime.setToolTip("Lowers the resolution of the scene to hold this frame time");
+    _layout.addRow("Target frame time:", &_targetFrameTime);
+
+    setFrameShape(QFrame::StyledPanel);
+    for (QComboBox *comboBox : { &_renderMode, &_antialiasing }) {
+        connect(comboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+                [this] (int) { onSettingsChanged(); });
+    }
+    connect(&_targetFrameTime, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+            [this] (double) { onSettingsChanged(); });
 }
 
-// render mode change
-void onSelectionChange(QComboBox * comboBox, const QString &text) {
-    std::cout << text.toStdString() << " selected" << std::endl;
+RenderMode SettingsPanel::getRenderMode() const {
+    const int index { _renderMode.currentIndex() };
+    return index < 0 ? RenderMode::Textured : RenderModes[index];
 }
 
-void onTextureModeChanged(QComboBox * comboBox, const QString &text) {
-    // TODO:
+void SettingsPanel::setRenderMode(RenderMode mode) {
+    for (auto i = 0u; i < std::size(RenderModes); ++i) {
+        if (RenderModes[i] == mode) {
+            _renderMode.setCurrentIndex(static_cast<int>(i));
+        }
+    }
 }
 
-}  // anonymous namespace
-
-
-ControlPanel::ControlPanel()
-    : _comboBox { new QComboBox },
-      _checkbox1 { new QCheckBox("Light") },
-      _checkbox3 { new QCheckBox("Bounding Box") }
-{
-    // set rendering modes
-    _comboBox->addItem("Solid");
-    _comboBox->addItem("Textured");
-    _comboBox->addItem("Wireframe");
-
-    // _comboBox->setDisabled(true);
-
-    // TODO: ComboBox Texture Sampling selection ("Nearest", "Linear")
-
-    // set frame layout
-    QVBoxLayout * const layout { new QVBoxLayout() };
-    setFrameShape(QFrame::HLine);
-    setFrameStyle(1);
-    setLayout(layout);
-
-    layout->addWidget(_checkbox1);
-    layout->addWidget(_checkbox3);
-    layout->addWidget(_comboBox);
-    layout->addStretch();  // disables stretching
-
-    // TODO: simplify
-    connect(_checkbox1, &QCheckBox::stateChanged,
-            std::bind(&onStateChange, _checkbox1, std::placeholders::_1));
-    connect(_checkbox3, &QCheckBox::stateChanged,
-            std::bind(&onStateChange, _checkbox3, std::placeholders::_1));
-
-    connect(_comboBox, &QComboBox::currentTextChanged,
-            std::bind(&onSelectionChange, _comboBox, std::placeholders::_1));
+Antialiasing SettingsPanel::getAntialiasing() const {
+    const int index { _antialiasing.currentIndex() };
+    return index < 0 ? Antialiasing::None : AntialiasingModes[index];
 }
 
+void SettingsPanel::setAntialiasing(Antialiasing mode) {
+    for (auto i = 0u; i < std::size(AntialiasingModes); ++i) {
+        if (AntialiasingModes[i] == mode) {
+            _antialiasing.setCurrentIndex(static_cast<int>(i));
+        }
+    }
+}
 
-InfoPanel::InfoPanel(unsigned vertices, unsigned materials, unsigned triangles)
-    : _vertices { createLabel("Vertices", vertices) },
-        _triangles { createLabel("Triangles", triangles) },
-        _materials { createLabel("Materials", materials) } {
+double SettingsPanel::getTargetFrameTime() const {
+    return _targetFrameTime.value();
+}
 
-    setFrameShape(QFrame::HLine);  // TODO: rethink
-    setFrameStyle(1);              // TODO: rethink
+void SettingsPanel::setTargetFrameTime(double time) {
+    _targetFrameTime.setValue(time);
+}
 
-    QVBoxLayout * const layout { new QVBoxLayout() };
-    layout->addWidget(_triangles);
-    layout->addWidget(_vertices);
-    layout->addWidget(_materials);
-    layout->addStretch();
-    setLayout(layout);
+void SettingsPanel::setOnSettingsChanged(Callback callback) {
+    _callback = std::move(callback);
 }
 
-QLabel* InfoPanel::createLabel(const std::string &text, unsigned number) {
-    std::ostringstream oss;
-    oss << text << ": " << std::setw(6) << number;
-    return new QLabel { oss.str().c_str() };
+void SettingsPanel::onSettingsChanged() {
+    if (_callback) {
+        _callback();
+    }
 }
 
+/* ------------------------------------ StatisticsPanel ------------------------------------ */
+
+StatisticsPanel::StatisticsPanel()
+    : _layout { this } {
+    _tree.setColumnCount(3);
+    _tree.setHeaderLabels({ "Resource", "GPU", "CPU" });
+    _layout.addWidget(&_summary);
+    _layout.addWidget(&_tree);
+    setFrameShape(QFrame::StyledPanel);
+    setMemoryReport(MemoryReport {});
+}
 
-Panel::Panel()
-    : _layout { new QVBoxLayout() } {
-    setLayout(_layout);
-    _layout->addStretch();
-    _layout->addWidget(new InfoPanel);
-    _layout->addWidget(new ControlPanel);
+void StatisticsPanel::setMemoryReport(const MemoryReport &report) {
+    std::set<std::string> expanded;
+    for (auto i = 0; i < _tree.topLevelItemCount(); ++i) {
+        if (_tree.topLevelItem(i)->isExpanded()) {
+            expanded.insert(_tree.topLevelItem(i)->text(0).toStdString());
+        }
+    }
+
+    _tree.clear();
+    for (const ModelMemory &model : report.models) {
+        std::string name { std::filesystem::path { model.path }.filename().string() };
+        if (!model.inScene) {
+            name += " (cached)";
+        }
+        QTreeWidgetItem * const item { new QTreeWidgetItem { &_tree } };
+        set_columns(item, name, model.bufferBytes + model.textureBytes, model.cpuBytes);
+        item->setToolTip(0, QString::fromStdString(model.path + "\n" + model.type));
+
+        for (auto i = 0u; i < model.meshes.size(); ++i) {
+            const MeshMemory &mesh { model.meshes[i] };
+            std::string label { "Mesh " + std::to_string(i) };
+            if (mesh.instances > 1) {
+                label += " (" + std::to_string(mesh.instances) + " instances)";
+            }
+            set_columns(new QTreeWidgetItem { item }, label,
+                        mesh.vertexBytes + mesh.indexBytes, mesh.meshletBytes + mesh.occluderBytes);
+        }
+        add_materials(item, model);
+        item->setExpanded(expanded.count(name) > 0);
+    }
+    for (auto column = 0; column < 3; ++column) {
+        _tree.resizeColumnToContents(column);
+    }
+
+    std::ostringstream summary;
+    summary << "GPU: " << format_bytes(report.bufferBytes) << " buffers, "
+            << format_bytes(report.textureBytes) << " textures\n"
+            << "CPU: " << format_bytes(report.cpuBytes) << " mesh copies, "
+            << format_bytes(report.residentBytes) << " resident\n"
+            << "Budget: " << format_bytes(report.budget);
+    _summary.setText(QString::fromStdString(summary.str()));
 }
 
-#endif  // 0
+}  // namespace bgl
@@ -1,80 +1,81 @@
-#ifdef  GUI_PANEL_HPP_
+#ifndef GUI_PANEL_HPP_
 #define GUI_PANEL_HPP_
 
-#include <QFrame>
-#include <QCheckBox>
 #include <QComboBox>
-#include <QLayout>
+#include <QDoubleSpinBox>
+#include <QFormLayout>
+#include <QFrame>
 #include <QLabel>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+
+#include <functional>  // std::function
+
+#include "../gfx/antialiasing.hpp"  // bgl::Antialiasing
+#include "../gfx/memory_report.hpp"  // bgl::MemoryReport
+#include "../gfx/render_mode.hpp"   // bgl::RenderMode
 
 
 namespace bgl {
 
+/**
+ * @brief Render settings that can be changed while the viewer is running.
+ */
 class SettingsPanel : public QFrame {
  public:
-    enum class RenderMode { /* TODO */ };
-    enum class Settings { /* TODO */  };
+	using Callback = std::function<void()>;
 
 	SettingsPanel();
-	SettingsPanel(SettingsPanel&&) = default;
-	StatisticsPanel& operator=(SettingsPanel&&) = default;
+	SettingsPanel(SettingsPanel&&) = delete;
+	SettingsPanel& operator=(SettingsPanel&&) = delete;
 
 	SettingsPanel(const SettingsPanel&) = delete;
 	SettingsPanel& operator=(const SettingsPanel&) = delete;
 
-    bool is_set(Settings settings);
-    RenderMode get_mode();
+	virtual ~SettingsPanel() noexcept = default;
+
+	RenderMode getRenderMode() const;
+	void setRenderMode(RenderMode mode);
+
+	Antialiasing getAntialiasing() const;
+	void setAntialiasing(Antialiasing mode);
+
+	double getTargetFrameTime() const;  // [ms] of dynamic resolution, 0 if disabled
+	void setTargetFrameTime(double time);
+
+	void setOnSettingsChanged(Callback callback);
 
  protected:
-    virtual void onSettingsChanged();
+	virtual void onSettingsChanged();
 
  private:
-    QComboBox _render_mode;
-    QCheckBox _lighting;
-    QCheckBox _bounding_box;
-    QLayout _layout;
+	QFormLayout _layout;
+	QComboBox _renderMode;
+	QComboBox _antialiasing;
+	QDoubleSpinBox _targetFrameTime;
+	Callback _callback;
 };
 
+/**
+ * @brief Memory of the loaded models broken down by mesh, material and texture.
+ */
 class StatisticsPanel : public QFrame {
  public:
-	enum class StatisticsType { /* TODO */ };
-
 	StatisticsPanel();
-	StatisticsPanel(StatisticsPanel&&) = default;
-	StatisticsPanel& operator=(StatisticsPanel&&) = default;
+	StatisticsPanel(StatisticsPanel&&) = delete;
+	StatisticsPanel& operator=(StatisticsPanel&&) = delete;
 
 	StatisticsPanel(const StatisticsPanel&) = delete;
 	StatisticsPanel& operator=(const StatisticsPanel&) = delete;
 
-	virtual StatisticsPanel() noexcept = default;
+	virtual ~StatisticsPanel() noexcept = default;
 
-    void update(StatisticsType type, unsigned int value);
-
- private:
-    QLabel vertices;
-    QLabel triangles;
-    QLabel materials;
-    QVBoxLayout _layout;
-};
-
-class Panel : public QPanel {
- public:
-	Panel();
-	Panel(Panel&&) = default;
-	Panel& operator=(Panel&&) = default;
-
-	Panel(const Panel&) = delete;
-	Panel& operator=(const Panel&) = delete;
-
-	virtual Panel() noexcept = default;
-
- protected:
-	virtual void settingsChanged();  // TODO
+	void setMemoryReport(const MemoryReport &report);  // keeps expanded models expanded
 
  private:
-	StatisticsPanel _statistics;
-	SettingsPanel _settings;
 	QVBoxLayout _layout;
+	QLabel _summary;
+	QTreeWidget _tree;
 };
 
 }  // namespace bgl
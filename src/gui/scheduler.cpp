@@ -0,0 +1,52 @@
+#include <QWidget>
+
+#include <algorithm>  // std::max()
+
+#include "scheduler.hpp"
+
+
+namespace bgl {
+
+RenderScheduler::RenderScheduler(QWidget &widget, int interval)
+    : _widget { widget }, _interval { interval } {
+    _timer.setSingleShot(true);
+    QObject::connect(&_timer, &QTimer::timeout, [this] () { _widget.update(); });
+}
+
+void RenderScheduler::request(Reason reason) {
+    _reasons |= reason;
+    ++_requests;
+    if (_timer.isActive()) {
+        return;  // coalesced into the already scheduled frame
+    }
+
+    // keeps at least one interval between two frames
+    const qint64 elapsed { _lastFrame.isValid() ? _lastFrame.elapsed() : _interval };
+    _timer.start(static_cast<int>(std::max<qint64>(0, _interval - elapsed)));
+}
+
+void RenderScheduler::onFrame() noexcept {
+    _timer.stop();  // this frame serves all pending requests
+    _frameReasons = _reasons;
+    _reasons = 0;
+    ++_frames;
+    _lastFrame.restart();
+}
+
+bool RenderScheduler::isIdle() const noexcept {
+    return _reasons == 0 && !_timer.isActive();
+}
+
+unsigned RenderScheduler::getReasons() const noexcept {
+    return _frameReasons;
+}
+
+std::size_t RenderScheduler::getRequestCount() const noexcept {
+    return _requests;
+}
+
+std::size_t RenderScheduler::getFrameCount() const noexcept {
+    return _frames;
+}
+
+}  // namespace bgl
@@ -0,0 +1,64 @@
+/**
+ * @file scheduler.hpp
+ * @brief Event driven redraws of a Viewport.
+ */
+#ifndef GUI_SCHEDULER_HPP_
+#define GUI_SCHEDULER_HPP_
+
+#include <QElapsedTimer>
+#include <QTimer>
+
+#include <cstddef>  // std::size_t
+
+class QWidget;
+
+
+namespace bgl {
+
+/**
+ * @brief Redraws a widget only when something visible changed.
+ * @details All requests that arrive within one frame interval are coalesced into a single
+ *          repaint. Without requests no frames are rendered at all.
+ */
+class RenderScheduler {
+ public:
+	enum Reason : unsigned {
+		Camera   = 1 << 0,
+		Scene    = 1 << 1,
+		Settings = 1 << 2,
+		Loading  = 1 << 3   // polls for background work to finish
+	};
+
+	explicit RenderScheduler(QWidget &widget, int interval = 16 /* [ms] */);
+
+	RenderScheduler(RenderScheduler&&) = delete;
+	RenderScheduler& operator=(RenderScheduler&&) = delete;
+
+	RenderScheduler(const RenderScheduler&) = delete;
+	RenderScheduler& operator=(const RenderScheduler&) = delete;
+
+	virtual ~RenderScheduler() noexcept = default;
+
+	void request(Reason reason);
+	void onFrame() noexcept;  // to be called by the widget whenever it renders
+
+	bool isIdle() const noexcept;
+	unsigned getReasons() const noexcept;  // reasons of the frame being rendered
+	std::size_t getRequestCount() const noexcept;
+	std::size_t getFrameCount() const noexcept;
+
+ private:
+	QWidget &_widget;
+	QTimer _timer;
+	QElapsedTimer _lastFrame;
+	const int _interval;
+
+	unsigned _reasons { 0 };
+	unsigned _frameReasons { 0 };
+	std::size_t _requests { 0 };
+	std::size_t _frames { 0 };
+};
+
+}  // namespace bgl
+
+#endif  // GUI_SCHEDULER_HPP_
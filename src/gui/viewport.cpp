@@ -10,6 +10,7 @@
 #include <ctime>     // std::clock()
 
 #include "viewport.hpp"
+#include "../gfx/startup.hpp"
 
 
 namespace bgl {
@@ -55,7 +56,15 @@ class frame_counter final {
 }  // anonymous namespace
 
 Viewport::Viewport(QWidget *parent)
-    : QOpenGLWidget( parent) {
+    : QOpenGLWidget( parent), _scheduler { *this } {
+}
+
+void Viewport::requestRedraw(RenderScheduler::Reason reason) {
+    _scheduler.request(reason);
+}
+
+const RenderScheduler& Viewport::getScheduler() const noexcept {
+    return _scheduler;
 }
 
 void Viewport::initializeGL() {
@@ -63,6 +72,7 @@ void Viewport::initializeGL() {
     if (GLEW_OK != error) {
         throw std::runtime_error { reinterpret_cast<const char*>(glewGetErrorString(error)) };
     }
+    MarkStartupPhase("initialized GLEW");
 
     glClearColor(0.3, 1.0, 0.3, 1.0f);
     std::cout << "initialized OpenGL: " << glGetString(GL_VERSION) << std::endl;
@@ -74,6 +84,8 @@ void Viewport::resizeGL(int width, int height) {
 }
 
 void Viewport::paintGL() {
+    _scheduler.onFrame();
+
 	static frame_counter frame_counter;
     const bool changed { frame_counter.count() };
     if (changed) {
@@ -83,6 +95,12 @@ void Viewport::paintGL() {
 
     makeCurrent();
     on_render(frame_counter.delta());
+
+    static bool first_frame { true };
+    if (first_frame) {
+        MarkStartupPhase("first frame");
+        first_frame = false;
+    }
     // std::cout << "paintedGL()" << std::endl;
 }
 
@@ -7,6 +7,8 @@
 
 #include <QOpenGLWidget>
 
+#include "scheduler.hpp"
+
 
 namespace bgl {
 
@@ -21,6 +23,9 @@ class Viewport : public QOpenGLWidget {
 
 	virtual ~Viewport() noexcept = default;
 
+	void requestRedraw(RenderScheduler::Reason reason);
+	const RenderScheduler& getScheduler() const noexcept;
+
  protected:
 	void initializeGL() override;
 	void resizeGL(int width, int height) override;
@@ -28,6 +33,8 @@ class Viewport : public QOpenGLWidget {
 
  private:
 	 virtual void on_render(float delta);
+
+	 RenderScheduler _scheduler;
 };
 
 }  // namespace bgl
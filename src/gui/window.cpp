@@ -1,5 +1,6 @@
 #include <QEvent>          // QEvent::KeyPress
 #include <QGuiApplication>
+#include <QMessageBox>
 #include <QScreen>
 #include <QStatusBar>
 #include <QGroupBox>
@@ -35,7 +36,7 @@ QStatusBar* get_dummy_status_bar() {
     return statusBar;
 }
 
-QMenuBar* get_dummy_menu_bar(QMainWindow &window) {
+QMenuBar* get_dummy_menu_bar(Window &window) {
     static QMenuBar * menuBar { new MenuBar(window) };
     return menuBar;
 }
@@ -71,4 +72,12 @@ void Window::render() {
 	// TODO(bkuolt)
 }
 
+void Window::loadModel(const std::filesystem::path &path) {
+    QMessageBox::warning(nullptr, "Warning,", "Not implemented yet.");
+}
+
+void Window::unloadModels() {
+    QMessageBox::warning(nullptr, "Warning,", "Not implemented yet.");
+}
+
 }  // namespace bgl
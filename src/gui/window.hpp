@@ -1,6 +1,7 @@
 #ifndef GUI_WINDOW_HPP_
 #define GUI_WINDOW_HPP_
 
+#include <filesystem>
 #include <string>
 #include <QMainWindow>  // NOLINT
 
@@ -28,6 +29,9 @@ class Window : public QMainWindow {
     void render();
     void setViewport(Viewport *p);
 
+    virtual void loadModel(const std::filesystem::path &path);
+    virtual void unloadModels();
+
  protected:
 	Viewport *_viewport { nullptr };
 };
@@ -3,9 +3,32 @@
 
 #include <csignal>
 #include <cstdlib>
+#include <iostream>
 #include <stdexcept>
+#include <string>
 
 #include "window.hpp"
+#include "options.hpp"
+#include "gfx/allocation.hpp"
+#include "gfx/block_compression.hpp"
+#include "gfx/gfx.hpp"
+#include "gfx/gpu_culling.hpp"
+#include "gfx/importer.hpp"
+#include "gfx/instancing.hpp"
+#include "gfx/mesh_codec.hpp"
+#include "gfx/memory_report.hpp"
+#include "gfx/meshlet.hpp"
+#include "gfx/model_cache.hpp"
+#include "gfx/occlusion.hpp"
+#include "gfx/paged_builder.hpp"
+#include "gfx/paged_model.hpp"
+#include "gfx/point_cloud.hpp"
+#include "gfx/resource_manager.hpp"
+#include "gfx/scene_graph.hpp"
+#include "gfx/startup.hpp"
+#include "gfx/tangent_space.hpp"
+#include "gfx/texture_streamer.hpp"
+#include "gfx/vertex_weld.hpp"
 
 
 static void signal_handler(int signal) {
@@ -14,17 +37,98 @@ static void signal_handler(int signal) {
 
 int main(int argc, char *argv[]) {
 	QApplication app(argc, argv);
+	bgl::MarkStartupPhase("created QApplication");
 
-	if (argc != 2) {
-		QMessageBox::critical(nullptr, "Error", "usage: bgl <path-to-model>");
+	bgl::Options options;
+	try {
+		options = bgl::ParseOptions(argc, argv);
+	} catch (const std::invalid_argument &exception) {
+		QMessageBox::critical(nullptr, "Error", (std::string { exception.what() } + "\n" + bgl::GetUsage()).c_str());
 		return EXIT_FAILURE;
 	}
 
+	if (!options.buildInput.empty()) {
+		try {
+			bgl::BuildPagedModel(options.buildInput, options.buildOutput);
+			std::cout << "wrote " << options.buildOutput << std::endl;
+			return EXIT_SUCCESS;
+		} catch (const std::exception &exception) {
+			std::cerr << exception.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	bgl::SetCreaseAngle(options.creaseAngle);
+	bgl::SetWeldEpsilon(options.weldEpsilon);
+	if (options.codecBenchmark) {
+		return bgl::RunCodecBenchmark() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (options.weldBenchmark) {
+		return bgl::RunWeldBenchmark() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (options.normalBenchmark) {
+		try {
+			return bgl::RunNormalBenchmark(options.models) ? EXIT_SUCCESS : EXIT_FAILURE;
+		} catch (const std::exception &exception) {
+			std::cerr << exception.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+	if (options.sceneGraphBenchmark) {
+		return bgl::RunSceneGraphBenchmark() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (options.textureBenchmark) {
+		return bgl::RunBlockCompressionBenchmark() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (options.meshletBenchmark) {
+		return bgl::RunMeshletBenchmark() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (options.octreeBenchmark) {
+		return bgl::RunOctreeBenchmark() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	if (options.instancingBenchmark) {
+		return bgl::RunInstancingBenchmark() ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	std::signal(SIGINT, signal_handler);
 	std::signal(SIGHUP, signal_handler);
 
 	try {
-		bgl::SimpleWindow window { "BGL Model Viewer" };
+		bgl::EnableStartupReport(options.startupReport);
+		bgl::ResourceManager::instance().setBudget(options.memoryBudget);
+		bgl::SetTextureCompression(options.textureCompression);
+		bgl::TextureStreamer::instance().setBudget(options.textureBudget);
+		bgl::EnableTextureReport(options.textureReport);
+		bgl::EnableCodecReport(options.codecReport);
+		bgl::EnableAllocationTracking(options.allocationReport);
+		bgl::EnableMemoryReport(options.memoryReport);
+		bgl::SetGPUCulling(options.gpuCulling);
+		bgl::SetOcclusionCulling(options.occlusionCulling);
+		bgl::SetMeshletCulling(options.meshletCulling);
+		bgl::EnableInstancing(options.instancing);
+		bgl::EnableModelCache(!options.reloadBenchmark);  // the benchmark imports with Assimp every time
+		bgl::SetPagedModelBudget(options.pagedBudget);
+		bgl::SetPointBudget(options.pointBudget);
+
+		// imports models and reads shaders while Qt creates the window and OpenGL context
+		for (auto &path : options.models) {
+			bgl::ResourceManager::instance().prefetchModel(path);
+		}
+		bgl::PrefetchPrograms();
+
+		bgl::SimpleWindow window { "BGL Model Viewer", options.models };
+		bgl::MarkStartupPhase("created window");
+		window.setAntialiasing(options.antialiasing);
+		window.setTargetFrameTime(options.targetFrameTime);
+		if (options.lightBenchmark) {
+			window.runLightBenchmark();
+		}
+		if (options.pointBenchmark) {
+			window.runPointBenchmark();
+		}
+		if (options.reloadBenchmark) {
+			window.runReloadBenchmark(options.models);
+		}
 		window.show();
 		return app.exec();
 	} catch (const std::exception &exception) {
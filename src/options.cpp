@@ -0,0 +1,179 @@
+#include <stdexcept>
+#include <string>
+
+#include "options.hpp"
+#include "gfx/vertex_weld.hpp"
+
+
+namespace bgl {
+
+namespace {
+
+std::size_t parse_size(const std::string &option, const char *value) {
+    if (value == nullptr) {
+        throw std::invalid_argument { "missing value for " + option };
+    }
+    try {
+        std::size_t length { 0 };
+        const unsigned long long number { std::stoull(value, &length) };
+        if (value[length] != '\0') {
+            throw std::invalid_argument { value };
+        }
+        return static_cast<std::size_t>(number);
+    } catch (const std::logic_error&) {
+        throw std::invalid_argument { "invalid value for " + option + ": " + value };
+    }
+}
+
+float parse_float(const std::string &option, const char *value, float max) {
+    if (value == nullptr) {
+        throw std::invalid_argument { "missing value for " + option };
+    }
+    try {
+        std::size_t length { 0 };
+        const float number { std::stof(value, &length) };
+        if (value[length] != '\0' || !(number >= 0.0f && number <= max)) {
+            throw std::invalid_argument { value };
+        }
+        return number;
+    } catch (const std::logic_error&) {
+        throw std::invalid_argument { "invalid value for " + option + ": " + value };
+    }
+}
+
+TextureCompression parse_compression(const std::string &option, const char *value) {
+    if (value == nullptr) {
+        throw std::invalid_argument { "missing value for " + option };
+    }
+    const std::string name { value };
+    if (name == "none") {
+        return TextureCompression::None;
+    } else if (name == "bc") {
+        return TextureCompression::BC;
+    } else if (name == "bc7") {
+        return TextureCompression::BC7;
+    }
+    throw std::invalid_argument { "invalid value for " + option + ": " + name };
+}
+
+Antialiasing parse_antialiasing(const std::string &option, const char *value) {
+    if (value == nullptr) {
+        throw std::invalid_argument { "missing value for " + option };
+    }
+    const std::string name { value };
+    if (name == "off") {
+        return Antialiasing::None;
+    } else if (name == "msaa2") {
+        return Antialiasing::MSAA2;
+    } else if (name == "msaa4") {
+        return Antialiasing::MSAA4;
+    } else if (name == "msaa8") {
+        return Antialiasing::MSAA8;
+    } else if (name == "fxaa") {
+        return Antialiasing::FXAA;
+    }
+    throw std::invalid_argument { "invalid value for " + option + ": " + name };
+}
+
+}  // anonymous namespace
+
+Options ParseOptions(int argc, char *argv[]) {
+    Options options;
+
+    for (auto i = 1; i < argc; ++i) {
+        const std::string argument { argv[i] };
+        if (argument == "--memory-budget") {
+            options.memoryBudget = parse_size(argument, argv[++i]) * 1024 * 1024;  // [MiB]
+        } else if (argument == "--startup-report") {
+            options.startupReport = true;
+        } else if (argument == "--texture-compression") {
+            options.textureCompression = parse_compression(argument, argv[++i]);
+        } else if (argument == "--texture-budget") {
+            options.textureBudget = parse_size(argument, argv[++i]) * 1024 * 1024;  // [MiB]
+        } else if (argument == "--texture-report") {
+            options.textureReport = true;
+        } else if (argument == "--light-benchmark") {
+            options.lightBenchmark = true;
+        } else if (argument == "--aa") {
+            options.antialiasing = parse_antialiasing(argument, argv[++i]);
+        } else if (argument == "--gpu-culling") {
+            options.gpuCulling = true;
+        } else if (argument == "--occlusion-culling") {
+            options.occlusionCulling = true;
+        } else if (argument == "--meshlets") {
+            options.meshletCulling = true;
+        } else if (argument == "--paged-budget") {
+            options.pagedBudget = parse_size(argument, argv[++i]) * 1024 * 1024;  // [MiB]
+        } else if (argument == "--build-paged") {
+            if (i + 2 >= argc) {
+                throw std::invalid_argument { "missing input or output for " + argument };
+            }
+            options.buildInput = argv[++i];
+            options.buildOutput = argv[++i];
+        } else if (argument == "--point-budget") {
+            options.pointBudget = parse_size(argument, argv[++i]);
+        } else if (argument == "--point-benchmark") {
+            options.pointBenchmark = true;
+        } else if (argument == "--codec-report") {
+            options.codecReport = true;
+        } else if (argument == "--allocation-report") {
+            options.allocationReport = true;
+        } else if (argument == "--memory-report") {
+            options.memoryReport = true;
+        } else if (argument == "--reload-benchmark") {
+            options.reloadBenchmark = true;
+        } else if (argument == "--codec-benchmark") {
+            options.codecBenchmark = true;
+        } else if (argument == "--crease-angle") {
+            options.creaseAngle = parse_float(argument, argv[++i], 180.0f);  // [degrees]
+        } else if (argument == "--normal-benchmark") {
+            options.normalBenchmark = true;
+        } else if (argument == "--weld-epsilon") {
+            options.weldEpsilon = parse_float(argument, argv[++i], 1.0f);  // models are scaled into [-1, 1]
+        } else if (argument == "--weld-benchmark") {
+            options.weldBenchmark = true;
+        } else if (argument == "--instancing") {
+            options.instancing = true;
+        } else if (argument == "--target-frame-time") {
+            options.targetFrameTime = parse_float(argument, argv[++i], 1000.0f);
+        } else if (argument == "--scene-graph-benchmark") {
+            options.sceneGraphBenchmark = true;
+        } else if (argument == "--texture-benchmark") {
+            options.textureBenchmark = true;
+        } else if (argument == "--meshlet-benchmark") {
+            options.meshletBenchmark = true;
+        } else if (argument == "--octree-benchmark") {
+            options.octreeBenchmark = true;
+        } else if (argument == "--instancing-benchmark") {
+            options.instancingBenchmark = true;
+        } else if (argument.rfind("--", 0) == 0) {
+            throw std::invalid_argument { "unknown option " + argument };
+        } else {
+            options.models.emplace_back(argument);
+        }
+    }
+    return options;
+}
+
+const char* GetUsage() noexcept {
+    return "usage: bgl [--memory-budget <MiB>] [--startup-report]\n"
+           "           [--texture-compression none|bc|bc7] [--texture-budget <MiB>] [--texture-report]\n"
+           "           [--light-benchmark] [--aa off|msaa2|msaa4|msaa8|fxaa] [--gpu-culling]\n"
+           "           [--occlusion-culling] [--meshlets] [--paged-budget <MiB>]\n"
+           "           [--point-budget <points>] [--point-benchmark] [--codec-report]\n"
+           "           [--allocation-report] [--memory-report] [--crease-angle <degrees>]\n"
+           "           [--weld-epsilon <distance>] [--instancing] [--target-frame-time <ms>]\n"
+           "           [<path-to-model>...]\n"
+           "       bgl --build-paged <input.obj|input.ply> <output.bglp>\n"
+           "       bgl --codec-benchmark\n"
+           "       bgl --reload-benchmark <path-to-model>...\n"
+           "       bgl --normal-benchmark [--crease-angle <degrees>] [<path-to-model>...]\n"
+           "       bgl --weld-benchmark\n"
+           "       bgl --scene-graph-benchmark\n"
+           "       bgl --texture-benchmark\n"
+           "       bgl --meshlet-benchmark\n"
+           "       bgl --octree-benchmark\n"
+           "       bgl --instancing-benchmark";
+}
+
+}  // namespace bgl
@@ -0,0 +1,71 @@
+/**
+ * @file options.hpp
+ * @brief Command line options of the model viewer.
+ */
+#ifndef OPTIONS_HPP_
+#define OPTIONS_HPP_
+
+#include <cstddef>     // std::size_t
+#include <filesystem>  // std::filesystem::path
+#include <vector>
+
+#include "gfx/antialiasing.hpp"      // bgl::Antialiasing
+#include "gfx/paged_model.hpp"       // bgl::PagedModel::DefaultBudget
+#include "gfx/point_cloud.hpp"       // bgl::PointCloud::DefaultBudget
+#include "gfx/resource_manager.hpp"  // bgl::ResourceManager::DefaultBudget
+#include "gfx/tangent_space.hpp"     // bgl::DefaultCreaseAngle
+#include "gfx/texture.hpp"           // bgl::TextureCompression
+#include "gfx/texture_streamer.hpp"  // bgl::TextureStreamer::DefaultBudget
+
+
+namespace bgl {
+
+struct Options {
+    std::vector<std::filesystem::path> models;
+    std::size_t memoryBudget { ResourceManager::DefaultBudget };  // [bytes]
+    bool startupReport { false };
+    TextureCompression textureCompression { TextureCompression::BC };
+    std::size_t textureBudget { TextureStreamer::DefaultBudget };  // [bytes] of streamed textures, 0 disables streaming
+    bool textureReport { false };
+    bool lightBenchmark { false };
+    Antialiasing antialiasing { Antialiasing::MSAA4 };
+    bool gpuCulling { false };
+    bool occlusionCulling { false };
+    bool meshletCulling { false };
+    std::size_t pagedBudget { PagedModel::DefaultBudget };  // [bytes] of each paged model
+    std::filesystem::path buildInput;   // converted into a paged model instead of running the viewer
+    std::filesystem::path buildOutput;
+    std::size_t pointBudget { PointCloud::DefaultBudget };  // [points] drawn per point cloud
+    bool pointBenchmark { false };
+    bool codecReport { false };
+    bool allocationReport { false };
+    bool memoryReport { false };
+    bool codecBenchmark { false };  // runs instead of the viewer
+    bool reloadBenchmark { false };  // loads and unloads the models 100 times in the viewer, then quits
+    float creaseAngle { DefaultCreaseAngle };  // [degrees] of generated normals
+    bool normalBenchmark { false };  // compares the normal and tangent generation with Assimp instead of running the viewer
+    float weldEpsilon { 0.0f };  // distance below which imported positions are welded
+    bool weldBenchmark { false };  // runs instead of the viewer
+    bool instancing { false };
+    float targetFrameTime { 0.0f };  // [ms] of dynamic resolution, 0 disables it
+    bool sceneGraphBenchmark { false };  // runs instead of the viewer
+    bool textureBenchmark { false };  // runs instead of the viewer
+    bool meshletBenchmark { false };  // runs instead of the viewer
+    bool octreeBenchmark { false };  // runs instead of the viewer
+    bool instancingBenchmark { false };  // runs instead of the viewer
+};
+
+/**
+ * @brief Parses the command line.
+ * @throw std::invalid_argument on unknown or malformed options
+ */
+Options ParseOptions(int argc, char *argv[]);
+
+/**
+ * @brief Returns a short usage description.
+ */
+const char* GetUsage() noexcept;
+
+}  // namespace bgl
+
+#endif  // OPTIONS_HPP_
@@ -1,19 +1,47 @@
 #include "gfx/gfx.hpp"
 
+#include <malloc.h>  // malloc_trim()
+
 #include <QApplication>
+#include <QDockWidget>
 #include <QKeyEvent>
+#include <QMainWindow>
+#include <QMessageBox>
+#include <QOpenGLContext>
+#include <QStatusBar>
 #include <QWheelEvent>
-#include <QOpenGLFramebufferObject>  // QOpenGLFramebufferObjectFormat
 
 #include <algorithm>  // std::max()
+#include <array>
+#include <chrono>
+#include <cstdlib>    // EXIT_SUCCESS, EXIT_FAILURE
+#include <iomanip>    // std::setw()
+#include <iostream>
+#include <map>
 #include <memory>     // std::shared_ptr
+#include <optional>
+#include <random>
+#include <sstream>
+#include <utility>    // std::move(), std::pair
 
 #include "window.hpp"
 
 #include "gfx/model.hpp"
+#include "gfx/allocation.hpp"
+#include "gfx/antialiasing.hpp"
 #include "gfx/box.hpp"
+#include "gfx/dynamic_resolution.hpp"
 #include "gfx/grid.hpp"
 #include "gfx/camera.hpp"
+#include "gfx/paged_model.hpp"
+#include "gfx/point_cloud.hpp"
+#include "gfx/frame_timer.hpp"
+#include "gfx/memory_report.hpp"
+#include "gfx/scene.hpp"
+#include "gfx/resource_manager.hpp"
+#include "gfx/startup.hpp"
+#include "gfx/texture_streamer.hpp"
+#include "gfx/upload_ring.hpp"
 
 
 namespace bgl {
@@ -21,31 +49,168 @@ namespace bgl {
 namespace {
 
 struct {
-	std::shared_ptr<Model> model;
+	Scene scene;
 	std::shared_ptr<Grid> grid;
 	ArcBall camera;
 	std::shared_ptr<Box> box;
-} Scene;
-
-void set_up_scene(const std::filesystem::path &path) {
-	Scene.model = LoadModel(path);
-	Scene.camera.setFocus({ 0.0, 0.0, 0.0 });
-	Scene.camera.setPosition({ 0.0, 1.0, 2.0 });
 
-	Scene.box = std::make_shared<Box>(Scene.model->getBoundingBox());
+	RenderTarget target;
+	DynamicResolution resolution;
+	FrameTimer timer;
+	std::map<std::pair<RenderMode, Antialiasing>, double> frameTimes;  // [ms] on the GPU, averaged per mode
+	std::size_t revision { 0 };  // changes whenever models are added to or removed from the scene
+} Viewer;
+
+/**
+ * @brief Distance between neighbouring models along the x axis.
+ * @note Imported models are normalized to [-1, 1].
+ */
+constexpr float ModelSpacing { 2.5f };
+
+/**
+ * @brief Measures frames while the number of point and spot lights doubles from 1 to 1024.
+ */
+class LightBenchmark {
+ public:
+	static constexpr unsigned MaxLights { 1024 };
+	static constexpr unsigned FramesPerStep { 100 };
+
+	void start() {
+		_lights = 1;
+		_frames = 0;
+		_frameTime = _binningTime = 0.0;
+		std::cout << std::setw(8) << "lights" << std::setw(14) << "frame [ms]"
+		          << std::setw(14) << "binning [ms]" << std::endl;
+		placeLights();
+	}
+
+	bool isRunning() const noexcept {
+		return _lights > 0;
+	}
+
+	/**
+	 * @brief Records a frame that took @p frameTime including the GPU.
+	 */
+	void onFrame(double frameTime) {
+		_frameTime += frameTime;
+		_binningTime += Viewer.scene.getLighting()->getBinningTime();
+		if (++_frames < FramesPerStep) {
+			return;
+		}
+
+		std::cout << std::fixed << std::setprecision(3) << std::setw(8) << _lights
+		          << std::setw(14) << _frameTime / _frames << std::setw(14) << _binningTime / _frames << std::endl;
+		_frames = 0;
+		_frameTime = _binningTime = 0.0;
+		_lights = _lights < MaxLights ? _lights * 2 : 0;
+		placeLights();
+	}
+
+ private:
+	void placeLights() {
+		Lights &lights { Viewer.scene.getLights() };
+		lights.points.clear();
+		lights.spots.clear();
+
+		// every other light is a spot light pointing down, spread over all models
+		const float width { std::max(Viewer.scene.getModels().size(), std::size_t { 1 }) * ModelSpacing };
+		std::mt19937 generator { 42 };
+		std::uniform_real_distribution<float> x { -1.0f, width - 1.0f };
+		std::uniform_real_distribution<float> yz { -1.0f, 1.0f };
+		std::uniform_real_distribution<float> color { 0.2f, 1.0f };
+		for (auto i = 0u; i < _lights; ++i) {
+			const vec3 position { x(generator), yz(generator), yz(generator) };
+			const vec3 rgb { color(generator), color(generator), color(generator) };
+			if (i % 2 == 0) {
+				lights.points.push_back({ position, rgb, 0.5f });
+			} else {
+				lights.spots.push_back({ position, vec3 { 0.0f, -1.0f, 0.0f }, rgb, 1.0f, 20.0f, 30.0f });
+			}
+		}
+	}
+
+	unsigned _lights { 0 };  // 0 if not running
+	unsigned _frames { 0 };
+	double _frameTime { 0.0 };
+	double _binningTime { 0.0 };
+} Benchmark;
+
+std::size_t get_drawn_points() {
+	std::size_t points { 0 };
+	for (auto &[node, model] : Viewer.scene.getModels()) {
+		if (const auto cloud { std::dynamic_pointer_cast<PointCloud>(model) }) {
+			points += cloud->getStatistics().drawnPoints;
+		}
+	}
+	return points;
+}
 
-	Scene.grid = std::make_shared<Grid>(0.125, 40);
-	const vec3 v { 0.0, -Scene.model->getBoundingBox().getSize().y / 2.0, 0.0 };
-	Scene.grid->translate(v);
+/**
+ * @brief Measures frames while the point budget of point clouds doubles from 1 to 32 million.
+ */
+class PointBenchmark {
+ public:
+	static constexpr std::size_t MinBudget { std::size_t { 1 } * 1000 * 1000 };
+	static constexpr std::size_t MaxBudget { std::size_t { 32 } * 1000 * 1000 };
+	static constexpr unsigned FramesPerStep { 100 };
+
+	void start() {
+		_previousBudget = GetPointBudget();
+		_budget = MinBudget;
+		_frames = 0;
+		_frameTime = 0.0;
+		_points = 0;
+		std::cout << std::setw(12) << "budget" << std::setw(12) << "points" << std::setw(14) << "frame [ms]" << std::endl;
+		SetPointBudget(_budget);
+	}
+
+	bool isRunning() const noexcept {
+		return _budget > 0;
+	}
+
+	/**
+	 * @brief Records a frame that took @p frameTime including the GPU.
+	 */
+	void onFrame(double frameTime) {
+		_frameTime += frameTime;
+		_points += get_drawn_points();
+		if (++_frames < FramesPerStep) {
+			return;
+		}
+
+		std::cout << std::fixed << std::setprecision(3) << std::setw(12) << _budget
+		          << std::setw(12) << _points / _frames << std::setw(14) << _frameTime / _frames << std::endl;
+		_frames = 0;
+		_frameTime = 0.0;
+		_points = 0;
+		_budget = _budget < MaxBudget ? _budget * 2 : 0;
+		SetPointBudget(_budget > 0 ? _budget : _previousBudget);
+	}
+
+ private:
+	std::size_t _budget { 0 };  // 0 if not running
+	std::size_t _previousBudget { 0 };
+	unsigned _frames { 0 };
+	double _frameTime { 0.0 };
+	std::size_t _points { 0 };  // drawn in all frames of the current step
+} PointBudgetBenchmark;
+
+void set_up_scene() {
+	Viewer.camera.setFocus({ 0.0, 0.0, 0.0 });
+	Viewer.camera.setPosition({ 0.0, 1.0, 2.0 });
+
+	Viewer.box = std::make_shared<Box>();
+	Viewer.grid = std::make_shared<Grid>(0.125);
+	Viewer.scene.getLights().directional = {
+		.direction = vec3 { -1.0, -1.0, -1.0 },
+		.diffuse = vec3 { 0.0, 1.0, 1.0 },
+		.ambient = vec3 { 0.2f, 0.2f, 0.2f }
+	};
 
 	glEnable(GL_DEPTH_TEST);
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
-	// enables OpenGL Antialiasing
-	glEnable(GL_LINE_SMOOTH);
-	glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
-	glEnable(GL_POLYGON_SMOOTH);
-	glHint(GL_POLYGON_SMOOTH_HINT, GL_NICEST);
+	// anti-aliasing is done by the RenderTarget, polygon smoothing is slow and causes seams
 	glEnable(GL_MULTISAMPLE);
 
 	glEnable(GL_CULL_FACE);
@@ -53,6 +218,87 @@ void set_up_scene(const std::filesystem::path &path) {
 	glFrontFace(GL_CCW);
 }
 
+void add_model(const std::filesystem::path &path) {
+	const std::shared_ptr<Model> model { ResourceManager::instance().loadModel(path) };
+	const std::size_t index { Viewer.scene.getModels().size() };
+	Viewer.scene.add(model, SceneGraph::None, glm::translate(vec3 { index * ModelSpacing, 0.0f, 0.0f }));
+	++Viewer.revision;
+
+	if (index == 0) {  // the bounding box and grid follow the first model
+		Viewer.box->setBoundingBox(model->getBoundingBox());
+		Viewer.grid = std::make_shared<Grid>(0.125);
+		const vec3 v { 0.0, -model->getBoundingBox().getSize().y / 2.0, 0.0 };
+		Viewer.grid->translate(v);
+	}
+}
+
+void remove_models() {
+	Viewer.scene.clear();
+	++Viewer.revision;
+}
+
+/**
+ * @brief Loads models into the scene, renders them, removes and evicts them again 100 times and
+ *        compares the resident memory after the first and the last time.
+ * @details Every cycle covers the import (without the model cache, see main()), the creation of buffers and
+ *          textures, texture streaming and the bookkeeping of the ResourceManager. The memory is
+ *          measured after an empty frame, in which the TextureStreamer releases its textures.
+ */
+class ReloadBenchmark {
+ public:
+	static constexpr unsigned Repetitions { 100 };
+	static constexpr std::size_t Tolerance { std::size_t { 4 } * 1024 * 1024 };  // allocator and driver noise
+
+	void start(const std::vector<std::filesystem::path> &paths) {
+		_paths = paths;
+		_cycles = 0;
+		_running = true;
+	}
+
+	bool isRunning() const noexcept {
+		return _running;
+	}
+
+	/**
+	 * @brief Advances the cycle after a frame, either by removing the models or by measuring and loading them again.
+	 * @return the exit status once all cycles are done
+	 */
+	std::optional<int> onFrame() {
+		if (!Viewer.scene.getModels().empty()) {
+			remove_models();
+			ResourceManager::instance().clear();  // evicts the models and their textures
+			return std::nullopt;
+		}
+
+		malloc_trim(0);  // returns freed heap pages, so that only leaks stay resident
+		const std::size_t resident { GetResidentMemory() };
+		if (_cycles++ == 0) {
+			_warm = resident;  // the first cycle also fills lazily created caches
+		}
+		if (_cycles == Repetitions) {
+			const auto to_mib = [] (std::size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); };
+			const bool flat { resident <= _warm + Tolerance };
+			std::cout << std::fixed << std::setprecision(1)
+			          << "resident memory after 1 load: " << to_mib(_warm) << " MiB, after " << Repetitions
+			          << " loads: " << to_mib(resident) << " MiB, peak: " << to_mib(GetPeakResidentMemory())
+			          << " MiB" << (flat ? "" : " (leaking)") << std::endl;
+			_running = false;
+			return flat ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+
+		for (auto &path : _paths) {
+			add_model(path);
+		}
+		return std::nullopt;
+	}
+
+ private:
+	std::vector<std::filesystem::path> _paths;
+	unsigned _cycles { 0 };  // measured
+	std::size_t _warm { 0 };  // resident memory after the first cycle
+	bool _running { false };
+} ReloadCycles;
+
 }  // anonymous namespace
 
 /* ------------------------------------ GLViewport ------------------------------------ */
@@ -61,41 +307,340 @@ GLViewport::GLViewport(QWidget *parent)
     : Viewport(parent)
 {}
 
-void GLViewport::on_render(float delta) {
-    QOpenGLFramebufferObjectFormat format;
-    format.setAttachment(QOpenGLFramebufferObject::CombinedDepthStencil);
-    format.setMipmap(false);
-    format.setSamples(0);
+void GLViewport::addModel(const std::filesystem::path &path) {
+    if (!_initialized || !_pending.empty()) {
+        _pending.push_back(path);  // keeps the order of the models
+        return;
+    }
+
+    makeCurrent();
+    add_model(path);
+    requestRedraw(RenderScheduler::Scene);
+}
 
-    static bool initialized { false };
-    if (!initialized) {
-        const std::filesystem::path path { QCoreApplication::arguments().at(1).toStdString() };
-        set_up_scene(path);
-        initialized = true;
+void GLViewport::clearModels() {
+    _pending.clear();
+    if (!_initialized) {
+        return;
     }
 
+    makeCurrent();
+    remove_models();
+    ResourceManager::instance().collect();
+    requestRedraw(RenderScheduler::Scene);
+}
+
+void GLViewport::initializeGL() {
+    Viewport::initializeGL();
+    set_up_scene();
+    _initialized = true;
+    MarkStartupPhase("set up scene");
+    _programs = PrewarmPrograms();  // while the models are still imported
+    MarkStartupPhase("linked programs");
+
+    // the viewer state and the upload ring are statics and would otherwise be destroyed after the context
+    QObject::connect(context(), &QOpenGLContext::aboutToBeDestroyed, [this] () { releaseGL(); });
+}
+
+/**
+ * @brief Deletes all OpenGL objects that outlive the context.
+ * @details The models are removed, so that their buffers, textures and GPU culling data are
+ *          evicted while the context is still current, and the scene is replaced, which deletes
+ *          the buffers of the light binning. The grid and box are created again by initializeGL().
+ */
+void GLViewport::releaseGL() {
+    makeCurrent();
+    _pending.clear();
+    remove_models();
+    Viewer.scene = Scene {};
+    ResourceManager::instance().clear();
+    Viewer.grid.reset();
+    Viewer.box.reset();
+    Viewer.target.release();
+    Viewer.resolution.release();
+    Viewer.timer.release();
+    UploadRing::instance().release();
+    _programs.clear();
+    _initialized = false;
+    doneCurrent();
+}
+
+void GLViewport::addPendingModels() {
+    // models still being imported on a worker thread are added in one of the next frames
+    while (!_pending.empty() && ResourceManager::instance().isModelReady(_pending.front())) {
+        const std::filesystem::path path { _pending.front() };
+        _pending.erase(_pending.begin());
+        try {
+            add_model(path);
+        } catch (const std::exception &exception) {
+            QMessageBox::critical(this, "Error", exception.what());
+        }
+    }
+}
+
+void GLViewport::on_render(float delta) {
+    const auto begin { std::chrono::steady_clock::now() };
+    addPendingModels();
+
+    UploadRing::instance().beginFrame();
+    Viewer.timer.begin();
+    Viewer.target.begin(defaultFramebufferObject());
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    const mat4 PV { Scene.camera.matrix() };
-    Scene.grid->render(PV);
-    Scene.box->render(PV);
-
-    static DirectionalLight light {
-        .direction = vec3 { -1.0, -1.0, -1.0 },
-        .diffuse = vec3 { 0.0, 1.0, 1.0 },
-        .ambient = vec3 { 0.2f, 0.2f, 0.2f }
+    Viewer.resolution.begin();
+    Viewer.scene.render(Viewer.camera);
+    Viewer.resolution.end();
+
+    // the grid and bounding box stay at full resolution, they are tested against the upscaled depth
+    const mat4 PV { Viewer.camera.matrix() };
+    Viewer.grid->render(PV);
+    if (!Viewer.scene.getModels().empty()) {
+        Viewer.box->render(PV);
+    }
+    Viewer.target.end(defaultFramebufferObject());
+    Viewer.timer.end();
+    UploadRing::instance().endFrame();
+    if (const std::optional<double> time { Viewer.timer.getTime() }) {
+        Viewer.resolution.update(*time);
+        showFrameTime(*time);
+    }
+    TextureStreamer::instance().update();
+    checkMemoryChanged();
+
+    if (_pending.empty()) {
+        FinishStartup();
+        if (IsMemoryReportEnabled() && !_memoryReported) {
+            WriteMemoryReport(std::cout, ResourceManager::instance().getMemoryReport());
+            _memoryReported = true;
+        }
+    }
+    const auto &models { Viewer.scene.getModels() };
+    const bool loading { std::any_of(models.begin(), models.end(), [] (auto &entry) { return entry.second->isLoading(); }) };
+    if (!_pending.empty() || !TextureStreamer::instance().isIdle() || loading) {
+        requestRedraw(RenderScheduler::Loading);
+    }
+
+    if (ReloadCycles.isRunning() && _pending.empty()) {
+        try {
+            if (const std::optional<int> status { ReloadCycles.onFrame() }) {
+                QApplication::exit(*status);
+            }
+        } catch (const std::exception &exception) {
+            std::cerr << exception.what() << std::endl;
+            QApplication::exit(EXIT_FAILURE);
+        }
+        requestRedraw(RenderScheduler::Scene);
+    }
+
+    if ((Benchmark.isRunning() || PointBudgetBenchmark.isRunning()) && _pending.empty()) {
+        glFinish();  // includes the GPU time
+        const double time { std::chrono::duration<double, std::milli> { std::chrono::steady_clock::now() - begin }.count() };
+        if (Benchmark.isRunning()) {
+            Benchmark.onFrame(time);
+        }
+        if (PointBudgetBenchmark.isRunning()) {
+            PointBudgetBenchmark.onFrame(time);
+        }
+        requestRedraw(RenderScheduler::Scene);
+    }
+}
+
+void GLViewport::runLightBenchmark() {
+    Benchmark.start();
+    requestRedraw(RenderScheduler::Scene);
+}
+
+void GLViewport::runReloadBenchmark(const std::vector<std::filesystem::path> &paths) {
+    ReloadCycles.start(paths);
+    requestRedraw(RenderScheduler::Scene);
+}
+
+void GLViewport::runPointBenchmark() {
+    PointBudgetBenchmark.start();
+    requestRedraw(RenderScheduler::Scene);
+}
+
+void GLViewport::setRenderMode(RenderMode mode) {
+    Viewer.scene.setRenderMode(mode);
+    Viewer.timer.reset();  // pending frames were rendered with the previous mode
+    requestRedraw(RenderScheduler::Settings);
+}
+
+void GLViewport::setAntialiasing(Antialiasing mode) {
+    Viewer.target.setMode(mode);
+    Viewer.timer.reset();  // pending frames were rendered with the previous mode
+    requestRedraw(RenderScheduler::Settings);
+}
+
+void GLViewport::setTargetFrameTime(double time) {
+    Viewer.resolution.setTargetFrameTime(time);
+    requestRedraw(RenderScheduler::Settings);
+}
+
+MemoryReport GLViewport::getMemoryReport() {
+    if (!_initialized) {
+        return {};
+    }
+    makeCurrent();  // buffer sizes are queried from OpenGL
+    return ResourceManager::instance().getMemoryReport();
+}
+
+void GLViewport::setOnMemoryChanged(Callback callback) {
+    _onMemoryChanged = std::move(callback);
+}
+
+void GLViewport::checkMemoryChanged() {
+    std::size_t paged_bytes { 0 };
+    for (auto &[node, model] : Viewer.scene.getModels()) {
+        if (const auto paged { std::dynamic_pointer_cast<PagedModel>(model) }) {
+            paged_bytes += paged->getStatistics().residentBytes;
+        }
+    }
+    const std::array<std::size_t, 4> state { Viewer.revision, ResourceManager::instance().getRevision(),
+                                             TextureStreamer::instance().getRevision(), paged_bytes };
+    if (state != _memoryState) {
+        _memoryState = state;
+        if (_onMemoryChanged) {
+            _onMemoryChanged();
+        }
+    }
+}
+
+/**
+ * @brief Shows the frame time of the current and of all previously used render and anti-aliasing modes.
+ */
+void GLViewport::showFrameTime(double time) {
+    const std::pair<RenderMode, Antialiasing> modes { Viewer.scene.getRenderMode(), Viewer.target.getMode() };
+    const auto iterator { Viewer.frameTimes.find(modes) };
+    if (iterator == Viewer.frameTimes.end()) {
+        Viewer.frameTimes[modes] = time;
+    } else {
+        iterator->second = 0.9 * iterator->second + 0.1 * time;  // smooths out single frames
+    }
+
+    QMainWindow * const main_window { dynamic_cast<QMainWindow*>(window()) };
+    if (main_window == nullptr) {
+        return;
+    }
+    const auto print = [] (std::ostream &os, const std::pair<RenderMode, Antialiasing> &modes, double frame_time) {
+        os << GetName(modes.first) << ", " << GetName(modes.second) << ": " << frame_time << " ms";
     };
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    print(oss, modes, Viewer.frameTimes[modes]);
+    for (auto &[other, frame_time] : Viewer.frameTimes) {
+        if (other != modes) {
+            oss << "   ";
+            print(oss, other, frame_time);
+        }
+    }
 
-    Scene.model->render(PV, light);
+    if (Viewer.resolution.isEnabled()) {
+        oss << "   resolution: " << 100.0 * Viewer.resolution.getScale() << " % (target "
+            << Viewer.resolution.getTargetFrameTime() << " ms)";
+    }
+
+    const UploadRing &ring { UploadRing::instance() };
+    oss << "   uploads: " << ring.getFrameUsage() / 1024.0 << " KiB/frame, "
+        << ring.getStallCount() << " stalls, " << ring.getOverflowCount() << " overflows";
+    if (const OcclusionCuller *occlusion { Viewer.scene.getOcclusionCuller() }) {
+        const OcclusionCuller::Statistics &statistics { occlusion->getStatistics() };
+        const double rate { statistics.tested ? 100.0 * statistics.culled / statistics.tested : 0.0 };
+        oss << "   occlusion: " << statistics.culled << "/" << statistics.tested << " meshes culled ("
+            << rate << " %), " << statistics.occluders << " occluders, "
+            << statistics.rasterTime + statistics.testTime << " ms";
+    }
+
+    std::size_t resident { 0 }, budget { 0 }, needed { 0 }, faults { 0 };
+    for (auto &[node, model] : Viewer.scene.getModels()) {
+        if (const auto paged { std::dynamic_pointer_cast<PagedModel>(model) }) {
+            const PagedModel::Statistics &statistics { paged->getStatistics() };
+            resident += statistics.residentBytes;
+            budget += paged->getBudget();
+            needed += statistics.neededPages;
+            faults += statistics.pageFaults;
+        }
+    }
+    if (const std::size_t points { get_drawn_points() }) {
+        oss << "   points: " << points / (1000.0 * 1000.0) << " M drawn";
+    }
+    if (budget > 0) {
+        const double rate { needed ? 100.0 * faults / needed : 0.0 };
+        oss << "   paged: " << resident / (1024.0 * 1024.0) << "/" << budget / (1024.0 * 1024.0) << " MiB resident, "
+            << faults << " page faults (" << rate << " %)";
+    }
+    main_window->statusBar()->showMessage(oss.str().c_str());
 }
 
 /* ------------------------------------ SimpleWindow ------------------------------------ */
 
-SimpleWindow::SimpleWindow(const std::string &title)
-    : bgl::Window(title), _viewport(this) {
+SimpleWindow::SimpleWindow(const std::string &title,
+                           const std::vector<std::filesystem::path> &models)
+    : bgl::Window(title), _viewport(this), _settings { new SettingsPanel }, _statistics { new StatisticsPanel } {
+    for (auto &path : models) {
+        _viewport.addModel(path);
+    }
     this->setViewport(&_viewport);
+
+    _settings->setOnSettingsChanged([this] () {
+        _viewport.setRenderMode(_settings->getRenderMode());
+        _viewport.setAntialiasing(_settings->getAntialiasing());
+        _viewport.setTargetFrameTime(_settings->getTargetFrameTime());
+    });
+    QDockWidget * const dock { new QDockWidget { "Settings", this } };
+    dock->setWidget(_settings);
+    this->addDockWidget(Qt::RightDockWidgetArea, dock);
+
+    QDockWidget * const statistics_dock { new QDockWidget { "Memory", this } };
+    statistics_dock->setWidget(_statistics);
+    this->addDockWidget(Qt::RightDockWidgetArea, statistics_dock);
+    _viewport.setOnMemoryChanged([this] () {
+        _statisticsChanged = true;
+        updateStatistics();
+    });
+    QObject::connect(statistics_dock, &QDockWidget::visibilityChanged, [this] (bool) { updateStatistics(); });
     this->show();
 }
 
+void SimpleWindow::loadModel(const std::filesystem::path &path) {
+    _viewport.addModel(path);
+}
+
+void SimpleWindow::unloadModels() {
+    _viewport.clearModels();
+}
+
+void SimpleWindow::runLightBenchmark() {
+    _viewport.runLightBenchmark();
+}
+
+void SimpleWindow::runReloadBenchmark(const std::vector<std::filesystem::path> &paths) {
+    _viewport.runReloadBenchmark(paths);
+}
+
+void SimpleWindow::runPointBenchmark() {
+    _viewport.runPointBenchmark();
+}
+
+void SimpleWindow::setAntialiasing(Antialiasing mode) {
+    _settings->setAntialiasing(mode);
+    _viewport.setAntialiasing(mode);
+}
+
+void SimpleWindow::setTargetFrameTime(double time) {
+    _settings->setTargetFrameTime(time);
+    _viewport.setTargetFrameTime(time);
+}
+
+/**
+ * @brief Refreshes the statistics panel if it is visible and the memory changed since its last refresh.
+ */
+void SimpleWindow::updateStatistics() {
+    if (_statisticsChanged && _statistics->isVisible()) {
+        _statistics->setMemoryReport(_viewport.getMemoryReport());
+        _statisticsChanged = false;
+    }
+}
+
 bool SimpleWindow::event(QEvent *event) {
     if (event->type()  == QEvent::KeyPress) {
         return keyEvent(reinterpret_cast<QKeyEvent*>(event));
@@ -112,33 +657,30 @@ bool SimpleWindow::keyEvent(QKeyEvent *event) {
             close();
             return true;
         case Qt::Key_Left:
-            Scene.camera.rotate(-rotation, 0);
+            Viewer.camera.rotate(-rotation, 0);
             break;
         case Qt::Key_Right:
-            Scene.camera.rotate(rotation, 0);
+            Viewer.camera.rotate(rotation, 0);
             break;
         case Qt::Key_Up:
-            Scene.camera.rotate(0, -rotation);
+            Viewer.camera.rotate(0, -rotation);
             break;
         case Qt::Key_Down:
-            Scene.camera.rotate(0, rotation);
+            Viewer.camera.rotate(0, rotation);
             break;
     default:
         return QMainWindow::event(event);
     }
 
-    _viewport.makeCurrent();
-    _viewport.update();
+    _viewport.requestRedraw(RenderScheduler::Camera);
     return true;
 }
 
 void SimpleWindow::wheelEvent(QWheelEvent *event) {
     const float delta { (-event->angleDelta().y() / 120.0f) / 10.0f };  // TODO
-    const float zoom { std::max(Scene.camera.getZoom() + delta, 1.0f) };
-    Scene.camera.setZoom(zoom);
-
-    _viewport.makeCurrent();
-    _viewport.update();
+    const float zoom { std::max(Viewer.camera.getZoom() + delta, 1.0f) };
+    Viewer.camera.setZoom(zoom);
+    _viewport.requestRedraw(RenderScheduler::Camera);
 }
 
 }  // namespace bgl
@@ -4,9 +4,20 @@
  */
 #include <QKeyEvent>
 
+#include <array>
+#include <cstddef>     // std::size_t
+#include <filesystem>
+#include <functional>  // std::function
+#include <memory>      // std::shared_ptr
 #include <string>
+#include <vector>
 
-#include "gui/gui.hpp"  // bgl::Window, bgl::Viewport
+#include "gui/gui.hpp"  // bgl::Window, bgl::Viewport, bgl::SettingsPanel
+#include "gfx/antialiasing.hpp"
+#include "gfx/memory_report.hpp"
+#include "gfx/render_mode.hpp"
+
+class QOpenGLShaderProgram;
 
 
 namespace bgl {
@@ -16,6 +27,8 @@ namespace bgl {
  */
 class GLViewport final : public Viewport {
  public:
+	using Callback = std::function<void()>;
+
 	explicit GLViewport(QWidget *parent);
 
 	GLViewport(const GLViewport&) = delete;
@@ -26,7 +39,37 @@ class GLViewport final : public Viewport {
 
     virtual ~GLViewport() = default;
 
+	void addModel(const std::filesystem::path &path);
+	void clearModels();
+	void runLightBenchmark();  // prints frame times for 1 to 1024 lights
+	void runPointBenchmark();  // prints frame times for point budgets of 1 to 32 million
+	void runReloadBenchmark(const std::vector<std::filesystem::path> &paths);  // quits with its status
+	void setRenderMode(RenderMode mode);
+	void setAntialiasing(Antialiasing mode);
+	void setTargetFrameTime(double time);  // [ms] of dynamic resolution, 0 disables it
+	MemoryReport getMemoryReport();
+
+	/**
+	 * @brief Sets a function that is called after a frame in which models were added, removed or
+	 *        evicted, or texture levels or pages were streamed, i.e. when the memory report changed.
+	 */
+	void setOnMemoryChanged(Callback callback);
+
+	void initializeGL() override;
 	void on_render(float delta) override;
+
+ private:
+	void addPendingModels();
+	void showFrameTime(double time);
+	void checkMemoryChanged();
+	void releaseGL();
+
+	std::vector<std::filesystem::path> _pending;  // models to load once OpenGL is initialized
+	bool _initialized { false };
+	bool _memoryReported { false };  // see EnableMemoryReport()
+	std::vector<std::shared_ptr<QOpenGLShaderProgram>> _programs;  // built-in programs, see PrewarmPrograms()
+	Callback _onMemoryChanged;
+	std::array<std::size_t, 4> _memoryState { 0, 0, 0, 0 };  // of the last call of _onMemoryChanged
 };
 
 /**
@@ -35,7 +78,8 @@ class GLViewport final : public Viewport {
 class SimpleWindow final : public Window {
  public:
 	SimpleWindow() noexcept = default;
-	explicit SimpleWindow(const std::string &title);
+	explicit SimpleWindow(const std::string &title,
+	                      const std::vector<std::filesystem::path> &models = {});
 	SimpleWindow(SimpleWindow&&) = default;
 
 	SimpleWindow(const SimpleWindow&) = delete;
@@ -47,9 +91,22 @@ class SimpleWindow final : public Window {
 	bool event(QEvent *event) override;
 	void wheelEvent(QWheelEvent *event) override;
 
+	void loadModel(const std::filesystem::path &path) override;
+	void unloadModels() override;
+	void runLightBenchmark();
+	void runPointBenchmark();
+	void runReloadBenchmark(const std::vector<std::filesystem::path> &paths);
+	void setAntialiasing(Antialiasing mode);
+	void setTargetFrameTime(double time);
+
     GLViewport _viewport;  // TODO
  private:
 	bool keyEvent(QKeyEvent *event);
+	void updateStatistics();
+
+	SettingsPanel *_settings { nullptr };  // owned by its dock widget
+	StatisticsPanel *_statistics { nullptr };  // owned by its dock widget
+	bool _statisticsChanged { true };  // since the statistics panel was refreshed
 };
 
 }  // namespace bgl